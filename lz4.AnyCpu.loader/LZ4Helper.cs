@@ -37,6 +37,14 @@ namespace lz4 {
 			return LZ4Loader.Compress4()(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, highCompression);
 		}
 
+		public static byte[] Compress(byte[] input, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, long? maxFrameSize, int compressionLevel, bool favorDecSpeed = false, int acceleration = 1) {
+			return LZ4Loader.Compress5()(input, 0, input.Length, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, acceleration);
+		}
+
+		public static byte[] Compress(byte[] input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, long? maxFrameSize, int compressionLevel, bool favorDecSpeed = false, int acceleration = 1) {
+			return LZ4Loader.Compress5()(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, acceleration);
+		}
+
 		public static byte[] Decompress(byte[] input) {
 			return LZ4Loader.Decompress3()(input);
 		}
@@ -45,6 +53,18 @@ namespace lz4 {
 			return LZ4Loader.Decompress4()(input, inputOffset, inputLength);
 		}
 
+		public static byte[] Compress(byte[] input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, long? maxFrameSize, int compressionLevel, bool favorDecSpeed, int acceleration, LZ4Dictionary dictionary) {
+			return LZ4Loader.Compress6()(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, acceleration, dictionary == null ? null : dictionary.InnerDictionary);
+		}
+
+		public static byte[] Decompress(byte[] input, int inputOffset, int inputLength, LZ4Dictionary dictionary) {
+			return LZ4Loader.Decompress5()(input, inputOffset, inputLength, dictionary == null ? null : dictionary.InnerDictionary);
+		}
+
+		public static byte[] Decompress(byte[] input, int inputOffset, int inputLength, LZ4Dictionary dictionary, int maxDegreeOfParallelism) {
+			return LZ4Loader.Decompress6()(input, inputOffset, inputLength, dictionary == null ? null : dictionary.InnerDictionary, maxDegreeOfParallelism);
+		}
+
 		//}
 	}
 }
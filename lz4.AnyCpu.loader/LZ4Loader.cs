@@ -43,6 +43,7 @@ namespace lz4.AnyCPU.loader {
 			var helperType2 = asm.GetType("lz4.LZ4Helper+Frame", true);
 			var streamType = asm.GetType("lz4.LZ4Stream", true);
 			var eventArgsType = asm.GetType("lz4.LZ4UserDataFrameEventArgs", true);
+			var dictionaryType = asm.GetType("lz4.LZ4Dictionary", true);
 
 			var streamModeType = asm.GetType("lz4.LZ4StreamMode", true);
 			var blockModeType = asm.GetType("lz4.LZ4FrameBlockMode", true);
@@ -90,6 +91,23 @@ namespace lz4.AnyCPU.loader {
 			var cc1ce = Expression.Call(cc1, cc1p1, cc1p2_c, cc1p3_c, cc1p4_c, cc1p5_c, cc1p6, cc1p7, cc1p8);
 			_createCompressor = Expression.Lambda<Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, bool, bool, Stream>>(cc1ce, cc1p1, cc1p2, cc1p3, cc1p4, cc1p5, cc1p6, cc1p7, cc1p8).Compile();
 
+			var cc2 = streamType.GetMethod("CreateCompressor", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(Stream), streamModeType, blockModeType, blockSizeType, checksumType, typeof(long?), typeof(int), typeof(bool), typeof(bool) }, null);
+			var cc2p1 = Expression.Parameter(typeof(Stream));
+			var cc2p2 = Expression.Parameter(typeof(LZ4StreamMode));
+			var cc2p3 = Expression.Parameter(typeof(LZ4FrameBlockMode));
+			var cc2p4 = Expression.Parameter(typeof(LZ4FrameBlockSize));
+			var cc2p5 = Expression.Parameter(typeof(LZ4FrameChecksumMode));
+			var cc2p6 = Expression.Parameter(typeof(long?));
+			var cc2p7 = Expression.Parameter(typeof(int));
+			var cc2p8 = Expression.Parameter(typeof(bool));
+			var cc2p9 = Expression.Parameter(typeof(bool));
+			var cc2p2_c = Expression.Convert(cc2p2, streamModeType);
+			var cc2p3_c = Expression.Convert(cc2p3, blockModeType);
+			var cc2p4_c = Expression.Convert(cc2p4, blockSizeType);
+			var cc2p5_c = Expression.Convert(cc2p5, checksumType);
+			var cc2ce = Expression.Call(cc2, cc2p1, cc2p2_c, cc2p3_c, cc2p4_c, cc2p5_c, cc2p6, cc2p7, cc2p8, cc2p9);
+			_createCompressor2 = Expression.Lambda<Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, bool, Stream>>(cc2ce, cc2p1, cc2p2, cc2p3, cc2p4, cc2p5, cc2p6, cc2p7, cc2p8, cc2p9).Compile();
+
 			var cd1 = streamType.GetMethod("CreateDecompressor", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(Stream), streamModeType, typeof(bool) }, null);
 			var cd1p1 = Expression.Parameter(typeof(Stream));
 			var cd1p2 = Expression.Parameter(typeof(LZ4StreamMode));
@@ -112,6 +130,13 @@ namespace lz4.AnyCPU.loader {
 			var fcmce = Expression.Call(fci_c, fcm);
 			_frameCount = Expression.Lambda<Func<Stream, long>>(fcmce, fci).Compile();
 
+			var ac = streamType.GetProperty("AllocationCount", BindingFlags.Public | BindingFlags.Instance);
+			var aci = Expression.Parameter(typeof(Stream));
+			var aci_c = Expression.Convert(aci, streamType);
+			var acm = ac.GetGetMethod(false);
+			var acmce = Expression.Call(aci_c, acm);
+			_allocationCount = Expression.Lambda<Func<Stream, long>>(acmce, aci).Compile();
+
 			var ir = streamType.GetProperty("InteractiveRead", BindingFlags.Public | BindingFlags.Instance);
 			var iri = Expression.Parameter(typeof(Stream));
 			var iri_c = Expression.Convert(iri, streamType);
@@ -124,6 +149,144 @@ namespace lz4.AnyCPU.loader {
 			var irsmce = Expression.Call(iri_c, irsm, irsma);
 			_setInteractiveRead = Expression.Lambda<Action<Stream, bool>>(irsmce, iri, irsma).Compile();
 
+			var dop = streamType.GetProperty("MaxDegreeOfParallelism", BindingFlags.Public | BindingFlags.Instance);
+			var dopi = Expression.Parameter(typeof(Stream));
+			var dopi_c = Expression.Convert(dopi, streamType);
+			var dopgm = dop.GetGetMethod(false);
+			var dopgmce = Expression.Call(dopi_c, dopgm);
+			_getMaxDegreeOfParallelism = Expression.Lambda<Func<Stream, int>>(dopgmce, dopi).Compile();
+
+			var dopsma = Expression.Parameter(typeof(int));
+			var dopsm = dop.GetSetMethod(false);
+			var dopsmce = Expression.Call(dopi_c, dopsm, dopsma);
+			_setMaxDegreeOfParallelism = Expression.Lambda<Action<Stream, int>>(dopsmce, dopi, dopsma).Compile();
+
+			var cs = streamType.GetProperty("ContentSize", BindingFlags.Public | BindingFlags.Instance);
+			var csi = Expression.Parameter(typeof(Stream));
+			var csi_c = Expression.Convert(csi, streamType);
+			var csgm = cs.GetGetMethod(false);
+			var csgmce = Expression.Call(csi_c, csgm);
+			_getContentSize = Expression.Lambda<Func<Stream, long?>>(csgmce, csi).Compile();
+
+			var cssma = Expression.Parameter(typeof(long?));
+			var cssm = cs.GetSetMethod(false);
+			var cssmce = Expression.Call(csi_c, cssm, cssma);
+			_setContentSize = Expression.Lambda<Action<Stream, long?>>(cssmce, csi, cssma).Compile();
+
+			var wbi = streamType.GetProperty("WriteBlockIndex", BindingFlags.Public | BindingFlags.Instance);
+			var wbii = Expression.Parameter(typeof(Stream));
+			var wbii_c = Expression.Convert(wbii, streamType);
+			var wbigm = wbi.GetGetMethod(false);
+			var wbigmce = Expression.Call(wbii_c, wbigm);
+			_getWriteBlockIndex = Expression.Lambda<Func<Stream, bool>>(wbigmce, wbii).Compile();
+
+			var wbisma = Expression.Parameter(typeof(bool));
+			var wbism = wbi.GetSetMethod(false);
+			var wbismce = Expression.Call(wbii_c, wbism, wbisma);
+			_setWriteBlockIndex = Expression.Lambda<Action<Stream, bool>>(wbismce, wbii, wbisma).Compile();
+
+			var ri = streamType.GetProperty("RestartInterval", BindingFlags.Public | BindingFlags.Instance);
+			var rii = Expression.Parameter(typeof(Stream));
+			var rii_c = Expression.Convert(rii, streamType);
+			var rigm = ri.GetGetMethod(false);
+			var rigmce = Expression.Call(rii_c, rigm);
+			_getRestartInterval = Expression.Lambda<Func<Stream, int>>(rigmce, rii).Compile();
+
+			var risma = Expression.Parameter(typeof(int));
+			var rism = ri.GetSetMethod(false);
+			var rismce = Expression.Call(rii_c, rism, risma);
+			_setRestartInterval = Expression.Lambda<Action<Stream, int>>(rismce, rii, risma).Compile();
+
+			var acc = streamType.GetProperty("Acceleration", BindingFlags.Public | BindingFlags.Instance);
+			var acci = Expression.Parameter(typeof(Stream));
+			var acci_c = Expression.Convert(acci, streamType);
+			var accgm = acc.GetGetMethod(false);
+			var accgmce = Expression.Call(acci_c, accgm);
+			_getAcceleration = Expression.Lambda<Func<Stream, int>>(accgmce, acci).Compile();
+
+			var accsma = Expression.Parameter(typeof(int));
+			var accsm = acc.GetSetMethod(false);
+			var accsmce = Expression.Call(acci_c, accsm, accsma);
+			_setAcceleration = Expression.Lambda<Action<Stream, int>>(accsmce, acci, accsma).Compile();
+
+			var macc = streamType.GetProperty("MaxAcceleration", BindingFlags.Public | BindingFlags.Instance);
+			var macci = Expression.Parameter(typeof(Stream));
+			var macci_c = Expression.Convert(macci, streamType);
+			var maccgm = macc.GetGetMethod(false);
+			var maccgmce = Expression.Call(macci_c, maccgm);
+			_getMaxAcceleration = Expression.Lambda<Func<Stream, int?>>(maccgmce, macci).Compile();
+
+			var maccsma = Expression.Parameter(typeof(int?));
+			var maccsm = macc.GetSetMethod(false);
+			var maccsmce = Expression.Call(macci_c, maccsm, maccsma);
+			_setMaxAcceleration = Expression.Lambda<Action<Stream, int?>>(maccsmce, macci, maccsma).Compile();
+
+			var cacc = streamType.GetProperty("CurrentAcceleration", BindingFlags.Public | BindingFlags.Instance);
+			var cacci = Expression.Parameter(typeof(Stream));
+			var cacci_c = Expression.Convert(cacci, streamType);
+			var caccm = cacc.GetGetMethod(false);
+			var caccmce = Expression.Call(cacci_c, caccm);
+			_currentAcceleration = Expression.Lambda<Func<Stream, int>>(caccmce, cacci).Compile();
+
+			var cdc = dictionaryType.GetConstructor(BindingFlags.Public | BindingFlags.Instance, null, new Type[] { typeof(uint?), typeof(byte[]), typeof(int), typeof(int) }, null);
+			var cdcp1 = Expression.Parameter(typeof(uint?));
+			var cdcp2 = Expression.Parameter(typeof(byte[]));
+			var cdcp3 = Expression.Parameter(typeof(int));
+			var cdcp4 = Expression.Parameter(typeof(int));
+			var cdcne = Expression.New(cdc, cdcp1, cdcp2, cdcp3, cdcp4);
+			_createDictionary = Expression.Lambda<Func<uint?, byte[], int, int, object>>(cdcne, cdcp1, cdcp2, cdcp3, cdcp4).Compile();
+
+			var dl = dictionaryType.GetProperty("Length", BindingFlags.Public | BindingFlags.Instance);
+			var dli = Expression.Parameter(typeof(object));
+			var dli_c = Expression.Convert(dli, dictionaryType);
+			var dlm = dl.GetGetMethod(false);
+			var dlmce = Expression.Call(dli_c, dlm);
+			_dictionaryLength = Expression.Lambda<Func<object, int>>(dlmce, dli).Compile();
+
+			var pd = dictionaryType.GetMethod("Prepare", BindingFlags.Public | BindingFlags.Instance);
+			var pdi = Expression.Parameter(typeof(object));
+			var pdi_c = Expression.Convert(pdi, dictionaryType);
+			var pdp1 = Expression.Parameter(typeof(int));
+			var pdp2 = Expression.Parameter(typeof(bool));
+			var pdce = Expression.Call(pdi_c, pd, pdp1, pdp2);
+			_prepareDictionary = Expression.Lambda<Action<object, int, bool>>(pdce, pdi, pdp1, pdp2).Compile();
+
+			var sd = streamType.GetProperty("Dictionary", BindingFlags.Public | BindingFlags.Instance);
+			var sdi = Expression.Parameter(typeof(Stream));
+			var sdi_c = Expression.Convert(sdi, streamType);
+			var sdsma = Expression.Parameter(typeof(object));
+			var sdsma_c = Expression.Convert(sdsma, dictionaryType);
+			var sdsm = sd.GetSetMethod(false);
+			var sdsmce = Expression.Call(sdi_c, sdsm, sdsma_c);
+			_setDictionary = Expression.Lambda<Action<Stream, object>>(sdsmce, sdi, sdsma).Compile();
+
+			var addDictionaryMethod = streamType.GetMethod("AddDictionary", BindingFlags.Public | BindingFlags.Instance);
+			var addDictionaryP1 = Expression.Parameter(typeof(Stream));
+			var addDictionaryP2 = Expression.Parameter(typeof(object));
+			var addDictionaryP1Converted = Expression.Convert(addDictionaryP1, streamType);
+			var addDictionaryP2Converted = Expression.Convert(addDictionaryP2, dictionaryType);
+			var addDictionaryCallExpression = Expression.Call(addDictionaryP1Converted, addDictionaryMethod, addDictionaryP2Converted);
+			_addDictionary = Expression.Lambda<Action<Stream, object>>(addDictionaryCallExpression, addDictionaryP1, addDictionaryP2).Compile();
+
+			var trainingResultType = asm.GetType("lz4.LZ4DictionaryTrainingResult", true);
+			var td = dictionaryType.GetMethod("Train", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(IEnumerable<byte[]>), typeof(int), typeof(int), typeof(int) }, null);
+			var tdp1 = Expression.Parameter(typeof(IEnumerable<byte[]>));
+			var tdp2 = Expression.Parameter(typeof(int));
+			var tdp3 = Expression.Parameter(typeof(int));
+			var tdp4 = Expression.Parameter(typeof(int));
+			var tdr = Expression.Variable(trainingResultType);
+			var tdc = typeof(LZ4DictionaryTrainingResult).GetConstructor(BindingFlags.NonPublic | BindingFlags.Instance, null, new Type[] { typeof(byte[]), typeof(int), typeof(int), typeof(int), typeof(long), typeof(long), typeof(long) }, null);
+			var tdne = Expression.New(tdc,
+				Expression.Property(tdr, "Data"),
+				Expression.Property(tdr, "SegmentSize"),
+				Expression.Property(tdr, "DmerSize"),
+				Expression.Property(tdr, "EvaluatedSamples"),
+				Expression.Property(tdr, "EvaluatedSize"),
+				Expression.Property(tdr, "CompressedSize"),
+				Expression.Property(tdr, "CompressedSizeWithDictionary"));
+			var tdb = Expression.Block(new ParameterExpression[] { tdr }, Expression.Assign(tdr, Expression.Call(td, tdp1, tdp2, tdp3, tdp4)), tdne);
+			_trainDictionary = Expression.Lambda<Func<IEnumerable<byte[]>, int, int, int, LZ4DictionaryTrainingResult>>(tdb, tdp1, tdp2, tdp3, tdp4).Compile();
+
 			var ufe = streamType.GetEvent("UserDataFrameRead", BindingFlags.Public | BindingFlags.Instance);
 			var ufei = Expression.Parameter(typeof(Stream));
 			var efei_c = Expression.Convert(ufei, streamType);
@@ -195,18 +358,73 @@ namespace lz4.AnyCPU.loader {
 			var c4ce = Expression.Call(c4, c4p1, c4p2, c4p3, c4p4_c, c4p5_c, c4p6_c, c4p7, c4p8);
 			_compress4 = Expression.Lambda<Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, bool, byte[]>>(c4ce, c4p1, c4p2, c4p3, c4p4, c4p5, c4p6, c4p7, c4p8).Compile();
 
+			var c5 = helperType2.GetMethod("Compress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int), blockModeType, blockSizeType, checksumType, typeof(long?), typeof(int), typeof(bool), typeof(int) }, null);
+			var c5p1 = Expression.Parameter(typeof(byte[]));
+			var c5p2 = Expression.Parameter(typeof(int));
+			var c5p3 = Expression.Parameter(typeof(int));
+			var c5p4 = Expression.Parameter(typeof(LZ4FrameBlockMode));
+			var c5p4_c = Expression.Convert(c5p4, blockModeType);
+			var c5p5 = Expression.Parameter(typeof(LZ4FrameBlockSize));
+			var c5p5_c = Expression.Convert(c5p5, blockSizeType);
+			var c5p6 = Expression.Parameter(typeof(LZ4FrameChecksumMode));
+			var c5p6_c = Expression.Convert(c5p6, checksumType);
+			var c5p7 = Expression.Parameter(typeof(long?));
+			var c5p8 = Expression.Parameter(typeof(int));
+			var c5p9 = Expression.Parameter(typeof(bool));
+			var c5p10 = Expression.Parameter(typeof(int));
+			var c5ce = Expression.Call(c5, c5p1, c5p2, c5p3, c5p4_c, c5p5_c, c5p6_c, c5p7, c5p8, c5p9, c5p10);
+			_compress5 = Expression.Lambda<Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, byte[]>>(c5ce, c5p1, c5p2, c5p3, c5p4, c5p5, c5p6, c5p7, c5p8, c5p9, c5p10).Compile();
+
+			var c6 = helperType2.GetMethod("Compress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int), blockModeType, blockSizeType, checksumType, typeof(long?), typeof(int), typeof(bool), typeof(int), dictionaryType }, null);
+			var c6p1 = Expression.Parameter(typeof(byte[]));
+			var c6p2 = Expression.Parameter(typeof(int));
+			var c6p3 = Expression.Parameter(typeof(int));
+			var c6p4 = Expression.Parameter(typeof(LZ4FrameBlockMode));
+			var c6p4_c = Expression.Convert(c6p4, blockModeType);
+			var c6p5 = Expression.Parameter(typeof(LZ4FrameBlockSize));
+			var c6p5_c = Expression.Convert(c6p5, blockSizeType);
+			var c6p6 = Expression.Parameter(typeof(LZ4FrameChecksumMode));
+			var c6p6_c = Expression.Convert(c6p6, checksumType);
+			var c6p7 = Expression.Parameter(typeof(long?));
+			var c6p8 = Expression.Parameter(typeof(int));
+			var c6p9 = Expression.Parameter(typeof(bool));
+			var c6p10 = Expression.Parameter(typeof(int));
+			var c6p11 = Expression.Parameter(typeof(object));
+			var c6p11_c = Expression.Convert(c6p11, dictionaryType);
+			var c6ce = Expression.Call(c6, c6p1, c6p2, c6p3, c6p4_c, c6p5_c, c6p6_c, c6p7, c6p8, c6p9, c6p10, c6p11_c);
+			_compress6 = Expression.Lambda<Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, object, byte[]>>(c6ce, c6p1, c6p2, c6p3, c6p4, c6p5, c6p6, c6p7, c6p8, c6p9, c6p10, c6p11).Compile();
+
 			var d3 = helperType2.GetMethod("Decompress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]) }, null);
 			var d3p1 = Expression.Parameter(typeof(byte[]));
 			var d3ce = Expression.Call(d3, d3p1);
 			_decompress3 = Expression.Lambda<Func<byte[], byte[]>>(d3ce, d3p1).Compile();
 
-			var d4 = helperType1.GetMethod("Decompress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int) }, null);
+			var d4 = helperType2.GetMethod("Decompress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int) }, null);
 			var d4p1 = Expression.Parameter(typeof(byte[]));
 			var d4p2 = Expression.Parameter(typeof(int));
 			var d4p3 = Expression.Parameter(typeof(int));
 			var d4ce = Expression.Call(d4, d4p1, d4p2, d4p3);
 			_decompress4 = Expression.Lambda<Func<byte[], int, int, byte[]>>(d4ce, d4p1, d4p2, d4p3).Compile();
 
+			var d5 = helperType2.GetMethod("Decompress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int), dictionaryType }, null);
+			var d5p1 = Expression.Parameter(typeof(byte[]));
+			var d5p2 = Expression.Parameter(typeof(int));
+			var d5p3 = Expression.Parameter(typeof(int));
+			var d5p4 = Expression.Parameter(typeof(object));
+			var d5p4_c = Expression.Convert(d5p4, dictionaryType);
+			var d5ce = Expression.Call(d5, d5p1, d5p2, d5p3, d5p4_c);
+			_decompress5 = Expression.Lambda<Func<byte[], int, int, object, byte[]>>(d5ce, d5p1, d5p2, d5p3, d5p4).Compile();
+
+			var d6 = helperType2.GetMethod("Decompress", BindingFlags.Public | BindingFlags.Static, null, new Type[] { typeof(byte[]), typeof(int), typeof(int), dictionaryType, typeof(int) }, null);
+			var d6p1 = Expression.Parameter(typeof(byte[]));
+			var d6p2 = Expression.Parameter(typeof(int));
+			var d6p3 = Expression.Parameter(typeof(int));
+			var d6p4 = Expression.Parameter(typeof(object));
+			var d6p4_c = Expression.Convert(d6p4, dictionaryType);
+			var d6p5 = Expression.Parameter(typeof(int));
+			var d6ce = Expression.Call(d6, d6p1, d6p2, d6p3, d6p4_c, d6p5);
+			_decompress6 = Expression.Lambda<Func<byte[], int, int, object, int, byte[]>>(d6ce, d6p1, d6p2, d6p3, d6p4, d6p5).Compile();
+
 			if (!DisableVCRuntimeDetection) {
 				DetectVCRuntime();
 			}
@@ -291,6 +509,12 @@ namespace lz4.AnyCPU.loader {
 			return _frameCount;
 		}
 
+		private static Func<Stream, long> _allocationCount;
+		internal static Func<Stream, long> AllocationCount() {
+			Ensure();
+			return _allocationCount;
+		}
+
 		private static Func<Stream, bool> _getInteractiveRead;
 		internal static Func<Stream, bool> GetInteractiveRead() {
 			Ensure();
@@ -303,12 +527,132 @@ namespace lz4.AnyCPU.loader {
 			return _setInteractiveRead;
 		}
 
+		private static Func<Stream, int> _getMaxDegreeOfParallelism;
+		internal static Func<Stream, int> GetMaxDegreeOfParallelism() {
+			Ensure();
+			return _getMaxDegreeOfParallelism;
+		}
+
+		private static Action<Stream, int> _setMaxDegreeOfParallelism;
+		internal static Action<Stream, int> SetMaxDegreeOfParallelism() {
+			Ensure();
+			return _setMaxDegreeOfParallelism;
+		}
+
+		private static Func<Stream, long?> _getContentSize;
+		internal static Func<Stream, long?> GetContentSize() {
+			Ensure();
+			return _getContentSize;
+		}
+
+		private static Action<Stream, long?> _setContentSize;
+		internal static Action<Stream, long?> SetContentSize() {
+			Ensure();
+			return _setContentSize;
+		}
+
+		private static Func<Stream, bool> _getWriteBlockIndex;
+		internal static Func<Stream, bool> GetWriteBlockIndex() {
+			Ensure();
+			return _getWriteBlockIndex;
+		}
+
+		private static Action<Stream, bool> _setWriteBlockIndex;
+		internal static Action<Stream, bool> SetWriteBlockIndex() {
+			Ensure();
+			return _setWriteBlockIndex;
+		}
+
+		private static Func<Stream, int> _getRestartInterval;
+		internal static Func<Stream, int> GetRestartInterval() {
+			Ensure();
+			return _getRestartInterval;
+		}
+
+		private static Action<Stream, int> _setRestartInterval;
+		internal static Action<Stream, int> SetRestartInterval() {
+			Ensure();
+			return _setRestartInterval;
+		}
+
+		private static Func<uint?, byte[], int, int, object> _createDictionary;
+		internal static Func<uint?, byte[], int, int, object> CreateDictionary() {
+			Ensure();
+			return _createDictionary;
+		}
+
+		private static Func<object, int> _dictionaryLength;
+		internal static Func<object, int> DictionaryLength() {
+			Ensure();
+			return _dictionaryLength;
+		}
+
+		private static Action<object, int, bool> _prepareDictionary;
+		internal static Action<object, int, bool> PrepareDictionary() {
+			Ensure();
+			return _prepareDictionary;
+		}
+
+		private static Action<Stream, object> _setDictionary;
+		internal static Action<Stream, object> SetDictionary() {
+			Ensure();
+			return _setDictionary;
+		}
+
+		private static Action<Stream, object> _addDictionary;
+		internal static Action<Stream, object> AddDictionary() {
+			Ensure();
+			return _addDictionary;
+		}
+
+		private static Func<IEnumerable<byte[]>, int, int, int, LZ4DictionaryTrainingResult> _trainDictionary;
+		internal static Func<IEnumerable<byte[]>, int, int, int, LZ4DictionaryTrainingResult> TrainDictionary() {
+			Ensure();
+			return _trainDictionary;
+		}
+
+		private static Func<Stream, int> _getAcceleration;
+		internal static Func<Stream, int> GetAcceleration() {
+			Ensure();
+			return _getAcceleration;
+		}
+
+		private static Action<Stream, int> _setAcceleration;
+		internal static Action<Stream, int> SetAcceleration() {
+			Ensure();
+			return _setAcceleration;
+		}
+
+		private static Func<Stream, int?> _getMaxAcceleration;
+		internal static Func<Stream, int?> GetMaxAcceleration() {
+			Ensure();
+			return _getMaxAcceleration;
+		}
+
+		private static Action<Stream, int?> _setMaxAcceleration;
+		internal static Action<Stream, int?> SetMaxAcceleration() {
+			Ensure();
+			return _setMaxAcceleration;
+		}
+
+		private static Func<Stream, int> _currentAcceleration;
+		internal static Func<Stream, int> CurrentAcceleration() {
+			Ensure();
+			return _currentAcceleration;
+		}
+
 		private static Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, bool, bool, Stream> _createCompressor;
 		internal static Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, bool, bool, Stream> CreateCompressor() {
 			Ensure();
 			return _createCompressor;
 		}
 
+		private static Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, bool, Stream> _createCompressor2;
+		internal static Func<Stream, LZ4StreamMode, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, bool, Stream> CreateCompressor2() {
+			Ensure();
+			return _createCompressor2;
+		}
+
 		private static Func<Stream, LZ4StreamMode, bool, Stream> _createDecompressor;
 		internal static Func<Stream, LZ4StreamMode, bool, Stream> CreateDecompressor() {
 			Ensure();
@@ -339,6 +683,18 @@ namespace lz4.AnyCPU.loader {
 			return _compress4;
 		}
 
+		private static Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, byte[]> _compress5;
+		internal static Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, byte[]> Compress5() {
+			Ensure();
+			return _compress5;
+		}
+
+		private static Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, object, byte[]> _compress6;
+		internal static Func<byte[], int, int, LZ4FrameBlockMode, LZ4FrameBlockSize, LZ4FrameChecksumMode, long?, int, bool, int, object, byte[]> Compress6() {
+			Ensure();
+			return _compress6;
+		}
+
 		private static Func<byte[], byte[]> _decompress1;
 		internal static Func<byte[], byte[]> Decompress1() {
 			Ensure();
@@ -363,6 +719,18 @@ namespace lz4.AnyCPU.loader {
 			return _decompress4;
 		}
 
+		private static Func<byte[], int, int, object, byte[]> _decompress5;
+		internal static Func<byte[], int, int, object, byte[]> Decompress5() {
+			Ensure();
+			return _decompress5;
+		}
+
+		private static Func<byte[], int, int, object, int, byte[]> _decompress6;
+		internal static Func<byte[], int, int, object, int, byte[]> Decompress6() {
+			Ensure();
+			return _decompress6;
+		}
+
 		private static Assembly LoadLZ4Assembly(LZ4LoaderType loaderType) {
 
 			if (loaderType == LZ4LoaderType.EmbeddedResource) {
@@ -9,6 +9,7 @@ namespace lz4 {
 	public sealed class LZ4Stream : Stream {
 
 		private Stream _innerStream;
+		private LZ4Dictionary _dictionary;
 
 		public event EventHandler<LZ4UserDataFrameEventArgs> UserDataFrameRead;
 
@@ -32,6 +33,13 @@ namespace lz4 {
 			return r;
 		}
 
+		public static LZ4Stream CreateCompressor(Stream innerStream, LZ4StreamMode streamMode, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, long? maxFrameSize, int compressionLevel, bool favorDecSpeed = false, bool leaveInnerStreamOpen = false) {
+			var s = LZ4Loader.CreateCompressor2()(innerStream, streamMode, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, leaveInnerStreamOpen);
+			var r = new LZ4Stream();
+			r._innerStream = s;
+			return r;
+		}
+
 		public static LZ4Stream CreateDecompressor(Stream innerStream, LZ4StreamMode streamMode, bool leaveInnerStreamOpen = false) {
 			var s = LZ4Loader.CreateDecompressor()(innerStream, streamMode, leaveInnerStreamOpen);
 			var r = new LZ4Stream();
@@ -48,11 +56,62 @@ namespace lz4 {
 			get { return LZ4Loader.FrameCount()(_innerStream); }
 		}
 
+		public long AllocationCount {
+			get { return LZ4Loader.AllocationCount()(_innerStream); }
+		}
+
 		public bool InteractiveRead {
 			get { return LZ4Loader.GetInteractiveRead()(_innerStream); }
 			set { LZ4Loader.SetInteractiveRead()(_innerStream, value); }
 		}
 
+		public int MaxDegreeOfParallelism {
+			get { return LZ4Loader.GetMaxDegreeOfParallelism()(_innerStream); }
+			set { LZ4Loader.SetMaxDegreeOfParallelism()(_innerStream, value); }
+		}
+
+		public long? ContentSize {
+			get { return LZ4Loader.GetContentSize()(_innerStream); }
+			set { LZ4Loader.SetContentSize()(_innerStream, value); }
+		}
+
+		public bool WriteBlockIndex {
+			get { return LZ4Loader.GetWriteBlockIndex()(_innerStream); }
+			set { LZ4Loader.SetWriteBlockIndex()(_innerStream, value); }
+		}
+
+		public int RestartInterval {
+			get { return LZ4Loader.GetRestartInterval()(_innerStream); }
+			set { LZ4Loader.SetRestartInterval()(_innerStream, value); }
+		}
+
+		public LZ4Dictionary Dictionary {
+			get { return _dictionary; }
+			set {
+				LZ4Loader.SetDictionary()(_innerStream, value == null ? null : value.InnerDictionary);
+				_dictionary = value;
+			}
+		}
+
+		public void AddDictionary(LZ4Dictionary dictionary) {
+			if (dictionary == null) { throw new ArgumentNullException("dictionary"); }
+			LZ4Loader.AddDictionary()(_innerStream, dictionary.InnerDictionary);
+		}
+
+		public int Acceleration {
+			get { return LZ4Loader.GetAcceleration()(_innerStream); }
+			set { LZ4Loader.SetAcceleration()(_innerStream, value); }
+		}
+
+		public int? MaxAcceleration {
+			get { return LZ4Loader.GetMaxAcceleration()(_innerStream); }
+			set { LZ4Loader.SetMaxAcceleration()(_innerStream, value); }
+		}
+
+		public int CurrentAcceleration {
+			get { return LZ4Loader.CurrentAcceleration()(_innerStream); }
+		}
+
 		public void WriteEndFrame() {
 			LZ4Loader.WriteEndFrame()(_innerStream);
 		}
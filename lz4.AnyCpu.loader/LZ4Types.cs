@@ -1,4 +1,5 @@
-﻿using System;
+﻿using lz4.AnyCPU.loader;
+using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Text;
@@ -28,6 +29,116 @@ namespace lz4 {
 		Block
 	}
 
+	public sealed class LZ4Dictionary {
+		private object _dictionary;
+		private uint? _id;
+
+		public LZ4Dictionary(byte[] data)
+			: this(null, data, 0, data == null ? 0 : data.Length) {
+		}
+
+		public LZ4Dictionary(uint id, byte[] data)
+			: this(id, data, 0, data == null ? 0 : data.Length) {
+		}
+
+		public LZ4Dictionary(uint? id, byte[] data, int offset, int count) {
+			this._dictionary = LZ4Loader.CreateDictionary()(id, data, offset, count);
+			this._id = id;
+		}
+
+		internal object InnerDictionary {
+			get {
+				return this._dictionary;
+			}
+		}
+
+		public uint? Id {
+			get {
+				return this._id;
+			}
+		}
+
+		public int Length {
+			get {
+				return LZ4Loader.DictionaryLength()(this._dictionary);
+			}
+		}
+
+		public void Prepare(int compressionLevel, bool favorDecSpeed) {
+			LZ4Loader.PrepareDictionary()(this._dictionary, compressionLevel, favorDecSpeed);
+		}
+
+		public static LZ4DictionaryTrainingResult Train(IEnumerable<byte[]> samples, int dictionarySize) {
+			return Train(samples, dictionarySize, 0, 0);
+		}
+
+		public static LZ4DictionaryTrainingResult Train(IEnumerable<byte[]> samples, int dictionarySize, int segmentSize, int dmerSize) {
+			return LZ4Loader.TrainDictionary()(samples, dictionarySize, segmentSize, dmerSize);
+		}
+	}
+
+	public sealed class LZ4DictionaryTrainingResult {
+		private byte[] _data;
+		private int _segmentSize;
+		private int _dmerSize;
+		private int _evaluatedSamples;
+		private long _evaluatedSize;
+		private long _compressedSize;
+		private long _compressedSizeWithDictionary;
+
+		internal LZ4DictionaryTrainingResult(byte[] data, int segmentSize, int dmerSize, int evaluatedSamples, long evaluatedSize, long compressedSize, long compressedSizeWithDictionary) {
+			this._data = data;
+			this._segmentSize = segmentSize;
+			this._dmerSize = dmerSize;
+			this._evaluatedSamples = evaluatedSamples;
+			this._evaluatedSize = evaluatedSize;
+			this._compressedSize = compressedSize;
+			this._compressedSizeWithDictionary = compressedSizeWithDictionary;
+		}
+
+		public byte[] Data {
+			get {
+				return this._data;
+			}
+		}
+
+		public int SegmentSize {
+			get {
+				return this._segmentSize;
+			}
+		}
+
+		public int DmerSize {
+			get {
+				return this._dmerSize;
+			}
+		}
+
+		public int EvaluatedSamples {
+			get {
+				return this._evaluatedSamples;
+			}
+		}
+
+		public long EvaluatedSize {
+			get {
+				return this._evaluatedSize;
+			}
+		}
+
+		public long CompressedSize {
+			get {
+				return this._compressedSize;
+			}
+		}
+
+		public long CompressedSizeWithDictionary {
+			get {
+				return this._compressedSizeWithDictionary;
+			}
+		}
+	}
+
 	public sealed class LZ4UserDataFrameEventArgs : EventArgs {
 		private byte[] _data;
 		private int _id;
@@ -0,0 +1,119 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4DictionaryTrainer.h"
+#include "lz4TestData.h"
+
+// compression of 1 KB messages with a 64 KB dictionary: none, the first 64 KB of the corpus, and a dictionary trained on other messages (lz4DictionaryTrainer.h)
+// the trained dictionary is loaded for every message (LZ4_loadDict, LZ4_loadDictHC) or prepared once, so that it is hashed once
+// usage: lz4DictionaryBench [files], the generated corpora when no files are passed; the first half is split into the training samples, the messages are the second half
+
+using namespace lz4::native;
+using namespace lz4test;
+
+static const int MessageSize = 1024;
+
+int main(int argc, char** argv) {
+	std::vector<Corpus> corpora = Corpora(argc, argv, 4 * 1024 * 1024);
+	const int levels[] = { 0, 4, 9 };
+	const char* modes[] = { "none", "first 64K", "trained", "prepared" };
+
+	printf("%-12s %-5s %-9s %7s %14s %14s\n", "corpus", "level", "dict", "ratio", "encode msg/s", "decode msg/s");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		int samples = (int)(data.size() / 2 / MessageSize);
+		if (samples < 5 || data.size() / 2 < LZ4FRAME_DICTIONARY_SIZE_MAX) { fprintf(stderr, "%s: too small\n", corpus.name.c_str()); continue; }
+		const char* messages = &data[(size_t)samples * MessageSize];
+		int count = (int)((data.size() - (size_t)samples * MessageSize) / MessageSize);
+
+		// the messages are not part of the training samples
+		std::vector<char> trained(LZ4FRAME_DICTIONARY_SIZE_MAX);
+		std::vector<int> sampleSizes((size_t)samples, MessageSize);
+		LZ4DictionaryTrainerParameters parameters = { 0, 0 };
+		LZ4DictionaryTrainerResult training;
+		double start = Now();
+		int trainedSize = LZ4Dictionary_train(trained.data(), (int)trained.size(), data.data(), sampleSizes.data(), samples, &parameters, &training);
+		if (trainedSize <= 0) { fprintf(stderr, "%s: training failed %d\n", corpus.name.c_str(), trainedSize); continue; }
+		printf("%-12s trained %d bytes from %d samples in %.2f s, segment size %d, dmer size %d\n", corpus.name.c_str(), trainedSize, samples, Now() - start, training.segmentSize, training.dmerSize);
+
+		for (int level : levels) {
+			LZ4PreparedDictionary prepared;
+			prepared.Init(trained.data(), trainedSize, level != 0, false);
+
+			for (int mode = 0; mode < 4; mode++) {
+				const char* dictionary = mode == 1 ? data.data() : mode >= 2 ? trained.data() : NULL;
+				int dictionarySize = mode == 1 ? LZ4FRAME_DICTIONARY_SIZE_MAX : mode >= 2 ? trainedSize : 0;
+				LZ4FrameInfo info;
+				memset(&info, 0, sizeof(info));
+				info.blockSizeId = 4;
+				info.independentBlocks = true;
+				LZ4FrameCompressionOptions options;
+				memset(&options, 0, sizeof(options));
+				options.compressionLevel = level;
+				options.acceleration = 1;
+
+				LZ4FrameEncoder encoder;
+				encoder.Init(&info, &options);
+				if (mode == 1 || mode == 2) { encoder.SetDictionary(dictionary, dictionarySize); }
+				else if (mode == 3) { encoder.SetPreparedDictionary(&prepared); }
+
+				int bound = (int)LZ4Frame_compressBound(&info, MessageSize, 0);
+				std::vector<char> frames((size_t)count * (size_t)bound);
+				std::vector<int> frameSizes((size_t)count);
+				auto compress = [&]() {
+					for (int i = 0; i < count; i++) {
+						frameSizes[(size_t)i] = encoder.CompressFrames(&messages[(size_t)i * MessageSize], MessageSize, 0, &frames[(size_t)i * (size_t)bound], bound);
+					}
+				};
+				compress();
+
+				long long total = 0;
+				std::vector<char> output(MessageSize);
+				for (int i = 0; i < count; i++) {
+					int result = LZ4Frame_decompress_usingDict(&frames[(size_t)i * (size_t)bound], frameSizes[(size_t)i], output.data(), MessageSize, dictionary, dictionarySize);
+					if (result != MessageSize || memcmp(output.data(), &messages[(size_t)i * MessageSize], MessageSize) != 0) { fprintf(stderr, "%s: level %d %s: message %d roundtrip failed %d\n", corpus.name.c_str(), level, modes[mode], i, result); return 1; }
+					total += frameSizes[(size_t)i];
+				}
+
+				double encode = Throughput((size_t)count * MessageSize, compress);
+				double decode = Throughput((size_t)count * MessageSize, [&]() {
+					for (int i = 0; i < count; i++) {
+						LZ4Frame_decompress_usingDict(&frames[(size_t)i * (size_t)bound], frameSizes[(size_t)i], output.data(), MessageSize, dictionary, dictionarySize);
+					}
+				});
+				// MB/s to messages per second
+				double perSecond = 1e6 / MessageSize;
+				printf("%-12s %-5d %-9s %7.3f %14.0f %14.0f\n", corpus.name.c_str(), level, modes[mode], (double)count * MessageSize / total, encode * perSecond, decode * perSecond);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,151 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+// throughput of the frame engine (lz4Frame.h): whole frames, the incremental decoder and the cost of a frame per small message
+// usage: lz4FrameBench [files], the generated corpora when no files are passed
+
+using namespace lz4::native;
+using namespace lz4test;
+
+struct Configuration {
+	const char* name;
+	int blockSizeId;
+	bool independentBlocks;
+	bool blockChecksum;
+	int compressionLevel;
+};
+
+static void InitEncoder(LZ4FrameEncoder& encoder, const Configuration& c, bool hasContentSize, unsigned long long contentSize) {
+	LZ4FrameInfo info;
+	memset(&info, 0, sizeof(info));
+	info.blockSizeId = c.blockSizeId;
+	info.independentBlocks = c.independentBlocks;
+	info.blockChecksum = c.blockChecksum;
+	info.contentChecksum = true;
+	info.hasContentSize = hasContentSize;
+	info.contentSize = contentSize;
+
+	LZ4FrameCompressionOptions options;
+	memset(&options, 0, sizeof(options));
+	options.compressionLevel = c.compressionLevel;
+	options.acceleration = 1;
+	encoder.Init(&info, &options);
+}
+
+// decodes the frame in parts of chunkSize bytes, as LZ4Stream reads it
+static size_t DecodeIncremental(LZ4FrameDecoder& decoder, const std::vector<char>& frame, int chunkSize) {
+	size_t outputSize = 0;
+	for (size_t offset = 0; offset < frame.size(); offset += (size_t)chunkSize) {
+		int size = (int)std::min<size_t>((size_t)chunkSize, frame.size() - offset);
+		int used = 0;
+		int frameEvent;
+		do {
+			int consumed;
+			frameEvent = decoder.Decode(&frame[offset + (size_t)used], size - used, &consumed);
+			if (LZ4Frame_isError(frameEvent)) { return 0; }
+			used += consumed;
+			if (frameEvent == LZ4FrameDecoder_Block) { outputSize += (size_t)decoder.OutputSize(); }
+		} while (frameEvent != LZ4FrameDecoder_NeedInput);
+	}
+	return outputSize;
+}
+
+int main(int argc, char** argv) {
+	std::vector<Corpus> corpora = Corpora(argc, argv, 4 * 1024 * 1024);
+	const Configuration configurations[] = {
+		{ "fast linked", 4, false, false, 0 },
+		{ "fast indep", 4, true, true, 0 },
+		{ "fast 4 MB", 7, false, false, 0 },
+		{ "hc4 linked", 4, false, false, 4 },
+		{ "hc9 linked", 4, false, false, 9 },
+	};
+
+	printf("%-12s %-12s %7s %11s %11s %11s\n", "corpus", "frame", "ratio", "encode MB/s", "decode MB/s", "stream MB/s");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		for (const Configuration& c : configurations) {
+			LZ4FrameEncoder encoder;
+			InitEncoder(encoder, c, true, data.size());
+			std::vector<char> frame((size_t)LZ4Frame_compressBound(&encoder.Info(), (long long)data.size(), 0));
+			std::vector<char> encoded(frame.size());
+			int frameSize = encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size());
+			if (frameSize <= 0) { fprintf(stderr, "%s: %s compress failed %d\n", corpus.name.c_str(), c.name, frameSize); return 1; }
+			frame.resize((size_t)frameSize);
+
+			std::vector<char> output(data.size());
+			int result = LZ4Frame_decompress(frame.data(), frameSize, output.data(), (int)output.size());
+			if (result != (int)data.size() || output != data) { fprintf(stderr, "%s: %s roundtrip failed %d\n", corpus.name.c_str(), c.name, result); return 1; }
+
+			// high compression on the first MB only
+			size_t encodeSize = c.compressionLevel == 0 ? data.size() : std::min<size_t>(data.size(), 1024 * 1024);
+			double encode = Throughput(encodeSize, [&]() { encoder.CompressFrames(data.data(), (int)encodeSize, 0, encoded.data(), (int)encoded.size()); });
+			double decode = Throughput(data.size(), [&]() { LZ4Frame_decompress(frame.data(), frameSize, output.data(), (int)output.size()); });
+			LZ4FrameDecoder decoder;
+			double stream = Throughput(data.size(), [&]() { DecodeIncremental(decoder, frame, 64 * 1024); });
+
+			printf("%-12s %-12s %7.3f %11.0f %11.0f %11.0f\n", corpus.name.c_str(), c.name, (double)data.size() / frameSize, encode, decode, stream);
+		}
+	}
+
+	// a frame per message: the header, end mark and checksum dominate for small messages, the encoder and decoder are reused
+	std::vector<char> log = LogCorpus(4 * 1024 * 1024);
+	const int messageSizes[] = { 256, 1024, 4096 };
+	printf("\n%-12s %7s %15s %15s\n", "message", "ratio", "encode msg/s", "decode msg/s");
+	for (int messageSize : messageSizes) {
+		int count = (int)(log.size() / (size_t)messageSize);
+		Configuration c = { "", 4, true, false, 0 };
+		LZ4FrameEncoder encoder;
+		InitEncoder(encoder, c, false, 0);
+		int bound = (int)LZ4Frame_compressBound(&encoder.Info(), messageSize, 0);
+		std::vector<char> frames((size_t)count * (size_t)bound);
+		std::vector<int> frameSizes((size_t)count);
+		long long total = 0;
+		for (int i = 0; i < count; i++) {
+			frameSizes[(size_t)i] = encoder.CompressFrames(&log[(size_t)i * (size_t)messageSize], messageSize, 0, &frames[(size_t)i * (size_t)bound], bound);
+			total += frameSizes[(size_t)i];
+		}
+
+		std::vector<char> output((size_t)messageSize);
+		double encode = Throughput((size_t)count * (size_t)messageSize, [&]() {
+			for (int i = 0; i < count; i++) { encoder.CompressFrames(&log[(size_t)i * (size_t)messageSize], messageSize, 0, &frames[(size_t)i * (size_t)bound], bound); }
+		});
+		double decode = Throughput((size_t)count * (size_t)messageSize, [&]() {
+			for (int i = 0; i < count; i++) { LZ4Frame_decompress(&frames[(size_t)i * (size_t)bound], frameSizes[(size_t)i], output.data(), messageSize); }
+		});
+		// MB/s to messages per second
+		double perSecond = 1e6 / messageSize;
+		printf("%-12d %7.3f %15.0f %15.0f\n", messageSize, (double)count * messageSize / total, encode * perSecond, decode * perSecond);
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+// ratio and throughput of the high compression levels 3 - 12 with and without favorDecSpeed, in 64 KB linked block frames as LZ4Stream writes them
+// usage: lz4HCLevelBench [files], the generated corpora when no files are passed
+
+using namespace lz4::native;
+using namespace lz4test;
+
+int main(int argc, char** argv) {
+	std::vector<Corpus> corpora = Corpora(argc, argv, 2 * 1024 * 1024);
+
+	printf("%-12s %-5s %-9s %7s %11s %11s\n", "corpus", "level", "decspeed", "ratio", "encode MB/s", "decode MB/s");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		for (int level = LZ4HC_CLEVEL_MIN; level <= LZ4HC_CLEVEL_MAX; level++) {
+			// favorDecSpeed only changes the optimal parser (LZ4HC_CLEVEL_OPT_MIN and up)
+			for (int favorDecSpeed = 0; favorDecSpeed < (level >= LZ4HC_CLEVEL_OPT_MIN ? 2 : 1); favorDecSpeed++) {
+				LZ4FrameInfo info;
+				memset(&info, 0, sizeof(info));
+				info.blockSizeId = 4;
+				info.contentChecksum = true;
+				LZ4FrameCompressionOptions options;
+				memset(&options, 0, sizeof(options));
+				options.compressionLevel = level;
+				options.favorDecSpeed = favorDecSpeed != 0;
+				options.acceleration = 1;
+
+				LZ4FrameEncoder encoder;
+				int status = encoder.Init(&info, &options);
+				if (status != LZ4Frame_OK) { fprintf(stderr, "level %d: %s\n", level, LZ4Frame_getErrorName(status)); return 1; }
+				std::vector<char> frame((size_t)LZ4Frame_compressBound(&info, (long long)data.size(), 0));
+				int frameSize = encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size());
+
+				std::vector<char> output(data.size());
+				int result = LZ4Frame_decompress(frame.data(), frameSize, output.data(), (int)output.size());
+				if (result != (int)data.size() || output != data) { fprintf(stderr, "%s: level %d roundtrip failed %d\n", corpus.name.c_str(), level, result); return 1; }
+
+				double encode = Throughput(data.size(), [&]() { encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size()); });
+				double decode = Throughput(data.size(), [&]() { LZ4Frame_decompress(frame.data(), frameSize, output.data(), (int)output.size()); });
+				printf("%-12s %-5d %-9s %7.3f %11.1f %11.0f\n", corpus.name.c_str(), level, favorDecSpeed ? "yes" : "no", (double)data.size() / frameSize, encode, decode);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,306 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+// the kernels of every instruction set against the baseline kernels (the portable code compiled natively without instruction set options), tablesize runs the selected kernels
+// the MSIL (/clr:pure) build of the same code is not measured, it only runs in the CLR on Windows
+// kernels: compression, decoding and xxh32 throughput
+// repetitive: the wide match length and backward extension compares on highly repetitive input, where fast and high compression (levels 9 - 12) extend long matches
+// batch: LZ4_decompress_safe_batch against a loop of LZ4_decompress_safe calls for small values, as a cache lookup decodes them
+// the values are spread over 64 MB and looked up in random order, the reads miss the cpu caches like the lookups of a large cache do
+// tablesize: ratio and compression throughput against the hash table size (memoryUsage): 1 KB messages, 64 KB and 4 MB blocks, fast and high compression
+// usage: lz4KernelsBench [case] [files], see RunBenchCases
+
+using namespace lz4::native;
+using namespace lz4test;
+
+static const int BlockSize = 64 * 1024;
+
+struct Blocks {
+	std::vector<int> sizes;
+	std::vector<std::vector<char>> compressed;
+};
+
+static Blocks Compress(const LZ4Kernels* kernels, const std::vector<char>& data) {
+	Blocks blocks;
+	for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+		int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+		std::vector<char> block((size_t)LZ4_compressBound(size));
+		block.resize((size_t)kernels->compress_fast(&data[offset], block.data(), size, (int)block.size(), 1));
+		blocks.sizes.push_back(size);
+		blocks.compressed.push_back(block);
+	}
+	return blocks;
+}
+
+static std::vector<Corpus> KernelsCorpora() {
+	return GeneratedCorpora(4 * 1024 * 1024);
+}
+
+static int RunKernels(const std::vector<Corpus>& corpora) {
+	std::vector<const LZ4Kernels*> kernels = SupportedKernels();
+	std::vector<char> output((size_t)LZ4_compressBound(BlockSize));
+
+	printf("%-12s %-10s %13s %13s %13s %13s\n", "corpus", "kernels", "fast MB/s", "hc9 MB/s", "decode MB/s", "xxh32 MB/s");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		// high compression on the first MB only
+		size_t hcSize = std::min<size_t>(data.size(), 1024 * 1024);
+		double baseline[4] = { 0, 0, 0, 0 };
+
+		for (const LZ4Kernels* k : kernels) {
+			double fast = Throughput(data.size(), [&]() {
+				for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+					int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+					k->compress_fast(&data[offset], output.data(), size, (int)output.size(), 1);
+				}
+			});
+			double hc = Throughput(hcSize, [&]() {
+				for (size_t offset = 0; offset < hcSize; offset += BlockSize) {
+					int size = (int)std::min<size_t>(BlockSize, hcSize - offset);
+					k->compress_HC(&data[offset], output.data(), size, (int)output.size(), 9);
+				}
+			});
+
+			Blocks blocks = Compress(k, data);
+			for (size_t i = 0; i < blocks.sizes.size(); i++) {
+				int result = k->decompress_safe(blocks.compressed[i].data(), output.data(), (int)blocks.compressed[i].size(), BlockSize);
+				if (result != blocks.sizes[i] || memcmp(output.data(), &data[i * BlockSize], (size_t)result) != 0) { fprintf(stderr, "%s: %s roundtrip failed\n", corpus.name.c_str(), k->name); return 1; }
+			}
+			double decode = Throughput(data.size(), [&]() {
+				for (size_t i = 0; i < blocks.sizes.size(); i++) {
+					k->decompress_safe(blocks.compressed[i].data(), output.data(), (int)blocks.compressed[i].size(), BlockSize);
+				}
+			});
+			volatile unsigned int hash = 0;
+			double xxh = Throughput(data.size(), [&]() { hash = hash + k->xxh32(data.data(), data.size(), 0); });
+
+			double results[4] = { fast, hc, decode, xxh };
+			if (k == kernels[0]) { memcpy(baseline, results, sizeof(results)); }
+			printf("%-12s %-10s", corpus.name.c_str(), k->name);
+			for (int i = 0; i < 4; i++) { printf(" %7.0f %4.2fx", results[i], results[i] / baseline[i]); }
+			printf("\n");
+		}
+	}
+	return 0;
+}
+
+static std::vector<Corpus> RepetitiveCorpora() {
+	std::vector<Corpus> corpora;
+	corpora.push_back(Corpus{ "repetitive", RepetitiveCorpus(4 * 1024 * 1024) });
+	// one long run, the longest matches
+	corpora.push_back(Corpus{ "run", std::vector<char>(4 * 1024 * 1024, 'a') });
+	return corpora;
+}
+
+static int RunRepetitive(const std::vector<Corpus>& corpora) {
+	std::vector<const LZ4Kernels*> kernels = SupportedKernels();
+	std::vector<char> output((size_t)LZ4_compressBound(BlockSize));
+	const int levels[] = { 0, 9, 10, 11, 12 };
+
+	printf("%-12s %-10s %-5s %8s %10s %8s\n", "corpus", "kernels", "level", "ratio", "MB/s", "speedup");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		for (int level : levels) {
+			// the optimal parser on the first MB only
+			size_t size = level < LZ4HC_CLEVEL_OPT_MIN ? data.size() : std::min<size_t>(data.size(), 1024 * 1024);
+			double baseline = 0;
+			for (const LZ4Kernels* k : kernels) {
+				size_t compressedSize = 0;
+				auto compress = [&]() {
+					compressedSize = 0;
+					for (size_t offset = 0; offset < size; offset += BlockSize) {
+						int blockSize = (int)std::min<size_t>(BlockSize, size - offset);
+						int result = level == 0 ? k->compress_fast(&data[offset], output.data(), blockSize, (int)output.size(), 1) : k->compress_HC(&data[offset], output.data(), blockSize, (int)output.size(), level);
+						compressedSize += (size_t)result;
+					}
+				};
+				double throughput = Throughput(size, compress);
+				if (k == kernels[0]) { baseline = throughput; }
+				printf("%-12s %-10s %-5d %8.2f %10.0f %7.2fx\n", corpus.name.c_str(), k->name, level, (double)size / compressedSize, throughput, throughput / baseline);
+			}
+		}
+	}
+	return 0;
+}
+
+static std::vector<Corpus> BatchCorpora() {
+	return GeneratedCorpora(4 * 1024 * 1024);
+}
+
+static int RunBatch(const std::vector<Corpus>& corpora) {
+	std::vector<const LZ4Kernels*> kernels = SupportedKernels();
+	const int valueSizes[] = { 128, 512, 2048, 8192, 65536 };
+	// the values of a lookup, they are decoded together
+	const int lookupSize = 16;
+	const size_t arenaSize = 64 * 1024 * 1024;
+
+	printf("%-12s %-10s %6s %12s %12s %8s\n", "corpus", "kernels", "value", "single MB/s", "batch MB/s", "speedup");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		for (int valueSize : valueSizes) {
+			// the values repeat the corpus, each of them is compressed on its own
+			int corpusValues = (int)(data.size() / (size_t)valueSize);
+			int count = (int)(arenaSize / (size_t)valueSize);
+			std::vector<std::vector<char>> compressed((size_t)corpusValues);
+			for (int i = 0; i < corpusValues; i++) {
+				compressed[(size_t)i].resize((size_t)LZ4_compressBound(valueSize));
+				compressed[(size_t)i].resize((size_t)LZ4Kernels_baseline.compress_fast(&data[(size_t)i * (size_t)valueSize], compressed[(size_t)i].data(), valueSize, (int)compressed[(size_t)i].size(), 1));
+			}
+			std::vector<char> arena;
+			std::vector<size_t> offsets;
+			for (int i = 0; i < count; i++) {
+				offsets.push_back(arena.size());
+				arena.insert(arena.end(), compressed[(size_t)(i % corpusValues)].begin(), compressed[(size_t)(i % corpusValues)].end());
+			}
+
+			// random order, every value once
+			std::vector<int> order((size_t)count);
+			for (int i = 0; i < count; i++) { order[(size_t)i] = i; }
+			Random random(22);
+			for (int i = count - 1; i > 0; i--) { std::swap(order[(size_t)i], order[random.Next((unsigned int)i + 1)]); }
+
+			std::vector<const char*> sources;
+			std::vector<int> compressedSizes, capacities((size_t)count, valueSize), results((size_t)count);
+			std::vector<char> output(arenaSize);
+			std::vector<char*> dests;
+			for (int i : order) {
+				sources.push_back(&arena[offsets[(size_t)i]]);
+				compressedSizes.push_back((int)compressed[(size_t)(i % corpusValues)].size());
+				dests.push_back(&output[(size_t)i * (size_t)valueSize]);
+			}
+
+			for (const LZ4Kernels* k : kernels) {
+				std::fill(output.begin(), output.end(), 0);
+				int failed = 0;
+				for (int i = 0; i < count; i += lookupSize) { failed += k->decompress_safe_batch(&sources[(size_t)i], &dests[(size_t)i], &compressedSizes[(size_t)i], &capacities[(size_t)i], &results[(size_t)i], lookupSize); }
+				for (int i = 0; failed == 0 && i < count; i++) {
+					if (memcmp(&output[(size_t)i * (size_t)valueSize], &data[(size_t)(i % corpusValues) * (size_t)valueSize], (size_t)valueSize) != 0) { failed++; }
+				}
+				if (failed != 0) { fprintf(stderr, "%s: %s batch roundtrip failed\n", corpus.name.c_str(), k->name); return 1; }
+
+				double single = Throughput(output.size(), [&]() {
+					for (int i = 0; i < count; i++) { k->decompress_safe(sources[(size_t)i], dests[(size_t)i], compressedSizes[(size_t)i], valueSize); }
+				});
+				double batch = Throughput(output.size(), [&]() {
+					for (int i = 0; i < count; i += lookupSize) { k->decompress_safe_batch(&sources[(size_t)i], &dests[(size_t)i], &compressedSizes[(size_t)i], &capacities[(size_t)i], &results[(size_t)i], lookupSize); }
+				});
+				printf("%-12s %-10s %6d %12.0f %12.0f %7.2fx\n", corpus.name.c_str(), k->name, valueSize, single, batch, batch / single);
+			}
+		}
+	}
+	return 0;
+}
+
+struct Workload {
+	const char* name;
+	int blockSizeId;
+	int messageSize; // a frame per message, 0: a single frame
+	int compressionLevel;
+};
+
+static std::vector<Corpus> TableSizeCorpora() {
+	return GeneratedCorpora(8 * 1024 * 1024);
+}
+
+static int RunTableSize(const std::vector<Corpus>& corpora) {
+	const Workload workloads[] = {
+		{ "fast 1 KB msg", 4, 1024, 0 },
+		{ "fast 64 KB", 4, 0, 0 },
+		{ "fast 4 MB", 7, 0, 0 },
+		{ "hc9 1 KB msg", 4, 1024, 9 },
+		{ "hc9 64 KB", 4, 0, 9 },
+		{ "hc9 4 MB", 7, 0, 9 },
+	};
+
+	printf("%-12s %-14s %6s %8s %11s\n", "corpus", "workload", "table", "ratio", "encode MB/s");
+	for (const Corpus& corpus : corpora) {
+		for (const Workload& w : workloads) {
+			// high compression on the first 2 MB only
+			size_t size = w.compressionLevel == 0 ? corpus.data.size() : std::min<size_t>(corpus.data.size(), 2 * 1024 * 1024);
+			if (w.messageSize != 0) { size -= size % (size_t)w.messageSize; }
+			const char* data = corpus.data.data();
+			std::vector<int> memoryUsages = w.compressionLevel == 0 ? std::vector<int>{ 12, 14, 16, 18 } : std::vector<int>{ 12, 14, 16, 17, 18 };
+
+			for (int memoryUsage : memoryUsages) {
+				LZ4FrameInfo info;
+				memset(&info, 0, sizeof(info));
+				info.blockSizeId = w.blockSizeId;
+				info.independentBlocks = w.messageSize != 0;
+				LZ4FrameCompressionOptions options;
+				memset(&options, 0, sizeof(options));
+				options.compressionLevel = w.compressionLevel;
+				options.acceleration = 1;
+				options.memoryUsage = memoryUsage;
+
+				LZ4FrameEncoder encoder;
+				int status = encoder.Init(&info, &options);
+				if (status != LZ4Frame_OK) { fprintf(stderr, "memory usage %d: %s\n", memoryUsage, LZ4Frame_getErrorName(status)); return 1; }
+				int chunkSize = w.messageSize != 0 ? w.messageSize : (int)size;
+				int bound = (int)LZ4Frame_compressBound(&info, chunkSize, 0);
+				std::vector<char> frame((size_t)bound);
+				size_t compressedSize = 0;
+				auto compress = [&]() {
+					compressedSize = 0;
+					for (size_t offset = 0; offset < size; offset += (size_t)chunkSize) {
+						compressedSize += (size_t)encoder.CompressFrames(&data[offset], chunkSize, 0, frame.data(), bound);
+					}
+				};
+				double throughput = Throughput(size, compress);
+
+				// the last frame (or the only one) is round tripped
+				std::vector<char> output((size_t)chunkSize);
+				int frameSize = encoder.CompressFrames(&data[size - (size_t)chunkSize], chunkSize, 0, frame.data(), bound);
+				int result = LZ4Frame_decompress(frame.data(), frameSize, output.data(), chunkSize);
+				if (result != chunkSize || memcmp(output.data(), &data[size - (size_t)chunkSize], (size_t)chunkSize) != 0) { fprintf(stderr, "%s: %s, memory usage %d: roundtrip failed\n", corpus.name.c_str(), w.name, memoryUsage); return 1; }
+
+				char table[16];
+				snprintf(table, sizeof(table), "%d KB", (1 << memoryUsage) / 1024);
+				printf("%-12s %-14s %6s %8.3f %11.0f\n", corpus.name.c_str(), w.name, table, (double)size / compressedSize, throughput);
+			}
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	const BenchCase cases[] = {
+		{ "kernels", KernelsCorpora, RunKernels },
+		{ "repetitive", RepetitiveCorpora, RunRepetitive },
+		{ "batch", BatchCorpora, RunBatch },
+		{ "tablesize", TableSizeCorpora, RunTableSize },
+	};
+	int status = RunBenchCases(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+	printf("selected kernels: %s\n", LZ4_kernels());
+	return status;
+}
@@ -0,0 +1,182 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// scaling of frames over worker threads against the sequential encoder, the native equivalent of LZ4ParallelBlockCompressor
+// every worker has its own encoder, the content checksum is updated in order
+// independent blocks: the frame is byte-identical to the sequential encoder
+// linked blocks: every block is primed with the 64 KB before it, the frame is decoded and the ratio compared with the sequential linked frame
+// usage: lz4ParallelBench [files], the generated corpora when no files are passed
+
+using namespace lz4::native;
+using namespace lz4test;
+
+static void InitOptions(int blockSizeId, bool independentBlocks, int compressionLevel, LZ4FrameInfo& info, LZ4FrameCompressionOptions& options) {
+	memset(&info, 0, sizeof(info));
+	info.blockSizeId = blockSizeId;
+	info.independentBlocks = independentBlocks;
+	info.contentChecksum = true;
+
+	memset(&options, 0, sizeof(options));
+	options.compressionLevel = compressionLevel;
+	options.acceleration = 1;
+}
+
+static std::vector<char> CompressSequential(const std::vector<char>& data, const LZ4FrameInfo& info, const LZ4FrameCompressionOptions& options) {
+	LZ4FrameEncoder encoder;
+	encoder.Init(&info, &options);
+	std::vector<char> frame((size_t)LZ4Frame_compressBound(&info, (long long)data.size(), 0));
+	int size = encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size());
+	frame.resize(size < 0 ? 0 : (size_t)size);
+	return frame;
+}
+
+class ParallelCompressor {
+public:
+	ParallelCompressor(const LZ4FrameInfo& info, const LZ4FrameCompressionOptions& options, int threads) : _info(info), _threads(threads) {
+		_encoder.Init(&info, &options);
+
+		// the content checksum is calculated by the frame encoder, the block encoders only compress and load their own history
+		LZ4FrameInfo blockInfo = info;
+		blockInfo.independentBlocks = true;
+		blockInfo.contentChecksum = false;
+		for (int i = 0; i < threads; i++) {
+			_blockEncoders.emplace_back(new LZ4FrameEncoder());
+			_blockEncoders.back()->Init(&blockInfo, &options);
+		}
+	}
+
+	std::vector<char> Compress(const std::vector<char>& data) {
+		int blockSize = _encoder.BlockSize();
+		size_t blocks = (data.size() + (size_t)blockSize - 1) / (size_t)blockSize;
+		_blocks.resize(blocks);
+		_nextBlock = 0;
+
+		std::vector<std::thread> workers;
+		for (int i = 0; i < _threads; i++) { workers.emplace_back(&ParallelCompressor::Work, this, i, std::cref(data)); }
+		for (std::thread& worker : workers) { worker.join(); }
+
+		std::vector<char> frame(LZ4FRAME_HEADER_SIZE_MAX);
+		frame.resize((size_t)_encoder.BeginFrame(frame.data(), (int)frame.size()));
+		for (size_t i = 0; i < blocks; i++) {
+			size_t offset = i * (size_t)blockSize;
+			_encoder.UpdateContentChecksum(&data[offset], (int)std::min<size_t>((size_t)blockSize, data.size() - offset));
+			frame.insert(frame.end(), _blocks[i].begin(), _blocks[i].end());
+		}
+		size_t size = frame.size();
+		frame.resize(size + LZ4FRAME_END_SIZE_MAX);
+		frame.resize(size + (size_t)_encoder.EndFrame(&frame[size], LZ4FRAME_END_SIZE_MAX));
+		return frame;
+	}
+
+private:
+	void Work(int worker, const std::vector<char>& data) {
+		LZ4FrameEncoder& encoder = *_blockEncoders[(size_t)worker];
+		int blockSize = encoder.BlockSize();
+		for (size_t i = _nextBlock++; i < _blocks.size(); i = _nextBlock++) {
+			size_t offset = i * (size_t)blockSize;
+			int size = (int)std::min<size_t>((size_t)blockSize, data.size() - offset);
+			if (!_info.independentBlocks) {
+				size_t historySize = std::min<size_t>(offset, LZ4FRAME_DICTIONARY_SIZE_MAX);
+				encoder.SetDictionary(historySize > 0 ? &data[offset - historySize] : NULL, (int)historySize);
+			}
+			std::vector<char>& block = _blocks[i];
+			block.resize((size_t)LZ4FRAME_BLOCK_BOUND(blockSize));
+			block.resize((size_t)encoder.CompressBlock(&data[offset], size, block.data(), (int)block.size()));
+		}
+	}
+
+	LZ4FrameInfo _info;
+	int _threads;
+	LZ4FrameEncoder _encoder;
+	std::vector<std::unique_ptr<LZ4FrameEncoder>> _blockEncoders;
+	std::vector<std::vector<char>> _blocks;
+	std::atomic<size_t> _nextBlock;
+};
+
+int main(int argc, char** argv) {
+	std::vector<Corpus> corpora = Corpora(argc, argv, 32 * 1024 * 1024);
+	// at least 4 threads, so the order of the blocks is verified on small machines too
+	int cores = (int)std::thread::hardware_concurrency();
+	int maxThreads = std::max(4, cores);
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2) { threadCounts.push_back(threads); }
+	threadCounts.push_back(maxThreads);
+	printf("%d cores\n", cores);
+
+	// 4 MB blocks as in the log archives, 64 KB blocks as in the default LZ4Stream frames
+	const int blockSizeIds[] = { 7, 4 };
+	const int levels[] = { 0, 9 };
+	printf("%-12s %-6s %-5s %-12s %7s %8s %9s %8s\n", "corpus", "block", "level", "blocks", "threads", "ratio", "MB/s", "scaling");
+	for (const Corpus& corpus : corpora) {
+		const std::vector<char>& data = corpus.data;
+		for (int blockSizeId : blockSizeIds) {
+			for (int level : levels) {
+				for (int independent = 1; independent >= 0; independent--) {
+					LZ4FrameInfo info;
+					LZ4FrameCompressionOptions options;
+					InitOptions(blockSizeId, independent != 0, level, info, options);
+					// high compression on the first 8 MB only
+					std::vector<char> input(data.begin(), data.begin() + (ptrdiff_t)(level == 0 ? data.size() : std::min<size_t>(data.size(), 8 * 1024 * 1024)));
+					std::vector<char> expected = CompressSequential(input, info, options);
+					std::vector<char> output(input.size());
+
+					// the sequential encoder is the reference of the ratio and the scaling
+					LZ4FrameEncoder encoder;
+					encoder.Init(&info, &options);
+					std::vector<char> sequentialFrame((size_t)LZ4Frame_compressBound(&info, (long long)input.size(), 0));
+					double sequential = Throughput(input.size(), [&]() { encoder.CompressFrames(input.data(), (int)input.size(), 0, sequentialFrame.data(), (int)sequentialFrame.size()); });
+					const char* blocks = independent ? "independent" : "linked";
+					const char* block = blockSizeId == 7 ? "4 MB" : "64 KB";
+					printf("%-12s %-6s %-5d %-12s %7s %8.3f %9.0f %7.2fx\n", corpus.name.c_str(), block, level, blocks, "seq", (double)input.size() / expected.size(), sequential, 1.0);
+
+					for (int threads : threadCounts) {
+						ParallelCompressor compressor(info, options, threads);
+						std::vector<char> frame = compressor.Compress(input);
+						if (independent && frame != expected) { fprintf(stderr, "%s: %d threads, the frame differs from the sequential frame\n", corpus.name.c_str(), threads); return 1; }
+						int result = LZ4Frame_decompress(frame.data(), (int)frame.size(), output.data(), (int)output.size());
+						if (result != (int)input.size() || output != input) { fprintf(stderr, "%s: %d threads, roundtrip failed %d\n", corpus.name.c_str(), threads, result); return 1; }
+
+						double throughput = Throughput(input.size(), [&]() { compressor.Compress(input); });
+						printf("%-12s %-6s %-5d %-12s %7d %8.3f %9.0f %7.2fx\n", corpus.name.c_str(), block, level, blocks, threads, (double)input.size() / frame.size(), throughput, throughput / sequential);
+					}
+				}
+			}
+		}
+	}
+	return 0;
+}
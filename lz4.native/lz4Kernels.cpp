@@ -0,0 +1,217 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Kernels.h"
+
+#include <stdlib.h>
+#include <string.h>
+#if LZ4_KERNELS_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+enum LZ4KernelsLevel {
+	LZ4KernelsLevel_baseline,
+	LZ4KernelsLevel_sse42,
+	LZ4KernelsLevel_avx2,
+	LZ4KernelsLevel_avx512
+};
+
+static const char* const LZ4KernelsNames[] = { "baseline", "sse42", "avx2", "avx512" };
+
+#if LZ4_KERNELS_X86
+// info: eax, ebx, ecx, edx
+static void LZ4Kernels_cpuid(unsigned int leaf, unsigned int subleaf, unsigned int info[4]) {
+#if defined(_MSC_VER)
+	int registers[4];
+	__cpuidex(registers, (int)leaf, (int)subleaf);
+	for (int i = 0; i < 4; i++) { info[i] = (unsigned int)registers[i]; }
+#else
+	__cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+// the register state that the os saves (xcr0)
+static unsigned long long LZ4Kernels_xgetbv() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+static int LZ4Kernels_cpuLevel() {
+#if LZ4_KERNELS_X86
+	unsigned int info[4];
+	LZ4Kernels_cpuid(0, 0, info);
+	unsigned int maxLeaf = info[0];
+	if (maxLeaf < 1) { return LZ4KernelsLevel_baseline; }
+
+	LZ4Kernels_cpuid(1, 0, info);
+	if ((info[2] & (1u << 20)) == 0) { return LZ4KernelsLevel_baseline; }
+
+	// avx: the cpu supports it and the os saves the ymm registers
+	bool osxsave = (info[2] & (1u << 27)) != 0, avx = (info[2] & (1u << 28)) != 0;
+	if (!osxsave || !avx || maxLeaf < 7) { return LZ4KernelsLevel_sse42; }
+	unsigned long long xcr0 = LZ4Kernels_xgetbv();
+	if ((xcr0 & 0x6) != 0x6) { return LZ4KernelsLevel_sse42; }
+
+	// avx2 variant: avx2, bmi1, bmi2
+	LZ4Kernels_cpuid(7, 0, info);
+	if ((info[1] & ((1u << 5) | (1u << 3) | (1u << 8))) != ((1u << 5) | (1u << 3) | (1u << 8))) { return LZ4KernelsLevel_sse42; }
+
+	// avx512 variant: avx512f, avx512bw, avx512vl and the opmask and zmm registers
+	unsigned int avx512 = (1u << 16) | (1u << 30) | (1u << 31);
+	if ((info[1] & avx512) != avx512 || (xcr0 & 0xE6) != 0xE6) { return LZ4KernelsLevel_avx2; }
+	return LZ4KernelsLevel_avx512;
+#else
+	return LZ4KernelsLevel_baseline;
+#endif
+}
+
+// LZ4_KERNELS: baseline, sse42, avx2 or avx512, -1 when not set
+static int LZ4Kernels_environmentLevel() {
+#if defined(_MSC_VER)
+	char value[16];
+	size_t length = 0;
+	if (getenv_s(&length, value, sizeof(value), "LZ4_KERNELS") != 0 || length == 0) { return -1; }
+#else
+	const char* value = getenv("LZ4_KERNELS");
+	if (value == NULL) { return -1; }
+#endif
+	for (int i = 0; i < (int)(sizeof(LZ4KernelsNames) / sizeof(LZ4KernelsNames[0])); i++) {
+		if (strcmp(value, LZ4KernelsNames[i]) == 0) { return i; }
+	}
+	return -1;
+}
+
+static const LZ4Kernels* LZ4Kernels_select() {
+	int level = LZ4Kernels_cpuLevel();
+	int environmentLevel = LZ4Kernels_environmentLevel();
+	if (environmentLevel >= 0 && environmentLevel < level) { level = environmentLevel; }
+
+	switch (level) {
+#if LZ4_KERNELS_X86
+		case LZ4KernelsLevel_avx512: return &LZ4Kernels_avx512;
+		case LZ4KernelsLevel_avx2: return &LZ4Kernels_avx2;
+		case LZ4KernelsLevel_sse42: return &LZ4Kernels_sse42;
+#endif
+		default: return &LZ4Kernels_baseline;
+	}
+}
+
+static const LZ4Kernels* LZ4Kernels_selected;
+
+// selected when the library is loaded, before the static initializers of the program that links it
+struct LZ4KernelsInit {
+	LZ4KernelsInit() { LZ4Kernels_selected = LZ4Kernels_select(); }
+};
+#if defined(_MSC_VER)
+#pragma warning(suppress: 4073)
+#pragma init_seg(lib)
+static LZ4KernelsInit LZ4Kernels_init;
+#else
+static LZ4KernelsInit LZ4Kernels_init __attribute__((init_priority(101)));
+#endif
+
+static const LZ4Kernels* LZ4Kernels_get() {
+	return LZ4Kernels_selected;
+}
+
+const char* LZ4_kernels(void) {
+	return LZ4Kernels_get()->name;
+}
+
+int LZ4_compress_default(const char* src, char* dst, int srcSize, int dstCapacity) {
+	return LZ4Kernels_get()->compress_default(src, dst, srcSize, dstCapacity);
+}
+
+int LZ4_compress_fast(const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration) {
+	return LZ4Kernels_get()->compress_fast(source, dest, inputSize, maxOutputSize, acceleration);
+}
+
+int LZ4_compress_fast_extState_fastReset(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration) {
+	return LZ4Kernels_get()->compress_fast_extState_fastReset(state, src, dst, srcSize, dstCapacity, acceleration);
+}
+
+int LZ4_compress_fast_continue(LZ4_stream_t* LZ4_stream, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration) {
+	return LZ4Kernels_get()->compress_fast_continue(LZ4_stream, source, dest, inputSize, maxOutputSize, acceleration);
+}
+
+int LZ4_compress_destSize(const char* src, char* dst, int* srcSizePtr, int targetDstSize) {
+	return LZ4Kernels_get()->compress_destSize(src, dst, srcSizePtr, targetDstSize);
+}
+
+int LZ4_compress_HC(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel) {
+	return LZ4Kernels_get()->compress_HC(src, dst, srcSize, dstCapacity, compressionLevel);
+}
+
+int LZ4_compress_HC_extStateHC_fastReset(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel) {
+	return LZ4Kernels_get()->compress_HC_extStateHC_fastReset(state, src, dst, srcSize, dstCapacity, compressionLevel);
+}
+
+int LZ4_compress_HC_continue(LZ4_streamHC_t* LZ4_streamHCPtr, const char* src, char* dst, int srcSize, int dstCapacity) {
+	return LZ4Kernels_get()->compress_HC_continue(LZ4_streamHCPtr, src, dst, srcSize, dstCapacity);
+}
+
+int LZ4_decompress_safe(const char* source, char* dest, int compressedSize, int maxDecompressedSize) {
+	return LZ4Kernels_get()->decompress_safe(source, dest, compressedSize, maxDecompressedSize);
+}
+
+int LZ4_decompress_safe_partial(const char* src, char* dst, int srcSize, int targetOutputSize, int dstCapacity) {
+	return LZ4Kernels_get()->decompress_safe_partial(src, dst, srcSize, targetOutputSize, dstCapacity);
+}
+
+int LZ4_decompress_safe_continue(LZ4_streamDecode_t* LZ4_streamDecode, const char* source, char* dest, int compressedSize, int maxOutputSize) {
+	return LZ4Kernels_get()->decompress_safe_continue(LZ4_streamDecode, source, dest, compressedSize, maxOutputSize);
+}
+
+int LZ4_decompress_safe_usingDict(const char* source, char* dest, int compressedSize, int maxOutputSize, const char* dictStart, int dictSize) {
+	return LZ4Kernels_get()->decompress_safe_usingDict(source, dest, compressedSize, maxOutputSize, dictStart, dictSize);
+}
+
+int LZ4_decompress_safe_batch(const char* const* sources, char* const* dests, const int* compressedSizes, const int* dstCapacities, int* results, int count) {
+	return LZ4Kernels_get()->decompress_safe_batch(sources, dests, compressedSizes, dstCapacities, results, count);
+}
+
+XXH_PUBLIC_API unsigned int XXH32(const void* input, size_t length, unsigned int seed) {
+	return LZ4Kernels_get()->xxh32(input, length, seed);
+}
+
+XXH_PUBLIC_API XXH_errorcode XXH32_update(XXH32_state_t* statePtr, const void* input, size_t length) {
+	return LZ4Kernels_get()->xxh32_update(statePtr, input, length);
+}
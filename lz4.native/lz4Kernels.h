@@ -0,0 +1,87 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+// the table has functions of the static api (LZ4LIB_STATIC_API)
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#include "lz4.h"
+#include "lz4hc.h"
+#include "xxhash.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define LZ4_KERNELS_X86 1
+#else
+#  define LZ4_KERNELS_X86 0
+#endif
+
+// the hot functions of lz4, lz4hc and xxhash, compiled once for every instruction set
+// lz4Kernels.cpp exports them under the api names and calls the table that is selected when the library is loaded
+typedef struct LZ4Kernels
+{
+	const char* name;
+	int (*compress_default)(const char* src, char* dst, int srcSize, int dstCapacity);
+	int (*compress_fast)(const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration);
+	int (*compress_fast_extState_fastReset)(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration);
+	int (*compress_fast_continue)(LZ4_stream_t* LZ4_stream, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration);
+	int (*compress_destSize)(const char* src, char* dst, int* srcSizePtr, int targetDstSize);
+	int (*compress_HC)(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel);
+	int (*compress_HC_extStateHC_fastReset)(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel);
+	int (*compress_HC_continue)(LZ4_streamHC_t* LZ4_streamHCPtr, const char* src, char* dst, int srcSize, int dstCapacity);
+	int (*decompress_safe)(const char* source, char* dest, int compressedSize, int maxDecompressedSize);
+	int (*decompress_safe_partial)(const char* src, char* dst, int srcSize, int targetOutputSize, int dstCapacity);
+	int (*decompress_safe_continue)(LZ4_streamDecode_t* LZ4_streamDecode, const char* source, char* dest, int compressedSize, int maxOutputSize);
+	int (*decompress_safe_usingDict)(const char* source, char* dest, int compressedSize, int maxOutputSize, const char* dictStart, int dictSize);
+	int (*decompress_safe_batch)(const char* const* sources, char* const* dests, const int* compressedSizes, const int* dstCapacities, int* results, int count);
+	unsigned int (*xxh32)(const void* input, size_t length, unsigned int seed);
+	XXH_errorcode (*xxh32_update)(XXH32_state_t* statePtr, const void* input, size_t length);
+} LZ4Kernels;
+
+// lz4KernelsBaseline.cpp, lz4KernelsSSE42.cpp, lz4KernelsAVX2.cpp and lz4KernelsAVX512.cpp
+extern const LZ4Kernels LZ4Kernels_baseline;
+#if LZ4_KERNELS_X86
+extern const LZ4Kernels LZ4Kernels_sse42;
+extern const LZ4Kernels LZ4Kernels_avx2;
+extern const LZ4Kernels LZ4Kernels_avx512;
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// the instruction set of the selected kernels: "baseline", "sse42", "avx2" or "avx512"
+// the environment variable LZ4_KERNELS selects a lower instruction set than the cpu supports (testing)
+LZ4LIB_API const char* LZ4_kernels(void);
+
+#if defined (__cplusplus)
+}
+#endif
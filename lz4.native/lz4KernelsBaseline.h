@@ -0,0 +1,50 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+// forced include of lz4.cpp, lz4hc.cpp and xxhash.cpp (lz4.native): the kernels of the baseline instruction set are compiled under these names
+// lz4Kernels.cpp defines the api names, they call the kernels of the selected instruction set
+#define LZ4_compress_default LZ4_baseline_compress_default
+#define LZ4_compress_fast LZ4_baseline_compress_fast
+#define LZ4_compress_fast_extState_fastReset LZ4_baseline_compress_fast_extState_fastReset
+#define LZ4_compress_fast_continue LZ4_baseline_compress_fast_continue
+#define LZ4_compress_destSize LZ4_baseline_compress_destSize
+#define LZ4_compress_HC LZ4_baseline_compress_HC
+#define LZ4_compress_HC_extStateHC_fastReset LZ4_baseline_compress_HC_extStateHC_fastReset
+#define LZ4_compress_HC_continue LZ4_baseline_compress_HC_continue
+#define LZ4_decompress_safe LZ4_baseline_decompress_safe
+#define LZ4_decompress_safe_partial LZ4_baseline_decompress_safe_partial
+#define LZ4_decompress_safe_continue LZ4_baseline_decompress_safe_continue
+#define LZ4_decompress_safe_usingDict LZ4_baseline_decompress_safe_usingDict
+#define LZ4_decompress_safe_batch LZ4_baseline_decompress_safe_batch
+#define XXH32 XXH32_baseline
+#define XXH32_update XXH32_baseline_update
@@ -0,0 +1,168 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+// compiles lz4, lz4hc and xxhash for the instruction set of the including file (x86), the functions are prefixed with LZ4_KERNELS_PREFIX
+// the table LZ4_KERNELS_TABLE (LZ4_KERNELS_NAME) points to its kernels, the other functions are not used
+#define LZ4_KERNELS_CONCAT2(prefix, name) prefix ## name
+#define LZ4_KERNELS_CONCAT(prefix, name) LZ4_KERNELS_CONCAT2(prefix, name)
+#define LZ4_KERNELS_RENAME(name) LZ4_KERNELS_CONCAT(LZ4_KERNELS_PREFIX, name)
+
+// lz4.cpp
+#define LZ4_attach_dictionary LZ4_KERNELS_RENAME(LZ4_attach_dictionary)
+#define LZ4_compress LZ4_KERNELS_RENAME(LZ4_compress)
+#define LZ4_compressBound LZ4_KERNELS_RENAME(LZ4_compressBound)
+#define LZ4_compress_continue LZ4_KERNELS_RENAME(LZ4_compress_continue)
+#define LZ4_compress_default LZ4_KERNELS_RENAME(LZ4_compress_default)
+#define LZ4_compress_destSize LZ4_KERNELS_RENAME(LZ4_compress_destSize)
+#define LZ4_compress_fast LZ4_KERNELS_RENAME(LZ4_compress_fast)
+#define LZ4_compress_fast_continue LZ4_KERNELS_RENAME(LZ4_compress_fast_continue)
+#define LZ4_compress_fast_extState LZ4_KERNELS_RENAME(LZ4_compress_fast_extState)
+#define LZ4_compress_fast_extState_fastReset LZ4_KERNELS_RENAME(LZ4_compress_fast_extState_fastReset)
+#define LZ4_compress_forceExtDict LZ4_KERNELS_RENAME(LZ4_compress_forceExtDict)
+#define LZ4_compress_limitedOutput LZ4_KERNELS_RENAME(LZ4_compress_limitedOutput)
+#define LZ4_compress_limitedOutput_continue LZ4_KERNELS_RENAME(LZ4_compress_limitedOutput_continue)
+#define LZ4_compress_limitedOutput_withState LZ4_KERNELS_RENAME(LZ4_compress_limitedOutput_withState)
+#define LZ4_compress_withState LZ4_KERNELS_RENAME(LZ4_compress_withState)
+#define LZ4_create LZ4_KERNELS_RENAME(LZ4_create)
+#define LZ4_createStream LZ4_KERNELS_RENAME(LZ4_createStream)
+#define LZ4_createStreamEx LZ4_KERNELS_RENAME(LZ4_createStreamEx)
+#define LZ4_createStreamDecode LZ4_KERNELS_RENAME(LZ4_createStreamDecode)
+#define LZ4_decoderRingBufferSize LZ4_KERNELS_RENAME(LZ4_decoderRingBufferSize)
+#define LZ4_decompress_fast LZ4_KERNELS_RENAME(LZ4_decompress_fast)
+#define LZ4_decompress_fast_continue LZ4_KERNELS_RENAME(LZ4_decompress_fast_continue)
+#define LZ4_decompress_fast_usingDict LZ4_KERNELS_RENAME(LZ4_decompress_fast_usingDict)
+#define LZ4_decompress_fast_withPrefix64k LZ4_KERNELS_RENAME(LZ4_decompress_fast_withPrefix64k)
+#define LZ4_decompress_safe LZ4_KERNELS_RENAME(LZ4_decompress_safe)
+#define LZ4_decompress_safe_batch LZ4_KERNELS_RENAME(LZ4_decompress_safe_batch)
+#define LZ4_decompress_safe_continue LZ4_KERNELS_RENAME(LZ4_decompress_safe_continue)
+#define LZ4_decompress_safe_forceExtDict LZ4_KERNELS_RENAME(LZ4_decompress_safe_forceExtDict)
+#define LZ4_decompress_safe_partial LZ4_KERNELS_RENAME(LZ4_decompress_safe_partial)
+#define LZ4_decompress_safe_usingDict LZ4_KERNELS_RENAME(LZ4_decompress_safe_usingDict)
+#define LZ4_decompress_safe_withPrefix64k LZ4_KERNELS_RENAME(LZ4_decompress_safe_withPrefix64k)
+#define LZ4_freeStream LZ4_KERNELS_RENAME(LZ4_freeStream)
+#define LZ4_freeStreamDecode LZ4_KERNELS_RENAME(LZ4_freeStreamDecode)
+#define LZ4_initStream LZ4_KERNELS_RENAME(LZ4_initStream)
+#define LZ4_initStreamEx LZ4_KERNELS_RENAME(LZ4_initStreamEx)
+#define LZ4_loadDict LZ4_KERNELS_RENAME(LZ4_loadDict)
+#define LZ4_resetStream LZ4_KERNELS_RENAME(LZ4_resetStream)
+#define LZ4_resetStreamState LZ4_KERNELS_RENAME(LZ4_resetStreamState)
+#define LZ4_resetStream_fast LZ4_KERNELS_RENAME(LZ4_resetStream_fast)
+#define LZ4_saveDict LZ4_KERNELS_RENAME(LZ4_saveDict)
+#define LZ4_setStreamDecode LZ4_KERNELS_RENAME(LZ4_setStreamDecode)
+#define LZ4_sizeofState LZ4_KERNELS_RENAME(LZ4_sizeofState)
+#define LZ4_sizeofStateEx LZ4_KERNELS_RENAME(LZ4_sizeofStateEx)
+#define LZ4_sizeofStreamState LZ4_KERNELS_RENAME(LZ4_sizeofStreamState)
+#define LZ4_slideInputBuffer LZ4_KERNELS_RENAME(LZ4_slideInputBuffer)
+#define LZ4_uncompress LZ4_KERNELS_RENAME(LZ4_uncompress)
+#define LZ4_uncompress_unknownOutputSize LZ4_KERNELS_RENAME(LZ4_uncompress_unknownOutputSize)
+#define LZ4_versionNumber LZ4_KERNELS_RENAME(LZ4_versionNumber)
+#define LZ4_versionString LZ4_KERNELS_RENAME(LZ4_versionString)
+
+// lz4hc.cpp
+#define LZ4_attach_HC_dictionary LZ4_KERNELS_RENAME(LZ4_attach_HC_dictionary)
+#define LZ4_compressHC LZ4_KERNELS_RENAME(LZ4_compressHC)
+#define LZ4_compressHC2 LZ4_KERNELS_RENAME(LZ4_compressHC2)
+#define LZ4_compressHC2_continue LZ4_KERNELS_RENAME(LZ4_compressHC2_continue)
+#define LZ4_compressHC2_limitedOutput LZ4_KERNELS_RENAME(LZ4_compressHC2_limitedOutput)
+#define LZ4_compressHC2_limitedOutput_continue LZ4_KERNELS_RENAME(LZ4_compressHC2_limitedOutput_continue)
+#define LZ4_compressHC2_limitedOutput_withStateHC LZ4_KERNELS_RENAME(LZ4_compressHC2_limitedOutput_withStateHC)
+#define LZ4_compressHC2_withStateHC LZ4_KERNELS_RENAME(LZ4_compressHC2_withStateHC)
+#define LZ4_compressHC_continue LZ4_KERNELS_RENAME(LZ4_compressHC_continue)
+#define LZ4_compressHC_limitedOutput LZ4_KERNELS_RENAME(LZ4_compressHC_limitedOutput)
+#define LZ4_compressHC_limitedOutput_continue LZ4_KERNELS_RENAME(LZ4_compressHC_limitedOutput_continue)
+#define LZ4_compressHC_limitedOutput_withStateHC LZ4_KERNELS_RENAME(LZ4_compressHC_limitedOutput_withStateHC)
+#define LZ4_compressHC_withStateHC LZ4_KERNELS_RENAME(LZ4_compressHC_withStateHC)
+#define LZ4_compress_HC LZ4_KERNELS_RENAME(LZ4_compress_HC)
+#define LZ4_compress_HC_continue LZ4_KERNELS_RENAME(LZ4_compress_HC_continue)
+#define LZ4_compress_HC_continue_destSize LZ4_KERNELS_RENAME(LZ4_compress_HC_continue_destSize)
+#define LZ4_compress_HC_destSize LZ4_KERNELS_RENAME(LZ4_compress_HC_destSize)
+#define LZ4_compress_HC_extStateHC LZ4_KERNELS_RENAME(LZ4_compress_HC_extStateHC)
+#define LZ4_compress_HC_extStateHC_fastReset LZ4_KERNELS_RENAME(LZ4_compress_HC_extStateHC_fastReset)
+#define LZ4_createHC LZ4_KERNELS_RENAME(LZ4_createHC)
+#define LZ4_createStreamHC LZ4_KERNELS_RENAME(LZ4_createStreamHC)
+#define LZ4_createStreamHCEx LZ4_KERNELS_RENAME(LZ4_createStreamHCEx)
+#define LZ4_favorDecompressionSpeed LZ4_KERNELS_RENAME(LZ4_favorDecompressionSpeed)
+#define LZ4_freeHC LZ4_KERNELS_RENAME(LZ4_freeHC)
+#define LZ4_freeStreamHC LZ4_KERNELS_RENAME(LZ4_freeStreamHC)
+#define LZ4_initStreamHC LZ4_KERNELS_RENAME(LZ4_initStreamHC)
+#define LZ4_initStreamHCEx LZ4_KERNELS_RENAME(LZ4_initStreamHCEx)
+#define LZ4_loadDictHC LZ4_KERNELS_RENAME(LZ4_loadDictHC)
+#define LZ4_resetStreamHC LZ4_KERNELS_RENAME(LZ4_resetStreamHC)
+#define LZ4_resetStreamHC_fast LZ4_KERNELS_RENAME(LZ4_resetStreamHC_fast)
+#define LZ4_resetStreamStateHC LZ4_KERNELS_RENAME(LZ4_resetStreamStateHC)
+#define LZ4_saveDictHC LZ4_KERNELS_RENAME(LZ4_saveDictHC)
+#define LZ4_setCompressionLevel LZ4_KERNELS_RENAME(LZ4_setCompressionLevel)
+#define LZ4_sizeofStateHC LZ4_KERNELS_RENAME(LZ4_sizeofStateHC)
+#define LZ4_sizeofStateHCEx LZ4_KERNELS_RENAME(LZ4_sizeofStateHCEx)
+#define LZ4_sizeofStreamStateHC LZ4_KERNELS_RENAME(LZ4_sizeofStreamStateHC)
+#define LZ4_slideInputBufferHC LZ4_KERNELS_RENAME(LZ4_slideInputBufferHC)
+
+// xxhash.cpp
+#define XXH_NAMESPACE LZ4_KERNELS_PREFIX
+
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#define XXH_STATIC_LINKING_ONLY
+#define LZ4_DISABLE_DEPRECATE_WARNINGS
+
+// the kernels are not exported
+#undef LZ4_DLL_EXPORT
+#undef XXH_DLL_EXPORT
+#define LZ4LIB_VISIBILITY
+
+#include "lz4Kernels.h"
+
+#if LZ4_KERNELS_X86
+
+#include "lz4.cpp"
+#include "lz4hc.cpp"
+#include "xxhash.cpp"
+
+const LZ4Kernels LZ4_KERNELS_TABLE = {
+	LZ4_KERNELS_NAME,
+	&LZ4_compress_default,
+	&LZ4_compress_fast,
+	&LZ4_compress_fast_extState_fastReset,
+	&LZ4_compress_fast_continue,
+	&LZ4_compress_destSize,
+	&LZ4_compress_HC,
+	&LZ4_compress_HC_extStateHC_fastReset,
+	&LZ4_compress_HC_continue,
+	&LZ4_decompress_safe,
+	&LZ4_decompress_safe_partial,
+	&LZ4_decompress_safe_continue,
+	&LZ4_decompress_safe_usingDict,
+	&LZ4_decompress_safe_batch,
+	&XXH32,
+	&XXH32_update
+};
+
+#endif
@@ -0,0 +1,115 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4TestData.h"
+
+// LZ4_decompress_safe_batch against LZ4_decompress_safe of every block: batches of 0 - 9 blocks of mixed sizes, with corrupted blocks and destinations that are too small
+
+using namespace lz4test;
+
+struct Block {
+	std::vector<char> compressed;
+	std::vector<char> data;
+	int capacity;
+	bool intact;
+};
+
+static Block MakeBlock(const std::vector<char>& corpus, Random& random) {
+	// tiny values up to full 64 KB blocks
+	const int sizes[] = { 1, 13, 31, 64, 65, 200, 1000, 4096, 20000, 65536 };
+	int size = sizes[random.Next(sizeof(sizes) / sizeof(sizes[0]))];
+	size_t offset = random.Next((unsigned int)(corpus.size() - (size_t)size));
+	Block block;
+	block.data.assign(corpus.begin() + (ptrdiff_t)offset, corpus.begin() + (ptrdiff_t)offset + size);
+	block.compressed.resize((size_t)LZ4_compressBound(size));
+	block.compressed.resize((size_t)LZ4Kernels_baseline.compress_fast(block.data.data(), block.compressed.data(), size, (int)block.compressed.size(), 1));
+	block.capacity = size + (int)random.Next(3) * 100;
+	block.intact = true;
+
+	// some blocks fail: a corrupted byte, a destination that is too small, a truncated block
+	switch (random.Next(8)) {
+		case 0: block.compressed[random.Next((unsigned int)block.compressed.size())] ^= (char)(1 + random.Next(255)); block.intact = false; break;
+		case 1: block.capacity = size - 1 - (int)random.Next((unsigned int)size); block.intact = false; break;
+		case 2: block.compressed.resize(block.compressed.size() - 1 - random.Next((unsigned int)block.compressed.size())); block.intact = false; break;
+		default: break;
+	}
+	return block;
+}
+
+static void CheckBatch(const LZ4Kernels* k, const std::vector<Block>& blocks, const char* description) {
+	size_t count = blocks.size();
+	std::vector<const char*> sources;
+	std::vector<int> compressedSizes, capacities, results(count, 12345), expectedResults(count);
+	std::vector<std::vector<char>> outputs(count), expectedOutputs(count);
+	std::vector<char*> dests;
+	int expectedFailed = 0;
+	for (size_t i = 0; i < count; i++) {
+		const Block& block = blocks[i];
+		// the destinations have room for the whole block, the capacity limits the output
+		outputs[i].assign(block.data.size() + 300, (char)0xCC);
+		expectedOutputs[i] = outputs[i];
+		sources.push_back(block.compressed.data());
+		dests.push_back(outputs[i].data());
+		compressedSizes.push_back((int)block.compressed.size());
+		capacities.push_back(block.capacity);
+		expectedResults[i] = k->decompress_safe(block.compressed.data(), expectedOutputs[i].data(), (int)block.compressed.size(), block.capacity);
+		if (expectedResults[i] < 0) { expectedFailed++; }
+	}
+
+	int failed = k->decompress_safe_batch(sources.data(), dests.data(), compressedSizes.data(), capacities.data(), results.data(), (int)count);
+	LZ4TEST_CHECK(failed == expectedFailed, "%s: %s: %d failed, %d expected", k->name, description, failed, expectedFailed);
+	for (size_t i = 0; i < count; i++) {
+		// a failed block only has to fail, the output of a successful block is compared including the bytes after it
+		bool same = expectedResults[i] < 0 ? results[i] < 0 : results[i] == expectedResults[i] && outputs[i] == expectedOutputs[i];
+		LZ4TEST_CHECK(same, "%s: %s: block %d of %d (%d bytes): %d, %d expected", k->name, description, (int)i, (int)count, (int)blocks[i].data.size(), results[i], expectedResults[i]);
+		if (blocks[i].intact) {
+			LZ4TEST_CHECK(expectedResults[i] == (int)blocks[i].data.size() && memcmp(outputs[i].data(), blocks[i].data.data(), blocks[i].data.size()) == 0, "%s: %s: block %d does not round trip", k->name, description, (int)i);
+		}
+	}
+}
+
+int main() {
+	std::vector<char> corpora[] = { LogCorpus(1024 * 1024), BinaryCorpus(1024 * 1024), RandomCorpus(256 * 1024), RepetitiveCorpus(1024 * 1024) };
+	char description[64];
+	for (const LZ4Kernels* k : SupportedKernels()) {
+		Random random(22);
+		CheckBatch(k, std::vector<Block>(), "no blocks");
+		for (int count = 1; count <= 9; count++) {
+			for (int repeat = 0; repeat < 200; repeat++) {
+				std::vector<Block> blocks;
+				for (int i = 0; i < count; i++) { blocks.push_back(MakeBlock(corpora[random.Next(4)], random)); }
+				snprintf(description, sizeof(description), "batch of %d, repeat %d", count, repeat);
+				CheckBatch(k, blocks, description);
+			}
+		}
+	}
+	return Result("lz4BatchDecodeTest");
+}
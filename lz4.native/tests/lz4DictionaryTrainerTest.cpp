@@ -0,0 +1,218 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4DictionaryTrainer.h"
+#include "lz4TestData.h"
+
+// the dictionary trainer (lz4DictionaryTrainer.h): the split into training and held-out samples, the dictionaries it builds, and the arguments it rejects
+
+using namespace lz4::native;
+using namespace lz4test;
+
+struct Samples {
+	std::vector<char> data;
+	std::vector<int> sizes;
+};
+
+// the lines of the log corpus, one message per line
+static Samples LogMessages(int count, unsigned int seed = 1) {
+	Samples samples;
+	samples.data = LogCorpus((size_t)count * 300, seed);
+	size_t position = 0;
+	while ((int)samples.sizes.size() < count && position < samples.data.size()) {
+		const char* end = (const char*)memchr(&samples.data[position], '\n', samples.data.size() - position);
+		size_t next = end != NULL ? (size_t)(end - samples.data.data()) + 1 : samples.data.size();
+		samples.sizes.push_back((int)(next - position));
+		position = next;
+	}
+	samples.data.resize(position);
+	return samples;
+}
+
+// the samples compressed one by one as the trainer evaluates them
+static long long CompressedSize(const char* data, const std::vector<int>& sizes, int holdoutInterval, const std::vector<char>& dictionary) {
+	LZ4_stream_t* stream = LZ4_createStream();
+	std::vector<char> buffer((size_t)LZ4_compressBound(64 * 1024));
+	long long total = 0;
+	for (size_t i = 0; i < sizes.size(); data += sizes[i], i++) {
+		if (sizes[i] == 0 || (int)(i % (size_t)holdoutInterval) != holdoutInterval - 1) { continue; }
+		LZ4_loadDict(stream, dictionary.data(), (int)dictionary.size());
+		int size = LZ4_compress_fast_continue(stream, data, buffer.data(), sizes[i], (int)buffer.size(), 1);
+		total += size > 0 ? size : sizes[i];
+	}
+	LZ4_freeStream(stream);
+	return total;
+}
+
+// every fifth sample is held out from 5 samples on: the split arrays are sized with the training and held-out counts, the counts at the boundaries must fit them
+static void TestSampleCounts() {
+	Samples messages = LogMessages(60);
+	const int counts[] = { 1, 2, 4, 5, 6, 9, 10, 11, 14, 15, 16, 59, 60 };
+	for (int count : counts) {
+		std::vector<int> sizes(messages.sizes.begin(), messages.sizes.begin() + count);
+		// empty samples are counted, but not evaluated
+		if (count > 3) { sizes[2] = 0; }
+		long long heldOutSize = 0;
+		for (int i = 4; i < count && count >= 5; i += 5) { heldOutSize += sizes[(size_t)i]; }
+
+		std::vector<char> dictionary(4096);
+		LZ4DictionaryTrainerParameters parameters = { 64, 6 };
+		LZ4DictionaryTrainerResult result;
+		int size = LZ4Dictionary_train(dictionary.data(), (int)dictionary.size(), messages.data.data(), sizes.data(), count, &parameters, &result);
+		LZ4TEST_CHECK(size > 0 || size == LZ4Frame_ErrorNotEnoughSamples, "%d samples: %d", count, size);
+		if (size <= 0) { continue; }
+		LZ4TEST_CHECK(result.evaluatedSamples == count / 5, "%d samples: %d held out", count, result.evaluatedSamples);
+		LZ4TEST_CHECK(result.evaluatedSize == heldOutSize, "%d samples: %lld bytes held out, expected %lld", count, result.evaluatedSize, heldOutSize);
+	}
+}
+
+static void TestTraining() {
+	Samples messages = LogMessages(3000);
+	std::vector<char> dictionary(LZ4FRAME_DICTIONARY_SIZE_MAX);
+	LZ4DictionaryTrainerParameters parameters = { 0, 0 };
+	LZ4DictionaryTrainerResult result;
+	int size = LZ4Dictionary_train(dictionary.data(), (int)dictionary.size(), messages.data.data(), messages.sizes.data(), (int)messages.sizes.size(), &parameters, &result);
+	LZ4TEST_CHECK(size > 0 && size <= LZ4FRAME_DICTIONARY_SIZE_MAX, "train %d", size);
+	if (size <= 0) { return; }
+	dictionary.resize((size_t)size);
+
+	// the reported sizes are those of the held-out samples, and the dictionary makes them smaller
+	LZ4TEST_CHECK(result.evaluatedSamples == 600, "%d held out", result.evaluatedSamples);
+	LZ4TEST_CHECK(result.segmentSize >= LZ4DICTIONARY_SEGMENT_SIZE_MIN && result.dmerSize >= LZ4DICTIONARY_DMER_SIZE_MIN && result.dmerSize <= LZ4DICTIONARY_DMER_SIZE_MAX, "segment size %d, dmer size %d", result.segmentSize, result.dmerSize);
+	LZ4TEST_CHECK(result.compressedSize == CompressedSize(messages.data.data(), messages.sizes, 5, std::vector<char>()), "compressed size without dictionary %lld", result.compressedSize);
+	LZ4TEST_CHECK(result.compressedSizeWithDictionary == CompressedSize(messages.data.data(), messages.sizes, 5, dictionary), "compressed size with dictionary %lld", result.compressedSizeWithDictionary);
+	LZ4TEST_CHECK(result.compressedSizeWithDictionary * 3 < result.compressedSize * 2, "held-out samples: %lld bytes without, %lld with the dictionary", result.compressedSize, result.compressedSizeWithDictionary);
+
+	// the same samples train the same dictionary
+	std::vector<char> again(LZ4FRAME_DICTIONARY_SIZE_MAX);
+	LZ4DictionaryTrainerResult againResult;
+	int againSize = LZ4Dictionary_train(again.data(), (int)again.size(), messages.data.data(), messages.sizes.data(), (int)messages.sizes.size(), &parameters, &againResult);
+	again.resize(againSize > 0 ? (size_t)againSize : 0);
+	LZ4TEST_CHECK(again == dictionary, "the dictionary of a second training differs");
+
+	// messages that were not trained on, in frames with the dictionary
+	Samples other = LogMessages(100, 7);
+	LZ4FrameInfo info;
+	memset(&info, 0, sizeof(info));
+	info.blockSizeId = 4;
+	info.independentBlocks = true;
+	info.contentChecksum = true;
+	LZ4FrameCompressionOptions options;
+	memset(&options, 0, sizeof(options));
+	options.acceleration = 1;
+	LZ4FrameEncoder encoder;
+	encoder.Init(&info, &options);
+	encoder.SetDictionary(dictionary.data(), (int)dictionary.size());
+	const char* message = other.data.data();
+	for (int messageSize : other.sizes) {
+		std::vector<char> frame((size_t)LZ4Frame_compressBound(&info, messageSize, 0)), output((size_t)messageSize);
+		int frameSize = encoder.CompressFrames(message, messageSize, 0, frame.data(), (int)frame.size());
+		int result = frameSize > 0 ? LZ4Frame_decompress_usingDict(frame.data(), frameSize, output.data(), messageSize, dictionary.data(), (int)dictionary.size()) : frameSize;
+		LZ4TEST_CHECK(result == messageSize && memcmp(output.data(), message, (size_t)messageSize) == 0, "frame of a message with the dictionary: %d", result);
+		message += messageSize;
+	}
+}
+
+static void TestParameters() {
+	Samples messages = LogMessages(500);
+	const LZ4DictionaryTrainerParameters fixed[] = { { 16, 4 }, { 256, 6 }, { 2048, 8 } };
+	for (const LZ4DictionaryTrainerParameters& parameters : fixed) {
+		std::vector<char> dictionary(8192);
+		LZ4DictionaryTrainerResult result;
+		int size = LZ4Dictionary_train(dictionary.data(), (int)dictionary.size(), messages.data.data(), messages.sizes.data(), (int)messages.sizes.size(), &parameters, &result);
+		LZ4TEST_CHECK(size > 0 && size <= (int)dictionary.size() && result.segmentSize == parameters.segmentSize && result.dmerSize == parameters.dmerSize,
+			"segment size %d, dmer size %d: %d, %d %d", parameters.segmentSize, parameters.dmerSize, size, result.segmentSize, result.dmerSize);
+	}
+
+	// samples that are shorter than a dmer
+	std::vector<char> tiny(100, 'a');
+	std::vector<int> tinySizes(50, 2);
+	std::vector<char> dictionary(4096);
+	LZ4DictionaryTrainerParameters automatic = { 0, 0 };
+	LZ4DictionaryTrainerResult result;
+	int size = LZ4Dictionary_train(dictionary.data(), (int)dictionary.size(), tiny.data(), tinySizes.data(), (int)tinySizes.size(), &automatic, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorNotEnoughSamples, "samples shorter than a dmer: %d", size);
+}
+
+static void TestInvalidArguments() {
+	Samples messages = LogMessages(20);
+	const int* sizes = messages.sizes.data();
+	int count = (int)messages.sizes.size();
+	std::vector<char> dictionary(LZ4FRAME_DICTIONARY_SIZE_MAX + 1);
+	LZ4DictionaryTrainerParameters automatic = { 0, 0 };
+	LZ4DictionaryTrainerResult result;
+
+	struct Case {
+		const char* name;
+		int capacity;
+		int segmentSize;
+		int dmerSize;
+	};
+	const Case cases[] = {
+		{ "capacity 0", 0, 0, 0 },
+		{ "capacity over the maximum", LZ4FRAME_DICTIONARY_SIZE_MAX + 1, 0, 0 },
+		{ "segment size without dmer size", 4096, 64, 0 },
+		{ "dmer size without segment size", 4096, 0, 6 },
+		{ "dmer size 3", 4096, 64, 3 },
+		{ "dmer size 9", 4096, 64, 9 },
+		{ "segment size below the minimum", 4096, LZ4DICTIONARY_SEGMENT_SIZE_MIN - 1, 4 },
+		{ "segment size over the capacity", 4096, 8192, 6 },
+	};
+	for (const Case& c : cases) {
+		LZ4DictionaryTrainerParameters parameters = { c.segmentSize, c.dmerSize };
+		int size = LZ4Dictionary_train(dictionary.data(), c.capacity, messages.data.data(), sizes, count, &parameters, &result);
+		LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "%s: %d", c.name, size);
+	}
+
+	int size = LZ4Dictionary_train(NULL, 4096, messages.data.data(), sizes, count, &automatic, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "no dictionary: %d", size);
+	size = LZ4Dictionary_train(dictionary.data(), 4096, NULL, sizes, count, &automatic, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "no samples: %d", size);
+	size = LZ4Dictionary_train(dictionary.data(), 4096, messages.data.data(), sizes, 0, &automatic, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "0 samples: %d", size);
+	size = LZ4Dictionary_train(dictionary.data(), 4096, messages.data.data(), sizes, count, NULL, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "no parameters: %d", size);
+	size = LZ4Dictionary_train(dictionary.data(), 4096, messages.data.data(), sizes, count, &automatic, NULL);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "no result: %d", size);
+
+	std::vector<int> negative(messages.sizes);
+	negative[3] = -1;
+	size = LZ4Dictionary_train(dictionary.data(), 4096, messages.data.data(), negative.data(), count, &automatic, &result);
+	LZ4TEST_CHECK(size == LZ4Frame_ErrorInvalidArgument, "negative sample size: %d", size);
+}
+
+int main() {
+	TestSampleCounts();
+	TestTraining();
+	TestParameters();
+	TestInvalidArguments();
+	return Result("lz4DictionaryTrainerTest");
+}
@@ -0,0 +1,339 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+// round trips of the frame engine (lz4Frame.h): every frame option, the incremental decoder with input of any size, and the errors it detects
+
+using namespace lz4::native;
+using namespace lz4test;
+
+struct FrameOptions {
+	int blockSizeId;
+	bool independentBlocks;
+	bool blockChecksum;
+	bool contentChecksum;
+	bool hasContentSize;
+	int compressionLevel;
+	int memoryUsage;
+};
+
+static std::string Describe(const FrameOptions& o) {
+	char text[128];
+	snprintf(text, sizeof(text), "block size id %d, %s, block checksum %d, content checksum %d, content size %d, level %d, memory usage %d",
+		o.blockSizeId, o.independentBlocks ? "independent" : "linked", o.blockChecksum, o.contentChecksum, o.hasContentSize, o.compressionLevel, o.memoryUsage);
+	return text;
+}
+
+static int InitEncoder(LZ4FrameEncoder& encoder, const FrameOptions& o, unsigned long long contentSize) {
+	LZ4FrameInfo info;
+	memset(&info, 0, sizeof(info));
+	info.blockSizeId = o.blockSizeId;
+	info.independentBlocks = o.independentBlocks;
+	info.blockChecksum = o.blockChecksum;
+	info.contentChecksum = o.contentChecksum;
+	info.hasContentSize = o.hasContentSize;
+	info.contentSize = contentSize;
+
+	LZ4FrameCompressionOptions options;
+	memset(&options, 0, sizeof(options));
+	options.compressionLevel = o.compressionLevel;
+	options.acceleration = 1;
+	options.memoryUsage = o.memoryUsage;
+	return encoder.Init(&info, &options);
+}
+
+// a frame written block by block, the way LZ4Stream writes it
+static std::vector<char> Encode(LZ4FrameEncoder& encoder, const std::vector<char>& data) {
+	std::vector<char> frame((size_t)LZ4Frame_compressBound(&encoder.Info(), (long long)data.size(), 0));
+	int size = encoder.BeginFrame(frame.data(), (int)frame.size());
+	for (size_t offset = 0; size >= 0 && offset < data.size(); offset += (size_t)encoder.BlockSize()) {
+		int blockSize = (int)std::min<size_t>((size_t)encoder.BlockSize(), data.size() - offset);
+		int written = encoder.CompressBlock(&data[offset], blockSize, &frame[(size_t)size], (int)frame.size() - size);
+		size = written < 0 ? written : size + written;
+	}
+	if (size >= 0) {
+		int written = encoder.EndFrame(&frame[(size_t)size], (int)frame.size() - size);
+		size = written < 0 ? written : size + written;
+	}
+	frame.resize(size < 0 ? 0 : (size_t)size);
+	return frame;
+}
+
+// decodes src in parts of at most chunkSize bytes, the data of skippable frames is appended to userData; returns the last event or an error
+static int DecodeIncremental(const std::vector<char>& src, int chunkSize, const std::vector<char>* dictionary, std::vector<char>& output, std::vector<char>& userData) {
+	LZ4FrameDecoder decoder;
+	output.clear();
+	userData.clear();
+	int frameEvent = LZ4FrameDecoder_NeedInput;
+	size_t offset = 0;
+	while (offset < src.size()) {
+		int size = (int)std::min<size_t>((size_t)chunkSize, src.size() - offset);
+		int used = 0;
+		do {
+			int consumed;
+			frameEvent = decoder.Decode(&src[offset + (size_t)used], size - used, &consumed);
+			if (LZ4Frame_isError(frameEvent)) { return frameEvent; }
+			used += consumed;
+
+			if (frameEvent == LZ4FrameDecoder_FrameHeader && decoder.Info().hasDictionaryId && dictionary != NULL) {
+				int status = decoder.SetDictionary(dictionary->data(), (int)dictionary->size());
+				if (LZ4Frame_isError(status)) { return status; }
+			}
+			else if (frameEvent == LZ4FrameDecoder_Block) {
+				output.insert(output.end(), decoder.Output(), decoder.Output() + decoder.OutputSize());
+			}
+			else if (frameEvent == LZ4FrameDecoder_SkippableData) {
+				userData.insert(userData.end(), decoder.Output(), decoder.Output() + decoder.OutputSize());
+			}
+		} while (frameEvent != LZ4FrameDecoder_NeedInput);
+		offset += (size_t)size;
+	}
+	return decoder.IsAtFrameBoundary() ? LZ4Frame_OK : LZ4Frame_ErrorTruncated;
+}
+
+static void RoundTrip(const FrameOptions& o, const std::vector<char>& data, const char* name) {
+	std::string description = std::string(name) + ": " + Describe(o);
+	LZ4FrameEncoder encoder;
+	int status = InitEncoder(encoder, o, data.size());
+	LZ4TEST_CHECK(status == LZ4Frame_OK, "%s: init %d", description.c_str(), status);
+	if (status != LZ4Frame_OK) { return; }
+	std::vector<char> frame = Encode(encoder, data);
+	LZ4TEST_CHECK(!frame.empty(), "%s: encode failed", description.c_str());
+
+	std::vector<char> output(data.size() + 1);
+	int size = LZ4Frame_decompress(frame.data(), (int)frame.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(size == (int)data.size() && memcmp(output.data(), data.data(), data.size()) == 0, "%s: decompress %d", description.c_str(), size);
+	LZ4TEST_CHECK(LZ4Frame_getDecompressedBound(frame.data(), (int)frame.size()) >= (long long)data.size(), "%s: decompressed bound", description.c_str());
+
+	// a single byte at a time is slow, it is only used for small frames
+	const int chunkSizes[] = { 1, 13, 4096, 1 << 30 };
+	for (int chunkSize : chunkSizes) {
+		if (chunkSize == 1 && frame.size() > 100000) { continue; }
+		std::vector<char> incremental, userData;
+		status = DecodeIncremental(frame, chunkSize, NULL, incremental, userData);
+		LZ4TEST_CHECK(status == LZ4Frame_OK && incremental == data, "%s: incremental decode in parts of %d bytes: %d", description.c_str(), chunkSize, status);
+	}
+}
+
+static void TestRoundTrips() {
+	std::vector<char> log = LogCorpus(1300 * 1000);
+	std::vector<char> random = RandomCorpus(300 * 1000);
+	std::vector<char> small(log.begin(), log.begin() + 1000);
+	std::vector<char> empty;
+
+	const int blockSizeIds[] = { 4, 5, 6, 7 };
+	const int levels[] = { 0, 9 };
+	for (int blockSizeId : blockSizeIds) {
+		for (int flags = 0; flags < 16; flags++) {
+			for (int level : levels) {
+				FrameOptions o = { blockSizeId, (flags & 1) != 0, (flags & 2) != 0, (flags & 4) != 0, (flags & 8) != 0, level, 0 };
+				RoundTrip(o, log, "log");
+				if (blockSizeId == 4) {
+					RoundTrip(o, random, "random");
+					RoundTrip(o, small, "small");
+					RoundTrip(o, empty, "empty");
+				}
+			}
+		}
+	}
+}
+
+static void TestDictionary() {
+	std::vector<char> log = LogCorpus(400 * 1000);
+	std::vector<char> dictionary(log.begin(), log.begin() + 64 * 1024);
+	std::vector<char> data(log.begin() + 64 * 1024, log.end());
+
+	const int levels[] = { 0, 9 };
+	for (int level : levels) {
+		for (int independent = 0; independent < 2; independent++) {
+			FrameOptions o = { 4, independent != 0, false, true, false, level, 0 };
+			LZ4FrameEncoder encoder;
+			InitEncoder(encoder, o, 0);
+			encoder.SetDictionaryId(true, 42);
+			encoder.SetDictionary(dictionary.data(), (int)dictionary.size());
+			std::vector<char> frame = Encode(encoder, data);
+
+			LZ4FrameEncoder plainEncoder;
+			InitEncoder(plainEncoder, o, 0);
+			std::vector<char> plain = Encode(plainEncoder, data);
+			LZ4TEST_CHECK(frame.size() < plain.size(), "level %d independent %d: the dictionary does not help: %d, %d", level, independent, (int)frame.size(), (int)plain.size());
+
+			std::vector<char> output(data.size());
+			int size = LZ4Frame_decompress_usingDict(frame.data(), (int)frame.size(), output.data(), (int)output.size(), dictionary.data(), (int)dictionary.size());
+			LZ4TEST_CHECK(size == (int)data.size() && output == data, "level %d independent %d: decompress using the dictionary %d", level, independent, size);
+
+			std::vector<char> incremental, userData;
+			int status = DecodeIncremental(frame, 1000, &dictionary, incremental, userData);
+			LZ4TEST_CHECK(status == LZ4Frame_OK && incremental == data, "level %d independent %d: incremental decode using the dictionary %d", level, independent, status);
+
+			// the frame header has the dictionary id, the decoder needs the dictionary
+			status = DecodeIncremental(frame, 1000, NULL, incremental, userData);
+			LZ4TEST_CHECK(status == LZ4Frame_ErrorDictionaryMissing || incremental != data, "level %d independent %d: decoded without the dictionary %d", level, independent, status);
+
+			LZ4PreparedDictionary prepared;
+			prepared.Init(dictionary.data(), (int)dictionary.size(), level != 0, false);
+			LZ4FrameEncoder preparedEncoder;
+			InitEncoder(preparedEncoder, o, 0);
+			preparedEncoder.SetDictionaryId(true, 42);
+			preparedEncoder.SetPreparedDictionary(&prepared);
+			std::vector<char> preparedFrame = Encode(preparedEncoder, data);
+			size = LZ4Frame_decompress_usingDict(preparedFrame.data(), (int)preparedFrame.size(), output.data(), (int)output.size(), dictionary.data(), (int)dictionary.size());
+			LZ4TEST_CHECK(size == (int)data.size() && output == data, "level %d independent %d: prepared dictionary %d", level, independent, size);
+		}
+	}
+}
+
+static void TestFramesAndSkippableFrames() {
+	std::vector<char> data = TextCorpus(500 * 1000);
+	FrameOptions o = { 4, false, true, true, true, 0, 0 };
+	LZ4FrameEncoder encoder;
+	InitEncoder(encoder, o, 0);
+
+	// 3 blocks per frame, every frame has the content size of its part
+	std::vector<char> frames((size_t)LZ4Frame_compressBound(&encoder.Info(), (long long)data.size(), 3));
+	int size = encoder.CompressFrames(data.data(), (int)data.size(), 3, frames.data(), (int)frames.size());
+	LZ4TEST_CHECK(size > 0, "compress frames %d", size);
+	frames.resize(size > 0 ? (size_t)size : 0);
+
+	int blocks = ((int)data.size() + 65535) / 65536;
+	int frameCount = LZ4Frame_locateFrames(frames.data(), (int)frames.size(), NULL, 0);
+	LZ4TEST_CHECK(frameCount == (blocks + 2) / 3, "frame count %d", frameCount);
+	LZ4TEST_CHECK(LZ4Frame_getDecompressedBound(frames.data(), (int)frames.size()) == (long long)data.size(), "decompressed bound of frames with a content size");
+
+	// a skippable frame between the frames, LZ4Frame_decompress ignores it
+	const char userText[] = "user data of a skippable frame";
+	std::vector<char> skippable(LZ4FRAME_SKIPPABLE_HEADER_SIZE + sizeof(userText));
+	LZ4Frame_writeSkippableHeader(5, sizeof(userText), skippable.data(), (int)skippable.size());
+	memcpy(&skippable[LZ4FRAME_SKIPPABLE_HEADER_SIZE], userText, sizeof(userText));
+	std::vector<LZ4FrameLocation> locations((size_t)frameCount);
+	LZ4Frame_locateFrames(frames.data(), (int)frames.size(), locations.data(), frameCount);
+	frames.insert(frames.begin() + locations[1].offset, skippable.begin(), skippable.end());
+
+	LZ4TEST_CHECK(LZ4Frame_locateFrames(frames.data(), (int)frames.size(), NULL, 0) == frameCount + 1, "frame count with the skippable frame");
+	std::vector<char> output(data.size());
+	size = LZ4Frame_decompress(frames.data(), (int)frames.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(size == (int)data.size() && output == data, "decompress frames %d", size);
+
+	std::vector<char> incremental, userData;
+	int status = DecodeIncremental(frames, 777, NULL, incremental, userData);
+	LZ4TEST_CHECK(status == LZ4Frame_OK && incremental == data, "incremental decode of the frames %d", status);
+	LZ4TEST_CHECK(userData.size() == sizeof(userText) && memcmp(userData.data(), userText, sizeof(userText)) == 0, "user data of the skippable frame");
+
+	// the frame of an empty input
+	std::vector<char> empty(LZ4FRAME_HEADER_SIZE_MAX + LZ4FRAME_END_SIZE_MAX);
+	size = LZ4Frame_writeEmptyFrame(&encoder.Info(), empty.data(), (int)empty.size());
+	LZ4TEST_CHECK(size > 0 && LZ4Frame_decompress(empty.data(), size, output.data(), (int)output.size()) == 0, "empty frame %d", size);
+}
+
+static void TestErrors() {
+	std::vector<char> data = LogCorpus(200 * 1000);
+	FrameOptions o = { 4, true, true, true, true, 0, 0 };
+	LZ4FrameEncoder encoder;
+	InitEncoder(encoder, o, data.size());
+	std::vector<char> frame = Encode(encoder, data);
+	std::vector<char> output(data.size());
+
+	std::vector<char> corrupted = frame;
+	corrupted[0] ^= 1;
+	int result = LZ4Frame_decompress(corrupted.data(), (int)corrupted.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorInvalidMagic, "magic %d", result);
+
+	// the header checksum is the last byte of the header: magic (4), descriptor (2), content size (8)
+	corrupted = frame;
+	corrupted[14] ^= 1;
+	result = LZ4Frame_decompress(corrupted.data(), (int)corrupted.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorFrameChecksum, "header checksum %d", result);
+
+	corrupted = frame;
+	corrupted[100] ^= 1;
+	result = LZ4Frame_decompress(corrupted.data(), (int)corrupted.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorBlockChecksum, "block checksum %d", result);
+
+	corrupted = frame;
+	corrupted[corrupted.size() - 1] ^= 1;
+	result = LZ4Frame_decompress(corrupted.data(), (int)corrupted.size(), output.data(), (int)output.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorContentChecksum, "content checksum %d", result);
+
+	result = LZ4Frame_decompress(frame.data(), (int)frame.size() - 3, output.data(), (int)output.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorTruncated, "truncated %d", result);
+
+	result = LZ4Frame_decompress(frame.data(), (int)frame.size(), output.data(), (int)output.size() - 1);
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorDstTooSmall, "destination too small %d", result);
+
+	// the content size of the header is verified at the end of the frame
+	LZ4FrameEncoder sizeEncoder;
+	InitEncoder(sizeEncoder, o, data.size() + 1);
+	std::vector<char> frameBuffer((size_t)LZ4Frame_compressBound(&sizeEncoder.Info(), (long long)data.size(), 0));
+	int size = sizeEncoder.BeginFrame(frameBuffer.data(), (int)frameBuffer.size());
+	size += sizeEncoder.CompressBlock(data.data(), 65536, &frameBuffer[(size_t)size], (int)frameBuffer.size() - size);
+	result = sizeEncoder.EndFrame(&frameBuffer[(size_t)size], (int)frameBuffer.size() - size);
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorContentSize, "content size %d", result);
+
+	// a block that is larger than the block size
+	result = encoder.BeginFrame(frameBuffer.data(), (int)frameBuffer.size());
+	result = encoder.CompressBlock(data.data(), 65537, frameBuffer.data(), (int)frameBuffer.size());
+	LZ4TEST_CHECK(result == LZ4Frame_ErrorBlockSizeExceeded, "block size exceeded %d", result);
+}
+
+// an encoder that is initialized again, with the same or other options, writes the frames of a new encoder
+static void TestEncoderReuse() {
+	std::vector<char> data = LogCorpus(300 * 1000);
+	const FrameOptions options[] = {
+		{ 4, false, false, true, false, 0, 0 },
+		{ 4, false, false, true, false, 0, 16 },
+		{ 4, true, true, false, false, 9, 0 },
+		{ 5, false, false, true, true, 4, 14 },
+		{ 4, false, false, true, false, 0, 0 },
+	};
+	LZ4FrameEncoder reused;
+	for (int repeat = 0; repeat < 2; repeat++) {
+		for (const FrameOptions& o : options) {
+			LZ4FrameEncoder fresh;
+			InitEncoder(fresh, o, data.size());
+			std::vector<char> expected = Encode(fresh, data);
+
+			int status = InitEncoder(reused, o, data.size());
+			std::vector<char> frame = Encode(reused, data);
+			LZ4TEST_CHECK(status == LZ4Frame_OK && frame == expected, "reused encoder: %s", Describe(o).c_str());
+		}
+	}
+}
+
+int main() {
+	TestRoundTrips();
+	TestDictionary();
+	TestFramesAndSkippableFrames();
+	TestErrors();
+	TestEncoderReuse();
+	return Result("lz4FrameTest");
+}
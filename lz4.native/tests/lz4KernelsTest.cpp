@@ -0,0 +1,265 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#include "lz4TestData.h"
+
+// the kernels of every instruction set that the cpu supports, and the api functions that dispatch to the selected kernels, against the baseline kernels
+// compression must write the same bytes, decompression the same output and result, the hashes must be equal
+// usage: lz4KernelsTest [kernels], with kernels the variant that LZ4_KERNELS selects: exits with 77 (skipped) when the cpu does not support it
+
+using namespace lz4test;
+
+static const int BlockSize = 64 * 1024;
+
+// the api functions as a kernel table, they call the kernels that are selected when the library is loaded
+static LZ4Kernels ApiKernels() {
+	LZ4Kernels kernels = {
+		"api", LZ4_compress_default, LZ4_compress_fast, LZ4_compress_fast_extState_fastReset, LZ4_compress_fast_continue,
+		LZ4_compress_destSize, LZ4_compress_HC, LZ4_compress_HC_extStateHC_fastReset, LZ4_compress_HC_continue,
+		LZ4_decompress_safe, LZ4_decompress_safe_partial, LZ4_decompress_safe_continue, LZ4_decompress_safe_usingDict,
+		LZ4_decompress_safe_batch, XXH32, XXH32_update
+	};
+	return kernels;
+}
+
+struct Blocks {
+	std::vector<std::vector<char>> compressed;
+	std::vector<int> sizes;
+};
+
+static Blocks CompressBlocks(const LZ4Kernels* k, const std::vector<char>& data, int level, int acceleration) {
+	Blocks blocks;
+	for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+		int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+		std::vector<char> block((size_t)LZ4_compressBound(size));
+		int result = level == 0 ? k->compress_fast(&data[offset], block.data(), size, (int)block.size(), acceleration) : k->compress_HC(&data[offset], block.data(), size, (int)block.size(), level);
+		block.resize(result > 0 ? (size_t)result : 0);
+		blocks.compressed.push_back(block);
+		blocks.sizes.push_back(size);
+	}
+	return blocks;
+}
+
+// linked blocks, every block references the blocks before it
+static Blocks CompressLinked(const LZ4Kernels* k, const std::vector<char>& data, int level) {
+	LZ4_stream_t stream;
+	LZ4_streamHC_t streamHC;
+	LZ4_initStream(&stream, sizeof(stream));
+	LZ4_initStreamHC(&streamHC, sizeof(streamHC));
+	LZ4_setCompressionLevel(&streamHC, level);
+
+	Blocks blocks;
+	for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+		int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+		std::vector<char> block((size_t)LZ4_compressBound(size));
+		int result = level == 0 ? k->compress_fast_continue(&stream, &data[offset], block.data(), size, (int)block.size(), 1) : k->compress_HC_continue(&streamHC, &data[offset], block.data(), size, (int)block.size());
+		block.resize(result > 0 ? (size_t)result : 0);
+		blocks.compressed.push_back(block);
+		blocks.sizes.push_back(size);
+	}
+	return blocks;
+}
+
+static void CheckCompression(const LZ4Kernels* k, const Corpus& corpus) {
+	const LZ4Kernels* baseline = &LZ4Kernels_baseline;
+	const std::vector<char>& data = corpus.data;
+	const int accelerations[] = { 1, 2, 17 };
+	for (int acceleration : accelerations) {
+		LZ4TEST_CHECK(CompressBlocks(k, data, 0, acceleration).compressed == CompressBlocks(baseline, data, 0, acceleration).compressed, "%s %s: compress_fast acceleration %d", k->name, corpus.name.c_str(), acceleration);
+	}
+
+	// high compression on the first 256 KB, the optimal parser is slow
+	std::vector<char> hcData(data.begin(), data.begin() + (ptrdiff_t)std::min<size_t>(data.size(), 256 * 1024));
+	const int levels[] = { 3, 9, 12 };
+	for (int level : levels) {
+		LZ4TEST_CHECK(CompressBlocks(k, hcData, level, 1).compressed == CompressBlocks(baseline, hcData, level, 1).compressed, "%s %s: compress_HC level %d", k->name, corpus.name.c_str(), level);
+		LZ4TEST_CHECK(CompressLinked(k, hcData, level).compressed == CompressLinked(baseline, hcData, level).compressed, "%s %s: compress_HC_continue level %d", k->name, corpus.name.c_str(), level);
+	}
+	LZ4TEST_CHECK(CompressLinked(k, data, 0).compressed == CompressLinked(baseline, data, 0).compressed, "%s %s: compress_fast_continue", k->name, corpus.name.c_str());
+
+	// the other entry points on the same blocks, the states are reused from block to block
+	LZ4_stream_t* state = LZ4_createStream();
+	LZ4_streamHC_t* stateHC = LZ4_createStreamHC();
+	std::vector<char> expected((size_t)LZ4_compressBound(BlockSize)), actual(expected.size());
+	for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+		int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+		int capacity = (int)expected.size();
+		int expectedSize = baseline->compress_fast(&data[offset], expected.data(), size, capacity, 1);
+		int actualSize = k->compress_default(&data[offset], actual.data(), size, capacity);
+		LZ4TEST_CHECK(actualSize == expectedSize && memcmp(actual.data(), expected.data(), (size_t)expectedSize) == 0, "%s %s: compress_default at %d", k->name, corpus.name.c_str(), (int)offset);
+		actualSize = k->compress_fast_extState_fastReset(state, &data[offset], actual.data(), size, capacity, 1);
+		LZ4TEST_CHECK(actualSize == expectedSize && memcmp(actual.data(), expected.data(), (size_t)expectedSize) == 0, "%s %s: compress_fast_extState_fastReset at %d", k->name, corpus.name.c_str(), (int)offset);
+
+		const int targetSizes[] = { 100, 1000, 20000 };
+		for (int targetSize : targetSizes) {
+			int expectedSourceSize = size, actualSourceSize = size;
+			expectedSize = baseline->compress_destSize(&data[offset], expected.data(), &expectedSourceSize, targetSize);
+			actualSize = k->compress_destSize(&data[offset], actual.data(), &actualSourceSize, targetSize);
+			LZ4TEST_CHECK(actualSize == expectedSize && actualSourceSize == expectedSourceSize && memcmp(actual.data(), expected.data(), (size_t)expectedSize) == 0, "%s %s: compress_destSize %d at %d", k->name, corpus.name.c_str(), targetSize, (int)offset);
+		}
+
+		if (offset < hcData.size()) {
+			expectedSize = baseline->compress_HC(&data[offset], expected.data(), size, capacity, 9);
+			actualSize = k->compress_HC_extStateHC_fastReset(stateHC, &data[offset], actual.data(), size, capacity, 9);
+			LZ4TEST_CHECK(actualSize == expectedSize && memcmp(actual.data(), expected.data(), (size_t)expectedSize) == 0, "%s %s: compress_HC_extStateHC_fastReset at %d", k->name, corpus.name.c_str(), (int)offset);
+		}
+	}
+	LZ4_freeStream(state);
+	LZ4_freeStreamHC(stateHC);
+
+	// the ends of the input at every alignment, where the wide compares stop
+	for (int size = 0; size <= 300; size += (size < 80 ? 1 : 7)) {
+		for (int offset = 0; offset < 8; offset++) {
+			if ((size_t)(offset + size) > data.size()) { continue; }
+			char expected[LZ4_COMPRESSBOUND(300)], actual[LZ4_COMPRESSBOUND(300)];
+			int expectedSize = baseline->compress_fast(&data[(size_t)offset], expected, size, (int)sizeof(expected), 1);
+			int actualSize = k->compress_fast(&data[(size_t)offset], actual, size, (int)sizeof(actual), 1);
+			LZ4TEST_CHECK(actualSize == expectedSize && memcmp(actual, expected, (size_t)expectedSize) == 0, "%s %s: compress_fast of %d bytes at offset %d", k->name, corpus.name.c_str(), size, offset);
+			expectedSize = baseline->compress_HC(&data[(size_t)offset], expected, size, (int)sizeof(expected), 12);
+			actualSize = k->compress_HC(&data[(size_t)offset], actual, size, (int)sizeof(actual), 12);
+			LZ4TEST_CHECK(actualSize == expectedSize && memcmp(actual, expected, (size_t)expectedSize) == 0, "%s %s: compress_HC of %d bytes at offset %d", k->name, corpus.name.c_str(), size, offset);
+		}
+	}
+}
+
+static void CheckDecompression(const LZ4Kernels* k, const Corpus& corpus) {
+	const std::vector<char>& data = corpus.data;
+	Blocks blocks = CompressBlocks(&LZ4Kernels_baseline, data, 0, 1);
+	std::vector<char> output(BlockSize + 64), expected(BlockSize + 64);
+
+	for (size_t i = 0; i < blocks.compressed.size(); i++) {
+		const std::vector<char>& block = blocks.compressed[i];
+		int result = k->decompress_safe(block.data(), output.data(), (int)block.size(), BlockSize);
+		LZ4TEST_CHECK(result == blocks.sizes[i] && memcmp(output.data(), &data[i * BlockSize], (size_t)result) == 0, "%s %s: decompress_safe block %d: %d", k->name, corpus.name.c_str(), (int)i, result);
+
+		// a destination that is too small and corrupted blocks fail the same way as the baseline, or decode the same output
+		result = k->decompress_safe(block.data(), output.data(), (int)block.size(), blocks.sizes[i] - 1);
+		LZ4TEST_CHECK(result < 0, "%s %s: decompress_safe block %d into a destination that is too small: %d", k->name, corpus.name.c_str(), (int)i, result);
+
+		// the start of the block, at least targetOutputSize bytes
+		const int targetSizes[] = { 1, 1000, blocks.sizes[i] / 2 };
+		for (int targetSize : targetSizes) {
+			int expectedResult = LZ4Kernels_baseline.decompress_safe_partial(block.data(), expected.data(), (int)block.size(), targetSize, BlockSize);
+			result = k->decompress_safe_partial(block.data(), output.data(), (int)block.size(), targetSize, BlockSize);
+			LZ4TEST_CHECK(result == expectedResult && result >= std::min(targetSize, blocks.sizes[i]) && memcmp(output.data(), &data[i * BlockSize], (size_t)result) == 0, "%s %s: decompress_safe_partial block %d to %d bytes: %d, baseline %d", k->name, corpus.name.c_str(), (int)i, targetSize, result, expectedResult);
+		}
+		std::vector<char> corrupted = block;
+		for (size_t position = 3; position < corrupted.size(); position += corrupted.size() / 7 + 1) {
+			corrupted[position] = (char)(corrupted[position] ^ 0x5A);
+			int expectedResult = LZ4Kernels_baseline.decompress_safe(corrupted.data(), expected.data(), (int)corrupted.size(), BlockSize);
+			result = k->decompress_safe(corrupted.data(), output.data(), (int)corrupted.size(), BlockSize);
+			bool same = expectedResult < 0 ? result < 0 : result == expectedResult && memcmp(output.data(), expected.data(), (size_t)result) == 0;
+			LZ4TEST_CHECK(same, "%s %s: decompress_safe of corrupted block %d: %d, baseline %d", k->name, corpus.name.c_str(), (int)i, result, expectedResult);
+		}
+	}
+
+	// linked blocks decode with the blocks before them, or with a dictionary
+	Blocks linked = CompressLinked(&LZ4Kernels_baseline, data, 0);
+	std::vector<char> decoded(data.size());
+	LZ4_streamDecode_t streamDecode;
+	LZ4_setStreamDecode(&streamDecode, NULL, 0);
+	bool continued = true, usingDict = true;
+	for (size_t i = 0; i < linked.compressed.size(); i++) {
+		const std::vector<char>& block = linked.compressed[i];
+		char* dst = &decoded[i * BlockSize];
+		continued = continued && k->decompress_safe_continue(&streamDecode, block.data(), dst, (int)block.size(), linked.sizes[i]) == linked.sizes[i];
+		size_t dictionarySize = std::min<size_t>(i * BlockSize, 64 * 1024);
+		int result = k->decompress_safe_usingDict(block.data(), output.data(), (int)block.size(), linked.sizes[i], dictionarySize > 0 ? &data[i * BlockSize - dictionarySize] : NULL, (int)dictionarySize);
+		usingDict = usingDict && result == linked.sizes[i] && memcmp(output.data(), &data[i * BlockSize], (size_t)result) == 0;
+	}
+	LZ4TEST_CHECK(continued && decoded == data, "%s %s: decompress_safe_continue", k->name, corpus.name.c_str());
+	LZ4TEST_CHECK(usingDict, "%s %s: decompress_safe_usingDict", k->name, corpus.name.c_str());
+
+	std::vector<const char*> sources;
+	std::vector<char*> dests;
+	std::vector<int> compressedSizes, capacities, results(blocks.compressed.size());
+	for (size_t i = 0; i < blocks.compressed.size(); i++) {
+		sources.push_back(blocks.compressed[i].data());
+		dests.push_back(&decoded[i * BlockSize]);
+		compressedSizes.push_back((int)blocks.compressed[i].size());
+		capacities.push_back(blocks.sizes[i]);
+	}
+	std::fill(decoded.begin(), decoded.end(), 0);
+	int failed = k->decompress_safe_batch(sources.data(), dests.data(), compressedSizes.data(), capacities.data(), results.data(), (int)results.size());
+	LZ4TEST_CHECK(failed == 0 && results == blocks.sizes && decoded == data, "%s %s: decompress_safe_batch: %d failed", k->name, corpus.name.c_str(), failed);
+}
+
+static void CheckHashes(const LZ4Kernels* k, const Corpus& corpus) {
+	const std::vector<char>& data = corpus.data;
+	const unsigned int seeds[] = { 0, 0x9E3779B1 };
+	for (unsigned int seed : seeds) {
+		LZ4TEST_CHECK(k->xxh32(data.data(), data.size(), seed) == LZ4Kernels_baseline.xxh32(data.data(), data.size(), seed), "%s %s: xxh32 seed %u", k->name, corpus.name.c_str(), seed);
+		for (size_t size = 0; size <= 100 && size + 8 <= data.size(); size++) {
+			for (size_t offset = 0; offset < 8; offset++) {
+				LZ4TEST_CHECK(k->xxh32(&data[offset], size, seed) == LZ4Kernels_baseline.xxh32(&data[offset], size, seed), "%s %s: xxh32 of %d bytes at offset %d", k->name, corpus.name.c_str(), (int)size, (int)offset);
+			}
+		}
+	}
+
+	// updates of every size, the state buffers the parts of 16 byte stripes
+	XXH32_state_t* state = XXH32_createState();
+	XXH32_reset(state, 0);
+	size_t offset = 0;
+	for (size_t size = 1; offset + size <= data.size(); offset += size, size = size % 37 + 1) {
+		k->xxh32_update(state, &data[offset], size);
+	}
+	LZ4TEST_CHECK(XXH32_digest(state) == LZ4Kernels_baseline.xxh32(data.data(), offset, 0), "%s %s: xxh32_update", k->name, corpus.name.c_str());
+	XXH32_freeState(state);
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], LZ4_kernels()) != 0) {
+		printf("lz4KernelsTest: %s kernels requested, %s selected: skipped\n", argv[1], LZ4_kernels());
+		return 77;
+	}
+
+	std::vector<Corpus> corpora = Corpora(1, argv, 1024 * 1024);
+	corpora.push_back(Corpus{ "random", RandomCorpus(256 * 1024) });
+	corpora.push_back(Corpus{ "small", LogCorpus(1000) });
+
+	// the variants are compared in process, the api only with the variant that it selected
+	std::vector<const LZ4Kernels*> kernels = SupportedKernels();
+	LZ4Kernels api = ApiKernels();
+	if (argc > 1) { kernels.assign(1, &api); }
+	else { kernels.erase(kernels.begin()); kernels.push_back(&api); }
+
+	for (const LZ4Kernels* k : kernels) {
+		for (const Corpus& corpus : corpora) {
+			CheckCompression(k, corpus);
+			CheckDecompression(k, corpus);
+			CheckHashes(k, corpus);
+		}
+	}
+	printf("selected kernels: %s\n", LZ4_kernels());
+	return Result("lz4KernelsTest");
+}
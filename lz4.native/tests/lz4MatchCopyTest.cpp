@@ -0,0 +1,223 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4TestData.h"
+
+// overlapping matches with short offsets (the pshufb pattern expansion of the sse42, avx2 and avx512 decoders) against a byte by byte reference decoder
+// the blocks are written by hand, so every offset and length occurs at every position, including the end of the destination and matches into a dictionary
+
+using namespace lz4test;
+
+struct Sequence {
+	int literals;
+	int offset;
+	int matchLength; // 0: the last sequence, literals only
+};
+
+static void WriteLength(std::vector<char>& block, int length) {
+	for (; length >= 255; length -= 255) { block.push_back((char)255); }
+	block.push_back((char)length);
+}
+
+// the lz4 block of the sequences, with random literals
+static std::vector<char> WriteBlock(const std::vector<Sequence>& sequences, Random& random) {
+	std::vector<char> block;
+	for (const Sequence& sequence : sequences) {
+		int matchCode = sequence.matchLength == 0 ? 0 : sequence.matchLength - 4;
+		block.push_back((char)((std::min(sequence.literals, 15) << 4) | std::min(matchCode, 15)));
+		if (sequence.literals >= 15) { WriteLength(block, sequence.literals - 15); }
+		for (int i = 0; i < sequence.literals; i++) { block.push_back((char)('a' + random.Next(26))); }
+		if (sequence.matchLength == 0) { break; }
+		block.push_back((char)(sequence.offset & 0xFF));
+		block.push_back((char)(sequence.offset >> 8));
+		if (matchCode >= 15) { WriteLength(block, matchCode - 15); }
+	}
+	return block;
+}
+
+// the reference: one byte at a time, the dictionary is the history before the output
+static std::vector<char> ReferenceDecode(const std::vector<char>& block, const std::vector<char>& dictionary) {
+	std::vector<char> history = dictionary;
+	size_t ip = 0;
+	while (ip < block.size()) {
+		unsigned char token = (unsigned char)block[ip++];
+		size_t literals = token >> 4;
+		if (literals == 15) { unsigned char b; do { b = (unsigned char)block[ip++]; literals += b; } while (b == 255); }
+		history.insert(history.end(), block.begin() + (ptrdiff_t)ip, block.begin() + (ptrdiff_t)(ip + literals));
+		ip += literals;
+		if (ip >= block.size()) { break; }
+		size_t offset = (unsigned char)block[ip] | ((size_t)(unsigned char)block[ip + 1] << 8);
+		ip += 2;
+		size_t length = (token & 15);
+		if (length == 15) { unsigned char b; do { b = (unsigned char)block[ip++]; length += b; } while (b == 255); }
+		length += 4;
+		for (size_t i = 0; i < length; i++) { history.push_back(history[history.size() - offset]); }
+	}
+	return std::vector<char>(history.begin() + (ptrdiff_t)dictionary.size(), history.end());
+}
+
+// the output at a few alignments, with guard bytes after the capacity that must stay untouched
+static void CheckBlock(const LZ4Kernels* k, const std::vector<char>& block, const std::vector<char>& dictionary, const char* description) {
+	std::vector<char> expected = ReferenceDecode(block, dictionary);
+	const int guardSize = 64;
+	for (int alignment = 0; alignment < 4; alignment++) {
+		// the dictionary is directly before the output (prefix) and in a separate buffer (external dictionary)
+		for (int prefix = 0; prefix < (dictionary.empty() ? 1 : 2); prefix++) {
+			std::vector<char> buffer((size_t)alignment + dictionary.size() + expected.size() + guardSize, (char)0xCC);
+			std::vector<char> separate = dictionary;
+			char* dictionaryStart = prefix ? &buffer[(size_t)alignment] : separate.data();
+			if (prefix) { std::copy(dictionary.begin(), dictionary.end(), buffer.begin() + alignment); }
+			char* dst = &buffer[(size_t)alignment + dictionary.size()];
+
+			int result = dictionary.empty()
+				? k->decompress_safe(block.data(), dst, (int)block.size(), (int)expected.size())
+				: k->decompress_safe_usingDict(block.data(), dst, (int)block.size(), (int)expected.size(), dictionaryStart, (int)dictionary.size());
+			bool guard = std::all_of(dst + expected.size(), dst + expected.size() + guardSize, [](char c) { return c == (char)0xCC; });
+			LZ4TEST_CHECK(result == (int)expected.size() && memcmp(dst, expected.data(), expected.size()) == 0 && guard,
+				"%s: %s, alignment %d%s: %d", k->name, description, alignment, dictionary.empty() ? "" : prefix ? ", prefix dictionary" : ", external dictionary", result);
+
+			// one byte less room fails without writing past the capacity
+			if (!expected.empty()) {
+				std::fill(buffer.begin() + (ptrdiff_t)(alignment + dictionary.size()), buffer.end(), (char)0xCC);
+				result = dictionary.empty()
+					? k->decompress_safe(block.data(), dst, (int)block.size(), (int)expected.size() - 1)
+					: k->decompress_safe_usingDict(block.data(), dst, (int)block.size(), (int)expected.size() - 1, dictionaryStart, (int)dictionary.size());
+				guard = std::all_of(dst + expected.size() - 1, dst + expected.size() + guardSize, [](char c) { return c == (char)0xCC; });
+				LZ4TEST_CHECK(result < 0 && guard, "%s: %s, alignment %d: capacity too small: %d", k->name, description, alignment, result);
+			}
+		}
+	}
+
+	if (dictionary.empty()) {
+		std::vector<char> output(expected.size());
+		const char* source = block.data();
+		char* dst = output.data();
+		int compressedSize = (int)block.size(), capacity = (int)expected.size(), result = 0;
+		k->decompress_safe_batch(&source, &dst, &compressedSize, &capacity, &result, 1);
+		LZ4TEST_CHECK(result == (int)expected.size() && output == expected, "%s: %s: decompress_safe_batch %d", k->name, description, result);
+	}
+}
+
+static void TestShortOffsets(const LZ4Kernels* k) {
+	Random random(21);
+	char description[128];
+	const int offsets[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 31, 32, 33, 64 };
+	for (int offset : offsets) {
+		for (int length = 4; length <= 100; length++) {
+			// a single match, the literals before it are its pattern
+			// 12 literals after it: the decoder is in its careful loop near the end of the output, 100 literals: in its fast loop
+			for (int lead = 0; lead < 3; lead++) {
+				for (int tail : { 12, 100 }) {
+					std::vector<Sequence> sequences = { { offset + lead, offset, length }, { tail + lead, 0, 0 } };
+					snprintf(description, sizeof(description), "offset %d, length %d, %d literals before, %d after", offset, length, offset + lead, tail + lead);
+					CheckBlock(k, WriteBlock(sequences, random), std::vector<char>(), description);
+				}
+			}
+		}
+
+		// long matches with length bytes, and runs of matches without literals between them
+		const int longLengths[] = { 255, 256, 300, 1000, 4096 + 7 };
+		for (int length : longLengths) {
+			std::vector<Sequence> sequences = { { offset, offset, length }, { 0, offset, 4 + offset % 5 }, { 0, 1 + offset % 3, 19 }, { 1, offset, length / 3 }, { 100, 0, 0 } };
+			snprintf(description, sizeof(description), "offset %d, length %d, matches without literals", offset, length);
+			CheckBlock(k, WriteBlock(sequences, random), std::vector<char>(), description);
+		}
+	}
+
+	// the match ends at the last byte that a match may write, 5 literals before the end of the block (it starts at least 12 bytes before the end)
+	for (int offset = 1; offset <= 16; offset++) {
+		for (int length = 7; length <= 40; length++) {
+			std::vector<Sequence> sequences = { { offset, offset, length }, { 5, 0, 0 } };
+			snprintf(description, sizeof(description), "offset %d, length %d, 5 literals after", offset, length);
+			CheckBlock(k, WriteBlock(sequences, random), std::vector<char>(), description);
+		}
+	}
+}
+
+// matches that start in the dictionary and continue into the output
+static void TestDictionaryOffsets(const LZ4Kernels* k) {
+	Random random(22);
+	std::vector<char> dictionary(64);
+	for (char& c : dictionary) { c = (char)('A' + random.Next(26)); }
+	char description[128];
+	for (int offset = 1; offset <= 20; offset++) {
+		for (int literals = 0; literals < offset; literals += 3) {
+			const int lengths[] = { 4, 7, 15, 16, 19, 33, 64, 200 };
+			for (int length : lengths) {
+				for (int tail : { 12, 100 }) {
+					std::vector<Sequence> sequences = { { literals, offset, length }, { tail, 0, 0 } };
+					snprintf(description, sizeof(description), "dictionary offset %d, length %d, %d literals before, %d after", offset, length, literals, tail);
+					CheckBlock(k, WriteBlock(sequences, random), dictionary, description);
+				}
+			}
+		}
+	}
+}
+
+// offset 0 is a corrupted block: every loop of the decoder fails on it without writing past the capacity
+static void TestOffsetZero(const LZ4Kernels* k) {
+	Random random(23);
+	std::vector<char> dictionary(64, 'D');
+	const int guardSize = 64;
+	for (int literals : { 0, 1, 8, 20 }) {
+		for (int length : { 4, 7, 15, 16, 19, 40, 300 }) {
+			for (int tail : { 12, 100 }) {
+				std::vector<Sequence> sequences = { { literals, 0, length }, { tail, 0, 0 } };
+				std::vector<char> block = WriteBlock(sequences, random);
+				int size = literals + length + tail;
+				std::vector<char> buffer(dictionary.size() + (size_t)size + guardSize, (char)0xCC);
+				char* dst = &buffer[dictionary.size()];
+				int result = k->decompress_safe(block.data(), dst, (int)block.size(), size);
+				bool guard = std::all_of(dst + size, dst + size + guardSize, [](char c) { return c == (char)0xCC; });
+				LZ4TEST_CHECK(result < 0 && guard, "%s: offset 0, length %d, %d literals before, %d after: %d", k->name, length, literals, tail, result);
+
+				std::copy(dictionary.begin(), dictionary.end(), buffer.begin());
+				result = k->decompress_safe_usingDict(block.data(), dst, (int)block.size(), size, buffer.data(), (int)dictionary.size());
+				LZ4TEST_CHECK(result < 0, "%s: offset 0, length %d, %d literals before, %d after, prefix dictionary: %d", k->name, length, literals, tail, result);
+
+				const char* source = block.data();
+				int compressedSize = (int)block.size(), capacity = size;
+				result = 0;
+				k->decompress_safe_batch(&source, &dst, &compressedSize, &capacity, &result, 1);
+				LZ4TEST_CHECK(result < 0, "%s: offset 0, length %d, %d literals before, %d after: decompress_safe_batch %d", k->name, length, literals, tail, result);
+			}
+		}
+	}
+}
+
+int main() {
+	for (const LZ4Kernels* k : SupportedKernels()) {
+		TestShortOffsets(k);
+		TestDictionaryOffsets(k);
+		TestOffsetZero(k);
+	}
+	return Result("lz4MatchCopyTest");
+}
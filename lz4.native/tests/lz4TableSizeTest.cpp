@@ -0,0 +1,252 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#include "lz4Frame.h"
+#include "lz4TestData.h"
+
+// hash tables of every size: the streams of LZ4_createStreamEx and LZ4_createStreamHCEx, and the memoryUsage option of the frame encoder
+
+using namespace lz4::native;
+using namespace lz4test;
+
+static const int BlockSize = 64 * 1024;
+static const int FastMemoryUsages[] = { 12, 14, 16, 18 };
+static const int HCHashLogs[] = { 10, 12, 14, 15, 16 };
+
+// linked blocks with a dictionary, decoded with LZ4_decompress_safe_usingDict; returns the compressed blocks
+static std::vector<char> CompressStream(LZ4_stream_t* stream, LZ4_streamHC_t* streamHC, const std::vector<char>& data, const std::vector<char>& dictionary, const char* description) {
+	if (stream != NULL) { LZ4_loadDict(stream, dictionary.data(), (int)dictionary.size()); }
+	else { LZ4_loadDictHC(streamHC, dictionary.data(), (int)dictionary.size()); }
+
+	std::vector<char> blocks, block((size_t)LZ4_compressBound(BlockSize)), output(BlockSize);
+	bool roundTrip = true;
+	for (size_t offset = 0; offset < data.size(); offset += BlockSize) {
+		int size = (int)std::min<size_t>(BlockSize, data.size() - offset);
+		int compressedSize = stream != NULL
+			? LZ4_compress_fast_continue(stream, &data[offset], block.data(), size, (int)block.size(), 1)
+			: LZ4_compress_HC_continue(streamHC, &data[offset], block.data(), size, (int)block.size());
+		blocks.insert(blocks.end(), block.begin(), block.begin() + compressedSize);
+
+		const char* history = offset == 0 ? dictionary.data() : &data[offset - std::min<size_t>(offset, 64 * 1024)];
+		int historySize = offset == 0 ? (int)dictionary.size() : (int)std::min<size_t>(offset, 64 * 1024);
+		int result = LZ4_decompress_safe_usingDict(block.data(), output.data(), compressedSize, size, history, historySize);
+		roundTrip = roundTrip && result == size && memcmp(output.data(), &data[offset], (size_t)size) == 0;
+	}
+	LZ4TEST_CHECK(roundTrip, "%s: round trip", description);
+	return blocks;
+}
+
+static void TestStreams() {
+	std::vector<char> log = LogCorpus(1024 * 1024);
+	std::vector<char> dictionary(log.begin(), log.begin() + 64 * 1024);
+	std::vector<char> data(log.begin() + 64 * 1024, log.end());
+	char description[64];
+
+	LZ4_stream_t defaultStream;
+	LZ4_initStream(&defaultStream, sizeof(defaultStream));
+	std::vector<char> expected = CompressStream(&defaultStream, NULL, data, dictionary, "default stream");
+	for (int memoryUsage : FastMemoryUsages) {
+		snprintf(description, sizeof(description), "memory usage %d", memoryUsage);
+		LZ4_stream_t* stream = LZ4_createStreamEx(memoryUsage);
+		LZ4TEST_CHECK(stream != NULL && LZ4_sizeofStateEx(memoryUsage) >= (int)sizeof(LZ4_stream_t), "%s: create", description);
+		if (stream == NULL) { continue; }
+		std::vector<char> blocks = CompressStream(stream, NULL, data, dictionary, description);
+		// the default size is the same compressor
+		LZ4TEST_CHECK(memoryUsage != LZ4_MEMORY_USAGE || blocks == expected, "%s: differs from the default stream", description);
+
+		// the table size is kept by LZ4_resetStream_fast and LZ4_loadDict
+		LZ4_resetStream_fast(stream);
+		LZ4TEST_CHECK(CompressStream(stream, NULL, data, dictionary, description) == blocks, "%s: differs after LZ4_resetStream_fast", description);
+		LZ4_freeStream(stream);
+
+		std::vector<char> buffer((size_t)LZ4_sizeofStateEx(memoryUsage) + 8);
+		stream = LZ4_initStreamEx(buffer.data(), buffer.size(), memoryUsage);
+		LZ4TEST_CHECK(stream != NULL && CompressStream(stream, NULL, data, dictionary, description) == blocks, "%s: LZ4_initStreamEx", description);
+		LZ4TEST_CHECK(LZ4_initStreamEx(buffer.data(), (size_t)LZ4_sizeofStateEx(memoryUsage) - 1, memoryUsage) == NULL, "%s: LZ4_initStreamEx accepts a buffer that is too small", description);
+	}
+	const int invalid[] = { 0, 11, 13, 15, 17, 19 };
+	for (int memoryUsage : invalid) {
+		LZ4TEST_CHECK(memoryUsage == LZ4_MEMORY_USAGE || LZ4_sizeofStateEx(memoryUsage) == 0, "memory usage %d is accepted", memoryUsage);
+	}
+
+	std::vector<char> hcData(data.begin(), data.begin() + 256 * 1024);
+	LZ4_streamHC_t defaultStreamHC;
+	LZ4_initStreamHC(&defaultStreamHC, sizeof(defaultStreamHC));
+	LZ4_setCompressionLevel(&defaultStreamHC, 9);
+	expected = CompressStream(NULL, &defaultStreamHC, hcData, dictionary, "default HC stream");
+	for (int hashLog : HCHashLogs) {
+		snprintf(description, sizeof(description), "hash log %d", hashLog);
+		LZ4_streamHC_t* streamHC = LZ4_createStreamHCEx(hashLog);
+		LZ4TEST_CHECK(streamHC != NULL && LZ4_sizeofStateHCEx(hashLog) >= (int)sizeof(LZ4_streamHC_t), "%s: create", description);
+		if (streamHC == NULL) { continue; }
+		LZ4_setCompressionLevel(streamHC, 9);
+		std::vector<char> blocks = CompressStream(NULL, streamHC, hcData, dictionary, description);
+		LZ4TEST_CHECK(hashLog != LZ4HC_HASH_LOG || blocks == expected, "%s: differs from the default stream", description);
+		LZ4_resetStreamHC_fast(streamHC, 9);
+		LZ4TEST_CHECK(CompressStream(NULL, streamHC, hcData, dictionary, description) == blocks, "%s: differs after LZ4_resetStreamHC_fast", description);
+		LZ4_freeStreamHC(streamHC);
+
+		std::vector<char> buffer((size_t)LZ4_sizeofStateHCEx(hashLog) + 8);
+		streamHC = LZ4_initStreamHCEx(buffer.data(), buffer.size(), hashLog);
+		LZ4TEST_CHECK(streamHC != NULL && CompressStream(NULL, streamHC, hcData, dictionary, description) == blocks, "%s: LZ4_initStreamHCEx", description);
+		LZ4TEST_CHECK(LZ4_initStreamHCEx(buffer.data(), (size_t)LZ4_sizeofStateHCEx(hashLog) - 1, hashLog) == NULL, "%s: LZ4_initStreamHCEx accepts a buffer that is too small", description);
+	}
+	const int invalidHashLogs[] = { LZ4HC_HASH_LOG_MIN - 1, 11, 13, LZ4HC_HASH_LOG_MAX + 1 };
+	for (int hashLog : invalidHashLogs) {
+		LZ4TEST_CHECK(LZ4_sizeofStateHCEx(hashLog) == 0 && LZ4_createStreamHCEx(hashLog) == NULL, "hash log %d is accepted", hashLog);
+	}
+}
+
+static std::vector<char> CompressFrame(const std::vector<char>& data, int blockSizeId, bool independentBlocks, int level, int memoryUsage, const std::vector<char>* dictionary, const LZ4PreparedDictionary* prepared, int* status) {
+	LZ4FrameInfo info;
+	memset(&info, 0, sizeof(info));
+	info.blockSizeId = blockSizeId;
+	info.independentBlocks = independentBlocks;
+	info.contentChecksum = true;
+	LZ4FrameCompressionOptions options;
+	memset(&options, 0, sizeof(options));
+	options.compressionLevel = level;
+	options.acceleration = 1;
+	options.memoryUsage = memoryUsage;
+
+	LZ4FrameEncoder encoder;
+	*status = encoder.Init(&info, &options);
+	if (*status != LZ4Frame_OK) { return std::vector<char>(); }
+	if (prepared != NULL) { encoder.SetPreparedDictionary(prepared); }
+	else if (dictionary != NULL) { encoder.SetDictionary(dictionary->data(), (int)dictionary->size()); }
+	std::vector<char> frame((size_t)LZ4Frame_compressBound(&info, (long long)data.size(), 0));
+	int size = encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size());
+	if (size < 0) { *status = size; }
+	frame.resize(size < 0 ? 0 : (size_t)size);
+	return frame;
+}
+
+static void TestFrames() {
+	std::vector<char> log = LogCorpus(2 * 1024 * 1024);
+	std::vector<char> dictionary(log.begin(), log.begin() + 64 * 1024);
+	std::vector<char> data(log.begin() + 64 * 1024, log.end());
+	std::vector<char> hcData(data.begin(), data.begin() + 512 * 1024);
+	std::vector<char> output(data.size());
+
+	const int blockSizeIds[] = { 4, 7 };
+	std::vector<std::vector<char>> frames;
+	for (int blockSizeId : blockSizeIds) {
+		for (int independent = 0; independent < 2; independent++) {
+			for (int memoryUsage : { 0, 12, 14, 16, 18 }) {
+				int status;
+				std::vector<char> frame = CompressFrame(data, blockSizeId, independent != 0, 0, memoryUsage, NULL, NULL, &status);
+				int result = LZ4Frame_decompress(frame.data(), (int)frame.size(), output.data(), (int)output.size());
+				LZ4TEST_CHECK(status == LZ4Frame_OK && result == (int)data.size() && output == data, "fast, block size id %d, independent %d, memory usage %d: %d, %d", blockSizeId, independent, memoryUsage, status, result);
+				if (blockSizeId == 7 && independent == 0) { frames.push_back(frame); }
+			}
+		}
+	}
+	// 0 is the default size (14), every other size compresses differently
+	LZ4TEST_CHECK(frames[0] == frames[2] && frames[1] != frames[2] && frames[3] != frames[2] && frames[4] != frames[3], "the memory usage does not change the frames");
+	LZ4TEST_CHECK(frames[4].size() < frames[1].size(), "4 MB blocks: the 256 KB table compresses less than the 4 KB table: %d, %d", (int)frames[4].size(), (int)frames[1].size());
+
+	for (int level : { 4, 9, 12 }) {
+		for (int memoryUsage : { 0, 12, 14, 16, 17, 18 }) {
+			int status;
+			std::vector<char> frame = CompressFrame(hcData, 4, false, level, memoryUsage, NULL, NULL, &status);
+			int result = LZ4Frame_decompress(frame.data(), (int)frame.size(), output.data(), (int)output.size());
+			LZ4TEST_CHECK(status == LZ4Frame_OK && result == (int)hcData.size() && memcmp(output.data(), hcData.data(), hcData.size()) == 0, "level %d, memory usage %d: %d, %d", level, memoryUsage, status, result);
+		}
+	}
+
+	// sizes that the compressors do not have
+	const int invalid[][2] = { { 0, 11 }, { 0, 13 }, { 0, 19 }, { 9, 11 }, { 9, 13 }, { 9, LZ4HC_HASH_LOG_MAX + 3 } };
+	for (const int* levelAndMemoryUsage : invalid) {
+		int status;
+		CompressFrame(data, 4, false, levelAndMemoryUsage[0], levelAndMemoryUsage[1], NULL, NULL, &status);
+		LZ4TEST_CHECK(status == LZ4Frame_ErrorInvalidArgument, "level %d, memory usage %d is accepted: %d", levelAndMemoryUsage[0], levelAndMemoryUsage[1], status);
+	}
+
+	// dictionaries with every size, a prepared dictionary is loaded instead when its table size differs
+	for (int level : { 0, 9 }) {
+		LZ4PreparedDictionary prepared;
+		prepared.Init(dictionary.data(), (int)dictionary.size(), level != 0, false);
+		const std::vector<char>& input = level == 0 ? data : hcData;
+		std::vector<int> memoryUsages = level == 0 ? std::vector<int>{ 0, 12, 14, 16, 18 } : std::vector<int>{ 0, 12, 17, 18 };
+		for (int memoryUsage : memoryUsages) {
+			for (int independent = 0; independent < 2; independent++) {
+				int status;
+				std::vector<char> loaded = CompressFrame(input, 4, independent != 0, level, memoryUsage, &dictionary, NULL, &status);
+				std::vector<char> frame = CompressFrame(input, 4, independent != 0, level, memoryUsage, NULL, &prepared, &status);
+				int result = LZ4Frame_decompress_usingDict(frame.data(), (int)frame.size(), output.data(), (int)output.size(), dictionary.data(), (int)dictionary.size());
+				LZ4TEST_CHECK(status == LZ4Frame_OK && result == (int)input.size() && memcmp(output.data(), input.data(), input.size()) == 0, "level %d, memory usage %d, independent %d: prepared dictionary: %d, %d", level, memoryUsage, independent, status, result);
+				result = LZ4Frame_decompress_usingDict(loaded.data(), (int)loaded.size(), output.data(), (int)output.size(), dictionary.data(), (int)dictionary.size());
+				LZ4TEST_CHECK(result == (int)input.size() && memcmp(output.data(), input.data(), input.size()) == 0, "level %d, memory usage %d, independent %d: dictionary: %d", level, memoryUsage, independent, result);
+			}
+		}
+	}
+}
+
+// SetMemoryUsage between frames, the encoder writes the frames of an encoder that is initialized with that size
+static void TestSetMemoryUsage() {
+	std::vector<char> data = LogCorpus(512 * 1024);
+	for (int level : { 0, 9 }) {
+		LZ4FrameInfo info;
+		memset(&info, 0, sizeof(info));
+		info.blockSizeId = 4;
+		info.contentChecksum = true;
+		LZ4FrameCompressionOptions options;
+		memset(&options, 0, sizeof(options));
+		options.compressionLevel = level;
+		options.acceleration = 1;
+		LZ4FrameEncoder encoder;
+		encoder.Init(&info, &options);
+		std::vector<char> frame((size_t)LZ4Frame_compressBound(&info, (long long)data.size(), 0));
+
+		std::vector<int> memoryUsages = level == 0 ? std::vector<int>{ 16, 12, 0, 18 } : std::vector<int>{ 12, 18, 0, 14 };
+		for (int memoryUsage : memoryUsages) {
+			int status = encoder.SetMemoryUsage(memoryUsage);
+			int size = encoder.CompressFrames(data.data(), (int)data.size(), 0, frame.data(), (int)frame.size());
+			int expectedStatus;
+			std::vector<char> expected = CompressFrame(data, 4, false, level, memoryUsage, NULL, NULL, &expectedStatus);
+			LZ4TEST_CHECK(status == LZ4Frame_OK && size == (int)expected.size() && memcmp(frame.data(), expected.data(), expected.size()) == 0, "level %d: SetMemoryUsage(%d): %d", level, memoryUsage, status);
+		}
+
+		// not within a frame
+		encoder.BeginFrame(frame.data(), (int)frame.size());
+		encoder.CompressBlock(data.data(), BlockSize, frame.data(), (int)frame.size());
+		LZ4TEST_CHECK(encoder.SetMemoryUsage(level == 0 ? 14 : 16) == LZ4Frame_ErrorInvalidArgument, "level %d: SetMemoryUsage within a frame", level);
+	}
+}
+
+int main() {
+	TestStreams();
+	TestFrames();
+	TestSetMemoryUsage();
+	return Result("lz4TableSizeTest");
+}
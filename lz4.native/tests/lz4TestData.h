@@ -0,0 +1,256 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4Kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// the corpora, checks and timing of the tests and benchmarks of lz4.native
+namespace lz4test {
+
+	inline int& Failures() {
+		static int failures = 0;
+		return failures;
+	}
+
+	// the tests report every failed check and return 1 from main
+#define LZ4TEST_CHECK(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s(%d): check failed: %s: ", __FILE__, __LINE__, #condition); \
+			fprintf(stderr, __VA_ARGS__); \
+			fprintf(stderr, "\n"); \
+			lz4test::Failures()++; \
+		} \
+	} while (0)
+
+	inline int Result(const char* name) {
+		if (Failures() != 0) { printf("%s: %d checks failed\n", name, Failures()); return 1; }
+		printf("%s: passed\n", name);
+		return 0;
+	}
+
+	// deterministic, the corpora are the same on every run and platform
+	class Random {
+	public:
+		explicit Random(unsigned int seed) : _state(seed * 2654435761u + 1) {}
+
+		unsigned int Next() {
+			_state = _state * 6364136223846793005ull + 1442695040888963407ull;
+			return (unsigned int)(_state >> 33);
+		}
+		unsigned int Next(unsigned int bound) { return Next() % bound; }
+
+	private:
+		unsigned long long _state;
+	};
+
+	// log lines with json payloads: repeated keys, changing numbers and identifiers
+	inline std::vector<char> LogCorpus(size_t size, unsigned int seed = 1) {
+		static const char* const levels[] = { "INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR" };
+		static const char* const services[] = { "ingest", "cache", "auth", "billing", "search", "gateway" };
+		static const char* const messages[] = { "request completed", "cache miss", "token refreshed", "retrying upstream call", "queue drained", "connection reset by peer" };
+		Random random(seed);
+		std::string text;
+		char line[512];
+		unsigned long long timestamp = 1700000000000ull;
+		while (text.size() < size) {
+			timestamp += random.Next(2000);
+			int length = snprintf(line, sizeof(line), "{\"ts\":%llu,\"level\":\"%s\",\"service\":\"%s\",\"msg\":\"%s\",\"user\":\"u%05u\",\"latency_ms\":%u,\"bytes\":%u,\"trace\":\"%08x%08x\"}\n",
+				timestamp, levels[random.Next(6)], services[random.Next(6)], messages[random.Next(6)], random.Next(20000), random.Next(900), random.Next(1u << 20), random.Next(), random.Next());
+			text.append(line, (size_t)length);
+		}
+		return std::vector<char>(text.begin(), text.begin() + (std::ptrdiff_t)size);
+	}
+
+	// natural language like text, words with a skewed frequency
+	inline std::vector<char> TextCorpus(size_t size, unsigned int seed = 2) {
+		static const char* const words[] = { "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be", "by", "on", "not", "he", "this", "are",
+			"compression", "block", "frame", "stream", "dictionary", "window", "match", "literal", "offset", "length", "buffer", "decoder", "encoder", "history", "checksum" };
+		const unsigned int count = sizeof(words) / sizeof(words[0]);
+		Random random(seed);
+		std::string text;
+		while (text.size() < size) {
+			// the square favors the first words
+			unsigned int r = random.Next(count);
+			text += words[r * r / count];
+			unsigned int separator = random.Next(20);
+			text += separator == 0 ? ".\n" : separator == 1 ? ", " : " ";
+		}
+		return std::vector<char>(text.begin(), text.begin() + (std::ptrdiff_t)size);
+	}
+
+	// fixed size records of integers, small values and a few floats
+	inline std::vector<char> BinaryCorpus(size_t size, unsigned int seed = 3) {
+		Random random(seed);
+		std::vector<char> data(size);
+		unsigned int id = 1000;
+		for (size_t i = 0; i + 32 <= size; i += 32) {
+			unsigned int record[8] = { id++, random.Next(16), random.Next(1000), 0, random.Next(), 0x3F800000u + random.Next(1u << 16), random.Next(4), 0 };
+			memcpy(&data[i], record, sizeof(record));
+		}
+		return data;
+	}
+
+	// runs of short repeating patterns (period 1 to 64) and long repeats of earlier data, the matches are long
+	inline std::vector<char> RepetitiveCorpus(size_t size, unsigned int seed = 4) {
+		Random random(seed);
+		std::vector<char> data(size);
+		size_t position = 0;
+		while (position < size) {
+			size_t length = 64 + random.Next(4096);
+			if (length > size - position) { length = size - position; }
+			if (random.Next(2) == 0 || position < 65536) {
+				unsigned int period = 1 + random.Next(random.Next(2) == 0 ? 16 : 64);
+				for (unsigned int i = 0; i < period && i < length; i++) { data[position + i] = (char)random.Next(256); }
+				for (size_t i = period; i < length; i++) { data[position + i] = data[position + i - period]; }
+			}
+			else {
+				size_t distance = 1 + random.Next(65535);
+				for (size_t i = 0; i < length; i++) { data[position + i] = data[position - distance + i]; }
+				data[position + random.Next((unsigned int)length)] ^= 1;
+			}
+			position += length;
+		}
+		return data;
+	}
+
+	inline std::vector<char> RandomCorpus(size_t size, unsigned int seed = 5) {
+		Random random(seed);
+		std::vector<char> data(size);
+		for (size_t i = 0; i < size; i++) { data[i] = (char)random.Next(256); }
+		return data;
+	}
+
+	struct Corpus {
+		std::string name;
+		std::vector<char> data;
+	};
+
+	// the generated corpora of size bytes each
+	inline std::vector<Corpus> GeneratedCorpora(size_t size) {
+		std::vector<Corpus> corpora;
+		corpora.push_back(Corpus{ "log", LogCorpus(size) });
+		corpora.push_back(Corpus{ "text", TextCorpus(size) });
+		corpora.push_back(Corpus{ "binary", BinaryCorpus(size) });
+		corpora.push_back(Corpus{ "repetitive", RepetitiveCorpus(size) });
+		return corpora;
+	}
+
+	// the files that are passed on the command line (benchmarks), or the generated corpora of size bytes each
+	inline std::vector<Corpus> Corpora(int argc, char** argv, size_t size) {
+		std::vector<Corpus> corpora;
+		for (int i = 1; i < argc; i++) {
+			FILE* file = fopen(argv[i], "rb");
+			if (file == NULL) { fprintf(stderr, "cannot open %s\n", argv[i]); exit(2); }
+			Corpus corpus;
+			corpus.name = argv[i];
+			char buffer[65536];
+			size_t read;
+			while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) { corpus.data.insert(corpus.data.end(), buffer, buffer + read); }
+			fclose(file);
+			corpora.push_back(corpus);
+		}
+		if (corpora.empty() && size > 0) { corpora = GeneratedCorpora(size); }
+		return corpora;
+	}
+
+	// a case of a benchmark: the corpora it measures when no files are passed, run returns 1 when a roundtrip fails
+	struct BenchCase {
+		const char* name;
+		std::vector<Corpus> (*corpora)();
+		int (*run)(const std::vector<Corpus>& corpora);
+	};
+
+	// usage: benchmark [case] [files], every case when none is named, the corpora of the case when no files are passed
+	inline int RunBenchCases(int argc, char** argv, const BenchCase* cases, size_t count) {
+		size_t first = 0, last = count;
+		if (argc > 1) {
+			for (size_t i = 0; i < count; i++) {
+				if (strcmp(argv[1], cases[i].name) == 0) { first = i; last = i + 1; argc--; argv++; break; }
+			}
+		}
+		std::vector<Corpus> files = Corpora(argc, argv, 0);
+		for (size_t i = first; i < last; i++) {
+			if (last - first > 1) { printf("%s[%s]\n", i > first ? "\n" : "", cases[i].name); }
+			int status = cases[i].run(files.empty() ? cases[i].corpora() : files);
+			if (status != 0) { return status; }
+		}
+		return 0;
+	}
+
+	inline double Now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// runs run() for at least 0.25 s in each of 3 rounds, returns the best throughput in MB/s of bytes per run
+	template<typename Run>
+	double Throughput(size_t bytes, Run run) {
+		double best = 0;
+		for (int round = 0; round < 3; round++) {
+			long long runs = 0;
+			double start = Now(), elapsed;
+			do {
+				run();
+				runs++;
+				elapsed = Now() - start;
+			} while (elapsed < 0.25);
+			double throughput = (double)bytes * (double)runs / elapsed / 1e6;
+			if (throughput > best) { best = throughput; }
+		}
+		return best;
+	}
+
+	// the kernels of every instruction set that the cpu supports (LZ4_KERNELS lowers it), baseline first
+	inline std::vector<const LZ4Kernels*> SupportedKernels() {
+		std::vector<const LZ4Kernels*> kernels;
+		kernels.push_back(&LZ4Kernels_baseline);
+#if LZ4_KERNELS_X86
+		const LZ4Kernels* const variants[] = { &LZ4Kernels_sse42, &LZ4Kernels_avx2, &LZ4Kernels_avx512 };
+		const char* selected = LZ4_kernels();
+		if (strcmp(selected, LZ4Kernels_baseline.name) != 0) {
+			for (const LZ4Kernels* variant : variants) {
+				kernels.push_back(variant);
+				if (strcmp(selected, variant->name) == 0) { break; }
+			}
+		}
+#endif
+		return kernels;
+	}
+}
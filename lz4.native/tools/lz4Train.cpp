@@ -0,0 +1,126 @@
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4DictionaryTrainer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// trains a dictionary for small messages from sample files (lz4DictionaryTrainer.h), the dictionary is written as a raw file for LZ4Stream and lz4 -D
+
+using namespace lz4::native;
+
+static int Usage() {
+	fprintf(stderr,
+		"usage: lz4Train [-o dictionary] [-c capacity] [-k segmentSize -d dmerSize] [-l] samples...\n"
+		"  -o  the dictionary file, default: dictionary\n"
+		"  -c  the maximum size of the dictionary, default and maximum: %d\n"
+		"  -k  the segment size (%d or more) and -d the dmer size (%d-%d), default: the best for the held-out samples\n"
+		"  -l  every line of the files is a sample, default: every file is a sample\n",
+		LZ4FRAME_DICTIONARY_SIZE_MAX, LZ4DICTIONARY_SEGMENT_SIZE_MIN, LZ4DICTIONARY_DMER_SIZE_MIN, LZ4DICTIONARY_DMER_SIZE_MAX);
+	return 2;
+}
+
+static bool ReadFile(const char* path, std::vector<char>& data) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) { return false; }
+	char buffer[65536];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) { data.insert(data.end(), buffer, buffer + read); }
+	bool failed = ferror(file) != 0;
+	fclose(file);
+	return !failed;
+}
+
+int main(int argc, char** argv) {
+	const char* output = "dictionary";
+	int capacity = LZ4FRAME_DICTIONARY_SIZE_MAX;
+	LZ4DictionaryTrainerParameters parameters;
+	memset(&parameters, 0, sizeof(parameters));
+	bool lines = false;
+
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i++) {
+		const char* option = argv[i];
+		if (strcmp(option, "-l") == 0) { lines = true; continue; }
+		if (option[1] == '\0' || option[2] != '\0' || i + 1 >= argc) { return Usage(); }
+		const char* value = argv[++i];
+		switch (option[1]) {
+			case 'o': output = value; break;
+			case 'c': capacity = atoi(value); break;
+			case 'k': parameters.segmentSize = atoi(value); break;
+			case 'd': parameters.dmerSize = atoi(value); break;
+			default: return Usage();
+		}
+	}
+	if (i >= argc) { return Usage(); }
+
+	std::vector<char> samples;
+	std::vector<int> sampleSizes;
+	for (; i < argc; i++) {
+		size_t begin = samples.size();
+		if (!ReadFile(argv[i], samples)) { fprintf(stderr, "cannot read %s\n", argv[i]); return 2; }
+		if (samples.size() - begin > (size_t)0x7FFFFFFF) { fprintf(stderr, "%s: too large for a sample\n", argv[i]); return 2; }
+		if (!lines) {
+			sampleSizes.push_back((int)(samples.size() - begin));
+			continue;
+		}
+		// the line feed stays with its line
+		for (size_t position = begin; position < samples.size();) {
+			const char* end = (const char*)memchr(&samples[position], '\n', samples.size() - position);
+			size_t next = end != NULL ? (size_t)(end - samples.data()) + 1 : samples.size();
+			sampleSizes.push_back((int)(next - position));
+			position = next;
+		}
+	}
+	if (sampleSizes.empty()) { fprintf(stderr, "no samples\n"); return 2; }
+
+	std::vector<char> dictionary((size_t)(capacity > 0 ? capacity : 1));
+	LZ4DictionaryTrainerResult result;
+	int size = LZ4Dictionary_train(dictionary.data(), capacity, samples.data(), sampleSizes.data(), (int)sampleSizes.size(), &parameters, &result);
+	if (LZ4Frame_isError(size)) { fprintf(stderr, "training failed: %s\n", LZ4Frame_getErrorName(size)); return 1; }
+
+	FILE* file = fopen(output, "wb");
+	if (file == NULL) { fprintf(stderr, "cannot create %s\n", output); return 2; }
+	bool written = fwrite(dictionary.data(), 1, (size_t)size, file) == (size_t)size;
+	written = fclose(file) == 0 && written;
+	if (!written) { fprintf(stderr, "cannot write %s\n", output); return 1; }
+
+	printf("%s: %d bytes from %d samples (%llu bytes), segment size %d, dmer size %d\n", output, size, (int)sampleSizes.size(), (unsigned long long)samples.size(), result.segmentSize, result.dmerSize);
+	if (result.evaluatedSamples > 0) {
+		printf("%d held-out samples (%lld bytes): ratio %.3f without and %.3f with the dictionary\n", result.evaluatedSamples, result.evaluatedSize,
+			(double)result.evaluatedSize / (double)result.compressedSize, (double)result.evaluatedSize / (double)result.compressedSizeWithDictionary);
+	}
+	return 0;
+}
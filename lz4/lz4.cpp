@@ -434,6 +434,43 @@ static const int      dec64table[8] = {0, 0, 0, -1, -4,  1, 2, 3};
 
 #if LZ4_FAST_DEC_LOOP
 
+/* lz4.native compiles the decoder for sse42, avx2 and avx512 as well (lz4KernelsSSE42.cpp, lz4KernelsAVX2.cpp, lz4KernelsAVX512.cpp),
+ * these variants expand the matches with an offset < 16 with pshufb and copy the literals 32 bytes at a time (avx2)
+ * LZ4_KERNELS_SSE42 : defined by the sse42 variant, msvc does not define __SSSE3__ */
+#if defined(LZ4_KERNELS_SSE42) || defined(__SSSE3__) || defined(__AVX2__)
+#  include <immintrin.h>
+#  define LZ4_SHUFFLE_COPY 1
+
+/* LZ4_offsetPattern[offset] : i % offset, the source bytes of a match that repeats its first offset bytes
+ * (offset 0 is invalid, LZ4_decompress_generic() rejects it before a match is copied, its row is never used) */
+static const BYTE LZ4_offsetPattern[16][32] = {
+    { 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+      0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80 },
+    { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 },
+    { 0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1 },
+    { 0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1 },
+    { 0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3 },
+    { 0,1,2,3,4,0,1,2,3,4,0,1,2,3,4,0,1,2,3,4,0,1,2,3,4,0,1,2,3,4,0,1 },
+    { 0,1,2,3,4,5,0,1,2,3,4,5,0,1,2,3,4,5,0,1,2,3,4,5,0,1,2,3,4,5,0,1 },
+    { 0,1,2,3,4,5,6,0,1,2,3,4,5,6,0,1,2,3,4,5,6,0,1,2,3,4,5,6,0,1,2,3 },
+    { 0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7 },
+    { 0,1,2,3,4,5,6,7,8,0,1,2,3,4,5,6,7,8,0,1,2,3,4,5,6,7,8,0,1,2,3,4 },
+    { 0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1 },
+    { 0,1,2,3,4,5,6,7,8,9,10,0,1,2,3,4,5,6,7,8,9,10,0,1,2,3,4,5,6,7,8,9 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,0,1,2,3,4,5,6,7,8,9,10,11,0,1,2,3,4,5,6,7 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,0,1,2,3,4,5,6,7,8,9,10,11,12,0,1,2,3,4,5 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,0,1,2,3,4,5,6,7,8,9,10,11,12,13,0,1,2,3 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,0,1 }
+};
+
+/* LZ4_offsetStep[offset] : the largest multiple of offset in one store */
+#  if defined(__AVX2__)
+static const BYTE LZ4_offsetStep[16] = { 32, 32, 32, 30, 32, 30, 30, 28, 32, 27, 30, 22, 24, 26, 28, 30 };
+#  else
+static const BYTE LZ4_offsetStep[16] = { 16, 16, 16, 15, 16, 15, 12, 14, 16, 9, 10, 11, 12, 13, 14, 15 };
+#  endif
+#endif
+
 LZ4_FORCE_INLINE void
 LZ4_memcpy_using_offset_base(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset)
 {
@@ -470,12 +507,46 @@ LZ4_wildCopy32(void* dstPtr, const void* srcPtr, void* dstEnd)
     do { LZ4_memcpy(d,s,16); LZ4_memcpy(d+16,s+16,16); d+=32; s+=32; } while (d<e);
 }
 
+/* LZ4_wildCopyLiterals32() :
+ * LZ4_wildCopy32() for the literals, the source is the input : it doesn't overlap the output,
+ * or it lies after it when decompressing in place, so each 32 byte load can precede its store */
+LZ4_FORCE_INLINE void
+LZ4_wildCopyLiterals32(void* dstPtr, const void* srcPtr, void* dstEnd)
+{
+#if defined(__AVX2__)
+    BYTE* d = (BYTE*)dstPtr;
+    const BYTE* s = (const BYTE*)srcPtr;
+    BYTE* const e = (BYTE*)dstEnd;
+
+    do { _mm256_storeu_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s)); d+=32; s+=32; } while (d<e);
+#else
+    LZ4_wildCopy32(dstPtr, srcPtr, dstEnd);
+#endif
+}
+
 /* LZ4_memcpy_using_offset()  presumes :
  * - dstEnd >= dstPtr + MINMATCH
- * - there is at least 8 bytes available to write after dstEnd */
+ * - there is at least 8 bytes available to write after dstEnd (LZ4_SHUFFLE_COPY: 32 bytes, and offset < 16) */
 LZ4_FORCE_INLINE void
 LZ4_memcpy_using_offset(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset)
 {
+#if defined(LZ4_SHUFFLE_COPY)
+    assert(dstEnd >= dstPtr + MINMATCH);
+    assert(offset < 16);
+    {   /* the pattern repeats every offset bytes, the stores advance by a multiple of offset */
+#  if defined(__AVX2__)
+        __m256i const pattern = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)srcPtr)),
+                                                    _mm256_loadu_si256((const __m256i*)LZ4_offsetPattern[offset]));
+        size_t const step = LZ4_offsetStep[offset];
+        do { _mm256_storeu_si256((__m256i*)dstPtr, pattern); dstPtr += step; } while (dstPtr < dstEnd);
+#  else
+        __m128i const pattern = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)srcPtr),
+                                                 _mm_loadu_si128((const __m128i*)LZ4_offsetPattern[offset]));
+        size_t const step = LZ4_offsetStep[offset];
+        do { _mm_storeu_si128((__m128i*)dstPtr, pattern); dstPtr += step; } while (dstPtr < dstEnd);
+#  endif
+    }
+#else
     BYTE v[8];
 
     assert(dstEnd >= dstPtr + MINMATCH);
@@ -504,6 +575,7 @@ LZ4_memcpy_using_offset(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const si
         LZ4_memcpy(dstPtr, v, 8);
         dstPtr += 8;
     }
+#endif
 }
 #endif
 
@@ -599,6 +671,87 @@ static unsigned LZ4_NbCommonBytes (reg_t val)
 }
 
 
+/*-************************************
+*  Vectorized comparisons
+*  lz4.native compiles the kernels for avx2 and avx512 as well (lz4KernelsAVX2.cpp, lz4KernelsAVX512.cpp),
+*  these variants compare LZ4_VECTOR_SIZE bytes per step
+**************************************/
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#  include <immintrin.h>
+#  if defined(__AVX512BW__)
+#    define LZ4_VECTOR_SIZE 64
+#    define LZ4_VECTOR_MASK (~(U64)0)
+#  else
+#    define LZ4_VECTOR_SIZE 32
+#    define LZ4_VECTOR_MASK ((U64)0xFFFFFFFF)
+#  endif
+
+/* LZ4_vectorEqual() :
+ * @return : bit i is set when p1[i] == p2[i] (LZ4_VECTOR_SIZE bytes) */
+LZ4_FORCE_INLINE U64 LZ4_vectorEqual(const BYTE* p1, const BYTE* p2)
+{
+#  if defined(__AVX512BW__)
+    return (U64)_mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)p1), _mm512_loadu_si512((const void*)p2));
+#  else
+    return (U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p1), _mm256_loadu_si256((const __m256i*)p2)));
+#  endif
+}
+
+/* LZ4_vectorEqualPattern() :
+ * @return : bit i is set when p[i] is equal to the repeated 4-byte pattern (LZ4_VECTOR_SIZE bytes) */
+LZ4_FORCE_INLINE U64 LZ4_vectorEqualPattern(const BYTE* p, U32 pattern)
+{
+#  if defined(__AVX512BW__)
+    return (U64)_mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)p), _mm512_set1_epi32((int)pattern));
+#  else
+    return (U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), _mm256_set1_epi32((int)pattern)));
+#  endif
+}
+
+/* LZ4_vectorLowEqual() :
+ * @return : nb of equal bytes at the start of the compared bytes, diff = ~equal & LZ4_VECTOR_MASK (not 0) */
+LZ4_FORCE_INLINE unsigned LZ4_vectorLowEqual(U64 diff)
+{
+    assert(diff != 0);
+#  if defined(_MSC_VER) && defined(_WIN64)
+    {   unsigned long r;
+        _BitScanForward64(&r, diff);
+        return (unsigned)r;
+    }
+#  elif defined(_MSC_VER)
+    {   unsigned long r;
+        if (_BitScanForward(&r, (U32)diff)) return (unsigned)r;
+        _BitScanForward(&r, (U32)(diff >> 32));
+        return (unsigned)r + 32;
+    }
+#  else
+    return (unsigned)__builtin_ctzll(diff);
+#  endif
+}
+
+/* LZ4_vectorHighEqual() :
+ * @return : nb of equal bytes at the end of the compared bytes, diff = ~equal & LZ4_VECTOR_MASK (not 0) */
+LZ4_FORCE_INLINE unsigned LZ4_vectorHighEqual(U64 diff)
+{
+    assert(diff != 0);
+#  if defined(_MSC_VER) && defined(_WIN64)
+    {   unsigned long r;
+        _BitScanReverse64(&r, diff);
+        return (unsigned)(LZ4_VECTOR_SIZE - 1 - r);
+    }
+#  elif defined(_MSC_VER)
+    {   unsigned long r;
+        if (_BitScanReverse(&r, (U32)(diff >> 32))) return (unsigned)(LZ4_VECTOR_SIZE - 1 - (r + 32));
+        _BitScanReverse(&r, (U32)diff);
+        return (unsigned)(LZ4_VECTOR_SIZE - 1 - r);
+    }
+#  else
+    return (unsigned)__builtin_clzll(diff) - (64 - LZ4_VECTOR_SIZE);
+#  endif
+}
+#endif
+
+
 #define STEPSIZE sizeof(reg_t)
 LZ4_FORCE_INLINE
 unsigned LZ4_count(const BYTE* pIn, const BYTE* pMatch, const BYTE* pInLimit)
@@ -613,6 +766,16 @@ unsigned LZ4_count(const BYTE* pIn, const BYTE* pMatch, const BYTE* pInLimit)
             return LZ4_NbCommonBytes(diff);
     }   }
 
+#if defined(LZ4_VECTOR_SIZE)
+    /* long matches */
+    while (likely(pIn < pInLimit-(LZ4_VECTOR_SIZE-1))) {
+        U64 const diff = ~LZ4_vectorEqual(pMatch, pIn) & LZ4_VECTOR_MASK;
+        if (!diff) { pIn+=LZ4_VECTOR_SIZE; pMatch+=LZ4_VECTOR_SIZE; continue; }
+        pIn += LZ4_vectorLowEqual(diff);
+        return (unsigned)(pIn - pStart);
+    }
+#endif
+
     while (likely(pIn < pInLimit-(STEPSIZE-1))) {
         reg_t const diff = LZ4_read_ARCH(pMatch) ^ LZ4_read_ARCH(pIn);
         if (!diff) { pIn+=STEPSIZE; pMatch+=STEPSIZE; continue; }
@@ -675,6 +838,18 @@ const char* LZ4_versionString(void) { return LZ4_VERSION_STRING; }
 int LZ4_compressBound(int isize)  { return LZ4_COMPRESSBOUND(isize); }
 int LZ4_sizeofState(void) { return LZ4_STREAMSIZE; }
 
+/* table size of a stream, a zeroed stream (LZ4_initStream()) uses LZ4_MEMORY_USAGE */
+LZ4_FORCE_INLINE U32 LZ4_streamMemoryUsage(const LZ4_stream_t_internal* ctx)
+{
+    return ctx->memoryUsage ? ctx->memoryUsage : LZ4_MEMORY_USAGE;
+}
+
+/* size of the state fields and a table of (1 << memoryUsage) bytes, the table is the last field */
+static size_t LZ4_sizeofStreamInternal(U32 memoryUsage)
+{
+    return offsetof(LZ4_stream_t_internal, hashTable) + ((size_t)1 << memoryUsage);
+}
+
 
 /*-************************************
 *  Internal Definitions used in Tests
@@ -696,17 +871,19 @@ int LZ4_decompress_safe_forceExtDict(const char* source, char* dest,
 /*-******************************
 *  Compression functions
 ********************************/
-LZ4_FORCE_INLINE U32 LZ4_hash4(U32 sequence, tableType_t const tableType)
+/* memoryUsage : log2 of the hash table size in bytes (LZ4_MEMORY_USAGE, or the size selected by LZ4_initStreamEx()).
+ * It is a compile time constant in LZ4_compress_generic_validated(), see LZ4_compress_generic(). */
+LZ4_FORCE_INLINE U32 LZ4_hash4(U32 sequence, tableType_t const tableType, U32 const memoryUsage)
 {
     if (tableType == byU16)
-        return ((sequence * 2654435761U) >> ((MINMATCH*8)-(LZ4_HASHLOG+1)));
+        return ((sequence * 2654435761U) >> ((MINMATCH*8)-(memoryUsage-1)));
     else
-        return ((sequence * 2654435761U) >> ((MINMATCH*8)-LZ4_HASHLOG));
+        return ((sequence * 2654435761U) >> ((MINMATCH*8)-(memoryUsage-2)));
 }
 
-LZ4_FORCE_INLINE U32 LZ4_hash5(U64 sequence, tableType_t const tableType)
+LZ4_FORCE_INLINE U32 LZ4_hash5(U64 sequence, tableType_t const tableType, U32 const memoryUsage)
 {
-    const U32 hashLog = (tableType == byU16) ? LZ4_HASHLOG+1 : LZ4_HASHLOG;
+    const U32 hashLog = (tableType == byU16) ? memoryUsage-1 : memoryUsage-2;
     if (LZ4_isLittleEndian()) {
         const U64 prime5bytes = 889523592379ULL;
         return (U32)(((sequence << 24) * prime5bytes) >> (64 - hashLog));
@@ -716,10 +893,10 @@ LZ4_FORCE_INLINE U32 LZ4_hash5(U64 sequence, tableType_t const tableType)
     }
 }
 
-LZ4_FORCE_INLINE U32 LZ4_hashPosition(const void* const p, tableType_t const tableType)
+LZ4_FORCE_INLINE U32 LZ4_hashPosition(const void* const p, tableType_t const tableType, U32 const memoryUsage)
 {
-    if ((sizeof(reg_t)==8) && (tableType != byU16)) return LZ4_hash5(LZ4_read_ARCH(p), tableType);
-    return LZ4_hash4(LZ4_read32(p), tableType);
+    if ((sizeof(reg_t)==8) && (tableType != byU16)) return LZ4_hash5(LZ4_read_ARCH(p), tableType, memoryUsage);
+    return LZ4_hash4(LZ4_read32(p), tableType, memoryUsage);
 }
 
 LZ4_FORCE_INLINE void LZ4_clearHash(U32 h, void* tableBase, tableType_t const tableType)
@@ -759,9 +936,9 @@ LZ4_FORCE_INLINE void LZ4_putPositionOnHash(const BYTE* p, U32 h,
     }
 }
 
-LZ4_FORCE_INLINE void LZ4_putPosition(const BYTE* p, void* tableBase, tableType_t tableType, const BYTE* srcBase)
+LZ4_FORCE_INLINE void LZ4_putPosition(const BYTE* p, void* tableBase, tableType_t tableType, const BYTE* srcBase, U32 const memoryUsage)
 {
-    U32 const h = LZ4_hashPosition(p, tableType);
+    U32 const h = LZ4_hashPosition(p, tableType, memoryUsage);
     LZ4_putPositionOnHash(p, h, tableBase, tableType, srcBase);
 }
 
@@ -776,12 +953,12 @@ LZ4_FORCE_INLINE U32 LZ4_getIndexOnHash(U32 h, const void* tableBase, tableType_
     LZ4_STATIC_ASSERT(LZ4_MEMORY_USAGE > 2);
     if (tableType == byU32) {
         const U32* const hashTable = (const U32*) tableBase;
-        assert(h < (1U << (LZ4_MEMORY_USAGE-2)));
+        assert(h < (1U << (LZ4_MEMORY_USAGE_MAX-2)));
         return hashTable[h];
     }
     if (tableType == byU16) {
         const U16* const hashTable = (const U16*) tableBase;
-        assert(h < (1U << (LZ4_MEMORY_USAGE-1)));
+        assert(h < (1U << (LZ4_MEMORY_USAGE_MAX-1)));
         return hashTable[h];
     }
     assert(0); return 0;  /* forbidden case */
@@ -797,9 +974,9 @@ static const BYTE* LZ4_getPositionOnHash(U32 h, const void* tableBase, tableType
 LZ4_FORCE_INLINE const BYTE*
 LZ4_getPosition(const BYTE* p,
                 const void* tableBase, tableType_t tableType,
-                const BYTE* srcBase)
+                const BYTE* srcBase, U32 const memoryUsage)
 {
-    U32 const h = LZ4_hashPosition(p, tableType);
+    U32 const h = LZ4_hashPosition(p, tableType, memoryUsage);
     return LZ4_getPositionOnHash(h, tableBase, tableType, srcBase);
 }
 
@@ -807,6 +984,7 @@ LZ4_FORCE_INLINE void
 LZ4_prepareTable(LZ4_stream_t_internal* const cctx,
            const int inputSize,
            const tableType_t tableType) {
+    U32 const memoryUsage = LZ4_streamMemoryUsage(cctx);
     /* If the table hasn't been used, it's guaranteed to be zeroed out, and is
      * therefore safe to use no matter what mode we're in. Otherwise, we figure
      * out if it's safe to leave as is or whether it needs to be reset.
@@ -820,7 +998,7 @@ LZ4_prepareTable(LZ4_stream_t_internal* const cctx,
           || inputSize >= 4 KB)
         {
             DEBUGLOG(4, "LZ4_prepareTable: Resetting table in %p", cctx);
-            MEM_INIT(cctx->hashTable, 0, LZ4_HASHTABLESIZE);
+            MEM_INIT(cctx->hashTable, 0, (size_t)1 << memoryUsage);
             cctx->currentOffset = 0;
             cctx->tableType = (U32)clearedTable;
         } else {
@@ -860,7 +1038,8 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                  const tableType_t tableType,
                  const dict_directive dictDirective,
                  const dictIssue_directive dictIssue,
-                 const int acceleration)
+                 const int acceleration,
+                 const U32 memoryUsage)
 {
     int result;
     const BYTE* ip = (const BYTE*) source;
@@ -922,8 +1101,8 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
     if (inputSize<LZ4_minLength) goto _last_literals;        /* Input too small, no compression (all literals) */
 
     /* First Byte */
-    LZ4_putPosition(ip, cctx->hashTable, tableType, base);
-    ip++; forwardH = LZ4_hashPosition(ip, tableType);
+    LZ4_putPosition(ip, cctx->hashTable, tableType, base, memoryUsage);
+    ip++; forwardH = LZ4_hashPosition(ip, tableType, memoryUsage);
 
     /* Main Loop */
     for ( ; ; ) {
@@ -946,7 +1125,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                 assert(ip < mflimitPlusOne);
 
                 match = LZ4_getPositionOnHash(h, cctx->hashTable, tableType, base);
-                forwardH = LZ4_hashPosition(forwardIp, tableType);
+                forwardH = LZ4_hashPosition(forwardIp, tableType, memoryUsage);
                 LZ4_putPositionOnHash(ip, h, cctx->hashTable, tableType, base);
 
             } while ( (match+LZ4_DISTANCE_MAX < ip)
@@ -995,7 +1174,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                 } else {   /* single continuous memory segment */
                     match = base + matchIndex;
                 }
-                forwardH = LZ4_hashPosition(forwardIp, tableType);
+                forwardH = LZ4_hashPosition(forwardIp, tableType, memoryUsage);
                 LZ4_putIndexOnHash(current, h, cctx->hashTable, tableType);
 
                 DEBUGLOG(7, "candidate at pos=%u  (offset=%u \n", matchIndex, current - matchIndex);
@@ -1112,7 +1291,7 @@ _next_match:
                         const BYTE* ptr;
                         DEBUGLOG(5, "Clearing %u positions", (U32)(filledIp - ip));
                         for (ptr = ip; ptr <= filledIp; ++ptr) {
-                            U32 const h = LZ4_hashPosition(ptr, tableType);
+                            U32 const h = LZ4_hashPosition(ptr, tableType, memoryUsage);
                             LZ4_clearHash(h, cctx->hashTable, tableType);
                         }
                     }
@@ -1144,20 +1323,20 @@ _next_match:
         if (ip >= mflimitPlusOne) break;
 
         /* Fill table */
-        LZ4_putPosition(ip-2, cctx->hashTable, tableType, base);
+        LZ4_putPosition(ip-2, cctx->hashTable, tableType, base, memoryUsage);
 
         /* Test next position */
         if (tableType == byPtr) {
 
-            match = LZ4_getPosition(ip, cctx->hashTable, tableType, base);
-            LZ4_putPosition(ip, cctx->hashTable, tableType, base);
+            match = LZ4_getPosition(ip, cctx->hashTable, tableType, base, memoryUsage);
+            LZ4_putPosition(ip, cctx->hashTable, tableType, base, memoryUsage);
             if ( (match+LZ4_DISTANCE_MAX >= ip)
               && (LZ4_read32(match) == LZ4_read32(ip)) )
             { token=op++; *token=0; goto _next_match; }
 
         } else {   /* byU32, byU16 */
 
-            U32 const h = LZ4_hashPosition(ip, tableType);
+            U32 const h = LZ4_hashPosition(ip, tableType, memoryUsage);
             U32 const current = (U32)(ip-base);
             U32 matchIndex = LZ4_getIndexOnHash(h, cctx->hashTable, tableType);
             assert(matchIndex < current);
@@ -1198,7 +1377,7 @@ _next_match:
         }
 
         /* Prepare next loop */
-        forwardH = LZ4_hashPosition(++ip, tableType);
+        forwardH = LZ4_hashPosition(++ip, tableType, memoryUsage);
 
     }
 
@@ -1275,10 +1454,21 @@ LZ4_FORCE_INLINE int LZ4_compress_generic(
     }
     assert(src != NULL);
 
-    return LZ4_compress_generic_validated(cctx, src, dst, srcSize,
-                inputConsumed, /* only written into if outputDirective == fillOutput */
-                dstCapacity, outputDirective,
-                tableType, dictDirective, dictIssue, acceleration);
+    /* instantiated for every table size, so that the hash shifts and table bounds are constants */
+    {   U32 const memoryUsage = LZ4_streamMemoryUsage(cctx);
+        if (memoryUsage == LZ4_MEMORY_USAGE) {
+            return LZ4_compress_generic_validated(cctx, src, dst, srcSize,
+                        inputConsumed, /* only written into if outputDirective == fillOutput */
+                        dstCapacity, outputDirective,
+                        tableType, dictDirective, dictIssue, acceleration, LZ4_MEMORY_USAGE);
+        }
+        switch (memoryUsage) {
+        case 12: return LZ4_compress_generic_validated(cctx, src, dst, srcSize, inputConsumed, dstCapacity, outputDirective, tableType, dictDirective, dictIssue, acceleration, 12);
+        case 14: return LZ4_compress_generic_validated(cctx, src, dst, srcSize, inputConsumed, dstCapacity, outputDirective, tableType, dictDirective, dictIssue, acceleration, 14);
+        case 16: return LZ4_compress_generic_validated(cctx, src, dst, srcSize, inputConsumed, dstCapacity, outputDirective, tableType, dictDirective, dictIssue, acceleration, 16);
+        default: assert(memoryUsage == 18);
+                 return LZ4_compress_generic_validated(cctx, src, dst, srcSize, inputConsumed, dstCapacity, outputDirective, tableType, dictDirective, dictIssue, acceleration, 18);
+    }   }
 }
 
 
@@ -1431,6 +1621,31 @@ LZ4_stream_t* LZ4_createStream(void)
     return lz4s;
 }
 
+static int LZ4_isValidMemoryUsage(int memoryUsage)
+{
+    return (memoryUsage == LZ4_MEMORY_USAGE)
+        || (memoryUsage == 12) || (memoryUsage == 14) || (memoryUsage == 16) || (memoryUsage == 18);
+}
+
+int LZ4_sizeofStateEx(int memoryUsage)
+{
+    if (!LZ4_isValidMemoryUsage(memoryUsage)) { return 0; }
+    if (memoryUsage <= LZ4_MEMORY_USAGE) { return LZ4_STREAMSIZE; }
+    return (int)((LZ4_sizeofStreamInternal((U32)memoryUsage) + sizeof(void*) - 1) & ~(sizeof(void*) - 1));
+}
+
+LZ4_stream_t* LZ4_createStreamEx(int memoryUsage)
+{
+    int const size = LZ4_sizeofStateEx(memoryUsage);
+    LZ4_stream_t* lz4s;
+    if (size == 0) { return NULL; }
+    lz4s = (LZ4_stream_t*)ALLOC((size_t)size);
+    DEBUGLOG(4, "LZ4_createStreamEx %p (memoryUsage %i)", lz4s, memoryUsage);
+    if (lz4s == NULL) return NULL;
+    LZ4_initStreamEx(lz4s, (size_t)size, memoryUsage);
+    return lz4s;
+}
+
 static size_t LZ4_stream_t_alignment(void)
 {
 #if LZ4_ALIGN_TEST
@@ -1451,6 +1666,21 @@ LZ4_stream_t* LZ4_initStream (void* buffer, size_t size)
     return (LZ4_stream_t*)buffer;
 }
 
+LZ4_stream_t* LZ4_initStreamEx (void* buffer, size_t size, int memoryUsage)
+{
+    LZ4_stream_t_internal* ctx;
+    DEBUGLOG(5, "LZ4_initStreamEx (memoryUsage %i)", memoryUsage);
+    if (buffer == NULL) { return NULL; }
+    if (!LZ4_isValidMemoryUsage(memoryUsage)) { return NULL; }
+    if (size < (size_t)LZ4_sizeofStateEx(memoryUsage)) { return NULL; }
+    if (!LZ4_isAligned(buffer, LZ4_stream_t_alignment())) return NULL;
+    /* only the part of the table that is used */
+    MEM_INIT(buffer, 0, LZ4_sizeofStreamInternal((U32)memoryUsage));
+    ctx = &((LZ4_stream_t*)buffer)->internal_donotuse;
+    ctx->memoryUsage = (U32)memoryUsage;
+    return (LZ4_stream_t*)buffer;
+}
+
 /* resetStream is now deprecated,
  * prefer initStream() which is more general */
 void LZ4_resetStream (LZ4_stream_t* LZ4_stream)
@@ -1487,7 +1717,10 @@ int LZ4_loadDict (LZ4_stream_t* LZ4_dict, const char* dictionary, int dictSize)
      * and not just continue it with prepareTable()
      * to avoid any risk of generating overflowing matchIndex
      * when compressing using this dictionary */
-    LZ4_resetStream(LZ4_dict);
+    {   U32 const memoryUsage = dict->memoryUsage;   /* kept, see LZ4_initStreamEx() */
+        MEM_INIT(dict, 0, LZ4_sizeofStreamInternal(LZ4_streamMemoryUsage(dict)));
+        dict->memoryUsage = memoryUsage;
+    }
 
     /* We always increment the offset by 64 KB, since, if the dict is longer,
      * we truncate it to the last 64k, and if it's shorter, we still want to
@@ -1507,10 +1740,11 @@ int LZ4_loadDict (LZ4_stream_t* LZ4_dict, const char* dictionary, int dictSize)
     dict->dictSize = (U32)(dictEnd - p);
     dict->tableType = (U32)tableType;
 
-    while (p <= dictEnd-HASH_UNIT) {
-        LZ4_putPosition(p, dict->hashTable, tableType, base);
-        p+=3;
-    }
+    {   U32 const memoryUsage = LZ4_streamMemoryUsage(dict);
+        while (p <= dictEnd-HASH_UNIT) {
+            LZ4_putPosition(p, dict->hashTable, tableType, base, memoryUsage);
+            p+=3;
+    }   }
 
     return (int)dict->dictSize;
 }
@@ -1523,6 +1757,12 @@ void LZ4_attach_dictionary(LZ4_stream_t* workingStream, const LZ4_stream_t* dict
              workingStream, dictionaryStream,
              dictCtx != NULL ? dictCtx->dictSize : 0);
 
+    /* the tables are searched with the same hash, a dictionary of another table size is not attached */
+    if ((dictCtx != NULL) && (LZ4_streamMemoryUsage(dictCtx) != LZ4_streamMemoryUsage(&workingStream->internal_donotuse))) {
+        DEBUGLOG(4, "LZ4_attach_dictionary: table size differs, not attached");
+        dictCtx = NULL;
+    }
+
     if (dictCtx != NULL) {
         /* If the current offset is zero, we will never look in the
          * external dictionary context, since there is no value a table
@@ -1550,9 +1790,10 @@ static void LZ4_renormDictT(LZ4_stream_t_internal* LZ4_dict, int nextSize)
         /* rescale hash table */
         U32 const delta = LZ4_dict->currentOffset - 64 KB;
         const BYTE* dictEnd = LZ4_dict->dictionary + LZ4_dict->dictSize;
+        int const hashSize = 1 << (LZ4_streamMemoryUsage(LZ4_dict) - 2);
         int i;
         DEBUGLOG(4, "LZ4_renormDictT");
-        for (i=0; i<LZ4_HASH_SIZE_U32; i++) {
+        for (i=0; i<hashSize; i++) {
             if (LZ4_dict->hashTable[i] < delta) LZ4_dict->hashTable[i]=0;
             else LZ4_dict->hashTable[i] -= delta;
         }
@@ -1619,7 +1860,7 @@ int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
                  * cost to copy the dictionary's tables into the active context,
                  * so that the compression loop is only looking into one table.
                  */
-                LZ4_memcpy(streamPtr, streamPtr->dictCtx, sizeof(*streamPtr));
+                LZ4_memcpy(streamPtr, streamPtr->dictCtx, LZ4_sizeofStreamInternal(LZ4_streamMemoryUsage(streamPtr)));
                 result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingExtDict, noDictIssue, acceleration);
             } else {
                 result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingDictCtx, noDictIssue, acceleration);
@@ -1817,7 +2058,7 @@ LZ4_decompress_generic(
                 LZ4_STATIC_ASSERT(MFLIMIT >= WILDCOPYLENGTH);
                 if (endOnInput) {  /* LZ4_decompress_safe() */
                     if ((cpy>oend-32) || (ip+length>iend-32)) { goto safe_literal_copy; }
-                    LZ4_wildCopy32(op, ip, cpy);
+                    LZ4_wildCopyLiterals32(op, ip, cpy);
                 } else {   /* LZ4_decompress_fast() */
                     if (cpy>oend-8) { goto safe_literal_copy; }
                     LZ4_wildCopy8(op, ip, cpy); /* LZ4_decompress_fast() cannot copy more than 8 bytes at a time :
@@ -1916,6 +2157,7 @@ LZ4_decompress_generic(
 
             assert((op <= oend) && (oend-op >= 32));
             if (unlikely(offset<16)) {
+                if (unlikely(offset == 0)) { goto _output_error; }   /* corrupted block, a match has no source */
                 LZ4_memcpy_using_offset(op, match, cpy, offset);
             } else {
                 LZ4_wildCopy32(op, match, cpy);
@@ -2121,6 +2363,7 @@ LZ4_decompress_generic(
             }
 
             if (unlikely(offset<8)) {
+                if (unlikely(offset == 0)) { goto _output_error; }   /* corrupted block, a match has no source */
                 LZ4_write32(op, 0);   /* silence msan warning when offset==0 */
                 op[0] = match[0];
                 op[1] = match[1];
@@ -2193,6 +2436,158 @@ int LZ4_decompress_fast(const char* source, char* dest, int originalSize)
                                   (BYTE*)dest - 64 KB, NULL, 0);
 }
 
+/*===== Batch decoding : independent blocks, interleaved in one thread =====*/
+
+#define LZ4_BATCH_STREAMS 4
+
+typedef struct {
+    const BYTE* ip;
+    BYTE* op;
+    const BYTE* ilimit;    /* the fast loop margins : ip < ilimit, op < olimit */
+    BYTE* olimit;
+    const BYTE* iend;
+    BYTE* oend;
+    const BYTE* lowPrefix;
+} LZ4_batchStream_t;
+
+#if LZ4_FAST_DEC_LOOP
+/* LZ4_decompress_batchStep() :
+ * decodes one sequence of a block, following the fast loop of LZ4_decompress_generic().
+ * Any sequence that needs a check of the fast loop (or its safe copies) is left unconsumed (returns 0),
+ * LZ4_decompress_generic() then decodes the rest of the block, so results and error positions are those of LZ4_decompress_safe().
+ * The steps of the streams of a batch don't depend on each other, which hides the latency of one block's loads behind the others. */
+LZ4_FORCE_INLINE int
+LZ4_decompress_batchStep(LZ4_batchStream_t* stream)
+{
+    const BYTE* ip = stream->ip;
+    BYTE* op = stream->op;
+    const BYTE* match;
+    size_t offset;
+    unsigned token;
+    size_t length;
+
+    if ((ip >= stream->ilimit) || (op >= stream->olimit)) { return 0; }
+    token = *ip++;
+    length = token >> ML_BITS;  /* literal length */
+
+    if (length == RUN_MASK) {
+        variable_length_error error = ok;
+        length += read_variable_length(&ip, stream->iend-RUN_MASK, 1, 1, &error);
+        if (error != ok) { return 0; }
+        if (unlikely((uptrval)(op)+length<(uptrval)(op))) { return 0; }
+        if (unlikely((uptrval)(ip)+length<(uptrval)(ip))) { return 0; }
+        if ((op+length > stream->oend-32) || (ip+length > stream->iend-32)) { return 0; }
+        LZ4_wildCopyLiterals32(op, ip, op+length);
+    } else {
+        /* ip < ilimit : 16 bytes can be read */
+        LZ4_memcpy(op, ip, 16);
+    }
+    ip += length; op += length;
+
+    /* get offset */
+    offset = LZ4_readLE16(ip); ip+=2;
+    match = op - offset;
+    if (unlikely(offset == 0) || unlikely(match < stream->lowPrefix)) { return 0; }
+
+    /* get matchlength */
+    length = token & ML_MASK;
+    if (length == ML_MASK) {
+        variable_length_error error = ok;
+        length += read_variable_length(&ip, stream->iend - LASTLITERALS + 1, 1, 0, &error);
+        if (error != ok) { return 0; }
+        if (unlikely((uptrval)(op)+length<(uptrval)op)) { return 0; }
+    }
+    length += MINMATCH;
+    if (op + length >= stream->oend - FASTLOOP_SAFE_DISTANCE) { return 0; }
+
+    /* copy match within block */
+    if ((offset >= 8) && (length <= 18)) {  /* the common short match, as the fast loop copies it */
+        LZ4_memcpy(op, match, 8);
+        LZ4_memcpy(op+8, match+8, 8);
+        LZ4_memcpy(op+16, match+16, 2);
+    } else if (unlikely(offset<16)) {
+        LZ4_memcpy_using_offset(op, match, op + length, offset);
+    } else {
+        LZ4_wildCopy32(op, match, op + length);
+    }
+
+    stream->ip = ip;
+    stream->op = op + length;
+    return 1;
+}
+#endif
+
+LZ4_FORCE_O2
+int LZ4_decompress_safe_batch(const char* const* sources, char* const* dests, const int* compressedSizes, const int* dstCapacities, int* results, int count)
+{
+    int failed = 0;
+    int first;
+
+    for (first = 0; first < count; first += LZ4_BATCH_STREAMS) {
+        int const nbStreams = MIN(count - first, LZ4_BATCH_STREAMS);
+        LZ4_batchStream_t streams[LZ4_BATCH_STREAMS];
+        int n;
+
+        for (n = 0; n < nbStreams; n++) {
+            LZ4_batchStream_t* const stream = &streams[n];
+            stream->ip = (const BYTE*)sources[first + n];
+            stream->op = (BYTE*)dests[first + n];
+            stream->lowPrefix = stream->op;
+        }
+
+#if LZ4_FAST_DEC_LOOP
+        {   unsigned live = 0;
+
+            /* blocks that are too small for the fast loop go to LZ4_decompress_generic() directly */
+            for (n = 0; n < nbStreams; n++) {
+                LZ4_batchStream_t* const stream = &streams[n];
+                int const srcSize = compressedSizes[first + n];
+                int const dstCapacity = dstCapacities[first + n];
+                if ((stream->ip == NULL) || (srcSize <= 32) || (dstCapacity <= FASTLOOP_SAFE_DISTANCE)) { continue; }
+                stream->iend = stream->ip + srcSize;
+                stream->oend = stream->op + dstCapacity;
+                stream->ilimit = stream->iend - 32;
+                stream->olimit = stream->oend - FASTLOOP_SAFE_DISTANCE;
+                live |= 1u << n;
+            }
+
+            /* one sequence of every live stream per round, a stream leaves at its first sequence that needs the checks of LZ4_decompress_generic()
+             * the round is unrolled, so that the state of the streams stays in registers */
+            LZ4_STATIC_ASSERT(LZ4_BATCH_STREAMS == 4);
+            while (live) {
+                if ((live & 1) && !LZ4_decompress_batchStep(&streams[0])) { live &= ~1u; }
+                if ((live & 2) && !LZ4_decompress_batchStep(&streams[1])) { live &= ~2u; }
+                if ((live & 4) && !LZ4_decompress_batchStep(&streams[2])) { live &= ~4u; }
+                if ((live & 8) && !LZ4_decompress_batchStep(&streams[3])) { live &= ~8u; }
+            }
+        }
+#endif
+
+        for (n = 0; n < nbStreams; n++) {
+            LZ4_batchStream_t* const stream = &streams[n];
+            const char* const src = sources[first + n];
+            char* const dst = dests[first + n];
+            int result;
+            if (src == NULL || (const char*)stream->ip == src) {
+                result = LZ4_decompress_generic(src, dst, compressedSizes[first + n], dstCapacities[first + n],
+                                                endOnInputSize, decode_full_block, noDict,
+                                                (BYTE*)dst, NULL, 0);
+            } else {
+                int const decoded = (int)((char*)stream->op - dst);
+                int const consumed = (int)((const char*)stream->ip - src);
+                result = LZ4_decompress_generic((const char*)stream->ip, (char*)stream->op, compressedSizes[first + n] - consumed, dstCapacities[first + n] - decoded,
+                                                endOnInputSize, decode_full_block, noDict,
+                                                (BYTE*)dst, NULL, 0);
+                result = (result >= 0) ? result + decoded : result - consumed;
+            }
+            results[first + n] = result;
+            if (result < 0) { failed++; }
+        }
+    }
+
+    return failed;
+}
+
 /*===== Instantiate a few more decoding cases, used more than once. =====*/
 
 LZ4_FORCE_O2 /* Exported, an obsolete API function. */
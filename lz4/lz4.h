@@ -264,6 +264,15 @@ LZ4LIB_API int LZ4_compress_destSize (const char* src, char* dst, int* srcSizePt
  */
 LZ4LIB_API int LZ4_decompress_safe_partial (const char* src, char* dst, int srcSize, int targetOutputSize, int dstCapacity);
 
+/*! LZ4_decompress_safe_batch() :
+ *  Decompresses `count` independent blocks, as LZ4_decompress_safe() would decompress each of them.
+ *  Up to 4 blocks are decoded together, one sequence of each in turn,
+ *  so that the serial dependencies of one block overlap with the work on the others (small blocks, latency bound).
+ *  results[n] receives the result of LZ4_decompress_safe(sources[n], dests[n], compressedSizes[n], dstCapacities[n]).
+ * @return : the number of blocks that failed (negative result), 0 when all blocks were decompressed.
+ */
+LZ4LIB_API int LZ4_decompress_safe_batch (const char* const* sources, char* const* dests, const int* compressedSizes, const int* dstCapacities, int* results, int count);
+
 
 /*-*********************************************
 *  Streaming Compression Functions
@@ -498,6 +507,24 @@ LZ4LIB_STATIC_API int LZ4_compress_fast_extState_fastReset (void* state, const c
  */
 LZ4LIB_STATIC_API void LZ4_attach_dictionary(LZ4_stream_t* workingStream, const LZ4_stream_t* dictionaryStream);
 
+/*! LZ4_createStreamEx(), LZ4_initStreamEx(), LZ4_sizeofStateEx() :
+ *  Streams with a hash table of (1 << memoryUsage) bytes, instead of the LZ4_MEMORY_USAGE default.
+ *  memoryUsage is one of 12, 14, 16, 18, or LZ4_MEMORY_USAGE.
+ *  A smaller table stays in L1 for small messages, a larger table finds more matches in large blocks.
+ *  The compressor is instantiated for each of these sizes, the table size is not a runtime parameter of the hot loop.
+ *
+ *  LZ4_sizeofStateEx() @return the buffer size for LZ4_initStreamEx(), or 0 when memoryUsage is not supported.
+ *  Sizes above the default are larger than LZ4_stream_t, such a stream can't be declared statically.
+ *  The table size is kept by LZ4_resetStream_fast() and LZ4_loadDict(),
+ *  LZ4_initStream() and LZ4_resetStream() reset the stream to the default size.
+ *  LZ4_attach_dictionary() ignores a dictionary stream with a different table size.
+ */
+#define LZ4_MEMORY_USAGE_MIN 12
+#define LZ4_MEMORY_USAGE_MAX 18
+LZ4LIB_STATIC_API int LZ4_sizeofStateEx(int memoryUsage);
+LZ4LIB_STATIC_API LZ4_stream_t* LZ4_initStreamEx(void* buffer, size_t size, int memoryUsage);
+LZ4LIB_STATIC_API LZ4_stream_t* LZ4_createStreamEx(int memoryUsage);
+
 
 /*! In-place compression and decompression
  *
@@ -594,12 +621,13 @@ LZ4LIB_STATIC_API void LZ4_attach_dictionary(LZ4_stream_t* workingStream, const
 
 typedef struct LZ4_stream_t_internal LZ4_stream_t_internal;
 struct LZ4_stream_t_internal {
-    LZ4_u32 hashTable[LZ4_HASH_SIZE_U32];
     LZ4_u32 currentOffset;
     LZ4_u32 tableType;
     const LZ4_byte* dictionary;
     const LZ4_stream_t_internal* dictCtx;
     LZ4_u32 dictSize;
+    LZ4_u32 memoryUsage;   /* 0 : LZ4_MEMORY_USAGE */
+    LZ4_u32 hashTable[LZ4_HASH_SIZE_U32];   /* last, LZ4_initStreamEx() tables can be larger */
 };
 
 typedef struct {
@@ -0,0 +1,67 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+using namespace System;
+using namespace System::Threading;
+
+namespace lz4 {
+
+	// the buffers and native states of one LZ4Stream, its parallel and pipelined workers allocate through it as well (LZ4Stream::AllocationCount)
+	ref class LZ4Allocations sealed
+	{
+	private:
+		long long _count = 0;
+
+	internal:
+		property long long Count {
+			long long get() {
+				return Interlocked::Read(_count);
+			}
+		}
+
+		// a managed buffer, workers allocate on the thread pool
+		template<typename T>
+		array<T>^ Buffer(int length) {
+			array<T>^ buffer = gcnew array<T>(length);
+			Interlocked::Increment(_count);
+			return buffer;
+		}
+
+		// a native state that was just created
+		template<typename T>
+		T* State(T* state) {
+			Interlocked::Increment(_count);
+			return state;
+		}
+	};
+}
@@ -0,0 +1,198 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4BlockIndex.h"
+
+namespace lz4 {
+
+	namespace {
+
+		void WriteLE32(array<unsigned char>^ buffer, int offset, unsigned int value) {
+			buffer[offset] = (unsigned char)value;
+			buffer[offset + 1] = (unsigned char)(value >> 8);
+			buffer[offset + 2] = (unsigned char)(value >> 16);
+			buffer[offset + 3] = (unsigned char)(value >> 24);
+		}
+
+		void WriteLE64(array<unsigned char>^ buffer, int offset, long long value) {
+			WriteLE32(buffer, offset, (unsigned int)value);
+			WriteLE32(buffer, offset + 4, (unsigned int)((unsigned long long)value >> 32));
+		}
+
+		unsigned int ReadLE32(array<unsigned char>^ buffer, int offset) {
+			return (unsigned int)buffer[offset] | ((unsigned int)buffer[offset + 1] << 8) | ((unsigned int)buffer[offset + 2] << 16) | ((unsigned int)buffer[offset + 3] << 24);
+		}
+
+		long long ReadLE64(array<unsigned char>^ buffer, int offset) {
+			return (long long)((unsigned long long)ReadLE32(buffer, offset) | ((unsigned long long)ReadLE32(buffer, offset + 4) << 32));
+		}
+
+		void ReadExactly(Stream^ stream, array<unsigned char>^ buffer, int count) {
+			int offset = 0;
+			while (offset < count) {
+				int bytesRead = stream->Read(buffer, offset, count - offset);
+				if (bytesRead == 0) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+				offset += bytesRead;
+			}
+		}
+	}
+
+	void LZ4BlockIndex::Advance(int count) {
+		_position += count;
+	}
+
+	void LZ4BlockIndex::BeginFrame() {
+		_frameOffset = _position;
+	}
+
+	void LZ4BlockIndex::AddBlock(int contentSize, int blockSize) {
+		LZ4BlockIndexEntry entry;
+		entry.FrameOffset = _frameOffset;
+		entry.BlockOffset = _position;
+		entry.ContentOffset = _contentLength;
+		entry.ContentSize = contentSize;
+		_entries->Add(entry);
+
+		_position += blockSize;
+		_contentLength += contentSize;
+	}
+
+	array<unsigned char>^ LZ4BlockIndex::ToArray() {
+		long long size = (long long)_entries->Count * LZ4BLOCKINDEX_ENTRY_SIZE + LZ4BLOCKINDEX_FOOTER_SIZE;
+		if (size > Int32::MaxValue) { throw gcnew NotSupportedException("Too many blocks for the block index"); }
+
+		array<byte>^ data = gcnew array<byte>((int)size);
+		int offset = 0;
+		for (int i = 0; i < _entries->Count; i++) {
+			LZ4BlockIndexEntry entry = _entries[i];
+			WriteLE64(data, offset, entry.FrameOffset);
+			WriteLE64(data, offset + 8, entry.BlockOffset);
+			WriteLE64(data, offset + 16, entry.ContentOffset);
+			WriteLE32(data, offset + 24, (unsigned int)entry.ContentSize);
+			offset += LZ4BLOCKINDEX_ENTRY_SIZE;
+		}
+
+		// the footer is found from the end of the stream, the index frame starts at the current position
+		WriteLE64(data, offset, _position);
+		WriteLE32(data, offset + 8, (unsigned int)_entries->Count);
+		WriteLE32(data, offset + 12, (unsigned int)_restartInterval);
+		WriteLE32(data, offset + 16, LZ4BLOCKINDEX_MAGIC);
+		return data;
+	}
+
+	int LZ4BlockIndex::FindBlock(long long contentOffset) {
+		// the last block that starts at or before the offset
+		int low = 0;
+		int high = _entries->Count - 1;
+		while (low < high) {
+			int middle = low + (high - low + 1) / 2;
+			if (_entries[middle].ContentOffset <= contentOffset) {
+				low = middle;
+			}
+			else {
+				high = middle - 1;
+			}
+		}
+		return low;
+	}
+
+	int LZ4BlockIndex::FindFrameStart(int index) {
+		long long frameOffset = _entries[index].FrameOffset;
+		while (index > 0 && _entries[index - 1].FrameOffset == frameOffset) {
+			index--;
+		}
+		return index;
+	}
+
+	int LZ4BlockIndex::FindRestart(int index) {
+		int first = FindFrameStart(index);
+		if (_restartInterval == 0) { return first; }
+		return first + (index - first) / _restartInterval * _restartInterval;
+	}
+
+	bool LZ4BlockIndex::IsIndexFrame(int id, array<byte>^ data) {
+		return id == LZ4BLOCKINDEX_FRAME_ID && data != nullptr && data->Length >= LZ4BLOCKINDEX_FOOTER_SIZE && ReadLE32(data, data->Length - 4) == LZ4BLOCKINDEX_MAGIC;
+	}
+
+	LZ4BlockIndex^ LZ4BlockIndex::Read(Stream^ innerStream) {
+		if (!innerStream->CanSeek) { return nullptr; }
+
+		long long position = innerStream->Position;
+		long long length = innerStream->Length;
+		try {
+			if (length < LZ4FRAME_SKIPPABLE_HEADER_SIZE + LZ4BLOCKINDEX_FOOTER_SIZE) { return nullptr; }
+
+			array<byte>^ footer = gcnew array<byte>(LZ4BLOCKINDEX_FOOTER_SIZE);
+			innerStream->Position = length - LZ4BLOCKINDEX_FOOTER_SIZE;
+			ReadExactly(innerStream, footer, footer->Length);
+			if (ReadLE32(footer, 16) != LZ4BLOCKINDEX_MAGIC) { return nullptr; }
+
+			long long indexOffset = ReadLE64(footer, 0);
+			long long count = ReadLE32(footer, 8);
+			unsigned int restartInterval = ReadLE32(footer, 12);
+			long long dataSize = count * LZ4BLOCKINDEX_ENTRY_SIZE + LZ4BLOCKINDEX_FOOTER_SIZE;
+			long long frameStart = length - dataSize - LZ4FRAME_SKIPPABLE_HEADER_SIZE;
+			if (dataSize > Int32::MaxValue - LZ4FRAME_SKIPPABLE_HEADER_SIZE || frameStart < 0 || indexOffset < 0 || indexOffset > frameStart || restartInterval > Int32::MaxValue) { return nullptr; }
+
+			// the skippable frame header and the index data
+			array<byte>^ data = gcnew array<byte>((int)(LZ4FRAME_SKIPPABLE_HEADER_SIZE + dataSize));
+			innerStream->Position = frameStart;
+			ReadExactly(innerStream, data, data->Length);
+			if (ReadLE32(data, 0) != LZ4FRAME_SKIPPABLE_MAGIC + LZ4BLOCKINDEX_FRAME_ID || ReadLE32(data, 4) != (unsigned int)dataSize) { return nullptr; }
+
+			LZ4BlockIndex^ index = gcnew LZ4BlockIndex();
+			index->_streamOffset = frameStart - indexOffset;
+			index->_position = indexOffset;
+			index->_restartInterval = (int)restartInterval;
+			int offset = LZ4FRAME_SKIPPABLE_HEADER_SIZE;
+			for (int i = 0; i < (int)count; i++) {
+				LZ4BlockIndexEntry entry;
+				entry.FrameOffset = ReadLE64(data, offset);
+				entry.BlockOffset = ReadLE64(data, offset + 8);
+				entry.ContentOffset = ReadLE64(data, offset + 16);
+				entry.ContentSize = (int)ReadLE32(data, offset + 24);
+				offset += LZ4BLOCKINDEX_ENTRY_SIZE;
+
+				// the blocks follow each other
+				if (entry.ContentOffset != index->_contentLength || entry.ContentSize <= 0 || entry.FrameOffset < 0 || entry.FrameOffset > entry.BlockOffset || entry.BlockOffset >= indexOffset) {
+					throw gcnew Exception("Invalid block index");
+				}
+				index->_entries->Add(entry);
+				index->_contentLength += entry.ContentSize;
+			}
+			return index;
+		}
+		finally {
+			innerStream->Position = position;
+		}
+	}
+}
@@ -0,0 +1,132 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4Frame.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Collections::Generic;
+
+// the index is the data of a skippable frame at the end of the stream: an entry per block and a footer
+// entry: frame offset (8 bytes), block offset (8 bytes), content offset (8 bytes), content size (4 bytes), offsets relative to the start of the stream
+// footer: offset of the index frame (8 bytes), entry count (4 bytes), restart interval of linked blocks (4 bytes), magic (4 bytes)
+#define LZ4BLOCKINDEX_FRAME_ID 14
+#define LZ4BLOCKINDEX_MAGIC 0x49345A4CU // "LZ4I"
+#define LZ4BLOCKINDEX_ENTRY_SIZE 28
+#define LZ4BLOCKINDEX_FOOTER_SIZE 20
+
+namespace lz4 {
+
+	value struct LZ4BlockIndexEntry {
+		long long FrameOffset; // frame header of the block
+		long long BlockOffset; // block header
+		long long ContentOffset;
+		int ContentSize;
+	};
+
+	// offsets of the blocks of a stream, written by the compressor and used by the decompressor to seek
+	ref class LZ4BlockIndex sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		List<LZ4BlockIndexEntry>^ _entries = gcnew List<LZ4BlockIndexEntry>();
+		long long _position = 0;
+		long long _frameOffset = 0;
+		long long _contentLength = 0;
+		long long _streamOffset = 0;
+		int _restartInterval = 0;
+
+	internal:
+		// compress: number of bytes written to the inner stream
+		property long long Position {
+			long long get() {
+				return _position;
+			}
+		}
+
+		// decompress: offset of the stream in the inner stream
+		property long long StreamOffset {
+			long long get() {
+				return _streamOffset;
+			}
+		}
+
+		property long long ContentLength {
+			long long get() {
+				return _contentLength;
+			}
+		}
+
+		// linked blocks: every RestartInterval blocks of a frame a block starts without history, 0: only the first block of a frame
+		property int RestartInterval {
+			int get() {
+				return _restartInterval;
+			}
+			void set(int value) {
+				_restartInterval = value;
+			}
+		}
+
+		property int Count {
+			int get() {
+				return _entries->Count;
+			}
+		}
+
+		property LZ4BlockIndexEntry default[int] {
+			LZ4BlockIndexEntry get(int index) {
+				return _entries[index];
+			}
+		}
+
+		// compress: bytes that are not part of a block (frame headers, end marks, skippable frames)
+		void Advance(int count);
+		// compress: the frame header is written next
+		void BeginFrame();
+		// compress: the block is written next
+		void AddBlock(int contentSize, int blockSize);
+		// compress: data of the skippable frame, written at the current position
+		array<byte>^ ToArray();
+
+		// decompress: the entry of the block that contains the content offset
+		int FindBlock(long long contentOffset);
+		// decompress: the first entry of the frame of the block
+		int FindFrameStart(int index);
+		// decompress: the last entry at or before the block that starts without history (linked blocks)
+		int FindRestart(int index);
+
+		// reads the index at the end of the inner stream, nullptr when the stream doesn't end with an index, the position of the inner stream is restored
+		static LZ4BlockIndex^ Read(Stream^ innerStream);
+		static bool IsIndexFrame(int id, array<byte>^ data);
+	};
+}
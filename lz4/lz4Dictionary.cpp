@@ -0,0 +1,174 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4Dictionary.h"
+#include "lz4FrameResult.h"
+
+namespace lz4 {
+
+	LZ4Dictionary::LZ4Dictionary(array<byte>^ data) {
+		Init(Nullable<unsigned int>(), data, 0, data != nullptr ? data->Length : 0);
+	}
+
+	LZ4Dictionary::LZ4Dictionary(unsigned int id, array<byte>^ data) {
+		Init(Nullable<unsigned int>(id), data, 0, data != nullptr ? data->Length : 0);
+	}
+
+	LZ4Dictionary::LZ4Dictionary(Nullable<unsigned int> id, array<byte>^ data, int offset, int count) {
+		Init(id, data, offset, count);
+	}
+
+	void LZ4Dictionary::Init(Nullable<unsigned int> id, array<byte>^ data, int offset, int count) {
+		if (data == nullptr) { throw gcnew ArgumentNullException("data"); }
+		else if (offset < 0) { throw gcnew ArgumentOutOfRangeException("offset"); }
+		else if (count <= 0) { throw gcnew ArgumentOutOfRangeException("count"); }
+		else if (offset + count > data->Length) { throw gcnew ArgumentOutOfRangeException("offset + count"); }
+
+		// matches can only reach back 64 KB, the start of a larger dictionary is never used
+		if (count > LZ4FRAME_DICTIONARY_SIZE_MAX) {
+			offset += count - LZ4FRAME_DICTIONARY_SIZE_MAX;
+			count = LZ4FRAME_DICTIONARY_SIZE_MAX;
+		}
+
+		// native memory, the encoders and decoders keep a reference to it
+		_data = new char[count];
+		Marshal::Copy(data, offset, IntPtr(_data), count);
+		_length = count;
+		_id = id;
+	}
+
+	LZ4Dictionary::!LZ4Dictionary() {
+		if (_preparedFast != IntPtr::Zero) { delete (native::LZ4PreparedDictionary*)_preparedFast.ToPointer(); _preparedFast = IntPtr::Zero; }
+		if (_preparedHC != IntPtr::Zero) { delete (native::LZ4PreparedDictionary*)_preparedHC.ToPointer(); _preparedHC = IntPtr::Zero; }
+		if (_preparedHCFavorDecSpeed != IntPtr::Zero) { delete (native::LZ4PreparedDictionary*)_preparedHCFavorDecSpeed.ToPointer(); _preparedHCFavorDecSpeed = IntPtr::Zero; }
+		if (_data != nullptr) { delete[] _data; _data = nullptr; }
+	}
+
+	void LZ4Dictionary::Prepare(int compressionLevel, bool favorDecSpeed) {
+		if (compressionLevel != 0 && (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX)) { throw gcnew ArgumentOutOfRangeException("compressionLevel"); }
+
+		GetPrepared(compressionLevel, favorDecSpeed);
+	}
+
+	const native::LZ4PreparedDictionary* LZ4Dictionary::GetPrepared(int compressionLevel, bool favorDecSpeed) {
+		// the hash chain of high compression is the same for every level
+		if (compressionLevel == 0) { return GetPrepared(_preparedFast, false, false); }
+		else if (favorDecSpeed) { return GetPrepared(_preparedHCFavorDecSpeed, true, true); }
+		return GetPrepared(_preparedHC, true, false);
+	}
+
+	LZ4Dictionary^ LZ4Dictionary::Select(const native::LZ4FrameInfo& info, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries) {
+		if (!info.hasDictionaryId) { return dictionary; }
+
+		LZ4Dictionary^ result;
+		if (dictionaries != nullptr && dictionaries->TryGetValue(info.dictionaryId, result)) { return result; }
+		else if (dictionary == nullptr || !dictionary->Id.HasValue || dictionary->Id.Value != info.dictionaryId) {
+			throw gcnew Exception("Dictionary " + info.dictionaryId + " is not available");
+		}
+		return dictionary;
+	}
+
+	const native::LZ4PreparedDictionary* LZ4Dictionary::GetPrepared(IntPtr% slot, bool highCompression, bool favorDecSpeed) {
+		if (slot == IntPtr::Zero) {
+			native::LZ4PreparedDictionary* prepared = new native::LZ4PreparedDictionary();
+			int status = prepared->Init(_data, _length, highCompression, favorDecSpeed);
+			if (native::LZ4Frame_isError(status)) {
+				delete prepared;
+				CheckFrameResult(status);
+			}
+			// another thread may have prepared it first
+			if (Interlocked::CompareExchange(slot, IntPtr(prepared), IntPtr::Zero) != IntPtr::Zero) {
+				delete prepared;
+			}
+		}
+		return (const native::LZ4PreparedDictionary*)slot.ToPointer();
+	}
+
+	LZ4DictionaryTrainingResult^ LZ4Dictionary::Train(System::Collections::Generic::IEnumerable<array<byte>^>^ samples, int dictionarySize, int segmentSize, int dmerSize) {
+		if (samples == nullptr) { throw gcnew ArgumentNullException("samples"); }
+		else if (dictionarySize <= 0 || dictionarySize > LZ4FRAME_DICTIONARY_SIZE_MAX) { throw gcnew ArgumentOutOfRangeException("dictionarySize"); }
+		else if (segmentSize != 0 && (segmentSize < LZ4DICTIONARY_SEGMENT_SIZE_MIN || segmentSize > dictionarySize)) { throw gcnew ArgumentOutOfRangeException("segmentSize"); }
+		else if (dmerSize != 0 && (dmerSize < LZ4DICTIONARY_DMER_SIZE_MIN || dmerSize > LZ4DICTIONARY_DMER_SIZE_MAX)) { throw gcnew ArgumentOutOfRangeException("dmerSize"); }
+		else if ((segmentSize == 0) != (dmerSize == 0)) { throw gcnew ArgumentException("segmentSize and dmerSize are either both 0 or both set"); }
+
+		// the trainer reads the samples from one buffer
+		System::Collections::Generic::List<array<byte>^>^ list = gcnew System::Collections::Generic::List<array<byte>^>(samples);
+		if (list->Count == 0) { throw gcnew ArgumentException("No samples", "samples"); }
+		long long totalSize = 0;
+		for (int i = 0; i < list->Count; i++) {
+			if (list[i] == nullptr) { throw gcnew ArgumentNullException("samples"); }
+			totalSize += list[i]->Length;
+		}
+		if (totalSize == 0) { throw gcnew ArgumentException("No sample data", "samples"); }
+		else if (totalSize > Int32::MaxValue) { throw gcnew ArgumentOutOfRangeException("samples"); }
+
+		array<byte>^ data = gcnew array<byte>((int)totalSize);
+		array<int>^ sampleSizes = gcnew array<int>(list->Count);
+		int offset = 0;
+		for (int i = 0; i < list->Count; i++) {
+			Buffer::BlockCopy(list[i], 0, data, offset, list[i]->Length);
+			sampleSizes[i] = list[i]->Length;
+			offset += list[i]->Length;
+		}
+
+		native::LZ4DictionaryTrainerParameters parameters;
+		parameters.segmentSize = segmentSize;
+		parameters.dmerSize = dmerSize;
+		native::LZ4DictionaryTrainerResult result;
+
+		array<byte>^ dictionary = gcnew array<byte>(dictionarySize);
+		int size;
+		{
+			pin_ptr<byte> dataPtr = &data[0];
+			pin_ptr<int> sampleSizesPtr = &sampleSizes[0];
+			pin_ptr<byte> dictionaryPtr = &dictionary[0];
+			size = CheckFrameResult(native::LZ4Dictionary_train(dictionaryPtr, dictionarySize, dataPtr, sampleSizesPtr, sampleSizes->Length, &parameters, &result));
+		}
+
+		if (size != dictionarySize) {
+			array<byte>^ slimDictionary = gcnew array<byte>(size);
+			Buffer::BlockCopy(dictionary, 0, slimDictionary, 0, size);
+			dictionary = slimDictionary;
+		}
+		return gcnew LZ4DictionaryTrainingResult(dictionary, &result);
+	}
+
+	LZ4DictionaryTrainingResult::LZ4DictionaryTrainingResult(array<byte>^ data, const native::LZ4DictionaryTrainerResult* result) {
+		_data = data;
+		_segmentSize = result->segmentSize;
+		_dmerSize = result->dmerSize;
+		_evaluatedSamples = result->evaluatedSamples;
+		_evaluatedSize = result->evaluatedSize;
+		_compressedSize = result->compressedSize;
+		_compressedSizeWithDictionary = result->compressedSizeWithDictionary;
+	}
+}
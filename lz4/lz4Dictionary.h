@@ -0,0 +1,131 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4Frame.h"
+#include "lz4DictionaryTrainer.h"
+
+using namespace System;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// dictionary trained by LZ4Dictionary::Train, the sizes are those of the held-out samples (every fifth sample, none with less than five samples)
+	public ref class LZ4DictionaryTrainingResult sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		array<byte>^ _data;
+		int _segmentSize;
+		int _dmerSize;
+		int _evaluatedSamples;
+		long long _evaluatedSize;
+		long long _compressedSize;
+		long long _compressedSizeWithDictionary;
+
+	internal:
+		LZ4DictionaryTrainingResult(array<byte>^ data, const native::LZ4DictionaryTrainerResult* result);
+
+	public:
+		property array<byte>^ Data { array<byte>^ get() { return _data; }; };
+		property int SegmentSize { int get() { return _segmentSize; }; };
+		property int DmerSize { int get() { return _dmerSize; }; };
+		property int EvaluatedSamples { int get() { return _evaluatedSamples; }; };
+		property long long EvaluatedSize { long long get() { return _evaluatedSize; }; };
+		// held-out samples compressed one by one, without and with the dictionary
+		property long long CompressedSize { long long get() { return _compressedSize; }; };
+		property long long CompressedSizeWithDictionary { long long get() { return _compressedSizeWithDictionary; }; };
+	};
+
+	// dictionary of LZ4Stream frames, the data is copied (only the last 64 KB are used) and doesn't change
+	// with an id the frames contain the dictionary id, a decompressor finds the dictionary by that id (LZ4Stream::AddDictionary)
+	public ref class LZ4Dictionary sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		Nullable<unsigned int> _id;
+		char* _data = nullptr;
+		int _length = 0;
+		// native::LZ4PreparedDictionary, created on first use
+		IntPtr _preparedFast = IntPtr::Zero;
+		IntPtr _preparedHC = IntPtr::Zero;
+		IntPtr _preparedHCFavorDecSpeed = IntPtr::Zero;
+
+		void Init(Nullable<unsigned int> id, array<byte>^ data, int offset, int count);
+		const native::LZ4PreparedDictionary* GetPrepared(IntPtr% slot, bool highCompression, bool favorDecSpeed);
+
+	internal:
+		property const char* DataPtr {
+			const char* get() {
+				return _data;
+			}
+		}
+
+		// hashed once for the compression mode, shared by all encoders that use the dictionary
+		const native::LZ4PreparedDictionary* GetPrepared(int compressionLevel, bool favorDecSpeed);
+
+		// decompress: the dictionary with the id of the frame, otherwise the dictionary for frames without an id
+		static LZ4Dictionary^ Select(const native::LZ4FrameInfo& info, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries);
+
+	public:
+		// without an id the frames don't contain a dictionary id, the decompressor should use the same dictionary (LZ4Stream::Dictionary)
+		LZ4Dictionary(array<byte>^ data);
+		LZ4Dictionary(unsigned int id, array<byte>^ data);
+		LZ4Dictionary(Nullable<unsigned int> id, array<byte>^ data, int offset, int count);
+		!LZ4Dictionary();
+
+		// prepares the dictionary for compressionLevel (0: fast compression, 3 - 12: high compression) before the first compression, otherwise it is prepared when it is first used
+		void Prepare(int compressionLevel, bool favorDecSpeed);
+
+		// trains a dictionary of at most dictionarySize bytes (LZ4FRAME_DICTIONARY_SIZE_MAX) for messages like the samples, the most useful data is at the end
+		// segmentSize and dmerSize: 0 selects them with the held-out samples, otherwise LZ4DICTIONARY_SEGMENT_SIZE_MIN - dictionarySize and LZ4DICTIONARY_DMER_SIZE_MIN - LZ4DICTIONARY_DMER_SIZE_MAX
+		static LZ4DictionaryTrainingResult^ Train(System::Collections::Generic::IEnumerable<array<byte>^>^ samples, int dictionarySize, int segmentSize, int dmerSize);
+		static LZ4DictionaryTrainingResult^ Train(System::Collections::Generic::IEnumerable<array<byte>^>^ samples, int dictionarySize) {
+			return Train(samples, dictionarySize, 0, 0);
+		}
+
+		property Nullable<unsigned int> Id {
+			Nullable<unsigned int> get() {
+				return _id;
+			}
+		}
+
+		// number of bytes that are used
+		property int Length {
+			int get() {
+				return _length;
+			}
+		}
+	};
+}
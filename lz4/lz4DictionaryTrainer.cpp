@@ -0,0 +1,327 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4DictionaryTrainer.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned char       BYTE;
+typedef unsigned int        U32;
+typedef unsigned long long  U64;
+
+#define LZ4DICTIONARY_HASH_LOG 20
+#define LZ4DICTIONARY_HOLDOUT_INTERVAL 5
+
+namespace lz4 {
+	namespace native {
+
+		namespace {
+
+			struct Segment {
+				size_t begin; // first dmer
+				size_t end; // after the last dmer
+				U64 score;
+			};
+
+			// counters are kept per hash of a dmer instead of per dmer, collisions only make the scores less accurate
+			struct CoverContext {
+				const BYTE* data; // training samples
+				size_t dataSize;
+				const int* sampleSizes;
+				int sampleCount;
+				int dmerSize;
+				U32* dmerHashes; // hash of the dmer at every position
+				U32* sampleFrequencies; // number of samples that contain a dmer
+				U32* frequencies; // sample frequencies of the dmers that are not yet in the dictionary
+				U32* segmentCounts; // dmers of the current segment
+				U32* lastSample;
+			};
+
+			U32 HashDmer(const BYTE* p, int dmerSize) {
+				U64 value = 0;
+				memcpy(&value, p, (size_t)dmerSize);
+				return (U32)((value * 0xCF1BBCDCB7A56463ULL) >> (64 - LZ4DICTIONARY_HASH_LOG));
+			}
+
+			size_t DmerCount(const CoverContext* ctx) {
+				return ctx->dataSize >= (size_t)ctx->dmerSize ? ctx->dataSize - (size_t)ctx->dmerSize + 1 : 0;
+			}
+
+			void CountDmers(CoverContext* ctx) {
+				size_t hashTableSize = (size_t)1 << LZ4DICTIONARY_HASH_LOG;
+				memset(ctx->sampleFrequencies, 0, hashTableSize * sizeof(U32));
+				memset(ctx->lastSample, 0xFF, hashTableSize * sizeof(U32));
+
+				size_t dmers = DmerCount(ctx);
+				for (size_t i = 0; i < dmers; i++) {
+					ctx->dmerHashes[i] = HashDmer(ctx->data + i, ctx->dmerSize);
+				}
+
+				// a dmer is counted once per sample, dmers that cross the end of a sample are not counted
+				size_t position = 0;
+				for (int s = 0; s < ctx->sampleCount; s++) {
+					size_t sampleSize = (size_t)ctx->sampleSizes[s];
+					if (sampleSize >= (size_t)ctx->dmerSize) {
+						size_t end = position + sampleSize - (size_t)ctx->dmerSize + 1;
+						for (size_t i = position; i < end; i++) {
+							U32 hash = ctx->dmerHashes[i];
+							if (ctx->lastSample[hash] != (U32)s) {
+								ctx->lastSample[hash] = (U32)s;
+								ctx->sampleFrequencies[hash]++;
+							}
+						}
+					}
+					position += sampleSize;
+				}
+			}
+
+			// the segment of segmentSize bytes in [begin, end) with the highest sum of frequencies of its distinct dmers
+			Segment SelectSegment(CoverContext* ctx, size_t begin, size_t end, int segmentSize) {
+				size_t windowDmers = (size_t)(segmentSize - ctx->dmerSize + 1);
+				Segment best = { begin, begin, 0 };
+				U64 score = 0;
+				size_t windowBegin = begin;
+
+				for (size_t i = begin; i < end; i++) {
+					U32 hash = ctx->dmerHashes[i];
+					if (ctx->segmentCounts[hash] == 0) { score += ctx->frequencies[hash]; }
+					ctx->segmentCounts[hash]++;
+
+					if (i - windowBegin + 1 > windowDmers) {
+						U32 first = ctx->dmerHashes[windowBegin];
+						if (--ctx->segmentCounts[first] == 0) { score -= ctx->frequencies[first]; }
+						windowBegin++;
+					}
+
+					if (score > best.score) {
+						best.begin = windowBegin;
+						best.end = i + 1;
+						best.score = score;
+					}
+				}
+
+				for (size_t i = windowBegin; i < end; i++) {
+					ctx->segmentCounts[ctx->dmerHashes[i]]--;
+				}
+
+				// dmers at the edges that don't occur elsewhere are of no use
+				while (best.begin < best.end && ctx->frequencies[ctx->dmerHashes[best.begin]] <= 1) { best.begin++; }
+				while (best.end > best.begin && ctx->frequencies[ctx->dmerHashes[best.end - 1]] <= 1) { best.end--; }
+
+				// the selected dmers are in the dictionary now, other segments don't gain from them
+				for (size_t i = best.begin; i < best.end; i++) {
+					ctx->frequencies[ctx->dmerHashes[i]] = 0;
+				}
+				return best;
+			}
+
+			int BuildDictionary(CoverContext* ctx, int segmentSize, BYTE* dictionary, int dictionaryCapacity) {
+				size_t dmers = DmerCount(ctx);
+				if (dmers == 0) { return 0; }
+
+				// a single occurrence doesn't make a dmer useful
+				size_t hashTableSize = (size_t)1 << LZ4DICTIONARY_HASH_LOG;
+				for (size_t i = 0; i < hashTableSize; i++) {
+					ctx->frequencies[i] = ctx->sampleFrequencies[i] > 1 ? ctx->sampleFrequencies[i] : 0;
+				}
+
+				// the data is split in epochs, every epoch contributes one segment per pass
+				size_t epochs = (size_t)(dictionaryCapacity / segmentSize);
+				if (epochs == 0) { epochs = 1; }
+				size_t epochSize = dmers / epochs;
+				if (epochSize < (size_t)segmentSize) {
+					epochSize = dmers < (size_t)segmentSize ? dmers : (size_t)segmentSize;
+					epochs = dmers / epochSize;
+				}
+
+				int tail = dictionaryCapacity;
+				size_t emptyEpochs = 0;
+				for (size_t epoch = 0; tail > 0; epoch = (epoch + 1) % epochs) {
+					size_t begin = epoch * epochSize;
+					Segment segment = SelectSegment(ctx, begin, begin + epochSize, segmentSize);
+					if (segment.score == 0 || segment.begin == segment.end) {
+						// stop when no epoch has anything left
+						if (++emptyEpochs >= epochs) { break; }
+						continue;
+					}
+					emptyEpochs = 0;
+
+					// the dictionary is filled from the end, the first segments are the most useful ones
+					int size = (int)(segment.end - segment.begin) + ctx->dmerSize - 1;
+					if (size > tail) { size = tail; }
+					tail -= size;
+					memcpy(dictionary + tail, ctx->data + segment.begin, (size_t)size);
+				}
+
+				int dictionarySize = dictionaryCapacity - tail;
+				memmove(dictionary, dictionary + tail, (size_t)dictionarySize);
+				return dictionarySize;
+			}
+
+			// compressed size of the samples, every sample is compressed on its own like a single message
+			long long Evaluate(const BYTE* samples, const int* sampleSizes, int sampleCount, const BYTE* dictionary, int dictionarySize, LZ4_stream_t* stream, char* buffer) {
+				long long total = 0;
+				const BYTE* sample = samples;
+				for (int i = 0; i < sampleCount; i++) {
+					int sampleSize = sampleSizes[i];
+					if (sampleSize > 0) {
+						LZ4_loadDict(stream, (const char*)dictionary, dictionarySize);
+						int size = LZ4_compress_fast_continue(stream, (const char*)sample, buffer, sampleSize, LZ4_compressBound(sampleSize), 1);
+						total += size > 0 ? size : sampleSize;
+					}
+					sample += sampleSize;
+				}
+				return total;
+			}
+		}
+
+		int LZ4Dictionary_train(void* dictionary, int dictionaryCapacity, const void* samples, const int* sampleSizes, int sampleCount, const LZ4DictionaryTrainerParameters* parameters, LZ4DictionaryTrainerResult* result) {
+			if (dictionary == NULL || dictionaryCapacity <= 0 || dictionaryCapacity > LZ4FRAME_DICTIONARY_SIZE_MAX) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (samples == NULL || sampleSizes == NULL || sampleCount <= 0 || parameters == NULL || result == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+			else if ((parameters->segmentSize == 0) != (parameters->dmerSize == 0)) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (parameters->dmerSize != 0 && (parameters->dmerSize < LZ4DICTIONARY_DMER_SIZE_MIN || parameters->dmerSize > LZ4DICTIONARY_DMER_SIZE_MAX)) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (parameters->segmentSize != 0 && (parameters->segmentSize < LZ4DICTIONARY_SEGMENT_SIZE_MIN || parameters->segmentSize < parameters->dmerSize || parameters->segmentSize > dictionaryCapacity)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			size_t totalSize = 0;
+			int maxSampleSize = 0;
+			for (int i = 0; i < sampleCount; i++) {
+				if (sampleSizes[i] < 0) { return LZ4Frame_ErrorInvalidArgument; }
+				totalSize += (size_t)sampleSizes[i];
+				if (sampleSizes[i] > maxSampleSize) { maxSampleSize = sampleSizes[i]; }
+			}
+
+			// every fifth sample is held out when there are enough samples
+			int evaluatedSamples = sampleCount >= LZ4DICTIONARY_HOLDOUT_INTERVAL ? sampleCount / LZ4DICTIONARY_HOLDOUT_INTERVAL : 0;
+			int trainingSamples = sampleCount - evaluatedSamples;
+
+			memset(result, 0, sizeof(*result));
+			size_t hashTableSize = (size_t)1 << LZ4DICTIONARY_HASH_LOG;
+			BYTE* trainingData = (BYTE*)malloc(totalSize > 0 ? totalSize : 1);
+			BYTE* evaluationData = (BYTE*)malloc(totalSize > 0 ? totalSize : 1);
+			int* trainingSizes = (int*)malloc((size_t)trainingSamples * sizeof(int));
+			int* evaluationSizes = (int*)malloc((size_t)(evaluatedSamples > 0 ? evaluatedSamples : 1) * sizeof(int));
+			U32* dmerHashes = (U32*)malloc((totalSize > 0 ? totalSize : 1) * sizeof(U32));
+			U32* tables = (U32*)malloc(4 * hashTableSize * sizeof(U32));
+			BYTE* candidate = (BYTE*)malloc((size_t)dictionaryCapacity);
+			char* buffer = (char*)malloc((size_t)LZ4_compressBound(maxSampleSize));
+			LZ4_stream_t* stream = LZ4_createStream();
+
+			int status = LZ4Frame_OK;
+			if (trainingData == NULL || evaluationData == NULL || trainingSizes == NULL || evaluationSizes == NULL || dmerHashes == NULL || tables == NULL || candidate == NULL || buffer == NULL || stream == NULL) {
+				status = LZ4Frame_ErrorAllocation;
+			}
+			else {
+				// split the samples
+				size_t trainingSize = 0, evaluationSize = 0;
+				int trainingCount = 0, evaluationCount = 0;
+				const BYTE* sample = (const BYTE*)samples;
+				for (int i = 0; i < sampleCount; i++) {
+					int sampleSize = sampleSizes[i];
+					if (evaluatedSamples > 0 && i % LZ4DICTIONARY_HOLDOUT_INTERVAL == LZ4DICTIONARY_HOLDOUT_INTERVAL - 1) {
+						memcpy(evaluationData + evaluationSize, sample, (size_t)sampleSize);
+						evaluationSize += (size_t)sampleSize;
+						evaluationSizes[evaluationCount++] = sampleSize;
+					}
+					else {
+						memcpy(trainingData + trainingSize, sample, (size_t)sampleSize);
+						trainingSize += (size_t)sampleSize;
+						trainingSizes[trainingCount++] = sampleSize;
+					}
+					sample += sampleSize;
+				}
+
+				CoverContext ctx;
+				ctx.data = trainingData;
+				ctx.dataSize = trainingSize;
+				ctx.sampleSizes = trainingSizes;
+				ctx.sampleCount = trainingCount;
+				ctx.dmerHashes = dmerHashes;
+				ctx.sampleFrequencies = tables;
+				ctx.frequencies = tables + hashTableSize;
+				ctx.segmentCounts = tables + 2 * hashTableSize;
+				ctx.lastSample = tables + 3 * hashTableSize;
+				memset(ctx.segmentCounts, 0, hashTableSize * sizeof(U32));
+
+				static const int dmerSizes[] = { 6, 8 };
+				static const int segmentSizes[] = { 64, 128, 256, 512, 1024, 2048 };
+				int dmerCandidates = parameters->dmerSize != 0 ? 1 : (int)(sizeof(dmerSizes) / sizeof(dmerSizes[0]));
+				int segmentCandidates = parameters->segmentSize != 0 ? 1 : (int)(sizeof(segmentSizes) / sizeof(segmentSizes[0]));
+
+				long long bestCompressedSize = -1;
+				int bestSize = 0;
+				for (int i = 0; i < dmerCandidates; i++) {
+					ctx.dmerSize = parameters->dmerSize != 0 ? parameters->dmerSize : dmerSizes[i];
+					CountDmers(&ctx);
+
+					for (int j = 0; j < segmentCandidates; j++) {
+						int segmentSize = parameters->segmentSize != 0 ? parameters->segmentSize : segmentSizes[j];
+						if (segmentSize > dictionaryCapacity) { continue; }
+
+						int size = BuildDictionary(&ctx, segmentSize, candidate, dictionaryCapacity);
+						if (size == 0) { continue; }
+
+						long long compressedSize = Evaluate(evaluationData, evaluationSizes, evaluationCount, candidate, size, stream, buffer);
+						if (bestCompressedSize < 0 || compressedSize < bestCompressedSize) {
+							bestCompressedSize = compressedSize;
+							bestSize = size;
+							memcpy(dictionary, candidate, (size_t)size);
+							result->segmentSize = segmentSize;
+							result->dmerSize = ctx.dmerSize;
+						}
+					}
+				}
+
+				if (bestSize == 0) {
+					status = LZ4Frame_ErrorNotEnoughSamples;
+				}
+				else {
+					result->evaluatedSamples = evaluationCount;
+					result->evaluatedSize = (long long)evaluationSize;
+					result->compressedSize = Evaluate(evaluationData, evaluationSizes, evaluationCount, NULL, 0, stream, buffer);
+					result->compressedSizeWithDictionary = bestCompressedSize;
+					status = bestSize;
+				}
+			}
+
+			if (stream != NULL) { LZ4_freeStream(stream); }
+			free(buffer);
+			free(candidate);
+			free(tables);
+			free(dmerHashes);
+			free(evaluationSizes);
+			free(trainingSizes);
+			free(evaluationData);
+			free(trainingData);
+			return status;
+		}
+	}
+}
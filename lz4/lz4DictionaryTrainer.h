@@ -0,0 +1,63 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4Frame.h"
+
+// dictionary training for small messages, based on the segment selection of the COVER algorithm of zstd (Liao, Petri, Moffat, Wirth: Effective Construction of Relative Lempel-Ziv Dictionaries)
+
+#define LZ4DICTIONARY_SEGMENT_SIZE_MIN 16
+#define LZ4DICTIONARY_DMER_SIZE_MIN 4 // MINMATCH
+#define LZ4DICTIONARY_DMER_SIZE_MAX 8
+
+namespace lz4 {
+	namespace native {
+
+		struct LZ4DictionaryTrainerParameters {
+			int segmentSize; // k: size of the parts of the samples that are copied into the dictionary, 0: the best of several sizes for the held-out samples
+			int dmerSize; // d: length of the substrings that are counted, LZ4DICTIONARY_DMER_SIZE_MIN - LZ4DICTIONARY_DMER_SIZE_MAX, 0: selected together with the segment size
+		};
+
+		// every fifth sample is held out for the evaluation (at least five samples), the dictionary is trained with the other samples
+		struct LZ4DictionaryTrainerResult {
+			int segmentSize;
+			int dmerSize;
+			int evaluatedSamples;
+			long long evaluatedSize; // total size of the held-out samples
+			long long compressedSize; // held-out samples compressed one by one without dictionary
+			long long compressedSizeWithDictionary; // held-out samples compressed one by one with the dictionary
+		};
+
+		// trains a dictionary of at most dictionaryCapacity (LZ4FRAME_DICTIONARY_SIZE_MAX) bytes, samples contains the samples one after another
+		// the most useful segments are at the end of the dictionary, returns the size of the dictionary
+		int LZ4Dictionary_train(void* dictionary, int dictionaryCapacity, const void* samples, const int* sampleSizes, int sampleCount, const LZ4DictionaryTrainerParameters* parameters, LZ4DictionaryTrainerResult* result);
+	}
+}
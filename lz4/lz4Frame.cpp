@@ -0,0 +1,1124 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#include "lz4Frame.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define KB *(1 <<10)
+#define MB *(1 <<20)
+
+typedef unsigned char       BYTE;
+typedef unsigned int        U32;
+typedef unsigned long long  U64;
+
+namespace lz4 {
+	namespace native {
+
+		static void WriteLE32(void* dst, U32 value) {
+			BYTE* p = (BYTE*)dst;
+			p[0] = (BYTE)(value & 0xFF);
+			p[1] = (BYTE)((value >> 8) & 0xFF);
+			p[2] = (BYTE)((value >> 16) & 0xFF);
+			p[3] = (BYTE)((value >> 24) & 0xFF);
+		}
+
+		static U32 ReadLE32(const void* src) {
+			const BYTE* p = (const BYTE*)src;
+			return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+		}
+
+		static void WriteLE64(void* dst, U64 value) {
+			WriteLE32(dst, (U32)(value & 0xFFFFFFFF));
+			WriteLE32((BYTE*)dst + 4, (U32)(value >> 32));
+		}
+
+		static U64 ReadLE64(const void* src) {
+			return (U64)ReadLE32(src) | ((U64)ReadLE32((const BYTE*)src + 4) << 32);
+		}
+
+		static bool IsValidMemoryUsage(bool highCompression, int memoryUsage) {
+			if (memoryUsage == 0) { return true; }
+			else if (!highCompression) { return LZ4_sizeofStateEx(memoryUsage) != 0; }
+			return LZ4_sizeofStateHCEx(memoryUsage - 2) != 0;
+		}
+
+		// the compressors are instantiated for every fast table size, high compression uses part of its table
+		class LZ4FrameHeapStateAllocator : public LZ4FrameStateAllocator {
+		public:
+			virtual LZ4_stream_t* RentStream(int memoryUsage) {
+				return memoryUsage != 0 ? LZ4_createStreamEx(memoryUsage) : LZ4_createStream();
+			}
+
+			virtual void ReturnStream(LZ4_stream_t* stream, int /*memoryUsage*/) {
+				LZ4_freeStream(stream);
+			}
+
+			virtual LZ4_streamHC_t* RentStreamHC(int memoryUsage) {
+				return memoryUsage != 0 ? LZ4_createStreamHCEx(memoryUsage - 2) : LZ4_createStreamHC();
+			}
+
+			virtual void ReturnStreamHC(LZ4_streamHC_t* stream, int /*memoryUsage*/) {
+				LZ4_freeStreamHC(stream);
+			}
+		};
+
+		static LZ4FrameHeapStateAllocator HeapStateAllocator;
+
+		LZ4FrameStateAllocator* LZ4Frame_getHeapStateAllocator() {
+			return &HeapStateAllocator;
+		}
+
+		const char* LZ4Frame_getErrorName(int code) {
+			switch (code) {
+			case LZ4Frame_OK: return "OK";
+			case LZ4Frame_ErrorInvalidArgument: return "Invalid argument";
+			case LZ4Frame_ErrorAllocation: return "Allocation failed";
+			case LZ4Frame_ErrorDstTooSmall: return "Destination buffer is too small";
+			case LZ4Frame_ErrorCompressFailed: return "Compress failed";
+			case LZ4Frame_ErrorDecompressFailed: return "Decompress failed";
+			case LZ4Frame_ErrorInvalidMagic: return "lz4 stream is corrupt";
+			case LZ4Frame_ErrorUnexpectedVersion: return "Unexpected frame version";
+			case LZ4Frame_ErrorPredefinedDictionary: return "Predefined dictionaries are not supported";
+			case LZ4Frame_ErrorReservedValue: return "Header contains unexpected value";
+			case LZ4Frame_ErrorUnsupportedBlockSize: return "Unsupported block size";
+			case LZ4Frame_ErrorFrameChecksum: return "Frame checksum is invalid";
+			case LZ4Frame_ErrorBlockSizeExceeded: return "Block size exceeds maximum block size";
+			case LZ4Frame_ErrorBlockChecksum: return "Block checksum did not match";
+			case LZ4Frame_ErrorContentChecksum: return "Content checksum did not match";
+			case LZ4Frame_ErrorChecksumUpdate: return "Failed to update content checksum";
+			case LZ4Frame_ErrorTruncated: return "Unexpected end of stream";
+			case LZ4Frame_ErrorContentSize: return "Content size did not match";
+			case LZ4Frame_ErrorDictionaryMissing: return "Dictionary is not available";
+			case LZ4Frame_ErrorNotEnoughSamples: return "Not enough samples to train a dictionary";
+			default: return "Unknown error";
+			}
+		}
+
+		int LZ4Frame_getBlockSize(int blockSizeId) {
+			switch (blockSizeId) {
+			case 4: return 64 KB;
+			case 5: return 256 KB;
+			case 6: return 1 MB;
+			case 7: return 4 MB;
+			default: return LZ4Frame_ErrorUnsupportedBlockSize;
+			}
+		}
+
+		int LZ4Frame_writeHeader(const LZ4FrameInfo* info, void* dst, int dstCapacity) {
+			if (info == NULL || dst == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+			if (LZ4Frame_isError(LZ4Frame_getBlockSize(info->blockSizeId))) { return LZ4Frame_ErrorUnsupportedBlockSize; }
+
+			int descriptorSize = 2 + (info->hasContentSize ? 8 : 0) + (info->hasDictionaryId ? 4 : 0);
+			int size = 4 + descriptorSize + 1;
+			if (dstCapacity < size) { return LZ4Frame_ErrorDstTooSmall; }
+
+			BYTE* op = (BYTE*)dst;
+			WriteLE32(op, LZ4FRAME_MAGIC);
+
+			BYTE* descriptor = op + 4;
+			descriptor[0] = 0x40; // version 01
+			if (info->contentChecksum) { descriptor[0] |= 0x04; }
+			if (info->hasContentSize) { descriptor[0] |= 0x08; }
+			if (info->blockChecksum) { descriptor[0] |= 0x10; }
+			if (info->independentBlocks) { descriptor[0] |= 0x20; }
+			if (info->hasDictionaryId) { descriptor[0] |= 0x01; }
+			descriptor[1] = (BYTE)(info->blockSizeId << 4);
+			if (info->hasContentSize) {
+				WriteLE64(descriptor + 2, info->contentSize);
+			}
+			if (info->hasDictionaryId) {
+				WriteLE32(descriptor + 2 + (info->hasContentSize ? 8 : 0), info->dictionaryId);
+			}
+
+			U32 xxh = XXH32(descriptor, descriptorSize, 0);
+			descriptor[descriptorSize] = (BYTE)((xxh >> 8) & 0xFF);
+			return size;
+		}
+
+		int LZ4Frame_writeEmptyFrame(const LZ4FrameInfo* info, void* dst, int dstCapacity) {
+			if (info == NULL || dst == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+
+			// no checksums, there is no content
+			LZ4FrameInfo emptyInfo;
+			memset(&emptyInfo, 0, sizeof(emptyInfo));
+			emptyInfo.blockSizeId = info->blockSizeId;
+			emptyInfo.independentBlocks = info->independentBlocks;
+
+			int size = LZ4Frame_writeHeader(&emptyInfo, dst, dstCapacity);
+			if (LZ4Frame_isError(size)) { return size; }
+			if (dstCapacity - size < 4) { return LZ4Frame_ErrorDstTooSmall; }
+
+			WriteLE32((BYTE*)dst + size, 0); // end mark
+			return size + 4;
+		}
+
+		int LZ4Frame_writeSkippableHeader(int id, unsigned int frameSize, void* dst, int dstCapacity) {
+			if (id < 0 || id > 15 || dst == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+			if (dstCapacity < LZ4FRAME_SKIPPABLE_HEADER_SIZE) { return LZ4Frame_ErrorDstTooSmall; }
+
+			WriteLE32(dst, LZ4FRAME_SKIPPABLE_MAGIC + (U32)id);
+			WriteLE32((BYTE*)dst + 4, frameSize);
+			return LZ4FRAME_SKIPPABLE_HEADER_SIZE;
+		}
+
+		LZ4PreparedDictionary::LZ4PreparedDictionary() : _dictionary(NULL), _dictionarySize(0), _favorDecSpeed(false), _lz4Stream(NULL), _lz4HCStream(NULL) {
+		}
+
+		LZ4PreparedDictionary::~LZ4PreparedDictionary() {
+			Release();
+		}
+
+		void LZ4PreparedDictionary::Release() {
+			if (_lz4Stream != NULL) { LZ4_freeStream(_lz4Stream); _lz4Stream = NULL; }
+			if (_lz4HCStream != NULL) { LZ4_freeStreamHC(_lz4HCStream); _lz4HCStream = NULL; }
+		}
+
+		int LZ4PreparedDictionary::Init(const void* dictionary, int dictionarySize, bool highCompression, bool favorDecSpeed) {
+			if (dictionary == NULL || dictionarySize <= 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			if (dictionarySize > LZ4FRAME_DICTIONARY_SIZE_MAX) {
+				dictionary = (const char*)dictionary + (dictionarySize - LZ4FRAME_DICTIONARY_SIZE_MAX);
+				dictionarySize = LZ4FRAME_DICTIONARY_SIZE_MAX;
+			}
+
+			Release();
+			if (!highCompression) {
+				_lz4Stream = LZ4_createStream();
+				if (_lz4Stream == NULL) { return LZ4Frame_ErrorAllocation; }
+				LZ4_loadDict(_lz4Stream, (const char*)dictionary, dictionarySize);
+			}
+			else {
+				// the chain is the same for every level, the working stream keeps its own level
+				_lz4HCStream = LZ4_createStreamHC();
+				if (_lz4HCStream == NULL) { return LZ4Frame_ErrorAllocation; }
+				LZ4_loadDictHC(_lz4HCStream, (const char*)dictionary, dictionarySize);
+				LZ4_favorDecompressionSpeed(_lz4HCStream, favorDecSpeed ? 1 : 0);
+			}
+
+			_dictionary = (const char*)dictionary;
+			_dictionarySize = dictionarySize;
+			_favorDecSpeed = highCompression && favorDecSpeed;
+			return LZ4Frame_OK;
+		}
+
+		LZ4FrameEncoder::LZ4FrameEncoder() : _allocator(&HeapStateAllocator), _blockSize(0), _highCompression(false), _blockCount(0), _frameContentSize(0), _dictionary(NULL), _dictionarySize(0), _preparedDictionary(NULL), _lz4Stream(NULL), _lz4HCStream(NULL), _contentHashState(NULL) {
+			memset(&_info, 0, sizeof(_info));
+			memset(&_options, 0, sizeof(_options));
+		}
+
+		LZ4FrameEncoder::LZ4FrameEncoder(LZ4FrameStateAllocator* allocator) : _allocator(allocator != NULL ? allocator : &HeapStateAllocator), _blockSize(0), _highCompression(false), _blockCount(0), _frameContentSize(0), _dictionary(NULL), _dictionarySize(0), _preparedDictionary(NULL), _lz4Stream(NULL), _lz4HCStream(NULL), _contentHashState(NULL) {
+			memset(&_info, 0, sizeof(_info));
+			memset(&_options, 0, sizeof(_options));
+		}
+
+		LZ4FrameEncoder::~LZ4FrameEncoder() {
+			Release();
+		}
+
+		void LZ4FrameEncoder::Release() {
+			ReleaseStreams();
+			if (_contentHashState != NULL) { XXH32_freeState(_contentHashState); _contentHashState = NULL; }
+		}
+
+		void LZ4FrameEncoder::ReleaseStreams() {
+			if (_lz4Stream != NULL) { _allocator->ReturnStream(_lz4Stream, _options.memoryUsage); _lz4Stream = NULL; }
+			if (_lz4HCStream != NULL) { _allocator->ReturnStreamHC(_lz4HCStream, _options.memoryUsage); _lz4HCStream = NULL; }
+		}
+
+		int LZ4FrameEncoder::Init(const LZ4FrameInfo* info, const LZ4FrameCompressionOptions* options) {
+			if (info == NULL || options == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (options->compressionLevel != 0 && (options->compressionLevel < LZ4HC_CLEVEL_MIN || options->compressionLevel > LZ4HC_CLEVEL_MAX)) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (options->acceleration < 1 || options->acceleration > LZ4FRAME_ACCELERATION_MAX) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (options->restartInterval < 0) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (!IsValidMemoryUsage(options->compressionLevel != 0, options->memoryUsage)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			int blockSize = LZ4Frame_getBlockSize(info->blockSizeId);
+			if (LZ4Frame_isError(blockSize)) { return blockSize; }
+
+			bool highCompression = options->compressionLevel != 0;
+
+			// the first block of a frame resets a stream that is kept
+			if (highCompression != _highCompression || options->memoryUsage != _options.memoryUsage) {
+				ReleaseStreams();
+			}
+			if (!highCompression) {
+				if (_lz4Stream == NULL) { _lz4Stream = _allocator->RentStream(options->memoryUsage); }
+				if (_lz4Stream == NULL) { return LZ4Frame_ErrorAllocation; }
+			}
+			else {
+				if (_lz4HCStream == NULL) { _lz4HCStream = _allocator->RentStreamHC(options->memoryUsage); }
+				if (_lz4HCStream == NULL) { return LZ4Frame_ErrorAllocation; }
+				// the level is kept when the stream is reset
+				LZ4_setCompressionLevel(_lz4HCStream, options->compressionLevel);
+			}
+			// the states are returned with this size
+			_highCompression = highCompression;
+			_options.memoryUsage = options->memoryUsage;
+
+			if (info->contentChecksum) {
+				if (_contentHashState == NULL) { _contentHashState = XXH32_createState(); }
+				if (_contentHashState == NULL) { return LZ4Frame_ErrorAllocation; }
+				XXH32_reset(_contentHashState, 0);
+			}
+			else if (_contentHashState != NULL) {
+				XXH32_freeState(_contentHashState);
+				_contentHashState = NULL;
+			}
+
+			_info = *info;
+			_options = *options;
+			_blockSize = blockSize;
+			_highCompression = highCompression;
+			_blockCount = 0;
+			_frameContentSize = 0;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetAcceleration(int acceleration) {
+			if (acceleration < 1 || acceleration > LZ4FRAME_ACCELERATION_MAX) { return LZ4Frame_ErrorInvalidArgument; }
+
+			_options.acceleration = acceleration;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetRestartInterval(int restartInterval) {
+			if (restartInterval < 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			_options.restartInterval = restartInterval;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetMemoryUsage(int memoryUsage) {
+			if (_blockSize == 0 || _blockCount > 0 || !IsValidMemoryUsage(_highCompression, memoryUsage)) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (memoryUsage == _options.memoryUsage) { return LZ4Frame_OK; }
+
+			// the first block of the frame resets the new stream
+			if (!_highCompression) {
+				LZ4_stream_t* stream = _allocator->RentStream(memoryUsage);
+				if (stream == NULL) { return LZ4Frame_ErrorAllocation; }
+				_allocator->ReturnStream(_lz4Stream, _options.memoryUsage);
+				_lz4Stream = stream;
+			}
+			else {
+				LZ4_streamHC_t* stream = _allocator->RentStreamHC(memoryUsage);
+				if (stream == NULL) { return LZ4Frame_ErrorAllocation; }
+				LZ4_setCompressionLevel(stream, _options.compressionLevel);
+				_allocator->ReturnStreamHC(_lz4HCStream, _options.memoryUsage);
+				_lz4HCStream = stream;
+			}
+
+			_options.memoryUsage = memoryUsage;
+			// prepared with the default table size
+			if (memoryUsage != 0) { _preparedDictionary = NULL; }
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetContentSize(bool hasContentSize, unsigned long long contentSize) {
+			if (_blockSize == 0 || _blockCount > 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			_info.hasContentSize = hasContentSize;
+			_info.contentSize = hasContentSize ? contentSize : 0;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetDictionaryId(bool hasDictionaryId, unsigned int dictionaryId) {
+			if (_blockSize == 0 || _blockCount > 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			_info.hasDictionaryId = hasDictionaryId;
+			_info.dictionaryId = hasDictionaryId ? dictionaryId : 0;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetDictionary(const void* dictionary, int dictionarySize) {
+			if (_blockSize == 0 || dictionarySize < 0 || (dictionary == NULL && dictionarySize > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			if (dictionarySize > LZ4FRAME_DICTIONARY_SIZE_MAX) {
+				dictionary = (const char*)dictionary + (dictionarySize - LZ4FRAME_DICTIONARY_SIZE_MAX);
+				dictionarySize = LZ4FRAME_DICTIONARY_SIZE_MAX;
+			}
+			_dictionary = dictionarySize > 0 ? (const char*)dictionary : NULL;
+			_dictionarySize = dictionarySize;
+			_preparedDictionary = NULL;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::SetPreparedDictionary(const LZ4PreparedDictionary* dictionary) {
+			int status = dictionary != NULL ? SetDictionary(dictionary->Dictionary(), dictionary->DictionarySize()) : SetDictionary(NULL, 0);
+			if (LZ4Frame_isError(status)) { return status; }
+
+			// a dictionary that was prepared for the other compression mode or table size is loaded as before
+			if (dictionary != NULL && dictionary->HighCompression() == _highCompression && (!_highCompression || dictionary->FavorDecSpeed() == _options.favorDecSpeed) && _options.memoryUsage == 0) {
+				_preparedDictionary = dictionary;
+			}
+			return LZ4Frame_OK;
+		}
+
+		void LZ4FrameEncoder::ResetStream(bool useDictionary) {
+			// the dictionary is the history of the first block
+			if (!useDictionary || _dictionarySize == 0) {
+				// a restart point or a block without dictionary, decoders continue with the history of the previous block
+				// the tables are kept, the positions of the previous blocks are more than LZ4_DISTANCE_MAX back (a failed stream is cleared)
+				if (!_highCompression) {
+					LZ4_resetStream_fast(_lz4Stream);
+					// a cleared table starts at offset 0, its empty entries would be candidates, the output does not depend on the previous use of the stream
+					if (_lz4Stream->internal_donotuse.currentOffset == 0) { LZ4_loadDict(_lz4Stream, NULL, 0); }
+				}
+				else {
+					LZ4_resetStreamHC_fast(_lz4HCStream, _options.compressionLevel);
+					LZ4_favorDecompressionSpeed(_lz4HCStream, _options.favorDecSpeed ? 1 : 0);
+				}
+			}
+			else if (_preparedDictionary != NULL) {
+				// attached read-only, the first block references the tables of the prepared dictionary
+				if (!_highCompression) {
+					LZ4_resetStream_fast(_lz4Stream);
+					LZ4_attach_dictionary(_lz4Stream, _preparedDictionary->Stream());
+				}
+				else {
+					LZ4_resetStreamHC_fast(_lz4HCStream, _options.compressionLevel);
+					LZ4_favorDecompressionSpeed(_lz4HCStream, _options.favorDecSpeed ? 1 : 0);
+					LZ4_attach_HC_dictionary(_lz4HCStream, _preparedDictionary->StreamHC());
+				}
+			}
+			else if (!_highCompression) {
+				LZ4_loadDict(_lz4Stream, _dictionary, _dictionarySize);
+			}
+			else {
+				LZ4_loadDictHC(_lz4HCStream, _dictionary, _dictionarySize);
+				// not kept by LZ4_loadDictHC
+				LZ4_favorDecompressionSpeed(_lz4HCStream, _options.favorDecSpeed ? 1 : 0);
+			}
+		}
+
+		int LZ4FrameEncoder::BeginFrame(void* dst, int dstCapacity) {
+			if (_blockSize == 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			int size = LZ4Frame_writeHeader(&_info, dst, dstCapacity);
+			if (LZ4Frame_isError(size)) { return size; }
+
+			_blockCount = 0;
+			_frameContentSize = 0;
+			return size;
+		}
+
+		int LZ4FrameEncoder::UpdateContentChecksum(const void* src, int srcSize) {
+			_frameContentSize += (unsigned long long)srcSize;
+			if (_contentHashState == NULL) { return LZ4Frame_OK; }
+
+			if (XXH32_update(_contentHashState, src, (size_t)srcSize) != XXH_OK) {
+				return LZ4Frame_ErrorChecksumUpdate;
+			}
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameEncoder::CompressBlock(const char* src, int srcSize, void* dst, int dstCapacity) {
+			if (_blockSize == 0 || src == NULL || dst == NULL || srcSize <= 0) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (srcSize > _blockSize) { return LZ4Frame_ErrorBlockSizeExceeded; }
+			else if (dstCapacity < LZ4FRAME_BLOCK_BOUND(srcSize)) { return LZ4Frame_ErrorDstTooSmall; }
+
+			if (_info.independentBlocks || _blockCount == 0) {
+				// reset the stream { create independently compressed blocks }
+				ResetStream(true);
+			}
+			else if (_options.restartInterval > 0 && _blockCount % _options.restartInterval == 0) {
+				// linked blocks, the block doesn't reference the blocks before it
+				ResetStream(false);
+			}
+
+			int status = UpdateContentChecksum(src, srcSize);
+			if (LZ4Frame_isError(status)) { return status; }
+
+			char* blockData = (char*)dst + LZ4FRAME_BLOCK_HEADER_SIZE;
+			int maxOutputSize = dstCapacity - LZ4FRAME_BLOCK_HEADER_SIZE - LZ4FRAME_CHECKSUM_SIZE;
+			if (maxOutputSize > _blockSize) { maxOutputSize = _blockSize; }
+
+			int outputBytes;
+			if (!_highCompression) {
+				outputBytes = LZ4_compress_fast_continue(_lz4Stream, src, blockData, srcSize, maxOutputSize, _options.acceleration);
+			}
+			else {
+				outputBytes = LZ4_compress_HC_continue(_lz4HCStream, src, blockData, srcSize, maxOutputSize);
+			}
+
+			if (outputBytes < 0) {
+				return LZ4Frame_ErrorCompressFailed;
+			}
+
+			bool isCompressed = outputBytes > 0 && outputBytes < srcSize;
+			int targetSize;
+			if (isCompressed) {
+				targetSize = outputBytes;
+			}
+			else {
+				// compression failed, output is too large or compressed size is bigger than input size
+				memcpy(blockData, src, (size_t)srcSize);
+				targetSize = srcSize;
+			}
+
+			WriteLE32(dst, (U32)targetSize | (isCompressed ? 0 : 0x80000000U));
+			int size = LZ4FRAME_BLOCK_HEADER_SIZE + targetSize;
+
+			if (_info.blockChecksum) {
+				WriteLE32(blockData + targetSize, XXH32(blockData, (size_t)targetSize, 0));
+				size += LZ4FRAME_CHECKSUM_SIZE;
+			}
+
+			_blockCount++;
+			return size;
+		}
+
+		int LZ4FrameEncoder::EndFrame(void* dst, int dstCapacity) {
+			if (_blockSize == 0 || dst == NULL) { return LZ4Frame_ErrorInvalidArgument; }
+
+			int size = 4 + (_info.contentChecksum ? LZ4FRAME_CHECKSUM_SIZE : 0);
+			if (dstCapacity < size) { return LZ4Frame_ErrorDstTooSmall; }
+			else if (_info.hasContentSize && _frameContentSize != _info.contentSize) { return LZ4Frame_ErrorContentSize; }
+
+			// end mark
+			WriteLE32(dst, 0);
+
+			if (_info.contentChecksum) {
+				U32 xxh = XXH32_digest(_contentHashState);
+				XXH32_reset(_contentHashState, 0); // reset for next frame
+				WriteLE32((BYTE*)dst + 4, xxh);
+			}
+
+			ResetStream(true);
+			_blockCount = 0;
+			_frameContentSize = 0;
+			return size;
+		}
+
+		int LZ4FrameEncoder::CompressFrames(const char* src, int srcSize, long long blocksPerFrame, void* dst, int dstCapacity) {
+			if (_blockSize == 0 || (src == NULL && srcSize > 0) || srcSize < 0 || dst == NULL || dstCapacity < 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			char* const ostart = (char*)dst;
+			char* const oend = ostart + dstCapacity;
+			char* op = ostart;
+			int position = 0;
+
+			do {
+				if (_info.hasContentSize) {
+					long long frameSize = srcSize - position;
+					if (blocksPerFrame > 0 && frameSize / _blockSize >= blocksPerFrame) { frameSize = blocksPerFrame * _blockSize; }
+					_info.contentSize = (unsigned long long)frameSize;
+				}
+
+				int size = BeginFrame(op, (int)(oend - op));
+				if (LZ4Frame_isError(size)) { return size; }
+				op += size;
+
+				// linked blocks use the previous block of src as dictionary, it doesn't move
+				long long blocks = 0;
+				while (position < srcSize && (blocksPerFrame <= 0 || blocks < blocksPerFrame)) {
+					int blockSize = srcSize - position;
+					if (blockSize > _blockSize) { blockSize = _blockSize; }
+
+					size = CompressBlock(src + position, blockSize, op, (int)(oend - op));
+					if (LZ4Frame_isError(size)) { return size; }
+					op += size;
+					position += blockSize;
+					blocks++;
+				}
+
+				size = EndFrame(op, (int)(oend - op));
+				if (LZ4Frame_isError(size)) { return size; }
+				op += size;
+			} while (position < srcSize);
+
+			return (int)(op - ostart);
+		}
+
+		long long LZ4Frame_compressBound(const LZ4FrameInfo* info, long long srcSize, long long blocksPerFrame) {
+			if (info == NULL || srcSize < 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			int blockSize = LZ4Frame_getBlockSize(info->blockSizeId);
+			if (LZ4Frame_isError(blockSize)) { return blockSize; }
+
+			// blocks that don't compress are stored as is
+			long long blocks = (srcSize + blockSize - 1) / blockSize;
+			long long frames = blocksPerFrame > 0 ? (blocks + blocksPerFrame - 1) / blocksPerFrame : 1;
+			if (frames == 0) { frames = 1; }
+			return frames * (LZ4FRAME_HEADER_SIZE_MAX + LZ4FRAME_END_SIZE_MAX) + blocks * (LZ4FRAME_BLOCK_HEADER_SIZE + LZ4FRAME_CHECKSUM_SIZE) + srcSize;
+		}
+
+		// size and decompressed bound of the frame or skippable frame that starts at istart
+		static int LocateFrame(const BYTE* const istart, const BYTE* const iend, LZ4FrameLocation* frame) {
+			const BYTE* ip = istart;
+			if (iend - ip < 4) { return LZ4Frame_ErrorTruncated; }
+			U32 magic = ReadLE32(ip);
+
+			if ((magic & LZ4FRAME_SKIPPABLE_MAGIC_MASK) == LZ4FRAME_SKIPPABLE_MAGIC) {
+				if (iend - ip < LZ4FRAME_SKIPPABLE_HEADER_SIZE) { return LZ4Frame_ErrorTruncated; }
+				U32 frameSize = ReadLE32(ip + 4);
+				ip += LZ4FRAME_SKIPPABLE_HEADER_SIZE;
+				if ((U64)(iend - ip) < frameSize) { return LZ4Frame_ErrorTruncated; }
+				ip += frameSize;
+
+				frame->size = (int)(ip - istart);
+				frame->decompressedBound = 0;
+				frame->skippable = true;
+				return LZ4Frame_OK;
+			}
+			else if (magic != LZ4FRAME_MAGIC) {
+				return LZ4Frame_ErrorInvalidMagic;
+			}
+
+			// only the fields that are needed to walk the blocks, the decoder verifies the header
+			if (iend - ip < 7) { return LZ4Frame_ErrorTruncated; }
+			BYTE flags = ip[4];
+			int blockSize = LZ4Frame_getBlockSize((ip[5] & 0x70) >> 4);
+			if (LZ4Frame_isError(blockSize)) { return LZ4Frame_ErrorUnsupportedBlockSize; }
+
+			bool hasContentSize = (flags & 0x08) != 0x00;
+			int headerSize = 7 + (hasContentSize ? 8 : 0) + ((flags & 0x01) != 0x00 ? 4 : 0);
+			if (iend - ip < headerSize) { return LZ4Frame_ErrorTruncated; }
+			U64 contentSize = hasContentSize ? ReadLE64(ip + 6) : 0;
+			ip += headerSize;
+
+			// a compressed block decompresses to at most the block size
+			long long frameBound = 0;
+			while (true) {
+				if (iend - ip < LZ4FRAME_BLOCK_HEADER_SIZE) { return LZ4Frame_ErrorTruncated; }
+				U32 value = ReadLE32(ip);
+				ip += LZ4FRAME_BLOCK_HEADER_SIZE;
+
+				U32 size = value & 0x7FFFFFFFU;
+				if (size == 0) { break; }
+				else if (size > (U32)blockSize) { return LZ4Frame_ErrorBlockSizeExceeded; }
+
+				frameBound += (value & 0x80000000U) != 0 ? (long long)size : (long long)blockSize;
+				long long skip = (long long)size + ((flags & 0x10) != 0x00 ? LZ4FRAME_CHECKSUM_SIZE : 0);
+				if (iend - ip < skip) { return LZ4Frame_ErrorTruncated; }
+				ip += skip;
+			}
+
+			if ((flags & 0x04) != 0x00) {
+				if (iend - ip < LZ4FRAME_CHECKSUM_SIZE) { return LZ4Frame_ErrorTruncated; }
+				ip += LZ4FRAME_CHECKSUM_SIZE;
+			}
+
+			if (hasContentSize && contentSize < (U64)frameBound) { frameBound = (long long)contentSize; }
+
+			frame->size = (int)(ip - istart);
+			frame->decompressedBound = frameBound;
+			frame->skippable = false;
+			return LZ4Frame_OK;
+		}
+
+		long long LZ4Frame_getDecompressedBound(const void* src, int srcSize) {
+			if (srcSize < 0 || (src == NULL && srcSize > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			const BYTE* ip = (const BYTE*)src;
+			const BYTE* const iend = ip + srcSize;
+			long long total = 0;
+
+			while (ip < iend) {
+				LZ4FrameLocation frame;
+				int status = LocateFrame(ip, iend, &frame);
+				if (LZ4Frame_isError(status)) { return status; }
+
+				total += frame.decompressedBound;
+				ip += frame.size;
+			}
+
+			return total;
+		}
+
+		int LZ4Frame_locateFrames(const void* src, int srcSize, LZ4FrameLocation* frames, int capacity) {
+			if (srcSize < 0 || (src == NULL && srcSize > 0) || capacity < 0 || (frames == NULL && capacity > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			const BYTE* const istart = (const BYTE*)src;
+			const BYTE* const iend = istart + srcSize;
+			const BYTE* ip = istart;
+			int count = 0;
+
+			while (ip < iend) {
+				LZ4FrameLocation frame;
+				int status = LocateFrame(ip, iend, &frame);
+				if (LZ4Frame_isError(status)) { return status; }
+
+				frame.offset = (int)(ip - istart);
+				if (count < capacity) { frames[count] = frame; }
+				count++;
+				ip += frame.size;
+			}
+
+			return count;
+		}
+
+		int LZ4Frame_decompress(const void* src, int srcSize, void* dst, int dstCapacity) {
+			return LZ4Frame_decompress_usingDict(src, srcSize, dst, dstCapacity, NULL, 0);
+		}
+
+		int LZ4Frame_decompress_usingDict(const void* src, int srcSize, void* dst, int dstCapacity, const void* dictionary, int dictionarySize) {
+			if (srcSize < 0 || (src == NULL && srcSize > 0) || dstCapacity < 0 || (dst == NULL && dstCapacity > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+			else if (dictionarySize < 0 || (dictionary == NULL && dictionarySize > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			LZ4FrameDecoder decoder;
+			// the blocks are decompressed here, directly into dst
+			decoder.SetExternalBlockDecoding(true);
+
+			const char* ip = (const char*)src;
+			const char* const iend = ip + srcSize;
+			char* const ostart = (char*)dst;
+			char* const oend = ostart + dstCapacity;
+			char* op = ostart;
+			char* frameStart = ostart;
+
+			while (true) {
+				int consumed;
+				int frameEvent = decoder.Decode(ip, (int)(iend - ip), &consumed);
+				ip += consumed;
+				if (LZ4Frame_isError(frameEvent)) { return frameEvent; }
+
+				switch (frameEvent) {
+				case LZ4FrameDecoder_NeedInput:
+					if (!decoder.IsAtFrameBoundary()) { return LZ4Frame_ErrorTruncated; }
+					return (int)(op - ostart);
+				case LZ4FrameDecoder_FrameHeader: {
+					frameStart = op;
+					int status = decoder.SetDictionary(dictionary, dictionarySize);
+					if (LZ4Frame_isError(status)) { return status; }
+					break;
+				}
+				case LZ4FrameDecoder_RawBlock: {
+					const LZ4FrameInfo& info = decoder.Info();
+					const char* data = decoder.BlockData();
+					int dataSize = decoder.BlockDataSize();
+
+					if (info.blockChecksum) {
+						// verify checksum
+						if (XXH32(data, (size_t)dataSize, 0) != decoder.BlockChecksum()) { return LZ4Frame_ErrorBlockChecksum; }
+					}
+
+					int capacity = (int)(oend - op);
+					if (capacity > decoder.BlockSize()) { capacity = decoder.BlockSize(); }
+
+					int decompressedSize;
+					if (!decoder.IsBlockCompressed()) {
+						if (dataSize > capacity) { return LZ4Frame_ErrorDstTooSmall; }
+						memcpy(op, data, (size_t)dataSize);
+						decompressedSize = dataSize;
+					}
+					else if (info.independentBlocks || op == frameStart) {
+						if (decoder.Dictionary() != NULL) {
+							decompressedSize = LZ4_decompress_safe_usingDict(data, op, dataSize, capacity, decoder.Dictionary(), decoder.DictionarySize());
+						}
+						else {
+							decompressedSize = LZ4_decompress_safe(data, op, dataSize, capacity);
+						}
+					}
+					else {
+						// the previous blocks of the frame precede the output, use the last 64 KB as dictionary
+						const char* dictionary = op - frameStart > 64 KB ? op - 64 KB : frameStart;
+						decompressedSize = LZ4_decompress_safe_usingDict(data, op, dataSize, capacity, dictionary, (int)(op - dictionary));
+					}
+					if (decompressedSize <= 0) {
+						return capacity < decoder.BlockSize() ? LZ4Frame_ErrorDstTooSmall : LZ4Frame_ErrorDecompressFailed;
+					}
+
+					int status = decoder.UpdateContentChecksum(op, decompressedSize);
+					if (LZ4Frame_isError(status)) { return status; }
+					op += decompressedSize;
+					break;
+				}
+				default:
+					// end mark, frame end and skippable frames
+					break;
+				}
+			}
+		}
+
+		LZ4FrameDecoder::LZ4FrameDecoder() : _blockSize(0), _blockCount(0), _externalBlockDecoding(false), _contentHashState(NULL), _frameContentSize(0), _hasSkippedBlocks(false), _dictionary(NULL), _dictionarySize(0),
+			_inputBuffer(NULL), _inputBufferCapacity(0), _outputBuffer(NULL), _outputBufferCapacity(0), _ownsOutputBuffer(false) {
+			memset(&_info, 0, sizeof(_info));
+			Reset();
+		}
+
+		LZ4FrameDecoder::~LZ4FrameDecoder() {
+			if (_contentHashState != NULL) { XXH32_freeState(_contentHashState); _contentHashState = NULL; }
+			if (_inputBuffer != NULL) { free(_inputBuffer); _inputBuffer = NULL; }
+			if (_ownsOutputBuffer && _outputBuffer != NULL) { free(_outputBuffer); }
+			_outputBuffer = NULL;
+		}
+
+		void LZ4FrameDecoder::Reset() {
+			Expect(Stage_Magic, 4);
+			_blockCount = 0;
+			_output = NULL;
+			_outputSize = 0;
+			_outputOffset = 0;
+			_blockData = NULL;
+			_blockDataSize = 0;
+			_blockIsCompressed = false;
+			_blockChecksum = 0;
+			_skippableId = 0;
+			_skippableSize = 0;
+			_skippableRemaining = 0;
+		}
+
+		void LZ4FrameDecoder::Expect(Stage stage, int size) {
+			_stage = stage;
+			_headerSize = 0;
+			_required = size;
+		}
+
+		void LZ4FrameDecoder::SetOutputBuffer(char* buffer, int capacity) {
+			if (_ownsOutputBuffer && _outputBuffer != NULL) { free(_outputBuffer); }
+			_outputBuffer = buffer;
+			_outputBufferCapacity = buffer != NULL ? capacity : 0;
+			_ownsOutputBuffer = false;
+			_output = NULL;
+			_outputSize = 0;
+		}
+
+		int LZ4FrameDecoder::UpdateContentChecksum(const void* src, int srcSize) {
+			_frameContentSize += (unsigned long long)srcSize;
+			if (!_info.contentChecksum) { return LZ4Frame_OK; }
+
+			if (XXH32_update(_contentHashState, src, (size_t)srcSize) != XXH_OK) {
+				return LZ4Frame_ErrorChecksumUpdate;
+			}
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameDecoder::SetDictionary(const void* dictionary, int dictionarySize) {
+			if (dictionarySize < 0 || (dictionary == NULL && dictionarySize > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			if (dictionarySize > LZ4FRAME_DICTIONARY_SIZE_MAX) {
+				dictionary = (const char*)dictionary + (dictionarySize - LZ4FRAME_DICTIONARY_SIZE_MAX);
+				dictionarySize = LZ4FRAME_DICTIONARY_SIZE_MAX;
+			}
+			_dictionary = dictionarySize > 0 ? (const char*)dictionary : NULL;
+			_dictionarySize = dictionarySize;
+			return LZ4Frame_OK;
+		}
+
+		int LZ4FrameDecoder::SkipBlocks(long long blockCount) {
+			if (_stage != Stage_BlockHeader || _headerSize != 0 || blockCount < 0) { return LZ4Frame_ErrorInvalidArgument; }
+
+			_blockCount += blockCount;
+			_hasSkippedBlocks = true;
+			// the next block is decompressed without the previous block [linked blocks]
+			_output = NULL;
+			_outputSize = 0;
+			_outputOffset = 0;
+			return LZ4Frame_OK;
+		}
+
+		bool LZ4FrameDecoder::IsAtFrameBoundary() const {
+			return _stage == Stage_Magic && _headerSize == 0;
+		}
+
+		int LZ4FrameDecoder::NextInputSize() const {
+			switch (_stage) {
+			case Stage_FrameEnd:
+				return 0;
+			case Stage_SkippableData:
+				return _skippableRemaining > 0x7FFFFFFFU ? 0x7FFFFFFF : (int)_skippableRemaining;
+			default:
+				return _required - _headerSize;
+			}
+		}
+
+		int LZ4FrameDecoder::Decode(const void* src, int srcSize, int* consumed) {
+			if (consumed == NULL || srcSize < 0 || (src == NULL && srcSize > 0)) { return LZ4Frame_ErrorInvalidArgument; }
+
+			const char* const istart = (const char*)src;
+			const char* const iend = istart + srcSize;
+			const char* ip = istart;
+			*consumed = 0;
+
+			while (true) {
+				if (_stage == Stage_FrameEnd) {
+					if (_info.hasContentSize && !_hasSkippedBlocks && _frameContentSize != _info.contentSize) { return LZ4Frame_ErrorContentSize; }
+					Expect(Stage_Magic, 4);
+					return LZ4FrameDecoder_FrameEnd;
+				}
+				else if (_stage == Stage_SkippableData) {
+					if (_skippableRemaining == 0) {
+						Expect(Stage_Magic, 4);
+						return LZ4FrameDecoder_SkippableFrameEnd;
+					}
+					if (ip == iend) {
+						*consumed = (int)(ip - istart);
+						return LZ4FrameDecoder_NeedInput;
+					}
+
+					int chunk = (int)(iend - ip);
+					if ((unsigned int)chunk > _skippableRemaining) { chunk = (int)_skippableRemaining; }
+					_output = ip;
+					_outputSize = chunk;
+					_outputOffset = 0;
+					_skippableRemaining -= (unsigned int)chunk;
+					ip += chunk;
+					*consumed = (int)(ip - istart);
+					return LZ4FrameDecoder_SkippableData;
+				}
+				else if (_stage == Stage_BlockData) {
+					const char* data;
+					if (_headerSize == 0 && iend - ip >= _required) {
+						// the whole block is available, use it in place
+						data = ip;
+						ip += _required;
+					}
+					else {
+						if (_inputBufferCapacity < _required) {
+							if (_inputBuffer != NULL) { free(_inputBuffer); }
+							_inputBufferCapacity = LZ4FRAME_BLOCK_BOUND(_blockSize);
+							_inputBuffer = (char*)malloc((size_t)_inputBufferCapacity);
+							if (_inputBuffer == NULL) { _inputBufferCapacity = 0; return LZ4Frame_ErrorAllocation; }
+						}
+
+						int chunk = (int)(iend - ip);
+						if (chunk > _required - _headerSize) { chunk = _required - _headerSize; }
+						if (chunk > 0) {
+							memcpy(_inputBuffer + _headerSize, ip, (size_t)chunk);
+							_headerSize += chunk;
+							ip += chunk;
+						}
+						if (_headerSize < _required) {
+							*consumed = (int)(ip - istart);
+							return LZ4FrameDecoder_NeedInput;
+						}
+						data = _inputBuffer;
+					}
+
+					*consumed = (int)(ip - istart);
+					return ProcessBlock(data);
+				}
+				else {
+					// fixed size parts are collected in the header buffer
+					int chunk = (int)(iend - ip);
+					if (chunk > _required - _headerSize) { chunk = _required - _headerSize; }
+					if (chunk > 0) {
+						memcpy(_header + _headerSize, ip, (size_t)chunk);
+						_headerSize += chunk;
+						ip += chunk;
+					}
+					*consumed = (int)(ip - istart);
+					if (_headerSize < _required) {
+						return LZ4FrameDecoder_NeedInput;
+					}
+
+					int result = ProcessHeader();
+					if (result != LZ4FrameDecoder_NeedInput) {
+						return result;
+					}
+				}
+			}
+		}
+
+		int LZ4FrameDecoder::ProcessHeader() {
+			switch (_stage) {
+			case Stage_Magic: {
+				U32 magic = ReadLE32(_header);
+				if (magic == LZ4FRAME_MAGIC) {
+					// expect 2 byte descriptor, the header buffer keeps the magic
+					_stage = Stage_Descriptor;
+					_required = 6;
+					return LZ4FrameDecoder_NeedInput;
+				}
+				else if ((magic & LZ4FRAME_SKIPPABLE_MAGIC_MASK) == LZ4FRAME_SKIPPABLE_MAGIC) {
+					_skippableId = (int)(magic & 0xF);
+					_stage = Stage_SkippableSize;
+					_required = LZ4FRAME_SKIPPABLE_HEADER_SIZE;
+					return LZ4FrameDecoder_NeedInput;
+				}
+				return LZ4Frame_ErrorInvalidMagic;
+			}
+			case Stage_Descriptor: {
+				BYTE flags = _header[4];
+				BYTE blockDescriptor = _header[5];
+
+				// verify version
+				if ((flags & 0xC0) != 0x40) { return LZ4Frame_ErrorUnexpectedVersion; }
+				else if ((flags & 0x02) != 0x00) { return LZ4Frame_ErrorReservedValue; }
+				else if ((blockDescriptor & 0x8F) != 0x00) { return LZ4Frame_ErrorReservedValue; }
+
+				int blockSizeId = (blockDescriptor & 0x70) >> 4;
+				if (LZ4Frame_isError(LZ4Frame_getBlockSize(blockSizeId))) { return LZ4Frame_ErrorUnsupportedBlockSize; }
+
+				// content size, dictionary id and header checksum
+				_stage = Stage_HeaderChecksum;
+				_required = 6 + ((flags & 0x08) != 0x00 ? 8 : 0) + ((flags & 0x01) != 0x00 ? 4 : 0) + 1;
+				return LZ4FrameDecoder_NeedInput;
+			}
+			case Stage_HeaderChecksum: {
+				// verify checksum
+				int descriptorSize = _required - 5;
+				U32 xxh = XXH32(_header + 4, (size_t)descriptorSize, 0);
+				if (_header[_required - 1] != (BYTE)((xxh >> 8) & 0xFF)) { return LZ4Frame_ErrorFrameChecksum; }
+
+				BYTE flags = _header[4];
+				LZ4FrameInfo info;
+				memset(&info, 0, sizeof(info));
+				info.blockSizeId = (_header[5] & 0x70) >> 4;
+				info.contentChecksum = (flags & 0x04) != 0x00;
+				info.hasContentSize = (flags & 0x08) != 0x00;
+				info.blockChecksum = (flags & 0x10) != 0x00;
+				info.independentBlocks = (flags & 0x20) != 0x00;
+				info.hasDictionaryId = (flags & 0x01) != 0x00;
+				if (info.hasContentSize) {
+					info.contentSize = ReadLE64(_header + 6);
+				}
+				if (info.hasDictionaryId) {
+					info.dictionaryId = ReadLE32(_header + 6 + (info.hasContentSize ? 8 : 0));
+				}
+
+				if (info.contentChecksum) {
+					if (_contentHashState == NULL) {
+						_contentHashState = XXH32_createState();
+						if (_contentHashState == NULL) { return LZ4Frame_ErrorAllocation; }
+					}
+					XXH32_reset(_contentHashState, 0);
+				}
+
+				_info = info;
+				_blockSize = LZ4Frame_getBlockSize(info.blockSizeId);
+				_blockCount = 0;
+				_frameContentSize = 0;
+				_hasSkippedBlocks = false;
+				_dictionary = NULL;
+				_dictionarySize = 0;
+				_output = NULL;
+				_outputSize = 0;
+				_outputOffset = 0;
+
+				Expect(Stage_BlockHeader, LZ4FRAME_BLOCK_HEADER_SIZE);
+				return LZ4FrameDecoder_FrameHeader;
+			}
+			case Stage_BlockHeader: {
+				U32 value = ReadLE32(_header);
+				U32 blockSize = value & 0x7FFFFFFFU;
+				if (blockSize > (U32)_blockSize) { return LZ4Frame_ErrorBlockSizeExceeded; }
+
+				if (blockSize == 0) {
+					// end mark
+					if (_info.contentChecksum) {
+						Expect(Stage_ContentChecksum, LZ4FRAME_CHECKSUM_SIZE);
+					}
+					else {
+						Expect(Stage_FrameEnd, 0);
+					}
+					return LZ4FrameDecoder_EndMark;
+				}
+
+				_blockIsCompressed = (value & 0x80000000U) == 0;
+				_blockDataSize = (int)blockSize;
+				Expect(Stage_BlockData, _blockDataSize + (_info.blockChecksum ? LZ4FRAME_CHECKSUM_SIZE : 0));
+				return LZ4FrameDecoder_NeedInput;
+			}
+			case Stage_ContentChecksum: {
+				if (!_hasSkippedBlocks) {
+					U32 xxh = XXH32_digest(_contentHashState);
+					if (ReadLE32(_header) != xxh) { return LZ4Frame_ErrorContentChecksum; }
+					else if (_info.hasContentSize && _frameContentSize != _info.contentSize) { return LZ4Frame_ErrorContentSize; }
+				}
+
+				Expect(Stage_Magic, 4);
+				return LZ4FrameDecoder_FrameEnd;
+			}
+			case Stage_SkippableSize: {
+				_skippableSize = ReadLE32(_header + 4);
+				_skippableRemaining = _skippableSize;
+				Expect(Stage_SkippableData, 0);
+				return LZ4FrameDecoder_SkippableFrame;
+			}
+			default:
+				return LZ4Frame_ErrorInvalidArgument;
+			}
+		}
+
+		int LZ4FrameDecoder::ProcessBlock(const char* data) {
+			if (_info.hasDictionaryId && _dictionary == NULL) { return LZ4Frame_ErrorDictionaryMissing; }
+
+			_blockData = data;
+			_blockChecksum = _info.blockChecksum ? ReadLE32(data + _blockDataSize) : 0;
+			_blockCount++;
+			Expect(Stage_BlockHeader, LZ4FRAME_BLOCK_HEADER_SIZE);
+
+			if (_externalBlockDecoding) {
+				return LZ4FrameDecoder_RawBlock;
+			}
+
+			if (_info.blockChecksum) {
+				// verify checksum
+				if (XXH32(data, (size_t)_blockDataSize, 0) != _blockChecksum) { return LZ4Frame_ErrorBlockChecksum; }
+			}
+
+			int requiredCapacity = 2 * _blockSize;
+			if (_outputBufferCapacity < requiredCapacity) {
+				if (_ownsOutputBuffer && _outputBuffer != NULL) { free(_outputBuffer); }
+				_outputBuffer = (char*)malloc((size_t)requiredCapacity);
+				_outputBufferCapacity = _outputBuffer != NULL ? requiredCapacity : 0;
+				_ownsOutputBuffer = true;
+				_output = NULL;
+				if (_outputBuffer == NULL) { return LZ4Frame_ErrorAllocation; }
+			}
+
+			// alternate between the two halves of the output buffer, the previous block stays available as dictionary [linked blocks]
+			const char* previous = _blockCount > 1 ? _output : NULL;
+			int previousSize = previous != NULL ? _outputSize : 0;
+			int outputOffset = (previous != NULL && _outputOffset == 0) ? _blockSize : 0;
+			char* output = _outputBuffer + outputOffset;
+
+			int decompressedSize;
+			if (!_blockIsCompressed) {
+				memcpy(output, data, (size_t)_blockDataSize);
+				decompressedSize = _blockDataSize;
+			}
+			else if ((_info.independentBlocks || previous == NULL) && _dictionary != NULL) {
+				decompressedSize = LZ4_decompress_safe_usingDict(data, output, _blockDataSize, _blockSize, _dictionary, _dictionarySize);
+			}
+			else if (_info.independentBlocks || previous == NULL) {
+				decompressedSize = LZ4_decompress_safe(data, output, _blockDataSize, _blockSize);
+			}
+			else {
+				decompressedSize = LZ4_decompress_safe_usingDict(data, output, _blockDataSize, _blockSize, previous, previousSize);
+			}
+			if (decompressedSize <= 0) { return LZ4Frame_ErrorDecompressFailed; }
+
+			_output = output;
+			_outputSize = decompressedSize;
+			_outputOffset = outputOffset;
+
+			int status = UpdateContentChecksum(output, decompressedSize);
+			if (LZ4Frame_isError(status)) { return status; }
+
+			return LZ4FrameDecoder_Block;
+		}
+	}
+}
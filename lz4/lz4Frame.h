@@ -0,0 +1,363 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4.h"
+#include "lz4hc.h"
+#include "xxhash.h"
+
+// native lz4 frame format engine, it has no CLR dependency so it can be built and tested outside the managed assembly
+
+#define LZ4FRAME_MAGIC 0x184D2204U
+#define LZ4FRAME_SKIPPABLE_MAGIC 0x184D2A50U
+#define LZ4FRAME_SKIPPABLE_MAGIC_MASK 0xFFFFFFF0U
+
+#define LZ4FRAME_HEADER_SIZE_MAX 19 // magic (4) + descriptor (2) + content size (8) + dictionary id (4) + header checksum (1)
+#define LZ4FRAME_SKIPPABLE_HEADER_SIZE 8 // magic (4) + frame size (4)
+#define LZ4FRAME_BLOCK_HEADER_SIZE 4
+#define LZ4FRAME_CHECKSUM_SIZE 4
+#define LZ4FRAME_END_SIZE_MAX 8 // end mark (4) + content checksum (4)
+#define LZ4FRAME_ACCELERATION_MAX 65537 // LZ4_ACCELERATION_MAX, larger values behave the same
+#define LZ4FRAME_DICTIONARY_SIZE_MAX (64 * 1024) // only the last 64 KB of a dictionary are used
+
+// size of a single encoded block of at most blockSize bytes: block size, block data and block checksum
+#define LZ4FRAME_BLOCK_BOUND(blockSize) ((blockSize) + LZ4FRAME_BLOCK_HEADER_SIZE + LZ4FRAME_CHECKSUM_SIZE)
+// frame header, a single block and the frame end, i.e. the maximum output of LZ4FrameEncoder for one block
+#define LZ4FRAME_COMPRESS_BOUND(blockSize) (LZ4FRAME_HEADER_SIZE_MAX + LZ4FRAME_BLOCK_BOUND(blockSize) + LZ4FRAME_END_SIZE_MAX)
+
+namespace lz4 {
+	namespace native {
+
+		// error codes, all functions return a negative value on failure
+		enum LZ4FrameError {
+			LZ4Frame_OK = 0,
+			LZ4Frame_ErrorInvalidArgument = -1,
+			LZ4Frame_ErrorAllocation = -2,
+			LZ4Frame_ErrorDstTooSmall = -3,
+			LZ4Frame_ErrorCompressFailed = -4,
+			LZ4Frame_ErrorDecompressFailed = -5,
+			LZ4Frame_ErrorInvalidMagic = -6,
+			LZ4Frame_ErrorUnexpectedVersion = -7,
+			LZ4Frame_ErrorPredefinedDictionary = -8,
+			LZ4Frame_ErrorReservedValue = -9,
+			LZ4Frame_ErrorUnsupportedBlockSize = -10,
+			LZ4Frame_ErrorFrameChecksum = -11,
+			LZ4Frame_ErrorBlockSizeExceeded = -12,
+			LZ4Frame_ErrorBlockChecksum = -13,
+			LZ4Frame_ErrorContentChecksum = -14,
+			LZ4Frame_ErrorChecksumUpdate = -15,
+			LZ4Frame_ErrorTruncated = -16,
+			LZ4Frame_ErrorContentSize = -17,
+			LZ4Frame_ErrorDictionaryMissing = -18,
+			LZ4Frame_ErrorNotEnoughSamples = -19,
+		};
+
+		inline bool LZ4Frame_isError(int code) { return code < 0; }
+		const char* LZ4Frame_getErrorName(int code);
+
+		struct LZ4FrameInfo {
+			int blockSizeId; // 4: 64 KB, 5: 256 KB, 6: 1 MB, 7: 4 MB
+			bool independentBlocks;
+			bool blockChecksum;
+			bool contentChecksum;
+			bool hasContentSize;
+			unsigned long long contentSize;
+			bool hasDictionaryId;
+			unsigned int dictionaryId;
+		};
+
+		struct LZ4FrameCompressionOptions {
+			int compressionLevel; // 0: fast compression, LZ4HC_CLEVEL_MIN - LZ4HC_CLEVEL_MAX: high compression
+			bool favorDecSpeed; // high compression (LZ4HC_CLEVEL_OPT_MIN and up): prefer matches that decompress faster
+			int acceleration; // fast compression: 1 - LZ4FRAME_ACCELERATION_MAX, higher values are faster and compress less
+			int restartInterval; // linked blocks: every restartInterval blocks a block starts without history (and without dictionary), it can be decompressed without the blocks before it, 0: only the first block of a frame
+			int memoryUsage; // hash table size 2^memoryUsage bytes, 0: default (fast compression: LZ4_MEMORY_USAGE, 12 14 16 18; high compression: 4 << LZ4HC_HASH_LOG, 12 14 16 17 18)
+		};
+
+		// a frame or skippable frame in a buffer of concatenated frames
+		struct LZ4FrameLocation {
+			int offset; // offset of the magic
+			int size; // frame header to content checksum, or the whole skippable frame
+			long long decompressedBound; // the content size when present, the block sizes otherwise (0 for a skippable frame)
+			bool skippable;
+		};
+
+		// block size in bytes for a block size id
+		int LZ4Frame_getBlockSize(int blockSizeId);
+		// writes the frame header (magic, descriptor and header checksum), returns the number of bytes written
+		int LZ4Frame_writeHeader(const LZ4FrameInfo* info, void* dst, int dstCapacity);
+		// writes a frame without blocks, returns the number of bytes written
+		int LZ4Frame_writeEmptyFrame(const LZ4FrameInfo* info, void* dst, int dstCapacity);
+		// writes the header of a skippable frame with id 0-15, the frame data should follow
+		int LZ4Frame_writeSkippableHeader(int id, unsigned int frameSize, void* dst, int dstCapacity);
+
+		// maximum output of LZ4FrameEncoder::CompressFrames for srcSize bytes
+		long long LZ4Frame_compressBound(const LZ4FrameInfo* info, long long srcSize, long long blocksPerFrame);
+		// upper bound of the decompressed size of all frames in src (the content size when present, the block sizes otherwise)
+		long long LZ4Frame_getDecompressedBound(const void* src, int srcSize);
+		// walks the frames in src, writes the locations of the first capacity frames (frames may be NULL to count them), returns the number of frames including skippable frames
+		int LZ4Frame_locateFrames(const void* src, int srcSize, LZ4FrameLocation* frames, int capacity);
+		// decompresses all frames in src directly into dst, skippable frames are ignored, returns the number of bytes written
+		int LZ4Frame_decompress(const void* src, int srcSize, void* dst, int dstCapacity);
+		// as LZ4Frame_decompress, the dictionary is used for every frame (the frames should not have different dictionary ids)
+		int LZ4Frame_decompress_usingDict(const void* src, int srcSize, void* dst, int dstCapacity, const void* dictionary, int dictionarySize);
+
+		// dictionary that is hashed once for fast compression or high compression (any level), the encoders attach it instead of loading the dictionary for every frame or independent block
+		// read-only after Init, it can be shared by encoders on different threads; it keeps a reference to the dictionary data
+		class LZ4PreparedDictionary {
+		public:
+			LZ4PreparedDictionary();
+			~LZ4PreparedDictionary();
+
+			// favorDecSpeed: high compression, should match the encoders (LZ4_attach_HC_dictionary copies it for blocks larger than 4 KB)
+			int Init(const void* dictionary, int dictionarySize, bool highCompression, bool favorDecSpeed);
+
+			const char* Dictionary() const { return _dictionary; }
+			int DictionarySize() const { return _dictionarySize; }
+			bool HighCompression() const { return _lz4HCStream != NULL; }
+			bool FavorDecSpeed() const { return _favorDecSpeed; }
+			const LZ4_stream_t* Stream() const { return _lz4Stream; }
+			const LZ4_streamHC_t* StreamHC() const { return _lz4HCStream; }
+
+		private:
+			LZ4PreparedDictionary(const LZ4PreparedDictionary&);
+			LZ4PreparedDictionary& operator=(const LZ4PreparedDictionary&);
+
+			void Release();
+
+			const char* _dictionary;
+			int _dictionarySize;
+			bool _favorDecSpeed;
+			LZ4_stream_t* _lz4Stream;
+			LZ4_streamHC_t* _lz4HCStream;
+		};
+
+		// supplies the compression states of the encoders, the managed assembly pools them across encoders and threads (LZ4StatePool)
+		// a state is rented for a table size (LZ4FrameCompressionOptions::memoryUsage) and returned with that size, the encoder resets it before the first block
+		class LZ4FrameStateAllocator {
+		public:
+			virtual ~LZ4FrameStateAllocator() {}
+			virtual LZ4_stream_t* RentStream(int memoryUsage) = 0;
+			virtual void ReturnStream(LZ4_stream_t* stream, int memoryUsage) = 0;
+			virtual LZ4_streamHC_t* RentStreamHC(int memoryUsage) = 0;
+			virtual void ReturnStreamHC(LZ4_streamHC_t* stream, int memoryUsage) = 0;
+		};
+
+		// creates and frees the states, the allocator of an encoder without one
+		LZ4FrameStateAllocator* LZ4Frame_getHeapStateAllocator();
+
+		// compresses the blocks of a frame, the caller provides the input and output buffers
+		class LZ4FrameEncoder {
+		public:
+			LZ4FrameEncoder();
+			// the allocator should outlive the encoder
+			explicit LZ4FrameEncoder(LZ4FrameStateAllocator* allocator);
+			~LZ4FrameEncoder();
+
+			// an encoder that is initialized again keeps its states when the compression mode and memoryUsage are the same
+			int Init(const LZ4FrameInfo* info, const LZ4FrameCompressionOptions* options);
+
+			const LZ4FrameInfo& Info() const { return _info; }
+			const LZ4FrameCompressionOptions& Options() const { return _options; }
+			int BlockSize() const { return _blockSize; }
+			long long BlockCount() const { return _blockCount; }
+
+			// acceleration of the next block (fast compression)
+			int SetAcceleration(int acceleration);
+			// restart interval of the next blocks (linked blocks)
+			int SetRestartInterval(int restartInterval);
+			// hash table size of the next frame (at the start of a frame), a prepared dictionary is loaded instead of attached when it is not the default size
+			int SetMemoryUsage(int memoryUsage);
+			// content size that is written in the header of the next frame, EndFrame verifies it
+			int SetContentSize(bool hasContentSize, unsigned long long contentSize);
+			// dictionary id that is written in the header of the next frame
+			int SetDictionaryId(bool hasDictionaryId, unsigned int dictionaryId);
+			// dictionary of the first block of a frame [linked blocks] or of every block [independent blocks], used from the next block that starts without history
+			// the encoder keeps a reference, the dictionary should stay available until it is replaced (NULL removes it)
+			int SetDictionary(const void* dictionary, int dictionarySize);
+			// as SetDictionary, the prepared dictionary is attached instead of loaded when it was prepared for the compression mode of the encoder (and favorDecSpeed)
+			int SetPreparedDictionary(const LZ4PreparedDictionary* dictionary);
+			const char* Dictionary() const { return _dictionary; }
+			int DictionarySize() const { return _dictionarySize; }
+			const LZ4PreparedDictionary* PreparedDictionary() const { return _preparedDictionary; }
+
+			// writes the frame header and resets the block count
+			int BeginFrame(void* dst, int dstCapacity);
+			// compresses a block of at most BlockSize() bytes into dst (block size, block data, block checksum), returns the number of bytes written
+			// linked blocks reference the previous block, it should still be available at the same address
+			int CompressBlock(const char* src, int srcSize, void* dst, int dstCapacity);
+			// updates the content checksum and size, for blocks that are not passed to CompressBlock (compressed by another encoder)
+			int UpdateContentChecksum(const void* src, int srcSize);
+			// writes the end mark and the content checksum, and resets the state for the next frame
+			int EndFrame(void* dst, int dstCapacity);
+			// compresses src in place into complete frames, a new frame is started after blocksPerFrame blocks (0: a single frame), returns the number of bytes written
+			// with a content size every frame contains the size of its own part of src
+			int CompressFrames(const char* src, int srcSize, long long blocksPerFrame, void* dst, int dstCapacity);
+
+		private:
+			LZ4FrameEncoder(const LZ4FrameEncoder&);
+			LZ4FrameEncoder& operator=(const LZ4FrameEncoder&);
+
+			void Release();
+			void ReleaseStreams();
+			void ResetStream(bool useDictionary);
+
+			LZ4FrameStateAllocator* _allocator;
+			LZ4FrameInfo _info;
+			LZ4FrameCompressionOptions _options;
+			int _blockSize;
+			bool _highCompression;
+			long long _blockCount;
+			unsigned long long _frameContentSize;
+			const char* _dictionary;
+			int _dictionarySize;
+			const LZ4PreparedDictionary* _preparedDictionary;
+			LZ4_stream_t* _lz4Stream;
+			LZ4_streamHC_t* _lz4HCStream;
+			XXH32_state_t* _contentHashState;
+		};
+
+		enum LZ4FrameDecoderEvent {
+			LZ4FrameDecoder_NeedInput = 0, // all input has been consumed
+			LZ4FrameDecoder_FrameHeader = 1, // Info() describes the new frame
+			LZ4FrameDecoder_Block = 2, // Output() contains the decompressed block
+			LZ4FrameDecoder_RawBlock = 3, // external block decoding: BlockData() contains the block as it is stored in the frame
+			LZ4FrameDecoder_EndMark = 4, // the last block of the frame has been read
+			LZ4FrameDecoder_FrameEnd = 5, // the frame is complete, the content checksum has been verified
+			LZ4FrameDecoder_SkippableFrame = 6, // SkippableId() and SkippableSize() describe the new skippable frame
+			LZ4FrameDecoder_SkippableData = 7, // Output() contains the next part of the skippable frame data (it points into the input)
+			LZ4FrameDecoder_SkippableFrameEnd = 8,
+		};
+
+		// incremental frame decoder, accepts input in chunks of any size and returns after every event
+		class LZ4FrameDecoder {
+		public:
+			LZ4FrameDecoder();
+			~LZ4FrameDecoder();
+
+			// decodes src until the next event, consumed receives the number of bytes used from src
+			// the output of an event is valid until the next call
+			int Decode(const void* src, int srcSize, int* consumed);
+			// number of bytes needed to complete the current part of the frame, allows exact reads from a stream
+			int NextInputSize() const;
+			// true when no frame or skippable frame is being decoded
+			bool IsAtFrameBoundary() const;
+			void Reset();
+
+			// optional buffer for the decompressed blocks (OutputBufferSize() bytes), only change it after a FrameHeader event
+			void SetOutputBuffer(char* buffer, int capacity);
+			int OutputBufferSize() const { return 2 * _blockSize; }
+			// blocks are returned as RawBlock events and the caller decompresses them (only for independent blocks)
+			void SetExternalBlockDecoding(bool value) { _externalBlockDecoding = value; }
+			// updates the content checksum and size with the blocks that are decompressed by the caller
+			int UpdateContentChecksum(const void* src, int srcSize);
+			// dictionary of the current frame (Info().dictionaryId), set it after the FrameHeader event, every frame header removes it
+			// used for the first block of a frame [linked blocks] or every block [independent blocks], the decoder keeps a reference
+			int SetDictionary(const void* dictionary, int dictionarySize);
+			const char* Dictionary() const { return _dictionary; }
+			int DictionarySize() const { return _dictionarySize; }
+			// continues the frame blockCount blocks later, the caller provides the input from the block header of that block
+			// only before a block header, the content checksum and content size of the frame are not verified
+			// linked blocks: the block should start without history (the first block of the frame or a restart point)
+			int SkipBlocks(long long blockCount);
+
+			const LZ4FrameInfo& Info() const { return _info; }
+			int BlockSize() const { return _blockSize; }
+			long long BlockCount() const { return _blockCount; }
+
+			const char* Output() const { return _output; }
+			int OutputSize() const { return _outputSize; }
+			int OutputOffset() const { return _outputOffset; }
+
+			const char* BlockData() const { return _blockData; }
+			int BlockDataSize() const { return _blockDataSize; }
+			bool IsBlockCompressed() const { return _blockIsCompressed; }
+			unsigned int BlockChecksum() const { return _blockChecksum; }
+
+			int SkippableId() const { return _skippableId; }
+			unsigned int SkippableSize() const { return _skippableSize; }
+
+		private:
+			enum Stage {
+				Stage_Magic,
+				Stage_Descriptor,
+				Stage_HeaderChecksum,
+				Stage_BlockHeader,
+				Stage_BlockData,
+				Stage_ContentChecksum,
+				Stage_FrameEnd,
+				Stage_SkippableSize,
+				Stage_SkippableData,
+			};
+
+			LZ4FrameDecoder(const LZ4FrameDecoder&);
+			LZ4FrameDecoder& operator=(const LZ4FrameDecoder&);
+
+			int ProcessHeader();
+			int ProcessBlock(const char* data);
+			void Expect(Stage stage, int size);
+
+			Stage _stage;
+			unsigned char _header[32];
+			int _headerSize;
+			int _required;
+
+			LZ4FrameInfo _info;
+			int _blockSize;
+			long long _blockCount;
+			bool _externalBlockDecoding;
+			XXH32_state_t* _contentHashState;
+			unsigned long long _frameContentSize;
+			bool _hasSkippedBlocks;
+			const char* _dictionary;
+			int _dictionarySize;
+
+			char* _inputBuffer;
+			int _inputBufferCapacity;
+			char* _outputBuffer;
+			int _outputBufferCapacity;
+			bool _ownsOutputBuffer;
+
+			const char* _output;
+			int _outputSize;
+			int _outputOffset;
+
+			const char* _blockData;
+			int _blockDataSize;
+			bool _blockIsCompressed;
+			unsigned int _blockChecksum;
+
+			int _skippableId;
+			unsigned int _skippableSize;
+			unsigned int _skippableRemaining;
+		};
+	}
+}
@@ -30,11 +30,149 @@
    */
 
 #include "lz4Helper.h"
+#include "lz4FrameResult.h"
+#include "lz4StatePool.h"
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
 #include "lz4.h"
 #include "lz4hc.h"
 
+using namespace System::Runtime::InteropServices;
+
 namespace lz4 {
-	array<Byte>^ LZ4Helper::Custom::Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes)
+	typedef unsigned char byte;
+
+	static int GetCustomHeaderSize(int length)
+	{
+		int i;
+		for (i = 0; length && i < 8; i++) {
+			length >>= 8;
+		}
+		return 2 + i;
+	}
+
+	static int WriteCustomHeader(byte* output, int outputLength, int inputLength, int passes)
+	{
+		int headerSize = GetCustomHeaderSize(inputLength);
+		if (outputLength < headerSize) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
+		}
+
+		output[0] = passes;
+		output[1] = headerSize - 2;
+		for (int i = 0; i < headerSize - 2; i++) {
+			output[2 + i] = ((inputLength >> (8 * i)) & 0xff);
+		}
+		return headerSize;
+	}
+
+	static int ReadCustomHeader(const byte* input, int inputLength, int* passes, int* headerSize)
+	{
+		int sizeOfSize = input[1];
+		if (sizeOfSize > 8 || inputLength < (2 + sizeOfSize) || !(input[0] == 1 || input[0] == 2)) {
+			throw gcnew Exception("Invalid data");
+		}
+
+		unsigned long long fileSize = 0;
+		for (int i = 0; i < sizeOfSize; i++) {
+			if (i >= 4 && input[2 + i] != 0) {
+				throw gcnew Exception("Invalid data");
+			}
+			fileSize |= (((unsigned long long)input[2 + i]) << (8 * i));
+		}
+
+		if (fileSize == 0 || fileSize > Int32::MaxValue)
+		{
+			throw gcnew Exception("Invalid data");
+		}
+
+		*passes = input[0];
+		*headerSize = 2 + sizeOfSize;
+		return (int)fileSize;
+	}
+
+	static int CompressCustom(const byte* input, int inputLength, byte* output, int outputLength, int passes, int compressionLevel, int acceleration)
+	{
+		int offset = WriteCustomHeader(output, outputLength, inputLength, passes);
+
+		// the states are rented from the pool, the output is the same as with a new state (LZ4_compress_fast, LZ4_compress_HC)
+		int compressedSize;
+		LZ4_stream_t* stream = LZ4StatePool::RentStream(0);
+		if (stream == nullptr) { CheckFrameResult(native::LZ4Frame_ErrorAllocation); }
+		try {
+			if (passes == 1) {
+				compressedSize = LZ4_compress_fast_extState_fastReset(stream, (const char*)input, (char*)output + offset, inputLength, outputLength - offset, acceleration);
+			}
+			else {
+				int bufferSize = LZ4_compressBound(inputLength);
+				array<Byte>^ buffer = gcnew array<Byte>(bufferSize);
+				pin_ptr<Byte> bufferPtr = &buffer[0];
+
+				int firstPassSize = LZ4_compress_fast_extState_fastReset(stream, (const char*)input, (char*)bufferPtr, inputLength, bufferSize, acceleration);
+				if (firstPassSize <= 0)
+				{
+					throw gcnew Exception("Compression failed");
+				}
+
+				LZ4_streamHC_t* streamHC = LZ4StatePool::RentStreamHC(0);
+				if (streamHC == nullptr) { CheckFrameResult(native::LZ4Frame_ErrorAllocation); }
+				try {
+					compressedSize = LZ4_compress_HC_extStateHC_fastReset(streamHC, (char*)bufferPtr, (char*)output + offset, firstPassSize, outputLength - offset, compressionLevel);
+				}
+				finally {
+					LZ4StatePool::ReturnStreamHC(streamHC, 0);
+				}
+			}
+		}
+		finally {
+			LZ4StatePool::ReturnStream(stream, 0);
+		}
+
+		if (compressedSize <= 0)
+		{
+			if (outputLength < LZ4Helper::Custom::GetMaxCompressedLength(inputLength, passes)) {
+				throw gcnew ArgumentOutOfRangeException("outputLength");
+			}
+			throw gcnew Exception("Compression failed");
+		}
+		return offset + compressedSize;
+	}
+
+	static int DecompressCustom(const byte* input, int inputLength, byte* output, int outputLength)
+	{
+		int passes, headerSize;
+		int fileSize = ReadCustomHeader(input, inputLength, &passes, &headerSize);
+		if (outputLength < fileSize) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
+		}
+
+		const char* src = (const char*)input + headerSize;
+		int srcSize = inputLength - headerSize;
+
+		array<Byte>^ buffer;
+		pin_ptr<Byte> bufferPtr;
+		if (passes == 2) {
+			int bufferSize = LZ4_compressBound(fileSize);
+			buffer = gcnew array<Byte>(bufferSize);
+			bufferPtr = &buffer[0];
+
+			srcSize = LZ4_decompress_safe(src, (char*)bufferPtr, srcSize, bufferSize);
+			if (srcSize <= 0)
+			{
+				throw gcnew Exception("Decompression failed");
+			}
+			src = (const char*)bufferPtr;
+		}
+
+		int decompressedSize = LZ4_decompress_safe(src, (char*)output, srcSize, fileSize);
+		if (decompressedSize <= 0)
+		{
+			throw gcnew Exception("Decompression failed");
+		}
+		return decompressedSize;
+	}
+
+	array<Byte>^ LZ4Helper::Custom::Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes, int compressionLevel, int acceleration)
 	{
 		if (input == nullptr) {
 			throw gcnew ArgumentNullException("input");
@@ -51,71 +189,126 @@ namespace lz4 {
 		else if (passes < 1 || passes > 2) {
 			throw gcnew ArgumentOutOfRangeException("passes");
 		}
-
-		int bufferSize = LZ4_compressBound(inputLength);
-		int offset = 0;
-		array<Byte>^ result = gcnew array<Byte>(bufferSize + 10);
-		if (passes == 1) {
-			result[0] = 1; // 1 pass
-			offset = inputLength;
-			int i;
-			for (i = 0; offset && i < 8; i++) {
-				result[2 + i] = (offset & 0xff);
-				offset >>= 8;
-			}
-			if (offset != 0) {
-				throw gcnew NotSupportedException("input too large");
-			}
-			result[1] = i;
-			offset = 2 + i;
+		else if (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX) {
+			throw gcnew ArgumentOutOfRangeException("compressionLevel");
+		}
+		else if (acceleration < 1 || acceleration > LZ4FRAME_ACCELERATION_MAX) {
+			throw gcnew ArgumentOutOfRangeException("acceleration");
 		}
 
+		int bufferSize = GetMaxCompressedLength(inputLength, passes);
+		array<Byte>^ result = gcnew array<Byte>(bufferSize);
+
 		pin_ptr<Byte> inputPtr = &input[inputOffset];
-		byte* inputBytePtr = inputPtr;
-		pin_ptr<Byte> outputPtr = &result[offset];
-		byte* outputBytePtr = outputPtr;
+		pin_ptr<Byte> outputPtr = &result[0];
+		int compressedSize = CompressCustom(inputPtr, inputLength, outputPtr, bufferSize, passes, compressionLevel, acceleration);
 
-		int compressedSize = LZ4_compress_default((char*)inputBytePtr, (char*)outputBytePtr, inputLength, bufferSize);
-		if (compressedSize <= 0)
-		{
-			throw gcnew Exception("Compression failed");
+		array<Byte>^ slimResult = gcnew array<Byte>(compressedSize);
+		Buffer::BlockCopy(result, 0, slimResult, 0, compressedSize);
+		return slimResult;
+	}
+
+	array<Byte>^ LZ4Helper::Custom::Decompress(array<Byte>^ input, int inputOffset, int inputLength)
+	{
+		if (input == nullptr) {
+			throw gcnew ArgumentNullException("input");
+		}
+		else if (inputOffset < 0) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset");
+		}
+		else if (inputLength < 3) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
 		}
+		else if (inputOffset + inputLength > input->Length) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
+		}
+
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		int passes, headerSize;
+		int fileSize = ReadCustomHeader(inputPtr, inputLength, &passes, &headerSize);
+
+		// the header contains the decompressed size, the data is decompressed directly into the result
+		array<Byte>^ result = gcnew array<Byte>(fileSize);
+		pin_ptr<Byte> outputPtr = &result[0];
+		int decompressedSize = DecompressCustom(inputPtr, inputLength, outputPtr, fileSize);
 
-		if (passes == 1) {
-			array<Byte>^ slimResult = gcnew array<Byte>(compressedSize + offset);
-			Buffer::BlockCopy(result, 0, slimResult, 0, compressedSize + offset);
+		if (decompressedSize != fileSize) {
+			array<Byte>^ slimResult = gcnew array<Byte>(decompressedSize);
+			Buffer::BlockCopy(result, 0, slimResult, 0, decompressedSize);
 			return slimResult;
 		}
+		return result;
+	}
 
-		int bufferSize2 = LZ4_compressBound(compressedSize);
-		array<Byte>^ result2 = gcnew array<Byte>(bufferSize2 + 10);
-		result2[0] = 2; // 2 pass
-		offset = inputLength;
-		int i;
-		for (i = 0; offset && i < 8; i++) {
-			result2[2 + i] = (offset & 0xff);
-			offset >>= 8;
+	int LZ4Helper::Custom::Compress(array<Byte>^ input, int inputOffset, int inputLength, array<Byte>^ output, int outputOffset, int outputLength, int passes, int compressionLevel, int acceleration)
+	{
+		if (input == nullptr) {
+			throw gcnew ArgumentNullException("input");
 		}
-		if (offset != 0) {
-			throw gcnew NotSupportedException("input too large");
+		else if (inputOffset < 0) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset");
+		}
+		else if (inputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
+		}
+		else if (inputOffset + inputLength > input->Length) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
+		}
+		else if (output == nullptr) {
+			throw gcnew ArgumentNullException("output");
+		}
+		else if (outputOffset < 0) {
+			throw gcnew ArgumentOutOfRangeException("outputOffset");
+		}
+		else if (outputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
+		}
+		else if (outputOffset + outputLength > output->Length) {
+			throw gcnew ArgumentOutOfRangeException("outputOffset+outputLength");
+		}
+		else if (passes < 1 || passes > 2) {
+			throw gcnew ArgumentOutOfRangeException("passes");
+		}
+		else if (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX) {
+			throw gcnew ArgumentOutOfRangeException("compressionLevel");
+		}
+		else if (acceleration < 1 || acceleration > LZ4FRAME_ACCELERATION_MAX) {
+			throw gcnew ArgumentOutOfRangeException("acceleration");
 		}
 
-		result2[1] = i;
-		offset = 2 + i;
-
-		inputPtr = &result[0];
-		inputBytePtr = inputPtr;
-		outputPtr = &result2[offset];
-		outputBytePtr = outputPtr;
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		pin_ptr<Byte> outputPtr = &output[outputOffset];
+		return CompressCustom(inputPtr, inputLength, outputPtr, outputLength, passes, compressionLevel, acceleration);
+	}
 
-		int compressedSize2 = LZ4_compress_HC((char *)inputBytePtr, (char *)outputBytePtr, compressedSize, bufferSize2, 0);
+	int LZ4Helper::Custom::Compress(IntPtr input, int inputLength, IntPtr output, int outputLength, int passes, int compressionLevel, int acceleration)
+	{
+		if (input == IntPtr::Zero) {
+			throw gcnew ArgumentNullException("input");
+		}
+		else if (inputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
+		}
+		else if (output == IntPtr::Zero) {
+			throw gcnew ArgumentNullException("output");
+		}
+		else if (outputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
+		}
+		else if (passes < 1 || passes > 2) {
+			throw gcnew ArgumentOutOfRangeException("passes");
+		}
+		else if (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX) {
+			throw gcnew ArgumentOutOfRangeException("compressionLevel");
+		}
+		else if (acceleration < 1 || acceleration > LZ4FRAME_ACCELERATION_MAX) {
+			throw gcnew ArgumentOutOfRangeException("acceleration");
+		}
 
-		array<Byte>^ slimResult = gcnew array<Byte>(compressedSize2 + offset);
-		Buffer::BlockCopy(result2, 0, slimResult, 0, compressedSize2 + offset);
-		return slimResult;
+		return CompressCustom((const byte*)input.ToPointer(), inputLength, (byte*)output.ToPointer(), outputLength, passes, compressionLevel, acceleration);
 	}
 
-	array<Byte>^ LZ4Helper::Custom::Decompress(array<Byte>^ input, int inputOffset, int inputLength)
+	int LZ4Helper::Custom::Decompress(array<Byte>^ input, int inputOffset, int inputLength, array<Byte>^ output, int outputOffset, int outputLength)
 	{
 		if (input == nullptr) {
 			throw gcnew ArgumentNullException("input");
@@ -129,67 +322,175 @@ namespace lz4 {
 		else if (inputOffset + inputLength > input->Length) {
 			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
 		}
-
-		int passes = input[0];
-		int sizeOfSize = input[1];
-		if (sizeOfSize > 8 || inputLength < (2 + (int)sizeOfSize) || !(passes == 1 || passes == 2)) {
-			throw gcnew Exception("Invalid data");
+		else if (output == nullptr) {
+			throw gcnew ArgumentNullException("output");
 		}
-
-		int fileSize = 0;
-		for (int i = 0; i < sizeOfSize; i++) {
-			fileSize += (((byte)input[2 + i]) << (8 * i));
+		else if (outputOffset < 0) {
+			throw gcnew ArgumentOutOfRangeException("outputOffset");
 		}
-
-		if (fileSize < 0)
-		{
-			throw gcnew Exception("Invalid data");
+		else if (outputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
+		}
+		else if (outputOffset + outputLength > output->Length) {
+			throw gcnew ArgumentOutOfRangeException("outputOffset+outputLength");
 		}
 
-		int bufferSize1 = fileSize;
-		if (passes == 2) {
-			bufferSize1 = LZ4_compressBound(fileSize);
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		pin_ptr<Byte> outputPtr = &output[outputOffset];
+		return DecompressCustom(inputPtr, inputLength, outputPtr, outputLength);
+	}
+
+	int LZ4Helper::Custom::Decompress(IntPtr input, int inputLength, IntPtr output, int outputLength)
+	{
+		if (input == IntPtr::Zero) {
+			throw gcnew ArgumentNullException("input");
+		}
+		else if (inputLength < 3) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
+		}
+		else if (output == IntPtr::Zero) {
+			throw gcnew ArgumentNullException("output");
+		}
+		else if (outputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("outputLength");
 		}
 
-		array<Byte>^ result = gcnew array<Byte>(bufferSize1);
+		return DecompressCustom((const byte*)input.ToPointer(), inputLength, (byte*)output.ToPointer(), outputLength);
+	}
 
-		pin_ptr<Byte> inputPtr = &input[2 + sizeOfSize];
-		byte* inputBytePtr = inputPtr;
-		pin_ptr<Byte> outputPtr = &result[0];
-		byte* outputBytePtr = outputPtr;
+	array<array<Byte>^>^ LZ4Helper::Custom::Decompress(array<array<Byte>^>^ inputs)
+	{
+		if (inputs == nullptr) {
+			throw gcnew ArgumentNullException("inputs");
+		}
+
+		const int batchSize = 4;
+		const char* sources[batchSize];
+		char* dests[batchSize];
+		int compressedSizes[batchSize];
+		int dstCapacities[batchSize];
+		int decompressedSizes[batchSize];
+		int indexes[batchSize];
+		array<GCHandle>^ handles = gcnew array<GCHandle>(2 * batchSize);
+
+		array<array<Byte>^>^ results = gcnew array<array<Byte>^>(inputs->Length);
+		int i = 0;
+		while (i < inputs->Length) {
+			int count = 0, pinned = 0;
+			try {
+				// the one pass inputs of the batch are pinned with their results, two pass inputs are decompressed directly
+				for (; i < inputs->Length && count < batchSize; i++) {
+					array<Byte>^ input = inputs[i];
+					if (input == nullptr) {
+						throw gcnew ArgumentNullException("inputs");
+					}
+					else if (input->Length < 3) {
+						throw gcnew ArgumentOutOfRangeException("inputs");
+					}
+
+					pin_ptr<Byte> inputPtr = &input[0];
+					int passes, headerSize;
+					int fileSize = ReadCustomHeader(inputPtr, input->Length, &passes, &headerSize);
+					array<Byte>^ result = gcnew array<Byte>(fileSize);
+					results[i] = result;
+					if (passes == 2) {
+						pin_ptr<Byte> outputPtr = &result[0];
+						int decompressedSize = DecompressCustom(inputPtr, input->Length, outputPtr, fileSize);
+						if (decompressedSize != fileSize) {
+							results[i] = gcnew array<Byte>(decompressedSize);
+							Buffer::BlockCopy(result, 0, results[i], 0, decompressedSize);
+						}
+						continue;
+					}
+
+					handles[pinned++] = GCHandle::Alloc(input, GCHandleType::Pinned);
+					handles[pinned++] = GCHandle::Alloc(result, GCHandleType::Pinned);
+					sources[count] = (const char*)(void*)handles[pinned - 2].AddrOfPinnedObject() + headerSize;
+					dests[count] = (char*)(void*)handles[pinned - 1].AddrOfPinnedObject();
+					compressedSizes[count] = input->Length - headerSize;
+					dstCapacities[count] = fileSize;
+					indexes[count] = i;
+					count++;
+				}
+
+				if (count > 0) {
+					LZ4_decompress_safe_batch(sources, dests, compressedSizes, dstCapacities, decompressedSizes, count);
+				}
+			}
+			finally {
+				for (int j = 0; j < pinned; j++) {
+					handles[j].Free();
+				}
+			}
 
-		int bufferSize2 = LZ4_decompress_safe((char *)inputBytePtr, (char *)outputBytePtr, inputLength - 2 - sizeOfSize, bufferSize1);
-		if (bufferSize2 <= 0)
-		{
-			throw gcnew Exception("Decompression failed");
+			for (int j = 0; j < count; j++) {
+				if (decompressedSizes[j] <= 0)
+				{
+					throw gcnew Exception("Decompression failed");
+				}
+				else if (decompressedSizes[j] != dstCapacities[j]) {
+					array<Byte>^ result = results[indexes[j]];
+					results[indexes[j]] = gcnew array<Byte>(decompressedSizes[j]);
+					Buffer::BlockCopy(result, 0, results[indexes[j]], 0, decompressedSizes[j]);
+				}
+			}
 		}
+		return results;
+	}
 
-		if (passes == 1)
-		{
-			array<Byte>^ slimResult = gcnew array<Byte>(bufferSize2);
-			Buffer::BlockCopy(result, 0, slimResult, 0, bufferSize2);
-			return slimResult;
+	int LZ4Helper::Custom::GetMaxCompressedLength(int inputLength, int passes)
+	{
+		if (inputLength <= 0) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
+		}
+		else if (passes < 1 || passes > 2) {
+			throw gcnew ArgumentOutOfRangeException("passes");
 		}
 
-		array<Byte>^ result2 = gcnew array<Byte>(fileSize);
+		int bufferSize = LZ4_compressBound(inputLength);
+		if (passes == 2) {
+			bufferSize = LZ4_compressBound(bufferSize);
+		}
+		if (bufferSize <= 0) {
+			throw gcnew NotSupportedException("input too large");
+		}
+		return GetCustomHeaderSize(inputLength) + bufferSize;
+	}
 
-		inputPtr = &result[0];
-		inputBytePtr = inputPtr;
-		outputPtr = &result2[0];
-		outputBytePtr = outputPtr;
+	int LZ4Helper::Custom::GetDecompressedLength(array<Byte>^ input, int inputOffset, int inputLength)
+	{
+		if (input == nullptr) {
+			throw gcnew ArgumentNullException("input");
+		}
+		else if (inputOffset < 0) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset");
+		}
+		else if (inputLength < 3) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
+		}
+		else if (inputOffset + inputLength > input->Length) {
+			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
+		}
 
-		int bufferSize3 = LZ4_decompress_safe((char *)inputBytePtr, (char *)outputBytePtr, bufferSize2, fileSize);
-		if (bufferSize3 <= 0)
-		{
-			throw gcnew Exception("Decompression failed");
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		int passes, headerSize;
+		return ReadCustomHeader(inputPtr, inputLength, &passes, &headerSize);
+	}
+
+	int LZ4Helper::Custom::GetDecompressedLength(IntPtr input, int inputLength)
+	{
+		if (input == IntPtr::Zero) {
+			throw gcnew ArgumentNullException("input");
+		}
+		else if (inputLength < 3) {
+			throw gcnew ArgumentOutOfRangeException("inputLength");
 		}
 
-		array<Byte>^ slimResult = gcnew array<Byte>(bufferSize3);
-		Buffer::BlockCopy(result2, 0, slimResult, 0, bufferSize3);
-		return slimResult;
+		int passes, headerSize;
+		return ReadCustomHeader((const byte*)input.ToPointer(), inputLength, &passes, &headerSize);
 	}
 
-	array<Byte>^ LZ4Helper::Frame::Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, bool highCompression)
+	array<Byte>^ LZ4Helper::Frame::Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed, int acceleration, LZ4Dictionary^ dictionary)
 	{
 		if (input == nullptr) {
 			throw gcnew ArgumentNullException("input");
@@ -203,33 +504,53 @@ namespace lz4 {
 		else if (inputOffset + inputLength > input->Length) {
 			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
 		}
+		else if (maxFrameSize.HasValue && maxFrameSize.Value <= 0) {
+			throw gcnew ArgumentOutOfRangeException("maxFrameSize");
+		}
+		else if (compressionLevel != 0 && (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX)) {
+			throw gcnew ArgumentOutOfRangeException("compressionLevel");
+		}
+		else if (acceleration < 1 || acceleration > LZ4FRAME_ACCELERATION_MAX) {
+			throw gcnew ArgumentOutOfRangeException("acceleration");
+		}
 
-		MemoryStream^ ms = nullptr;
-		array<Byte>^ result;
-		try
-		{
-			ms = gcnew MemoryStream();
-			LZ4Stream^ lz4 = nullptr;
-			try
-			{
-				lz4 = LZ4Stream::CreateCompressor(ms, LZ4StreamMode::Write, blockMode, blockSize, checksumMode, maxFrameSize, highCompression, true);
-				lz4->Write(input, inputOffset, inputLength);
-			}
-			finally
-			{
-				if (lz4 != nullptr) { delete lz4; }
-			}
-			result = ms->ToArray();
+		native::LZ4FrameInfo info;
+		LZ4Stream::CreateFrameInfo(blockMode, blockSize, checksumMode, &info);
+		// the size of the input is known, every frame contains its content size
+		info.hasContentSize = true;
+		long long blocksPerFrame = maxFrameSize.HasValue ? maxFrameSize.Value : 0;
+
+		long long bufferSize = CheckFrameResult(native::LZ4Frame_compressBound(&info, inputLength, blocksPerFrame));
+		if (bufferSize > Int32::MaxValue) {
+			throw gcnew NotSupportedException("input too large");
 		}
-		finally
-		{
-			if (ms != nullptr) { delete ms; }
+
+		native::LZ4FrameCompressionOptions options;
+		options.compressionLevel = compressionLevel;
+		options.favorDecSpeed = favorDecSpeed;
+		options.acceleration = acceleration;
+		options.restartInterval = 0;
+		options.memoryUsage = 0;
+
+		native::LZ4FrameEncoder encoder(LZ4StatePool::Allocator);
+		CheckFrameResult(encoder.Init(&info, &options));
+		if (dictionary != nullptr) {
+			CheckFrameResult(encoder.SetPreparedDictionary(dictionary->GetPrepared(compressionLevel, favorDecSpeed)));
+			CheckFrameResult(encoder.SetDictionaryId(dictionary->Id.HasValue, dictionary->Id.HasValue ? dictionary->Id.Value : 0));
 		}
 
-		return result;
+		// the blocks are compressed directly from the input, linked blocks reference the preceding input
+		array<Byte>^ result = gcnew array<Byte>((int)bufferSize);
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		pin_ptr<Byte> outputPtr = &result[0];
+		int compressedSize = CheckFrameResult(encoder.CompressFrames((const char*)inputPtr, inputLength, blocksPerFrame, outputPtr, (int)bufferSize));
+
+		array<Byte>^ slimResult = gcnew array<Byte>(compressedSize);
+		Buffer::BlockCopy(result, 0, slimResult, 0, compressedSize);
+		return slimResult;
 	}
 
-	array<Byte>^ LZ4Helper::Frame::Decompress(array<Byte>^ input, int inputOffset, int inputLength)
+	array<Byte>^ LZ4Helper::Frame::Decompress(array<Byte>^ input, int inputOffset, int inputLength, LZ4Dictionary^ dictionary, int maxDegreeOfParallelism)
 	{
 		if (input == nullptr) {
 			throw gcnew ArgumentNullException("input");
@@ -243,29 +564,41 @@ namespace lz4 {
 		else if (inputOffset + inputLength > input->Length) {
 			throw gcnew ArgumentOutOfRangeException("inputOffset+inputLength");
 		}
+		else if (maxDegreeOfParallelism < 1) {
+			throw gcnew ArgumentOutOfRangeException("maxDegreeOfParallelism");
+		}
 
-		MemoryStream ^ms = nullptr;
-		array<Byte>^ result;
-		try
-		{
-			ms = gcnew MemoryStream();
-			LZ4Stream^ lz4 = nullptr;
-			try
-			{
-				lz4 = LZ4Stream::CreateDecompressor(ms, LZ4StreamMode::Write, true);
-				lz4->Write(input, inputOffset, inputLength);
-			}
-			finally
-			{
-				if (lz4 != nullptr) { delete lz4; }
-			}
-			result = ms->ToArray();
+		pin_ptr<Byte> inputPtr = &input[inputOffset];
+		const char* dictionaryPtr = dictionary != nullptr ? dictionary->DataPtr : nullptr;
+		int dictionarySize = dictionary != nullptr ? dictionary->Length : 0;
+
+		// exact when the frames contain the content size
+		long long bufferSize = CheckFrameResult(native::LZ4Frame_getDecompressedBound(inputPtr, inputLength));
+		if (bufferSize > Int32::MaxValue) {
+			throw gcnew NotSupportedException("output too large");
 		}
-		finally
-		{
-			if (ms != nullptr) { delete ms; }
+		else if (bufferSize == 0) {
+			// verifies the frames, they contain no data
+			CheckFrameResult(native::LZ4Frame_decompress_usingDict(inputPtr, inputLength, nullptr, 0, dictionaryPtr, dictionarySize));
+			return gcnew array<Byte>(0);
 		}
 
+		array<Byte>^ result = gcnew array<Byte>((int)bufferSize);
+		pin_ptr<Byte> outputPtr = &result[0];
+		int decompressedSize;
+		if (maxDegreeOfParallelism > 1) {
+			// the frames are independent, the bound is the sum of the bounds of the frames
+			decompressedSize = LZ4ParallelFrameDecompressor::DecompressFrames((const char*)inputPtr, inputLength, (char*)outputPtr, (int)bufferSize, dictionary, maxDegreeOfParallelism);
+		}
+		else {
+			decompressedSize = CheckFrameResult(native::LZ4Frame_decompress_usingDict(inputPtr, inputLength, outputPtr, (int)bufferSize, dictionaryPtr, dictionarySize));
+		}
+
+		if (decompressedSize != bufferSize) {
+			array<Byte>^ slimResult = gcnew array<Byte>(decompressedSize);
+			Buffer::BlockCopy(result, 0, slimResult, 0, decompressedSize);
+			return slimResult;
+		}
 		return result;
 	}
 }
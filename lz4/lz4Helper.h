@@ -49,12 +49,44 @@ namespace lz4 {
 			{
 				return Compress(input, 0, input->Length, 1);
 			}
-			static array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes);
+			static inline array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes)
+			{
+				return Compress(input, inputOffset, inputLength, passes, LZ4HC_CLEVEL_DEFAULT);
+			}
+			// compressionLevel: high compression level of the second pass, 3 - 12
+			static inline array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes, int compressionLevel)
+			{
+				return Compress(input, inputOffset, inputLength, passes, compressionLevel, 1);
+			}
+			// acceleration: fast compression of the first pass, 1 - LZ4FRAME_ACCELERATION_MAX, higher values are faster and compress less
+			static array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, int passes, int compressionLevel, int acceleration);
 			static inline array<Byte>^ Decompress(array<Byte>^ input)
 			{
 				return Decompress(input, 0, input->Length);
 			}
 			static array<Byte>^ Decompress(array<Byte>^ input, int inputOffset, int inputLength);
+
+			// compress into / decompress into a caller provided buffer, returns the number of bytes written to output
+			static inline int Compress(array<Byte>^ input, int inputOffset, int inputLength, array<Byte>^ output, int outputOffset, int outputLength, int passes)
+			{
+				return Compress(input, inputOffset, inputLength, output, outputOffset, outputLength, passes, LZ4HC_CLEVEL_DEFAULT, 1);
+			}
+			static inline int Compress(IntPtr input, int inputLength, IntPtr output, int outputLength, int passes)
+			{
+				return Compress(input, inputLength, output, outputLength, passes, LZ4HC_CLEVEL_DEFAULT, 1);
+			}
+			static int Compress(array<Byte>^ input, int inputOffset, int inputLength, array<Byte>^ output, int outputOffset, int outputLength, int passes, int compressionLevel, int acceleration);
+			static int Compress(IntPtr input, int inputLength, IntPtr output, int outputLength, int passes, int compressionLevel, int acceleration);
+			static int Decompress(array<Byte>^ input, int inputOffset, int inputLength, array<Byte>^ output, int outputOffset, int outputLength);
+			static int Decompress(IntPtr input, int inputLength, IntPtr output, int outputLength);
+			// decompresses every input, the one pass inputs are decoded 4 at a time in one interleaved loop (many small values, the loads of one input overlap with the work on the others)
+			static array<array<Byte>^>^ Decompress(array<array<Byte>^>^ inputs);
+
+			// output size that is always large enough for Compress
+			static int GetMaxCompressedLength(int inputLength, int passes);
+			// size of the decompressed data, read from the header of the compressed data
+			static int GetDecompressedLength(array<Byte>^ input, int inputOffset, int inputLength);
+			static int GetDecompressedLength(IntPtr input, int inputLength);
 		};
 
 		ref class Frame abstract sealed
@@ -64,12 +96,41 @@ namespace lz4 {
 			{
 				return Compress(input, 0, input->Length, blockMode, blockSize, checksumMode, maxFrameSize, highCompression);
 			}
-			static array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, bool highCompression);
+			static inline array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, bool highCompression)
+			{
+				return Compress(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, highCompression ? LZ4HC_CLEVEL_DEFAULT : 0, false);
+			}
+			// compressionLevel: 0 for fast compression, 3 - 12 for high compression, favorDecSpeed: levels 10 - 12 prefer matches that decompress faster
+			static inline array<Byte>^ Compress(array<Byte>^ input, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed)
+			{
+				return Compress(input, 0, input->Length, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, 1);
+			}
+			static inline array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed)
+			{
+				return Compress(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, 1);
+			}
+			// acceleration: fast compression (compressionLevel 0), 1 - LZ4FRAME_ACCELERATION_MAX, higher values are faster and compress less
+			static inline array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed, int acceleration)
+			{
+				return Compress(input, inputOffset, inputLength, blockMode, blockSize, checksumMode, maxFrameSize, compressionLevel, favorDecSpeed, acceleration, nullptr);
+			}
+			// dictionary: prepared on first use and attached to every frame, small messages don't pay for hashing the dictionary
+			static array<Byte>^ Compress(array<Byte>^ input, int inputOffset, int inputLength, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed, int acceleration, LZ4Dictionary^ dictionary);
 			static inline array<Byte>^ Decompress(array<Byte>^ input)
 			{
 				return Decompress(input, 0, input->Length);
 			}
-			static array<Byte>^ Decompress(array<Byte>^ input, int inputOffset, int inputLength);
+			static inline array<Byte>^ Decompress(array<Byte>^ input, int inputOffset, int inputLength)
+			{
+				return Decompress(input, inputOffset, inputLength, nullptr);
+			}
+			// dictionary: used for every frame
+			static inline array<Byte>^ Decompress(array<Byte>^ input, int inputOffset, int inputLength, LZ4Dictionary^ dictionary)
+			{
+				return Decompress(input, inputOffset, inputLength, dictionary, 1);
+			}
+			// maxDegreeOfParallelism: concatenated frames (maxFrameSize) are decompressed on that many threads, each frame into its own part of the output
+			static array<Byte>^ Decompress(array<Byte>^ input, int inputOffset, int inputLength, LZ4Dictionary^ dictionary, int maxDegreeOfParallelism);
 		};
 	};
 }
@@ -0,0 +1,150 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4ParallelBlock.h"
+#include "lz4FrameResult.h"
+#include "lz4StatePool.h"
+
+namespace lz4 {
+
+	LZ4ParallelBlock::LZ4ParallelBlock(int blockSize, int maxSpanBlocks, LZ4Allocations^ allocations) {
+		// room for the encoded blocks (block size, block data and block checksum)
+		_blockSize = blockSize;
+		_allocations = allocations;
+		_inputBuffer = allocations->Buffer<byte>(maxSpanBlocks * LZ4FRAME_BLOCK_BOUND(blockSize));
+		_outputBuffer = allocations->Buffer<byte>(maxSpanBlocks * LZ4FRAME_BLOCK_BOUND(blockSize));
+		_spanOffsets = allocations->Buffer<int>(maxSpanBlocks);
+		_spanSizes = allocations->Buffer<int>(maxSpanBlocks);
+		_spanCompressed = allocations->Buffer<bool>(maxSpanBlocks);
+		_spanChecksums = allocations->Buffer<unsigned int>(maxSpanBlocks);
+		_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
+		_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
+		_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
+		_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
+		_completed = gcnew ManualResetEvent(true);
+	}
+
+	LZ4ParallelBlock::~LZ4ParallelBlock() {
+		if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); _inputBufferPtr = nullptr; }
+		if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
+		if (_historyBufferHandle.IsAllocated) { _historyBufferHandle.Free(); _historyBufferPtr = nullptr; }
+		_inputBuffer = nullptr;
+		_outputBuffer = nullptr;
+		_historyBuffer = nullptr;
+
+		if (_completed != nullptr) { _completed->Close(); _completed = nullptr; }
+
+		this->!LZ4ParallelBlock();
+	}
+
+	LZ4ParallelBlock::!LZ4ParallelBlock() {
+		if (_frameEncoder != nullptr) { delete _frameEncoder; _frameEncoder = nullptr; }
+	}
+
+	void LZ4ParallelBlock::InitEncoder(const native::LZ4FrameInfo* info, const native::LZ4FrameCompressionOptions* options) {
+		// the content checksum is calculated in order by the stream, every block loads its own history or dictionary
+		native::LZ4FrameInfo blockInfo = *info;
+		blockInfo.independentBlocks = true;
+		blockInfo.contentChecksum = false;
+
+		_frameEncoder = _allocations->State(new native::LZ4FrameEncoder(LZ4StatePool::Allocator));
+		CheckFrameResult(_frameEncoder->Init(&blockInfo, options));
+	}
+
+	void LZ4ParallelBlock::SetHistory(array<byte>^ buffer, int offset, int count) {
+		if (_historyBuffer == nullptr) {
+			_historyBuffer = _allocations->Buffer<byte>(LZ4FRAME_DICTIONARY_SIZE_MAX);
+			_historyBufferHandle = GCHandle::Alloc(_historyBuffer, GCHandleType::Pinned);
+			_historyBufferPtr = (char*)(void*)_historyBufferHandle.AddrOfPinnedObject();
+		}
+		if (count > 0) { Buffer::BlockCopy(buffer, offset, _historyBuffer, 0, count); }
+		_historySize = count;
+	}
+
+	void LZ4ParallelBlock::Compress() {
+		// independent blocks: the same encoder calls as the sequential path of LZ4Stream, so the output is identical
+		// linked blocks: the encoder is primed with the history, LZ4_loadDict hashes fewer positions of it than the sequential path that compressed it (see MaxDegreeOfParallelism)
+		if (_historySize >= 0) {
+			CheckFrameResult(_frameEncoder->SetDictionary(_historySize > 0 ? _historyBufferPtr : nullptr, _historySize));
+		}
+		else {
+			CheckFrameResult(_frameEncoder->SetPreparedDictionary(_dictionary));
+		}
+		CheckFrameResult(_frameEncoder->SetAcceleration(_acceleration));
+		_targetSize = CheckFrameResult(_frameEncoder->CompressBlock(_inputBufferPtr, _inputSize, _outputBufferPtr, _outputBuffer->Length));
+	}
+
+	void LZ4ParallelBlock::Decompress(bool blockChecksum, const char* dictionary, int dictionarySize) {
+		int outputOffset = 0;
+		for (int i = 0; i < _spanBlocks; i++) {
+			const char* src = &_inputBufferPtr[_spanOffsets[i]];
+			int srcSize = _spanSizes[i];
+
+			if (blockChecksum) {
+				// verify checksum
+				unsigned int xxh = XXH32(src, srcSize, 0);
+				if (_spanChecksums[i] != xxh) {
+					throw gcnew Exception("Block checksum did not match");
+				}
+			}
+
+			if (!_spanCompressed[i] && _spanBlocks == 1) {
+				// the data is returned from the input buffer
+				_isCompressed = false;
+				_targetSize = srcSize;
+				return;
+			}
+
+			int decompressedSize;
+			if (!_spanCompressed[i]) {
+				Buffer::BlockCopy(_inputBuffer, _spanOffsets[i], _outputBuffer, outputOffset, srcSize);
+				decompressedSize = srcSize;
+			}
+			else if (outputOffset > 0) {
+				// linked blocks, the blocks before it are the history
+				decompressedSize = LZ4_decompress_safe_usingDict(src, &_outputBufferPtr[outputOffset], srcSize, _blockSize, _outputBufferPtr, outputOffset);
+			}
+			else if (dictionary != nullptr) {
+				decompressedSize = LZ4_decompress_safe_usingDict(src, _outputBufferPtr, srcSize, _blockSize, dictionary, dictionarySize);
+			}
+			else {
+				decompressedSize = LZ4_decompress_safe(src, _outputBufferPtr, srcSize, _blockSize);
+			}
+			if (decompressedSize <= 0) {
+				throw gcnew Exception("Decompress failed");
+			}
+			outputOffset += decompressedSize;
+		}
+		_isCompressed = true;
+		_targetSize = outputOffset;
+	}
+}
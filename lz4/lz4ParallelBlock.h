@@ -0,0 +1,107 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4Frame.h"
+#include "lz4Allocations.h"
+
+using namespace System;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// a single independent frame block that is compressed or decompressed on the thread pool
+	// compress: or a linked block that is compressed with the end of the previous block as its history
+	// decompress: or a span of linked blocks that starts without history (a restart point), the blocks are decompressed in order into the output buffer
+	ref class LZ4ParallelBlock sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+	internal:
+		array<byte>^ _inputBuffer = nullptr;
+		array<byte>^ _outputBuffer = nullptr;
+		GCHandle _inputBufferHandle;
+		GCHandle _outputBufferHandle;
+		char* _inputBufferPtr;
+		char* _outputBufferPtr;
+		int _blockSize = 0;
+		int _inputSize = 0;
+		int _targetSize = 0;
+		int _acceleration = 1;
+		// compress: the last 64 KB of the previous block (linked blocks), -1 when the block starts with the dictionary
+		array<byte>^ _historyBuffer = nullptr;
+		GCHandle _historyBufferHandle;
+		char* _historyBufferPtr;
+		int _historySize = -1;
+		const native::LZ4PreparedDictionary* _dictionary = nullptr;
+		bool _isCompressed = false;
+		unsigned int _checksum = 0;
+		// decompress: the blocks of the span, the offset of their data in the input buffer
+		int _spanBlocks = 0;
+		array<int>^ _spanOffsets = nullptr;
+		array<int>^ _spanSizes = nullptr;
+		array<bool>^ _spanCompressed = nullptr;
+		array<unsigned int>^ _spanChecksums = nullptr;
+		Exception^ _error = nullptr;
+		ManualResetEvent^ _completed = nullptr;
+
+		native::LZ4FrameEncoder *_frameEncoder = nullptr;
+		LZ4Allocations^ _allocations;
+
+		// maxSpanBlocks: number of blocks the buffers can hold (1 for independent blocks)
+		LZ4ParallelBlock(int blockSize, int maxSpanBlocks, LZ4Allocations^ allocations);
+		~LZ4ParallelBlock();
+		!LZ4ParallelBlock();
+
+		// the decompressed block data, i.e. the output buffer when the block is compressed, otherwise the input buffer
+		property array<byte>^ Data {
+			array<byte>^ get() {
+				return _isCompressed ? _outputBuffer : _inputBuffer;
+			}
+		}
+		property char* DataPtr {
+			char* get() {
+				return _isCompressed ? _outputBufferPtr : _inputBufferPtr;
+			}
+		}
+
+		void InitEncoder(const native::LZ4FrameInfo* info, const native::LZ4FrameCompressionOptions* options);
+		// copies the history of a linked block, count 0 for a block that starts without history (a restart point)
+		void SetHistory(array<byte>^ buffer, int offset, int count);
+		// encodes the input into the output buffer (block size, block data and block checksum) with _acceleration and the history or _dictionary, _targetSize receives the encoded size
+		void Compress();
+		// the dictionary is used for the first block of the span, it may be NULL
+		void Decompress(bool blockChecksum, const char* dictionary, int dictionarySize);
+	};
+}
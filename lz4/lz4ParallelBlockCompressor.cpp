@@ -0,0 +1,163 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#include "lz4ParallelBlockCompressor.h"
+#include "lz4FrameResult.h"
+
+namespace lz4 {
+
+	LZ4ParallelBlockCompressor::LZ4ParallelBlockCompressor(Stream^ innerStream, const native::LZ4FrameInfo* info, const native::LZ4FrameCompressionOptions* options, int degreeOfParallelism, LZ4Allocations^ allocations) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+		else if (info == nullptr) { throw gcnew ArgumentNullException("info"); }
+		else if (options == nullptr) { throw gcnew ArgumentNullException("options"); }
+		else if (degreeOfParallelism < 1) { throw gcnew ArgumentOutOfRangeException("degreeOfParallelism"); }
+
+		int blockSize = CheckFrameResult(native::LZ4Frame_getBlockSize(info->blockSizeId));
+
+		_innerStream = innerStream;
+		_linkedBlocks = !info->independentBlocks;
+		_restartInterval = options->restartInterval;
+		_compressCallback = gcnew WaitCallback(this, &LZ4ParallelBlockCompressor::CompressBlock);
+
+		_blocks = gcnew array<LZ4ParallelBlock^>(degreeOfParallelism);
+		for (int i = 0; i < _blocks->Length; i++) {
+			_blocks[i] = gcnew LZ4ParallelBlock(blockSize, 1, allocations);
+			_blocks[i]->InitEncoder(info, options);
+		}
+	}
+
+	LZ4ParallelBlockCompressor::~LZ4ParallelBlockCompressor() {
+		if (_blocks == nullptr) { return; }
+
+		// the workers still reference the block buffers, wait for them before releasing anything
+		for (int i = 0; i < _blocks->Length; i++) {
+			_blocks[i]->_completed->WaitOne();
+		}
+		for (int i = 0; i < _blocks->Length; i++) {
+			delete _blocks[i];
+		}
+		_blocks = nullptr;
+		_pending = 0;
+	}
+
+	void LZ4ParallelBlockCompressor::CompressBlock(Object^ state) {
+		LZ4ParallelBlock^ block = safe_cast<LZ4ParallelBlock^>(state);
+		try {
+			block->Compress();
+		}
+		catch (Exception^ ex) {
+			block->_error = ex;
+		}
+		finally {
+			block->_completed->Set();
+		}
+	}
+
+	void LZ4ParallelBlockCompressor::Enqueue(array<byte>^ buffer, int offset, int count) {
+		if (count <= 0) { throw gcnew ArgumentOutOfRangeException("count"); }
+
+		if (_pending == _blocks->Length) {
+			// all blocks are in use, the oldest one is the next one to be written
+			WriteNextBlock();
+		}
+
+		int index = (_head + _pending) % _blocks->Length;
+		LZ4ParallelBlock^ block = _blocks[index];
+		if (count > block->_blockSize) { throw gcnew ArgumentOutOfRangeException("count"); }
+
+		long long frameBlock = _frameBlockCount++;
+		if (!_linkedBlocks || frameBlock == 0) {
+			block->_historySize = -1;
+		}
+		else if (_restartInterval > 0 && frameBlock % _restartInterval == 0) {
+			// a restart point
+			block->SetHistory(nullptr, 0, 0);
+		}
+		else {
+			// the previous block keeps its input until this block is enqueued, the copy is taken before the input is replaced
+			LZ4ParallelBlock^ previous = _blocks[(index + _blocks->Length - 1) % _blocks->Length];
+			int historySize = Math::Min(previous->_inputSize, LZ4FRAME_DICTIONARY_SIZE_MAX);
+			block->SetHistory(previous->_inputBuffer, previous->_inputSize - historySize, historySize);
+		}
+		block->_dictionary = _dictionary;
+
+		Buffer::BlockCopy(buffer, offset, block->_inputBuffer, 0, count);
+		block->_inputSize = count;
+		block->_acceleration = _acceleration;
+		block->_error = nullptr;
+		block->_completed->Reset();
+		_pending++;
+
+		ThreadPool::QueueUserWorkItem(_compressCallback, block);
+	}
+
+	void LZ4ParallelBlockCompressor::ResetTicks() {
+		_waitTicks = 0;
+		_writeTicks = 0;
+	}
+
+	void LZ4ParallelBlockCompressor::SetDictionary(const native::LZ4PreparedDictionary* dictionary) {
+		// the blocks that are pending keep the dictionary they were enqueued with
+		_dictionary = dictionary;
+	}
+
+	void LZ4ParallelBlockCompressor::WriteNextBlock() {
+		LZ4ParallelBlock^ block = _blocks[_head];
+		long long start = Stopwatch::GetTimestamp();
+		block->_completed->WaitOne();
+		long long completed = Stopwatch::GetTimestamp();
+
+		_head = (_head + 1) % _blocks->Length;
+		_pending--;
+
+		if (block->_error != nullptr) {
+			throw gcnew Exception("Compress failed", block->_error);
+		}
+
+		// block size, block data and block checksum
+		if (_blockIndex != nullptr) { _blockIndex->AddBlock(block->_inputSize, block->_targetSize); }
+		_innerStream->Write(block->_outputBuffer, 0, block->_targetSize);
+
+		_waitTicks += completed - start;
+		_writeTicks += Stopwatch::GetTimestamp() - completed;
+	}
+
+	void LZ4ParallelBlockCompressor::Drain() {
+		while (_pending > 0) {
+			WriteNextBlock();
+		}
+	}
+
+	void LZ4ParallelBlockCompressor::EndFrame() {
+		Drain();
+		_frameBlockCount = 0;
+	}
+}
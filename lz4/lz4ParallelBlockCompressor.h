@@ -0,0 +1,131 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4ParallelBlock.h"
+#include "lz4BlockIndex.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// compresses the blocks of a frame on the thread pool, the blocks are written to the inner stream in order
+	// linked blocks are compressed with the last 64 KB of the previous block as history, the frame stays a regular linked frame
+	ref class LZ4ParallelBlockCompressor sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		Stream^ _innerStream;
+		array<LZ4ParallelBlock^>^ _blocks;
+		WaitCallback^ _compressCallback;
+		int _head = 0;
+		int _pending = 0;
+		int _acceleration = 1;
+		bool _linkedBlocks;
+		int _restartInterval;
+		long long _frameBlockCount = 0;
+		const native::LZ4PreparedDictionary* _dictionary = nullptr;
+		long long _waitTicks = 0;
+		long long _writeTicks = 0;
+		LZ4BlockIndex^ _blockIndex = nullptr;
+
+		void CompressBlock(Object^ state);
+		void WriteNextBlock();
+
+	internal:
+		LZ4ParallelBlockCompressor(Stream^ innerStream, const native::LZ4FrameInfo* info, const native::LZ4FrameCompressionOptions* options, int degreeOfParallelism, LZ4Allocations^ allocations);
+		~LZ4ParallelBlockCompressor();
+
+		property int PendingBlocks {
+			int get() {
+				return _pending;
+			}
+		}
+
+		// acceleration of the blocks that are enqueued next
+		property int Acceleration {
+			int get() {
+				return _acceleration;
+			}
+			void set(int value) {
+				_acceleration = value;
+			}
+		}
+
+		// Stopwatch ticks spent waiting for and writing the blocks that were written since ResetTicks, the drained blocks included
+		property long long WaitTicks {
+			long long get() {
+				return _waitTicks;
+			}
+		}
+		property long long WriteTicks {
+			long long get() {
+				return _writeTicks;
+			}
+		}
+
+		// receives the blocks as they are written, nullptr when the stream has no block index
+		property LZ4BlockIndex^ BlockIndex {
+			LZ4BlockIndex^ get() {
+				return _blockIndex;
+			}
+			void set(LZ4BlockIndex^ value) {
+				_blockIndex = value;
+			}
+		}
+
+		// the inner stream of the next blocks, changed while no blocks are pending (LZ4Stream::Reset)
+		property Stream^ InnerStream {
+			Stream^ get() {
+				return _innerStream;
+			}
+			void set(Stream^ value) {
+				_innerStream = value;
+			}
+		}
+
+		void ResetTicks();
+
+		// dictionary of the blocks that are enqueued next, the encoders keep a reference
+		void SetDictionary(const native::LZ4PreparedDictionary* dictionary);
+
+		// the oldest block is written first when all blocks are in use
+		void Enqueue(array<byte>^ buffer, int offset, int count);
+		void Drain();
+		// drains the blocks, the next block starts a new frame
+		void EndFrame();
+	};
+}
@@ -0,0 +1,185 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4ParallelBlockDecompressor.h"
+#include "lz4FrameResult.h"
+
+namespace lz4 {
+
+	LZ4ParallelBlockDecompressor::LZ4ParallelBlockDecompressor(Stream^ innerStream, int blockSize, int spanBlocks, int degreeOfParallelism, LZ4Allocations^ allocations) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+		else if (spanBlocks < 1) { throw gcnew ArgumentOutOfRangeException("spanBlocks"); }
+		else if (degreeOfParallelism < 1) { throw gcnew ArgumentOutOfRangeException("degreeOfParallelism"); }
+
+		_innerStream = innerStream;
+		_blockSize = blockSize;
+		_spanBlocks = spanBlocks;
+		_decompressCallback = gcnew WaitCallback(this, &LZ4ParallelBlockDecompressor::DecompressBlock);
+
+		// one additional block for the block that is currently being read by the caller
+		_blocks = gcnew array<LZ4ParallelBlock^>(degreeOfParallelism + 1);
+		for (int i = 0; i < _blocks->Length; i++) {
+			_blocks[i] = gcnew LZ4ParallelBlock(blockSize, spanBlocks, allocations);
+		}
+	}
+
+	LZ4ParallelBlockDecompressor::~LZ4ParallelBlockDecompressor() {
+		if (_blocks == nullptr) { return; }
+
+		// the workers still reference the block buffers, wait for them before releasing anything
+		for (int i = 0; i < _blocks->Length; i++) {
+			_blocks[i]->_completed->WaitOne();
+		}
+		for (int i = 0; i < _blocks->Length; i++) {
+			delete _blocks[i];
+		}
+		_blocks = nullptr;
+		_current = nullptr;
+		_pending = 0;
+	}
+
+	void LZ4ParallelBlockDecompressor::DecompressBlock(Object^ state) {
+		LZ4ParallelBlock^ block = safe_cast<LZ4ParallelBlock^>(state);
+		try {
+			block->Decompress(_blockChecksum, _dictionary, _dictionarySize);
+		}
+		catch (Exception^ ex) {
+			block->_error = ex;
+		}
+		finally {
+			block->_completed->Set();
+		}
+	}
+
+	void LZ4ParallelBlockDecompressor::ReadExactly(array<byte>^ buffer, int offset, int count) {
+		while (count > 0) {
+			int bytesRead = _innerStream->Read(buffer, offset, count);
+			if (bytesRead == 0) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+			offset += bytesRead;
+			count -= bytesRead;
+		}
+	}
+
+	void LZ4ParallelBlockDecompressor::BeginFrame(native::LZ4FrameDecoder* frameDecoder) {
+		if (_pending != 0) { throw gcnew Exception("should not have happend, BeginFrame(): _pending == " + _pending); }
+		else if (frameDecoder->BlockSize() != _blockSize) { throw gcnew Exception("should not have happend, BeginFrame(): block size == " + frameDecoder->BlockSize()); }
+
+		_frameDecoder = frameDecoder;
+		_blockChecksum = frameDecoder->Info().blockChecksum;
+		_dictionary = frameDecoder->Dictionary();
+		_dictionarySize = frameDecoder->DictionarySize();
+		_endOfFrame = false;
+		_current = nullptr;
+	}
+
+	void LZ4ParallelBlockDecompressor::ReadAhead(int maxBlocks) {
+		int blocksRead = 0;
+		while (!_endOfFrame && blocksRead < maxBlocks && _pending + (_current != nullptr ? 1 : 0) < _blocks->Length) {
+
+			LZ4ParallelBlock^ block = _blocks[(_head + _pending) % _blocks->Length];
+			block->_spanBlocks = 0;
+
+			int offset = 0;
+			while (block->_spanBlocks < _spanBlocks) {
+				// read exactly the parts the frame decoder asks for, block data and block checksum are read into the block in one go
+				int frameEvent;
+				int required;
+				do {
+					required = _frameDecoder->NextInputSize();
+					if (offset + required > block->_inputBuffer->Length) { throw gcnew Exception("should not have happend, ReadAhead(): required == " + required); }
+					ReadExactly(block->_inputBuffer, offset, required);
+
+					int consumed;
+					frameEvent = CheckFrameResult(_frameDecoder->Decode(&block->_inputBufferPtr[offset], required, &consumed));
+				} while (frameEvent == native::LZ4FrameDecoder_NeedInput);
+
+				if (frameEvent == native::LZ4FrameDecoder_EndMark) {
+					_endOfFrame = true;
+					break;
+				}
+				else if (frameEvent != native::LZ4FrameDecoder_RawBlock || _frameDecoder->BlockData() != &block->_inputBufferPtr[offset]) {
+					throw gcnew Exception("should not have happend, ReadAhead(): frame event == " + frameEvent);
+				}
+
+				// the block checksum is verified by the worker
+				int i = block->_spanBlocks++;
+				block->_spanOffsets[i] = offset;
+				block->_spanSizes[i] = _frameDecoder->BlockDataSize();
+				block->_spanCompressed[i] = _frameDecoder->IsBlockCompressed();
+				block->_spanChecksums[i] = _frameDecoder->BlockChecksum();
+				offset += required;
+			}
+
+			if (block->_spanBlocks == 0) {
+				break;
+			}
+
+			block->_error = nullptr;
+			block->_completed->Reset();
+			_pending++;
+			blocksRead++;
+
+			ThreadPool::QueueUserWorkItem(_decompressCallback, block);
+		}
+	}
+
+	LZ4ParallelBlock^ LZ4ParallelBlockDecompressor::NextBlock() {
+		if (_pending == 0) { throw gcnew Exception("should not have happend, NextBlock(): _pending == 0"); }
+
+		// the previous block is no longer used by the caller
+		_current = nullptr;
+
+		LZ4ParallelBlock^ block = _blocks[_head];
+		block->_completed->WaitOne();
+
+		_head = (_head + 1) % _blocks->Length;
+		_pending--;
+
+		if (block->_error != nullptr) {
+			throw block->_error;
+		}
+
+		_current = block;
+		return block;
+	}
+
+	void LZ4ParallelBlockDecompressor::Reset() {
+		// the workers still use the pending blocks
+		for (int i = 0; i < _pending; i++) {
+			_blocks[(_head + i) % _blocks->Length]->_completed->WaitOne();
+		}
+		_head = 0;
+		_pending = 0;
+		_current = nullptr;
+		_endOfFrame = true;
+	}
+}
@@ -0,0 +1,114 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4ParallelBlock.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// reads the blocks of an independent block mode frame ahead and decompresses them on the thread pool, the blocks are returned in order
+	// linked blocks with a restart interval are read and returned in spans of that many blocks, the spans are decompressed on the thread pool
+	ref class LZ4ParallelBlockDecompressor sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		Stream^ _innerStream;
+		array<LZ4ParallelBlock^>^ _blocks;
+		native::LZ4FrameDecoder* _frameDecoder = nullptr;
+		WaitCallback^ _decompressCallback;
+		LZ4ParallelBlock^ _current = nullptr;
+		bool _blockChecksum = false;
+		const char* _dictionary = nullptr;
+		int _dictionarySize = 0;
+		bool _endOfFrame = false;
+		int _blockSize;
+		int _spanBlocks;
+		int _head = 0;
+		int _pending = 0;
+
+		void DecompressBlock(Object^ state);
+		void ReadExactly(array<byte>^ buffer, int offset, int count);
+
+	internal:
+		// spanBlocks: 1 for independent blocks, the restart interval for linked blocks
+		LZ4ParallelBlockDecompressor(Stream^ innerStream, int blockSize, int spanBlocks, int degreeOfParallelism, LZ4Allocations^ allocations);
+		~LZ4ParallelBlockDecompressor();
+
+		property int BlockSize {
+			int get() {
+				return _blockSize;
+			}
+		}
+
+		property int SpanBlocks {
+			int get() {
+				return _spanBlocks;
+			}
+		}
+
+		property int PendingBlocks {
+			int get() {
+				return _pending;
+			}
+		}
+
+		// true when the end mark of the current frame has been read
+		property bool EndOfFrame {
+			bool get() {
+				return _endOfFrame;
+			}
+		}
+
+		// the inner stream of the next frame, changed while no blocks are pending (LZ4Stream::Reset)
+		property Stream^ InnerStream {
+			Stream^ get() {
+				return _innerStream;
+			}
+			void set(Stream^ value) {
+				_innerStream = value;
+			}
+		}
+
+		// the frame decoder parses the block headers (external block decoding), the frame header has been read
+		void BeginFrame(native::LZ4FrameDecoder* frameDecoder);
+		void ReadAhead(int maxBlocks);
+		LZ4ParallelBlock^ NextBlock();
+		// discards the blocks that were read ahead, BeginFrame is called for the next frame
+		void Reset();
+	};
+}
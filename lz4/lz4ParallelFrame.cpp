@@ -0,0 +1,87 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4ParallelFrame.h"
+#include "lz4FrameResult.h"
+
+namespace lz4 {
+
+	LZ4ParallelFrame::LZ4ParallelFrame(LZ4Allocations^ allocations) {
+		_allocations = allocations;
+		_completed = gcnew ManualResetEvent(true);
+	}
+
+	LZ4ParallelFrame::~LZ4ParallelFrame() {
+		if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); }
+		if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); }
+		_inputBuffer = nullptr;
+		_outputBuffer = nullptr;
+		_input = nullptr;
+		_output = nullptr;
+		_dictionary = nullptr;
+
+		if (_completed != nullptr) { _completed->Close(); _completed = nullptr; }
+	}
+
+	void LZ4ParallelFrame::EnsureInputCapacity(int capacity) {
+		if (_inputBuffer != nullptr && _inputBuffer->Length >= capacity) { return; }
+
+		// grow by doubling, the frame is read in parts
+		int size = _inputBuffer != nullptr ? _inputBuffer->Length : 64 * 1024;
+		while (size < capacity) { size = size > Int32::MaxValue / 2 ? Int32::MaxValue : 2 * size; }
+
+		array<byte>^ buffer = _allocations->Buffer<byte>(size);
+		if (_inputBuffer != nullptr) {
+			Buffer::BlockCopy(_inputBuffer, 0, buffer, 0, _inputSize);
+			_inputBufferHandle.Free();
+		}
+		_inputBuffer = buffer;
+		_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
+		_input = (const char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
+	}
+
+	void LZ4ParallelFrame::EnsureOutputCapacity(int capacity) {
+		if (_outputBuffer == nullptr || _outputBuffer->Length < capacity) {
+			if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); }
+			_outputBuffer = _allocations->Buffer<byte>(Math::Max(capacity, 64 * 1024));
+			_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
+			_output = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
+		}
+		_outputCapacity = capacity;
+	}
+
+	void LZ4ParallelFrame::Decompress() {
+		const char* dictionary = _dictionary != nullptr ? _dictionary->DataPtr : nullptr;
+		int dictionarySize = _dictionary != nullptr ? _dictionary->Length : 0;
+		_targetSize = CheckFrameResult(native::LZ4Frame_decompress_usingDict(_input, _inputSize, _output, _outputCapacity, dictionary, dictionarySize));
+	}
+}
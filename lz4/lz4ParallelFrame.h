@@ -0,0 +1,82 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4Frame.h"
+#include "lz4Dictionary.h"
+#include "lz4Allocations.h"
+
+using namespace System;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// a whole frame that is decompressed on the thread pool, frames don't depend on each other
+	// LZ4Stream: the frame is read into the input buffer and decompressed into the output buffer, LZ4Helper: input and output point into the caller's arrays
+	ref class LZ4ParallelFrame sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+	internal:
+		array<byte>^ _inputBuffer = nullptr;
+		array<byte>^ _outputBuffer = nullptr;
+		GCHandle _inputBufferHandle;
+		GCHandle _outputBufferHandle;
+		const char* _input = nullptr;
+		int _inputSize = 0;
+		char* _output = nullptr;
+		int _outputCapacity = 0;
+		LZ4Dictionary^ _dictionary = nullptr;
+		int _targetSize = 0;
+		// LZ4Stream: the frame header and block count, a skippable frame, or the first part of a frame that is too large to read ahead
+		long long _blockCount = 0;
+		Nullable<long long> _contentSize = Nullable<long long>();
+		bool _skippable = false;
+		int _skippableId = 0;
+		array<byte>^ _userData = nullptr;
+		bool _incomplete = false;
+		Exception^ _error = nullptr;
+		ManualResetEvent^ _completed = nullptr;
+		LZ4Allocations^ _allocations;
+
+		LZ4ParallelFrame(LZ4Allocations^ allocations);
+		~LZ4ParallelFrame();
+
+		// the input buffer keeps its data when it grows
+		void EnsureInputCapacity(int capacity);
+		void EnsureOutputCapacity(int capacity);
+		// verifies the frame and decompresses it, _targetSize receives the decompressed size
+		void Decompress();
+	};
+}
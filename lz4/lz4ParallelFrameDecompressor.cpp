@@ -0,0 +1,316 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4ParallelFrameDecompressor.h"
+#include "lz4FrameResult.h"
+#include <string.h>
+
+namespace lz4 {
+
+	LZ4ParallelFrameDecompressor::LZ4ParallelFrameDecompressor(Stream^ innerStream, int maxFrameSize, int degreeOfParallelism, LZ4Allocations^ allocations) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+		else if (maxFrameSize < 1) { throw gcnew ArgumentOutOfRangeException("maxFrameSize"); }
+		else if (degreeOfParallelism < 1) { throw gcnew ArgumentOutOfRangeException("degreeOfParallelism"); }
+
+		_innerStream = innerStream;
+		_maxFrameSize = maxFrameSize;
+		_allocations = allocations;
+		_decompressCallback = gcnew WaitCallback(&LZ4ParallelFrameDecompressor::DecompressFrame);
+
+		// one additional frame for the frame that is currently being read by the caller, the buffers grow with the frames
+		_frames = gcnew array<LZ4ParallelFrame^>(degreeOfParallelism + 1);
+		for (int i = 0; i < _frames->Length; i++) {
+			_frames[i] = gcnew LZ4ParallelFrame(allocations);
+		}
+	}
+
+	LZ4ParallelFrameDecompressor::~LZ4ParallelFrameDecompressor() {
+		if (_frames == nullptr) { return; }
+
+		// the workers still reference the frame buffers, wait for them before releasing anything
+		for (int i = 0; i < _frames->Length; i++) {
+			_frames[i]->_completed->WaitOne();
+		}
+		for (int i = 0; i < _frames->Length; i++) {
+			delete _frames[i];
+		}
+		_frames = nullptr;
+		_current = nullptr;
+		_pending = 0;
+	}
+
+	void LZ4ParallelFrameDecompressor::DecompressFrame(Object^ state) {
+		LZ4ParallelFrame^ frame = safe_cast<LZ4ParallelFrame^>(state);
+		try {
+			frame->Decompress();
+		}
+		catch (Exception^ ex) {
+			frame->_error = ex;
+		}
+		finally {
+			frame->_completed->Set();
+		}
+	}
+
+	int LZ4ParallelFrameDecompressor::ReadInnerStream(array<byte>^ buffer, int offset, int count) {
+		int total = 0;
+		while (total < count) {
+			int bytesRead = _innerStream->Read(buffer, offset + total, count - total);
+			if (bytesRead == 0) { break; }
+			total += bytesRead;
+		}
+		return total;
+	}
+
+	bool LZ4ParallelFrameDecompressor::DecodeFrame(native::LZ4FrameDecoder* frameDecoder, LZ4ParallelFrame^ frame, const char* src, int srcSize, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries) {
+		int position = 0;
+		while (true) {
+			int consumed;
+			int frameEvent = CheckFrameResult(frameDecoder->Decode(src + position, srcSize - position, &consumed));
+			position += consumed;
+
+			switch (frameEvent) {
+			case native::LZ4FrameDecoder_NeedInput:
+				return false;
+			case native::LZ4FrameDecoder_FrameHeader: {
+				const native::LZ4FrameInfo& info = frameDecoder->Info();
+				frame->_dictionary = LZ4Dictionary::Select(info, dictionary, dictionaries);
+				frame->_contentSize = info.hasContentSize ? Nullable<long long>((long long)info.contentSize) : Nullable<long long>();
+				CheckFrameResult(frameDecoder->SetDictionary(frame->_dictionary != nullptr ? frame->_dictionary->DataPtr : nullptr, frame->_dictionary != nullptr ? frame->_dictionary->Length : 0));
+				// the blocks are only walked here, the worker verifies the blocks, the content checksum and the content size
+				CheckFrameResult(frameDecoder->SkipBlocks(0));
+				break;
+			}
+			case native::LZ4FrameDecoder_RawBlock: {
+				// a compressed block decompresses to at most the block size
+				long long bound = (long long)frame->_outputCapacity + (frameDecoder->IsBlockCompressed() ? frameDecoder->BlockSize() : frameDecoder->BlockDataSize());
+				if (bound > _maxFrameSize) {
+					// the caller decodes this frame from the part that has been read
+					frame->_incomplete = true;
+					_endOfStream = true;
+					return false;
+				}
+				frame->_outputCapacity = (int)bound;
+				frame->_blockCount++;
+				break;
+			}
+			case native::LZ4FrameDecoder_EndMark:
+				break;
+			case native::LZ4FrameDecoder_FrameEnd:
+				if (frame->_contentSize.HasValue && frame->_contentSize.Value < frame->_outputCapacity) {
+					frame->_outputCapacity = (int)frame->_contentSize.Value;
+				}
+				frame->EnsureOutputCapacity(frame->_outputCapacity);
+				return true;
+			case native::LZ4FrameDecoder_SkippableFrame:
+				// the user data is handed to the event handler, so it can't be reused
+				frame->_skippable = true;
+				frame->_skippableId = frameDecoder->SkippableId();
+				frame->_userData = _allocations->Buffer<byte>((int)frameDecoder->SkippableSize());
+				break;
+			case native::LZ4FrameDecoder_SkippableData:
+				break;
+			case native::LZ4FrameDecoder_SkippableFrameEnd:
+				return true;
+			default:
+				throw gcnew Exception("should not have happend, DecodeFrame(): frame event == " + frameEvent);
+			}
+		}
+	}
+
+	void LZ4ParallelFrameDecompressor::ReadAhead(native::LZ4FrameDecoder* frameDecoder, int maxFrames, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries) {
+		if (!frameDecoder->IsAtFrameBoundary()) { throw gcnew Exception("should not have happend, ReadAhead(): not at a frame boundary"); }
+		frameDecoder->SetExternalBlockDecoding(true);
+
+		int framesRead = 0;
+		while (!_endOfStream && framesRead < maxFrames && _pending + (_current != nullptr ? 1 : 0) < _frames->Length) {
+
+			LZ4ParallelFrame^ frame = _frames[(_head + _pending) % _frames->Length];
+			frame->_inputSize = 0;
+			frame->_outputCapacity = 0;
+			frame->_targetSize = 0;
+			frame->_dictionary = nullptr;
+			frame->_blockCount = 0;
+			frame->_contentSize = Nullable<long long>();
+			frame->_skippable = false;
+			frame->_userData = nullptr;
+			frame->_incomplete = false;
+			frame->_error = nullptr;
+
+			bool complete = false;
+			while (!complete && !frame->_incomplete) {
+				// read exactly the parts the frame decoder asks for, skippable frame data is read directly into the user data
+				int required = frameDecoder->NextInputSize();
+				if (frame->_userData != nullptr) {
+					if (ReadInnerStream(frame->_userData, 0, required) != required) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+
+					pin_ptr<byte> dataPtr = nullptr;
+					if (required > 0) { dataPtr = &frame->_userData[0]; }
+					complete = DecodeFrame(frameDecoder, frame, (const char*)dataPtr, required, dictionary, dictionaries);
+					continue;
+				}
+
+				frame->EnsureInputCapacity(frame->_inputSize + required);
+				int bytesRead = ReadInnerStream(frame->_inputBuffer, frame->_inputSize, required);
+				if (bytesRead == 0 && required > 0 && frameDecoder->IsAtFrameBoundary()) {
+					_endOfStream = true;
+					break;
+				}
+				else if (bytesRead != required) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+
+				const char* src = frame->_input + frame->_inputSize;
+				frame->_inputSize += required;
+				complete = DecodeFrame(frameDecoder, frame, src, required, dictionary, dictionaries);
+			}
+
+			if (!complete && !frame->_incomplete) {
+				break;
+			}
+
+			_pending++;
+			framesRead++;
+
+			if (complete && !frame->_skippable) {
+				frame->_completed->Reset();
+				ThreadPool::QueueUserWorkItem(_decompressCallback, frame);
+			}
+		}
+	}
+
+	LZ4ParallelFrame^ LZ4ParallelFrameDecompressor::NextFrame() {
+		if (_pending == 0) { throw gcnew Exception("should not have happend, NextFrame(): _pending == 0"); }
+
+		// the previous frame is no longer used by the caller
+		_current = nullptr;
+
+		LZ4ParallelFrame^ frame = _frames[_head];
+		frame->_completed->WaitOne();
+
+		_head = (_head + 1) % _frames->Length;
+		_pending--;
+
+		if (frame->_error != nullptr) {
+			throw frame->_error;
+		}
+
+		_current = frame;
+		return frame;
+	}
+
+	void LZ4ParallelFrameDecompressor::Reset() {
+		// the workers still use the pending frames
+		for (int i = 0; i < _pending; i++) {
+			_frames[(_head + i) % _frames->Length]->_completed->WaitOne();
+		}
+		_head = 0;
+		_pending = 0;
+		_current = nullptr;
+		_endOfStream = false;
+	}
+
+	int LZ4ParallelFrameDecompressor::DecompressFrames(const char* src, int srcSize, char* dst, int dstCapacity, LZ4Dictionary^ dictionary, int degreeOfParallelism) {
+		int frameCount = CheckFrameResult(native::LZ4Frame_locateFrames(src, srcSize, nullptr, 0));
+		if (degreeOfParallelism < 2 || frameCount < 2) {
+			const char* dictionaryPtr = dictionary != nullptr ? dictionary->DataPtr : nullptr;
+			int dictionarySize = dictionary != nullptr ? dictionary->Length : 0;
+			return CheckFrameResult(native::LZ4Frame_decompress_usingDict(src, srcSize, dst, dstCapacity, dictionaryPtr, dictionarySize));
+		}
+
+		native::LZ4FrameLocation* locations = new native::LZ4FrameLocation[frameCount];
+		array<int>^ outputOffsets = gcnew array<int>(frameCount);
+		array<int>^ outputSizes = gcnew array<int>(frameCount);
+		// the frame each worker decompresses, the frames are queued in order
+		array<LZ4ParallelFrame^>^ workers = gcnew array<LZ4ParallelFrame^>(Math::Min(degreeOfParallelism, frameCount));
+		array<int>^ workerFrames = gcnew array<int>(workers->Length);
+		WaitCallback^ decompressCallback = gcnew WaitCallback(&LZ4ParallelFrameDecompressor::DecompressFrame);
+		// the workers decompress into the caller's arrays, there is no stream to count allocations for
+		LZ4Allocations^ allocations = gcnew LZ4Allocations();
+		try {
+			CheckFrameResult(native::LZ4Frame_locateFrames(src, srcSize, locations, frameCount));
+			for (int i = 0; i < workers->Length; i++) {
+				workers[i] = gcnew LZ4ParallelFrame(allocations);
+				workerFrames[i] = -1;
+			}
+
+			long long outputOffset = 0;
+			int next = 0;
+			for (int i = 0; i < frameCount; i++) {
+				const native::LZ4FrameLocation& location = locations[i];
+				if (location.skippable) { continue; }
+				if (outputOffset + location.decompressedBound > dstCapacity) { CheckFrameResult(native::LZ4Frame_ErrorDstTooSmall); }
+
+				LZ4ParallelFrame^ worker = workers[next];
+				worker->_completed->WaitOne();
+				if (worker->_error != nullptr) { throw worker->_error; }
+				if (workerFrames[next] >= 0) { outputSizes[workerFrames[next]] = worker->_targetSize; }
+
+				outputOffsets[i] = (int)outputOffset;
+				workerFrames[next] = i;
+				worker->_input = src + location.offset;
+				worker->_inputSize = location.size;
+				worker->_output = dst + outputOffset;
+				worker->_outputCapacity = (int)location.decompressedBound;
+				worker->_dictionary = dictionary;
+				worker->_completed->Reset();
+				ThreadPool::QueueUserWorkItem(decompressCallback, worker);
+
+				outputOffset += location.decompressedBound;
+				next = (next + 1) % workers->Length;
+			}
+
+			for (int i = 0; i < workers->Length; i++) {
+				workers[i]->_completed->WaitOne();
+				if (workers[i]->_error != nullptr) { throw workers[i]->_error; }
+				if (workerFrames[i] >= 0) { outputSizes[workerFrames[i]] = workers[i]->_targetSize; }
+			}
+
+			// move the frames together, nothing moves when the frames contain their content size
+			int size = 0;
+			for (int i = 0; i < frameCount; i++) {
+				if (locations[i].skippable) { continue; }
+				if (outputOffsets[i] != size) { memmove(dst + size, dst + outputOffsets[i], (size_t)outputSizes[i]); }
+				size += outputSizes[i];
+			}
+			return size;
+		}
+		finally {
+			// the workers write into dst until they complete
+			for (int i = 0; i < workers->Length; i++) {
+				if (workers[i] != nullptr) {
+					workers[i]->_completed->WaitOne();
+					delete workers[i];
+				}
+			}
+			delete[] locations;
+		}
+	}
+}
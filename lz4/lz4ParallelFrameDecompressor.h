@@ -0,0 +1,103 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4ParallelFrame.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Runtime::InteropServices;
+
+namespace lz4 {
+
+	// reads whole frames of a stream of concatenated frames ahead (maxFrameSize) and decompresses them on the thread pool, the frames are returned in order
+	// skippable frames are returned in order as well, a frame that decompresses to more than maxFrameSize bytes ends the read-ahead, it is returned with the part that has been read
+	ref class LZ4ParallelFrameDecompressor sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		Stream^ _innerStream;
+		array<LZ4ParallelFrame^>^ _frames;
+		WaitCallback^ _decompressCallback;
+		LZ4ParallelFrame^ _current = nullptr;
+		bool _endOfStream = false;
+		int _maxFrameSize;
+		int _head = 0;
+		int _pending = 0;
+		LZ4Allocations^ _allocations;
+
+		static void DecompressFrame(Object^ state);
+		int ReadInnerStream(array<byte>^ buffer, int offset, int count);
+		// decodes the part of the frame that has been read, returns true when the frame is complete
+		bool DecodeFrame(native::LZ4FrameDecoder* frameDecoder, LZ4ParallelFrame^ frame, const char* src, int srcSize, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries);
+
+	internal:
+		LZ4ParallelFrameDecompressor(Stream^ innerStream, int maxFrameSize, int degreeOfParallelism, LZ4Allocations^ allocations);
+		~LZ4ParallelFrameDecompressor();
+
+		property int PendingFrames {
+			int get() {
+				return _pending;
+			}
+		}
+
+		// true when the inner stream has ended, or a frame was too large to read ahead
+		property bool EndOfStream {
+			bool get() {
+				return _endOfStream;
+			}
+		}
+
+		// the inner stream of the next frames, changed while no frames are pending (LZ4Stream::Reset)
+		property Stream^ InnerStream {
+			Stream^ get() {
+				return _innerStream;
+			}
+			void set(Stream^ value) {
+				_innerStream = value;
+			}
+		}
+
+		// the frame decoder is at a frame boundary, it parses the frames as they are read (external block decoding), the workers verify the blocks and checksums
+		// dictionary and dictionaries: LZ4Dictionary::Select
+		void ReadAhead(native::LZ4FrameDecoder* frameDecoder, int maxFrames, LZ4Dictionary^ dictionary, System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ dictionaries);
+		LZ4ParallelFrame^ NextFrame();
+		// discards the frames that were read ahead
+		void Reset();
+
+		// decompresses the frames of src on the thread pool, each frame into its own part of dst (the decompressed bounds of the frames before it), the parts are then moved together
+		// the dictionary is used for every frame, returns the number of bytes written
+		static int DecompressFrames(const char* src, int srcSize, char* dst, int dstCapacity, LZ4Dictionary^ dictionary, int degreeOfParallelism);
+	};
+}
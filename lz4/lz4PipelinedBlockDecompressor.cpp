@@ -0,0 +1,317 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4PipelinedBlockDecompressor.h"
+#include "lz4FrameResult.h"
+
+namespace lz4 {
+
+	LZ4PipelinedBlockDecompressor::LZ4PipelinedBlockDecompressor(Stream^ innerStream, int blockSize, int blockCount, LZ4Allocations^ allocations) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+		else if (blockCount < 2) { throw gcnew ArgumentOutOfRangeException("blockCount"); }
+
+		_innerStream = innerStream;
+		_blockSize = blockSize;
+		_readCallback = gcnew WaitCallback(this, &LZ4PipelinedBlockDecompressor::ReadBlocks);
+		_decompressCallback = gcnew WaitCallback(this, &LZ4PipelinedBlockDecompressor::DecompressBlocks);
+		_hashCallback = gcnew WaitCallback(this, &LZ4PipelinedBlockDecompressor::HashBlocks);
+
+		_blocks = gcnew array<LZ4ParallelBlock^>(blockCount);
+		for (int i = 0; i < blockCount; i++) {
+			_blocks[i] = gcnew LZ4ParallelBlock(blockSize, 1, allocations);
+		}
+		_sync = gcnew Object();
+	}
+
+	LZ4PipelinedBlockDecompressor::~LZ4PipelinedBlockDecompressor() {
+		if (_blocks == nullptr) { return; }
+
+		// the stages still reference the blocks, stop them before releasing anything
+		Stop();
+		for (int i = 0; i < _blocks->Length; i++) {
+			delete _blocks[i];
+		}
+		_blocks = nullptr;
+	}
+
+	bool LZ4PipelinedBlockDecompressor::WaitCount(long long% count, long long target, bool cancellable) {
+		// the previous stage is usually a block ahead, spin before blocking
+		SpinWait spinner;
+		while (!spinner.NextSpinWillYield) {
+			if (Interlocked::Read(count) >= target) { return true; }
+			else if (cancellable && Thread::VolatileRead(_cancelled) != 0) { return false; }
+			spinner.SpinOnce();
+		}
+
+		Monitor::Enter(_sync);
+		try {
+			// registered before the count is read again, Publish() pulses when it sees a waiter
+			Interlocked::Increment(_waiters);
+			try {
+				while (Interlocked::Read(count) < target) {
+					if (cancellable && Thread::VolatileRead(_cancelled) != 0) { return false; }
+					Monitor::Wait(_sync);
+				}
+				return true;
+			}
+			finally {
+				Interlocked::Decrement(_waiters);
+			}
+		}
+		finally {
+			Monitor::Exit(_sync);
+		}
+	}
+
+	void LZ4PipelinedBlockDecompressor::Publish(long long% count) {
+		Interlocked::Increment(count);
+		if (Thread::VolatileRead(_waiters) != 0) {
+			Monitor::Enter(_sync);
+			try {
+				Monitor::PulseAll(_sync);
+			}
+			finally {
+				Monitor::Exit(_sync);
+			}
+		}
+	}
+
+	void LZ4PipelinedBlockDecompressor::ReadExactly(array<byte>^ buffer, int count) {
+		int offset = 0;
+		while (offset < count) {
+			int bytesRead = _innerStream->Read(buffer, offset, count - offset);
+			if (bytesRead == 0) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+			offset += bytesRead;
+		}
+	}
+
+	bool LZ4PipelinedBlockDecompressor::ReadBlock(LZ4ParallelBlock^ block) {
+		// read exactly the parts the frame decoder asks for, block data and block checksum are read into the block in one go
+		int frameEvent;
+		do {
+			int required = _frameDecoder->NextInputSize();
+			if (required > block->_inputBuffer->Length) { throw gcnew Exception("should not have happend, ReadBlock(): required == " + required); }
+			ReadExactly(block->_inputBuffer, required);
+
+			int consumed;
+			frameEvent = CheckFrameResult(_frameDecoder->Decode(block->_inputBufferPtr, required, &consumed));
+		} while (frameEvent == native::LZ4FrameDecoder_NeedInput);
+
+		if (frameEvent == native::LZ4FrameDecoder_EndMark) {
+			return false;
+		}
+		else if (frameEvent != native::LZ4FrameDecoder_RawBlock || _frameDecoder->BlockData() != block->_inputBufferPtr) {
+			throw gcnew Exception("should not have happend, ReadBlock(): frame event == " + frameEvent);
+		}
+
+		block->_spanBlocks = 1;
+		block->_spanOffsets[0] = 0;
+		block->_spanSizes[0] = _frameDecoder->BlockDataSize();
+		block->_spanCompressed[0] = _frameDecoder->IsBlockCompressed();
+		block->_spanChecksums[0] = _frameDecoder->BlockChecksum();
+
+		if (_blockChecksum) {
+			// verify checksum
+			unsigned int xxh = XXH32(block->_inputBufferPtr, block->_spanSizes[0], 0);
+			if (block->_spanChecksums[0] != xxh) {
+				throw gcnew Exception("Block checksum did not match");
+			}
+		}
+		return true;
+	}
+
+	void LZ4PipelinedBlockDecompressor::ReadBlocks(Object^ state) {
+		try {
+			for (long long sequence = 0; ; sequence++) {
+				// the block of the previous round of the ring has been hashed and released by the caller
+				int index = (int)(sequence % _blocks->Length);
+				long long previousRound = sequence - _blocks->Length + 1;
+				if (!WaitCount(_hashedCount, previousRound, true) || !WaitCount(_releasedCount, previousRound, true)) { return; }
+
+				LZ4ParallelBlock^ block = _blocks[index];
+				bool hasBlock = false;
+				try {
+					block->_error = nullptr;
+					hasBlock = ReadBlock(block);
+				}
+				catch (Exception^ ex) {
+					block->_error = ex;
+				}
+				if (!hasBlock) {
+					// end mark or error, the last block of the ring
+					block->_spanBlocks = 0;
+				}
+				Publish(_readCount);
+
+				if (!hasBlock) { return; }
+			}
+		}
+		finally {
+			Publish(_completedStages);
+		}
+	}
+
+	void LZ4PipelinedBlockDecompressor::DecompressBlocks(Object^ state) {
+		try {
+			LZ4ParallelBlock^ previous = nullptr;
+			for (long long sequence = 0; ; sequence++) {
+				int index = (int)(sequence % _blocks->Length);
+				if (!WaitCount(_readCount, sequence + 1, true)) { return; }
+
+				LZ4ParallelBlock^ block = _blocks[index];
+				if (block->_spanBlocks > 0) {
+					try {
+						// the previous block is the history [linked blocks], it is released by the caller after this block
+						if (previous != nullptr) {
+							block->Decompress(false, previous->DataPtr, previous->_targetSize);
+						}
+						else {
+							block->Decompress(false, _dictionary, _dictionarySize);
+						}
+					}
+					catch (Exception^ ex) {
+						block->_error = ex;
+					}
+				}
+
+				bool last = block->_spanBlocks == 0 || block->_error != nullptr;
+				Publish(_decodedCount);
+
+				if (last) { return; }
+				previous = block;
+			}
+		}
+		finally {
+			Publish(_completedStages);
+		}
+	}
+
+	void LZ4PipelinedBlockDecompressor::HashBlocks(Object^ state) {
+		try {
+			for (long long sequence = 0; ; sequence++) {
+				int index = (int)(sequence % _blocks->Length);
+				if (!WaitCount(_decodedCount, sequence + 1, true)) { return; }
+
+				LZ4ParallelBlock^ block = _blocks[index];
+				bool last = block->_spanBlocks == 0 || block->_error != nullptr;
+				if (!last) {
+					try {
+						// only the content hash state of the frame decoder is used, the read stage uses the block header state
+						CheckFrameResult(_frameDecoder->UpdateContentChecksum(block->DataPtr, block->_targetSize));
+					}
+					catch (Exception^ ex) {
+						_hashError = ex;
+						last = true;
+					}
+				}
+				Publish(_hashedCount);
+
+				if (last) { return; }
+			}
+		}
+		finally {
+			Publish(_completedStages);
+		}
+	}
+
+	void LZ4PipelinedBlockDecompressor::BeginFrame(native::LZ4FrameDecoder* frameDecoder) {
+		if (_running) { throw gcnew Exception("should not have happend, BeginFrame(): running"); }
+		else if (frameDecoder->BlockSize() != _blockSize) { throw gcnew Exception("should not have happend, BeginFrame(): block size == " + frameDecoder->BlockSize()); }
+
+		_frameDecoder = frameDecoder;
+		_blockChecksum = frameDecoder->Info().blockChecksum;
+		_dictionary = frameDecoder->Dictionary();
+		_dictionarySize = frameDecoder->DictionarySize();
+		_sequence = 0;
+		_current = -1;
+		_hashError = nullptr;
+
+		// no stage is running, all blocks are free
+		_readCount = 0;
+		_decodedCount = 0;
+		_hashedCount = 0;
+		_releasedCount = 0;
+		_completedStages = 0;
+		_running = true;
+
+		ThreadPool::QueueUserWorkItem(_readCallback);
+		ThreadPool::QueueUserWorkItem(_decompressCallback);
+		ThreadPool::QueueUserWorkItem(_hashCallback);
+	}
+
+	LZ4ParallelBlock^ LZ4PipelinedBlockDecompressor::NextBlock() {
+		if (!_running) { throw gcnew Exception("should not have happend, NextBlock(): not running"); }
+
+		int index = (int)(_sequence % _blocks->Length);
+		WaitCount(_decodedCount, _sequence + 1, false);
+		_sequence++;
+
+		// the previous block is the history of this block, it can be reused now
+		if (_current >= 0) { Publish(_releasedCount); }
+		_current = index;
+
+		LZ4ParallelBlock^ block = _blocks[index];
+		if (block->_error != nullptr) {
+			// the stages that are still waiting for blocks are stopped
+			Stop();
+			throw block->_error;
+		}
+		else if (block->_spanBlocks == 0) {
+			// end mark, the content checksum includes all blocks when the stages have completed
+			Stop();
+			if (_hashError != nullptr) { throw _hashError; }
+			return nullptr;
+		}
+		return block;
+	}
+
+	void LZ4PipelinedBlockDecompressor::Stop() {
+		if (!_running) { return; }
+
+		// the waiting stages see the flag after the pulse
+		Thread::VolatileWrite(_cancelled, 1);
+		Monitor::Enter(_sync);
+		try {
+			Monitor::PulseAll(_sync);
+		}
+		finally {
+			Monitor::Exit(_sync);
+		}
+		WaitCount(_completedStages, 3, false);
+		Thread::VolatileWrite(_cancelled, 0);
+		_running = false;
+	}
+
+	void LZ4PipelinedBlockDecompressor::Reset() {
+		Stop();
+	}
+}
@@ -0,0 +1,113 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+#pragma once
+
+#include "lz4ParallelBlock.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+
+namespace lz4 {
+
+	// decodes the blocks of a linked block mode frame in a pipeline, each stage runs on its own thread pool thread:
+	// reading the blocks from the inner stream and verifying the block checksums, decompressing the blocks in order, and updating the content checksum
+	// the stages are connected by a ring of blocks, each stage counts the blocks it has passed on and the next stage waits for its count to include the block
+	// a stage that keeps up spins, otherwise it waits on a monitor that is only pulsed when a stage is waiting
+	ref class LZ4PipelinedBlockDecompressor sealed
+	{
+	private:
+		typedef unsigned char byte;
+
+		Stream^ _innerStream;
+		array<LZ4ParallelBlock^>^ _blocks;
+		// blocks that have been read, decompressed (for the hash stage and for the caller), hashed, released by the caller, stages that have completed
+		long long _readCount = 0;
+		long long _decodedCount = 0;
+		long long _hashedCount = 0;
+		long long _releasedCount = 0;
+		long long _completedStages = 0;
+		int _cancelled = 0;
+		int _waiters = 0;
+		Object^ _sync;
+		WaitCallback^ _readCallback;
+		WaitCallback^ _decompressCallback;
+		WaitCallback^ _hashCallback;
+		native::LZ4FrameDecoder* _frameDecoder = nullptr;
+		bool _blockChecksum = false;
+		const char* _dictionary = nullptr;
+		int _dictionarySize = 0;
+		int _blockSize;
+		bool _running = false;
+		long long _sequence = 0;
+		int _current = -1;
+		Exception^ _hashError = nullptr;
+
+		// false when the pipeline is stopped (cancellable)
+		bool WaitCount(long long% count, long long target, bool cancellable);
+		void Publish(long long% count);
+		void ReadExactly(array<byte>^ buffer, int count);
+		bool ReadBlock(LZ4ParallelBlock^ block);
+		void ReadBlocks(Object^ state);
+		void DecompressBlocks(Object^ state);
+		void HashBlocks(Object^ state);
+		void Stop();
+
+	internal:
+		// blockCount: number of blocks in the pipeline, at least 2
+		LZ4PipelinedBlockDecompressor(Stream^ innerStream, int blockSize, int blockCount, LZ4Allocations^ allocations);
+		~LZ4PipelinedBlockDecompressor();
+
+		property int BlockSize {
+			int get() {
+				return _blockSize;
+			}
+		}
+
+		// the inner stream of the next frame, changed while the stages are stopped (LZ4Stream::Reset)
+		property Stream^ InnerStream {
+			Stream^ get() {
+				return _innerStream;
+			}
+			void set(Stream^ value) {
+				_innerStream = value;
+			}
+		}
+
+		// starts the stages, the frame decoder parses the block headers (external block decoding) and the frame header has been read
+		void BeginFrame(native::LZ4FrameDecoder* frameDecoder);
+		// the next decompressed block, it is valid until the next call
+		// nullptr at the end mark of the frame, the stages have completed and the frame decoder continues with the content checksum
+		LZ4ParallelBlock^ NextBlock();
+		// stops the stages and discards the blocks that were read ahead
+		void Reset();
+	};
+}
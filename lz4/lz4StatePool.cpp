@@ -0,0 +1,173 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#define LZ4_STATIC_LINKING_ONLY
+#define LZ4_HC_STATIC_LINKING_ONLY
+#include "lz4StatePool.h"
+
+namespace lz4 {
+
+	namespace native {
+
+		class LZ4PooledStateAllocator : public LZ4FrameStateAllocator {
+		public:
+			virtual LZ4_stream_t* RentStream(int memoryUsage) {
+				return LZ4StatePool::RentStream(memoryUsage);
+			}
+
+			virtual void ReturnStream(LZ4_stream_t* stream, int memoryUsage) {
+				LZ4StatePool::ReturnStream(stream, memoryUsage);
+			}
+
+			virtual LZ4_streamHC_t* RentStreamHC(int memoryUsage) {
+				return LZ4StatePool::RentStreamHC(memoryUsage);
+			}
+
+			virtual void ReturnStreamHC(LZ4_streamHC_t* stream, int memoryUsage) {
+				LZ4StatePool::ReturnStreamHC(stream, memoryUsage);
+			}
+		};
+
+		static LZ4PooledStateAllocator PooledStateAllocator;
+	}
+
+	native::LZ4FrameStateAllocator* LZ4StatePool::Allocator::get() {
+		return &native::PooledStateAllocator;
+	}
+
+	LZ4StatePool::ThreadCache::!ThreadCache() {
+		for (int i = 0; i < Kinds; i++) {
+			if (_states[i] != IntPtr::Zero) { Free(i, _states[i]); _states[i] = IntPtr::Zero; }
+		}
+	}
+
+	int LZ4StatePool::GetKind(bool highCompression, int memoryUsage) {
+		// 0 is a kind of its own, a state of the default size keeps memoryUsage 0
+		if (!highCompression) { return memoryUsage == 0 ? 0 : 1 + (memoryUsage - LZ4_MEMORY_USAGE_MIN) / 2; }
+		return FastKinds + (memoryUsage == 0 ? 0 : 1 + memoryUsage - LZ4_MEMORY_USAGE_MIN);
+	}
+
+	IntPtr LZ4StatePool::Rent(bool highCompression, int memoryUsage) {
+		int kind = GetKind(highCompression, memoryUsage);
+		Interlocked::Increment(_rented);
+
+		IntPtr state = IntPtr::Zero;
+		ThreadCache^ cache = _threadCache;
+		if (cache != nullptr && cache->_states[kind] != IntPtr::Zero) {
+			state = cache->_states[kind];
+			cache->_states[kind] = IntPtr::Zero;
+			Interlocked::Increment(_threadCacheHits);
+		}
+		else {
+			System::Collections::Generic::Stack<IntPtr>^ shared = _shared[kind];
+			Monitor::Enter(shared);
+			try {
+				if (shared->Count > 0) { state = shared->Pop(); }
+			}
+			finally {
+				Monitor::Exit(shared);
+			}
+			if (state != IntPtr::Zero) { Interlocked::Increment(_sharedHits); }
+		}
+
+		if (state == IntPtr::Zero) {
+			// a new state is cleared
+			Interlocked::Increment(_misses);
+			native::LZ4FrameStateAllocator* heap = native::LZ4Frame_getHeapStateAllocator();
+			return highCompression ? IntPtr(heap->RentStreamHC(memoryUsage)) : IntPtr(heap->RentStream(memoryUsage));
+		}
+
+		// the tables are kept, the previous positions are out of reach
+		if (!highCompression) { LZ4_resetStream_fast((LZ4_stream_t*)state.ToPointer()); }
+		else { LZ4_resetStreamHC_fast((LZ4_streamHC_t*)state.ToPointer(), LZ4HC_CLEVEL_DEFAULT); }
+		return state;
+	}
+
+	void LZ4StatePool::Return(bool highCompression, int memoryUsage, IntPtr state) {
+		if (state == IntPtr::Zero) { return; }
+		int kind = GetKind(highCompression, memoryUsage);
+
+		ThreadCache^ cache = _threadCache;
+		if (cache == nullptr) {
+			cache = gcnew ThreadCache();
+			_threadCache = cache;
+		}
+		if (cache->_states[kind] == IntPtr::Zero) {
+			cache->_states[kind] = state;
+			return;
+		}
+
+		System::Collections::Generic::Stack<IntPtr>^ shared = _shared[kind];
+		Monitor::Enter(shared);
+		try {
+			if (shared->Count < _maxSharedStates) {
+				shared->Push(state);
+				return;
+			}
+		}
+		finally {
+			Monitor::Exit(shared);
+		}
+		Free(kind, state);
+	}
+
+	void LZ4StatePool::Free(int kind, IntPtr state) {
+		if (kind < FastKinds) { LZ4_freeStream((LZ4_stream_t*)state.ToPointer()); }
+		else { LZ4_freeStreamHC((LZ4_streamHC_t*)state.ToPointer()); }
+	}
+
+	void LZ4StatePool::ResetStatistics() {
+		Interlocked::Exchange(_rented, 0);
+		Interlocked::Exchange(_threadCacheHits, 0);
+		Interlocked::Exchange(_sharedHits, 0);
+		Interlocked::Exchange(_misses, 0);
+	}
+
+	void LZ4StatePool::Clear() {
+		ThreadCache^ cache = _threadCache;
+		if (cache != nullptr) {
+			_threadCache = nullptr;
+			delete cache;
+		}
+
+		for (int i = 0; i < Kinds; i++) {
+			System::Collections::Generic::Stack<IntPtr>^ shared = _shared[i];
+			Monitor::Enter(shared);
+			try {
+				while (shared->Count > 0) { Free(i, shared->Pop()); }
+			}
+			finally {
+				Monitor::Exit(shared);
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4Frame.h"
+
+using namespace System;
+using namespace System::Threading;
+
+namespace lz4 {
+
+	// compression states (the hash tables, 16 KB - 256 KB) that are reused across LZ4Stream compressors, LZ4Helper calls and threads
+	// a rented state is reset (LZ4_resetStream_fast, LZ4_resetStreamHC_fast) instead of allocated and cleared, every thread keeps one state of each size and the others are shared
+	public ref class LZ4StatePool abstract sealed
+	{
+	private:
+		// fast compression: memoryUsage 0, 12, 14, 16, 18, high compression: 0, 12 - 18 (12, 14, 16, 17, 18 are used)
+		literal int FastKinds = 5;
+		literal int Kinds = FastKinds + 8;
+
+		// the states of a thread, freed when the thread has ended
+		ref class ThreadCache sealed
+		{
+		internal:
+			array<IntPtr>^ _states = gcnew array<IntPtr>(Kinds);
+
+			~ThreadCache() { this->!ThreadCache(); }
+			!ThreadCache();
+		};
+
+		[ThreadStatic]
+		static ThreadCache^ _threadCache;
+		static array<System::Collections::Generic::Stack<IntPtr>^>^ _shared;
+		static int _maxSharedStates = 16;
+		static long long _rented = 0;
+		static long long _threadCacheHits = 0;
+		static long long _sharedHits = 0;
+		static long long _misses = 0;
+
+		static LZ4StatePool() {
+			_shared = gcnew array<System::Collections::Generic::Stack<IntPtr>^>(Kinds);
+			for (int i = 0; i < Kinds; i++) {
+				_shared[i] = gcnew System::Collections::Generic::Stack<IntPtr>();
+			}
+		}
+
+		static int GetKind(bool highCompression, int memoryUsage);
+		static IntPtr Rent(bool highCompression, int memoryUsage);
+		static void Return(bool highCompression, int memoryUsage, IntPtr state);
+		static void Free(int kind, IntPtr state);
+
+	internal:
+		// memoryUsage: LZ4FrameCompressionOptions::memoryUsage, a state is returned with the size it was rented for
+		static LZ4_stream_t* RentStream(int memoryUsage) {
+			return (LZ4_stream_t*)Rent(false, memoryUsage).ToPointer();
+		}
+		static void ReturnStream(LZ4_stream_t* stream, int memoryUsage) {
+			Return(false, memoryUsage, IntPtr(stream));
+		}
+		static LZ4_streamHC_t* RentStreamHC(int memoryUsage) {
+			return (LZ4_streamHC_t*)Rent(true, memoryUsage).ToPointer();
+		}
+		static void ReturnStreamHC(LZ4_streamHC_t* stream, int memoryUsage) {
+			Return(true, memoryUsage, IntPtr(stream));
+		}
+
+		// the allocator of the frame encoders
+		static property native::LZ4FrameStateAllocator* Allocator {
+			native::LZ4FrameStateAllocator* get();
+		}
+
+	public:
+		// shared states of each size, the states beyond it are freed when they are returned (0: only the states of the threads are kept)
+		static property int MaxSharedStates {
+			int get() {
+				return _maxSharedStates;
+			}
+			void set(int value) {
+				if (value < 0) { throw gcnew ArgumentOutOfRangeException("value"); }
+				_maxSharedStates = value;
+			}
+		}
+
+		static property long long Rented { long long get() { return Interlocked::Read(_rented); }; };
+		// rented from the states of the calling thread
+		static property long long ThreadCacheHits { long long get() { return Interlocked::Read(_threadCacheHits); }; };
+		static property long long SharedHits { long long get() { return Interlocked::Read(_sharedHits); }; };
+		// allocated
+		static property long long Misses { long long get() { return Interlocked::Read(_misses); }; };
+		// part of the rented states that were reused
+		property static double HitRate {
+			double get() {
+				long long rented = Rented;
+				return rented != 0 ? (double)(ThreadCacheHits + SharedHits) / rented : 0;
+			}
+		}
+
+		static void ResetStatistics();
+		// frees the shared states and those of the calling thread, the states of other threads are freed when the threads end
+		static void Clear();
+	};
+}
@@ -30,24 +30,23 @@
    */
 
 #include "lz4Stream.h"
-#include "lz4.h"
-#include "lz4hc.h"
-#include "xxhash.h"
-
-#define KB *(1 <<10)
-#define MB *(1 <<20)
-
-typedef unsigned int        U32;
+#include "lz4FrameResult.h"
+#include "lz4StatePool.h"
 
 namespace lz4 {
 
 	LZ4Stream::LZ4Stream() {
-
+		_allocations = gcnew LZ4Allocations();
 	}
 
 	LZ4Stream^ LZ4Stream::CreateCompressor(Stream^ innerStream, LZ4StreamMode streamMode, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, bool highCompression, bool leaveInnerStreamOpen) {
+		return CreateCompressor(innerStream, streamMode, blockMode, blockSize, checksumMode, maxFrameSize, highCompression ? LZ4HC_CLEVEL_DEFAULT : 0, false, leaveInnerStreamOpen);
+	}
+
+	LZ4Stream^ LZ4Stream::CreateCompressor(Stream^ innerStream, LZ4StreamMode streamMode, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed, bool leaveInnerStreamOpen) {
 		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
 		if (maxFrameSize.HasValue && maxFrameSize.Value <= 0) { throw gcnew ArgumentOutOfRangeException("maxFrameSize"); }
+		if (compressionLevel != 0 && (compressionLevel < LZ4HC_CLEVEL_MIN || compressionLevel > LZ4HC_CLEVEL_MAX)) { throw gcnew ArgumentOutOfRangeException("compressionLevel"); }
 
 		LZ4Stream^ result = gcnew LZ4Stream();
 		result->_streamMode = streamMode;
@@ -58,7 +57,8 @@ namespace lz4 {
 		result->_blockSize = blockSize;
 		result->_maxFrameSize = maxFrameSize;
 		result->_leaveInnerStreamOpen = leaveInnerStreamOpen;
-		result->_highCompression = highCompression;
+		result->_compressionLevel = compressionLevel;
+		result->_favorDecSpeed = favorDecSpeed;
 		result->Init();
 
 		return result;
@@ -78,12 +78,17 @@ namespace lz4 {
 	}
 
 	LZ4Stream::~LZ4Stream() {
-		if (_compressionMode == CompressionMode::Compress && _streamMode == LZ4StreamMode::Write) { WriteEndFrameInternal(); }
+		WriteEndStream();
 
 		if (!_leaveInnerStreamOpen) {
 			delete _innerStream;
 		}
 
+		if (_parallelCompressor != nullptr) { delete _parallelCompressor; _parallelCompressor = nullptr; }
+		if (_parallelDecompressor != nullptr) { delete _parallelDecompressor; _parallelDecompressor = nullptr; }
+		if (_pipelinedDecompressor != nullptr) { delete _pipelinedDecompressor; _pipelinedDecompressor = nullptr; }
+		if (_frameDecompressor != nullptr) { delete _frameDecompressor; _frameDecompressor = nullptr; }
+
 		if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); _inputBufferPtr = nullptr; }
 		if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
 		_inputBuffer = nullptr;
@@ -93,75 +98,148 @@ namespace lz4 {
 	}
 
 	LZ4Stream::!LZ4Stream() {
-		if (_lz4Stream != nullptr) { LZ4_freeStream(_lz4Stream); _lz4Stream = nullptr; }
-		if (_lz4HCStream != nullptr) { LZ4_freeStreamHC(_lz4HCStream); _lz4HCStream = nullptr; }
-		if (_contentHashState != nullptr) { XXH32_freeState(_contentHashState); _contentHashState = nullptr; }
-		if (_lz4DecodeStream != nullptr) { LZ4_freeStreamDecode(_lz4DecodeStream); _lz4DecodeStream = nullptr; }
+		if (_frameEncoder != nullptr) { delete _frameEncoder; _frameEncoder = nullptr; }
+		if (_frameDecoder != nullptr) { delete _frameDecoder; _frameDecoder = nullptr; }
 	}
 
-	void LZ4Stream::Init() {
-		if (_compressionMode == CompressionMode::Compress) {
-			if (!_highCompression) {
-				_lz4Stream = LZ4_createStream();
-			}
-			else {
-				_lz4HCStream = LZ4_createStreamHC();
-			}
+	void LZ4Stream::WriteEndStream() {
+		if (_compressionMode == CompressionMode::Compress && _streamMode == LZ4StreamMode::Write) {
+			WriteEndFrameInternal();
 
-			switch (_blockSize) {
-			case LZ4FrameBlockSize::Max64KB:
-				_inputBufferSize = 64 KB;
-				_outputBufferSize = 64 KB;
-				_inputBuffer = gcnew array<byte>(2 * _inputBufferSize);
-				_outputBuffer = gcnew array<byte>(_outputBufferSize);
-				_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				break;
-			case LZ4FrameBlockSize::Max256KB:
-				_inputBufferSize = 256 KB;
-				_outputBufferSize = 256 KB;
-				_inputBuffer = gcnew array<byte>(2 * _inputBufferSize);
-				_outputBuffer = gcnew array<byte>(_outputBufferSize);
-				_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				break;
-			case LZ4FrameBlockSize::Max1MB:
-				_inputBufferSize = 1 MB;
-				_outputBufferSize = 1 MB;
-				_inputBuffer = gcnew array<byte>(2 * _inputBufferSize);
-				_outputBuffer = gcnew array<byte>(_outputBufferSize);
-				_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				break;
-			case LZ4FrameBlockSize::Max4MB:
-				_inputBufferSize = 4 MB;
-				_outputBufferSize = 4 MB;
-				_inputBuffer = gcnew array<byte>(2 * _inputBufferSize);
-				_outputBuffer = gcnew array<byte>(_outputBufferSize);
-				_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				break;
-			default:
-				throw gcnew NotSupportedException(_blockSize.ToString());
+			if (_blockIndex != nullptr) {
+				// the index is the last frame of the stream, the empty frame is written first so the index knows its own offset
+				if (!_hasWrittenInitialStartFrame) { WriteEmptyFrame(); }
+				_blockIndex->RestartInterval = _blockMode == LZ4FrameBlockMode::Linked ? _restartInterval : 0;
+				array<byte>^ index = _blockIndex->ToArray();
+				WriteUserDataFrameInternal(LZ4BLOCKINDEX_FRAME_ID, index, 0, index->Length);
+				_blockIndex = nullptr;
 			}
+		}
+	}
+
+	void LZ4Stream::Reset(Stream^ innerStream) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+		else if (IsDisposed) { throw gcnew ObjectDisposedException("LZ4Stream"); }
+
+		WriteEndStream();
+		if (!_leaveInnerStreamOpen && _innerStream != innerStream) {
+			delete _innerStream;
+		}
+		ResetState(innerStream);
+	}
+
+	void LZ4Stream::Rebind(Stream^ innerStream) {
+		if (IsDisposed) { throw gcnew ObjectDisposedException("LZ4Stream"); }
 
-			if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-				_contentHashState = XXH32_createState();
-				XXH32_reset(_contentHashState, 0);
+		ResetState(innerStream);
+	}
+
+	void LZ4Stream::ResetState(Stream^ innerStream) {
+		_innerStream = innerStream;
+		_frameCount = 0;
+		_blockCount = 0;
+		_position = 0;
+		_contentSize = Nullable<long long>();
+		_outputBufferOffset = 0;
+		_outputBufferBlockSize = 0;
+
+		if (_compressionMode == CompressionMode::Compress) {
+			// the frame that was not completed [LZ4StreamMode::Read] is discarded, the encoder keeps its states and the dictionary
+			native::LZ4FrameInfo info = _frameEncoder->Info();
+			native::LZ4FrameCompressionOptions options = _frameEncoder->Options();
+			info.hasContentSize = false;
+			info.contentSize = 0;
+			options.acceleration = _acceleration;
+			CheckFrameResult(_frameEncoder->Init(&info, &options));
+
+			_isCompressed = false;
+			_hasWrittenStartFrame = false;
+			_hasWrittenInitialStartFrame = false;
+			_inputBufferOffset = 0;
+			_ringbufferOffset = 0;
+			_currentAcceleration = _acceleration;
+			_compressTicks = 0;
+			_writeTicks = 0;
+			_adaptiveBlockCount = 0;
+			_blockIndex = _writeBlockIndex ? gcnew LZ4BlockIndex() : nullptr;
+
+			if (_parallelCompressor != nullptr) {
+				_parallelCompressor->InnerStream = innerStream;
+				_parallelCompressor->BlockIndex = _blockIndex;
+				_parallelCompressor->ResetTicks();
 			}
 		}
 		else {
-			_lz4DecodeStream = LZ4_createStreamDecode();
-			_contentHashState = XXH32_createState();
-			XXH32_reset(_contentHashState, 0);
+			// the blocks and frames that were read ahead are discarded, the decompressors keep their blocks
+			if (_parallelDecompressor != nullptr) { _parallelDecompressor->Reset(); _parallelDecompressor->InnerStream = innerStream; }
+			if (_pipelinedDecompressor != nullptr) { _pipelinedDecompressor->Reset(); _pipelinedDecompressor->InnerStream = innerStream; }
+			if (_frameDecompressor != nullptr) { _frameDecompressor->Reset(); _frameDecompressor->InnerStream = innerStream; }
+			_parallelFrame = false;
+			_pipelinedFrame = false;
+			_concurrentFrames = false;
+			_concurrentFramesDisabled = false;
+			_pendingInput = nullptr;
+			_userData = nullptr;
+			_frameDictionary = nullptr;
+			_frameDecoder->SetExternalBlockDecoding(false);
+			_frameDecoder->Reset();
+			CheckFrameResult(_frameDecoder->SetDictionary(nullptr, 0));
+			_blockIndex = nullptr;
+			_hasReadBlockIndex = false;
+		}
+	}
+
+	void LZ4Stream::CreateFrameInfo(LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, native::LZ4FrameInfo* info) {
+		*info = native::LZ4FrameInfo();
+		switch (blockSize) {
+		case LZ4FrameBlockSize::Max64KB:
+			info->blockSizeId = 4;
+			break;
+		case LZ4FrameBlockSize::Max256KB:
+			info->blockSizeId = 5;
+			break;
+		case LZ4FrameBlockSize::Max1MB:
+			info->blockSizeId = 6;
+			break;
+		case LZ4FrameBlockSize::Max4MB:
+			info->blockSizeId = 7;
+			break;
+		default:
+			throw gcnew NotSupportedException(blockSize.ToString());
+		}
+		info->independentBlocks = blockMode == LZ4FrameBlockMode::Independent;
+		info->blockChecksum = (checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block;
+		info->contentChecksum = (checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content;
+	}
+
+	void LZ4Stream::Init() {
+		if (_compressionMode == CompressionMode::Compress) {
+			native::LZ4FrameInfo info;
+			CreateFrameInfo(_blockMode, _blockSize, _checksumMode, &info);
+
+			native::LZ4FrameCompressionOptions options;
+			options.compressionLevel = _compressionLevel;
+			options.favorDecSpeed = _favorDecSpeed;
+			options.acceleration = _acceleration;
+			options.restartInterval = _restartInterval;
+			options.memoryUsage = _memoryUsage;
+
+			// the hash tables are rented from the pool and returned when the stream is disposed
+			_frameEncoder = _allocations->State(new native::LZ4FrameEncoder(LZ4StatePool::Allocator));
+			CheckFrameResult(_frameEncoder->Init(&info, &options));
+
+			// the input is a ring buffer of two blocks [LZ4FrameBlockMode::Linked], the output holds an encoded block and in read mode also the frame header and end
+			_inputBufferSize = _frameEncoder->BlockSize();
+			_outputBufferSize = LZ4FRAME_COMPRESS_BOUND(_inputBufferSize);
+			_inputBuffer = _allocations->Buffer<byte>(2 * _inputBufferSize);
+			_outputBuffer = _allocations->Buffer<byte>(_outputBufferSize);
+			_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
+			_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
+			_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
+			_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
+		}
+		else {
+			_frameDecoder = _allocations->State(new native::LZ4FrameDecoder());
 		}
 	}
 
@@ -170,7 +248,7 @@ namespace lz4 {
 	}
 
 	bool LZ4Stream::Get_CanSeek() {
-		return false;
+		return GetBlockIndex() != nullptr;
 	}
 
 	bool LZ4Stream::Get_CanWrite() {
@@ -178,15 +256,199 @@ namespace lz4 {
 	}
 
 	long long LZ4Stream::Get_Length() {
-		return -1;
+		LZ4BlockIndex^ index = GetBlockIndex();
+		return index != nullptr ? index->ContentLength : -1;
 	}
 
 	long long LZ4Stream::Get_Position() {
-		return -1;
+		return GetBlockIndex() != nullptr ? _position : -1;
+	}
+
+	Nullable<long long> LZ4Stream::Get_ContentSize() {
+		return _contentSize;
+	}
+
+	void LZ4Stream::Set_ContentSize(Nullable<long long> value) {
+		if (_compressionMode != CompressionMode::Compress) { throw gcnew NotSupportedException("ContentSize"); }
+		else if (value.HasValue && value.Value < 0) { throw gcnew ArgumentOutOfRangeException("value"); }
+		else if (_hasWrittenStartFrame) { throw gcnew InvalidOperationException("ContentSize cannot be changed after data has been written to the current frame"); }
+		else if (value.HasValue && _maxFrameSize.HasValue) { throw gcnew InvalidOperationException("ContentSize cannot be used with maxFrameSize"); }
+
+		CheckFrameResult(_frameEncoder->SetContentSize(value.HasValue, value.HasValue ? (unsigned long long)value.Value : 0));
+		_contentSize = value;
+	}
+
+	void LZ4Stream::Set_Dictionary(LZ4Dictionary^ value) {
+		if (_compressionMode == CompressionMode::Compress) {
+			if (_hasWrittenStartFrame) { throw gcnew InvalidOperationException("Dictionary cannot be changed after data has been written to the current frame"); }
+
+			// prepared once per dictionary, the encoders attach it to every frame or independent block
+			const native::LZ4PreparedDictionary* prepared = value != nullptr ? value->GetPrepared(_compressionLevel, _favorDecSpeed) : nullptr;
+			CheckFrameResult(_frameEncoder->SetPreparedDictionary(prepared));
+			CheckFrameResult(_frameEncoder->SetDictionaryId(value != nullptr && value->Id.HasValue, value != nullptr && value->Id.HasValue ? value->Id.Value : 0));
+			if (_parallelCompressor != nullptr) { _parallelCompressor->SetDictionary(prepared); }
+		}
+		_dictionary = value;
+	}
+
+	void LZ4Stream::AddDictionary(LZ4Dictionary^ dictionary) {
+		if (_compressionMode != CompressionMode::Decompress) { throw gcnew NotSupportedException("Only supported in decompress mode"); }
+		else if (dictionary == nullptr) { throw gcnew ArgumentNullException("dictionary"); }
+		else if (!dictionary->Id.HasValue) { throw gcnew ArgumentException("The dictionary has no id", "dictionary"); }
+
+		if (_dictionaries == nullptr) { _dictionaries = gcnew System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>(); }
+		_dictionaries[dictionary->Id.Value] = dictionary;
+	}
+
+	void LZ4Stream::Set_Acceleration(int value) {
+		if (_compressionMode != CompressionMode::Compress) { throw gcnew NotSupportedException("Acceleration"); }
+		else if (value < 1 || value > LZ4FRAME_ACCELERATION_MAX) { throw gcnew ArgumentOutOfRangeException("value"); }
+		else if (_maxAcceleration.HasValue && value > _maxAcceleration.Value) { throw gcnew ArgumentOutOfRangeException("value", "Acceleration cannot be larger than MaxAcceleration"); }
+
+		_acceleration = value;
+		_currentAcceleration = value;
+	}
+
+	void LZ4Stream::Set_MaxAcceleration(Nullable<int> value) {
+		if (_compressionMode != CompressionMode::Compress) { throw gcnew NotSupportedException("MaxAcceleration"); }
+		else if (value.HasValue && (value.Value < _acceleration || value.Value > LZ4FRAME_ACCELERATION_MAX)) { throw gcnew ArgumentOutOfRangeException("value"); }
+
+		_maxAcceleration = value;
+		_currentAcceleration = value.HasValue ? Math::Min(_currentAcceleration, value.Value) : _acceleration;
+		_compressTicks = 0;
+		_writeTicks = 0;
+		_adaptiveBlockCount = 0;
+	}
+
+	void LZ4Stream::Set_WriteBlockIndex(bool value) {
+		if (!(_compressionMode == CompressionMode::Compress && _streamMode == LZ4StreamMode::Write)) { throw gcnew NotSupportedException("Only supported in compress mode with a write mode stream"); }
+		else if (_hasWrittenInitialStartFrame) { throw gcnew InvalidOperationException("The block index can only be enabled before the first frame is written"); }
+
+		_writeBlockIndex = value;
+		_blockIndex = value ? gcnew LZ4BlockIndex() : nullptr;
+	}
+
+	void LZ4Stream::Set_RestartInterval(int value) {
+		if (_compressionMode != CompressionMode::Compress) { throw gcnew NotSupportedException("RestartInterval"); }
+		else if (value < 0) { throw gcnew ArgumentOutOfRangeException("value"); }
+		else if (_hasWrittenInitialStartFrame) { throw gcnew InvalidOperationException("The restart interval can only be changed before the first frame is written"); }
+
+		CheckFrameResult(_frameEncoder->SetRestartInterval(value));
+		_restartInterval = value;
+	}
+
+	void LZ4Stream::Set_MemoryUsage(int value) {
+		if (_compressionMode != CompressionMode::Compress) { throw gcnew NotSupportedException("MemoryUsage"); }
+		else if (_hasWrittenInitialStartFrame) { throw gcnew InvalidOperationException("The memory usage can only be changed before the first frame is written"); }
+
+		int result = _frameEncoder->SetMemoryUsage(value);
+		if (result == native::LZ4Frame_ErrorInvalidArgument) { throw gcnew ArgumentOutOfRangeException("value"); }
+		CheckFrameResult(result);
+		_memoryUsage = value;
+	}
+
+	LZ4BlockIndex^ LZ4Stream::GetBlockIndex() {
+		if (_compressionMode != CompressionMode::Decompress || _streamMode != LZ4StreamMode::Read) { return nullptr; }
+
+		if (!_hasReadBlockIndex) {
+			// read once, the stream is not seekable when the inner stream is not or when it doesn't end with an index
+			_hasReadBlockIndex = true;
+			_blockIndex = LZ4BlockIndex::Read(_innerStream);
+		}
+		return _blockIndex;
 	}
 
 	long long LZ4Stream::Seek(long long offset, SeekOrigin origin) {
-		throw gcnew NotSupportedException("Seek");
+		LZ4BlockIndex^ index = GetBlockIndex();
+		if (index == nullptr) { throw gcnew NotSupportedException("Seek"); }
+
+		long long position;
+		switch (origin) {
+		case SeekOrigin::Begin:
+			position = offset;
+			break;
+		case SeekOrigin::Current:
+			position = _position + offset;
+			break;
+		case SeekOrigin::End:
+			position = index->ContentLength + offset;
+			break;
+		default:
+			throw gcnew ArgumentOutOfRangeException("origin");
+		}
+		if (position < 0) { throw gcnew ArgumentOutOfRangeException("offset"); }
+
+		SeekContent(position);
+		return _position;
+	}
+
+	void LZ4Stream::SeekFrame(long long offset) {
+		_innerStream->Position = offset;
+
+		// decode the frame header, the inner stream is at the first block header
+		while (true) {
+			int required = _frameDecoder->NextInputSize();
+			if (ReadInnerStream(_headerBuffer, 0, required) != required) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+
+			pin_ptr<byte> bufferPtr = &_headerBuffer[0];
+			int consumed;
+			int frameEvent = _frameDecoder->Decode((const char*)bufferPtr, required, &consumed);
+			if (frameEvent == native::LZ4FrameDecoder_FrameHeader) {
+				OnFrameEvent(frameEvent);
+				return;
+			}
+			else if (frameEvent != native::LZ4FrameDecoder_NeedInput) {
+				CheckFrameResult(frameEvent);
+				throw gcnew Exception("Invalid block index, frame event: " + frameEvent);
+			}
+		}
+	}
+
+	void LZ4Stream::SeekContent(long long position) {
+		LZ4BlockIndex^ index = _blockIndex;
+
+		// the blocks that were read ahead are discarded
+		if (_parallelDecompressor != nullptr) { _parallelDecompressor->Reset(); }
+		if (_pipelinedDecompressor != nullptr) { _pipelinedDecompressor->Reset(); }
+		if (_frameDecompressor != nullptr) { _frameDecompressor->Reset(); }
+		_parallelFrame = false;
+		_pipelinedFrame = false;
+		_concurrentFrames = false;
+		_concurrentFramesDisabled = false;
+		_pendingInput = nullptr;
+		_frameDecoder->SetExternalBlockDecoding(false);
+		_frameDecoder->Reset();
+		_userData = nullptr;
+		_outputBufferOffset = 0;
+		_outputBufferBlockSize = 0;
+		_position = position;
+
+		if (position >= index->ContentLength) {
+			// only the index frame is left
+			_innerStream->Position = index->StreamOffset + index->Position;
+			return;
+		}
+
+		int block = index->FindBlock(position);
+		int first = index->FindFrameStart(block);
+		SeekFrame(index->StreamOffset + index[block].FrameOffset);
+
+		// continue with the block that contains the position, linked blocks reference the blocks before them up to the restart point
+		int restart = _blockMode == LZ4FrameBlockMode::Independent ? block : index->FindRestart(block);
+		if (restart > first) {
+			CheckFrameResult(_frameDecoder->SkipBlocks(restart - first));
+			_innerStream->Position = index->StreamOffset + index[restart].BlockOffset;
+			_blockCount = restart - first;
+		}
+
+		long long skip = position - index[restart].ContentOffset;
+
+		while (skip > 0) {
+			if (!AcquireNextBlock()) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+			int chunk = (int)Math::Min(skip, (long long)_outputBufferBlockSize);
+			_outputBufferOffset = chunk;
+			skip -= chunk;
+		}
 	}
 
 	void LZ4Stream::SetLength(long long value) {
@@ -195,6 +457,7 @@ namespace lz4 {
 
 	void LZ4Stream::Flush() {
 		if (_compressionMode == CompressionMode::Compress && _streamMode == LZ4StreamMode::Write && _inputBufferOffset > 0) { FlushCurrentBlock(false); }
+		if (_parallelCompressor != nullptr) { _parallelCompressor->Drain(); }
 	}
 
 	void LZ4Stream::WriteEndFrame() {
@@ -206,12 +469,14 @@ namespace lz4 {
 	{
 		if (_streamMode == LZ4StreamMode::Read)
 		{
-			Buffer::BlockCopy(buffer, offset, _headerBuffer, _headerBufferSize, count);
-			_headerBufferSize += count;
+			// appended to the pending output of Read()
+			Buffer::BlockCopy(buffer, offset, _outputBuffer, _outputBufferBlockSize, count);
+			_outputBufferBlockSize += count;
 		}
 		else
 		{
 			_innerStream->Write(buffer, offset, count);
+			if (_blockIndex != nullptr) { _blockIndex->Advance(count); }
 		}
 	}
 
@@ -231,35 +496,23 @@ namespace lz4 {
 			FlushCurrentBlock(true);
 		}
 
-		array<byte>^ b = gcnew array<byte>(4);
-
-		// write end mark
-		b[0] = 0;
-		b[1] = 0;
-		b[2] = 0;
-		b[3] = 0; // 0x80
-		WriteHeaderData(b, 0, b->Length);
-
-		if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-			U32 xxh = XXH32_digest(_contentHashState);
-			XXH32_reset(_contentHashState, 0); // reset for next frame
-
-			b[0] = (byte)(xxh & 0xFF);
-			b[1] = (byte)((xxh >> 8) & 0xFF);
-			b[2] = (byte)((xxh >> 16) & 0xFF);
-			b[3] = (byte)((xxh >> 24) & 0xFF);
-			WriteHeaderData(b, 0, b->Length);
+		if (_parallelCompressor != nullptr) {
+			// write the blocks that are still being compressed
+			_parallelCompressor->EndFrame();
 		}
 
-		// reset the stream
-		if (!_highCompression) {
-			LZ4_loadDict(_lz4Stream, nullptr, 0);
-		}
-		else {
-			LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-		}
+		// write end mark and content checksum, resets the encoder for the next frame
+		pin_ptr<byte> headerPtr = &_headerBuffer[0];
+		int size = CheckFrameResult(_frameEncoder->EndFrame(headerPtr, _headerBuffer->Length));
+		WriteHeaderData(_headerBuffer, 0, size);
 
 		_hasWrittenStartFrame = false;
+
+		if (_contentSize.HasValue) {
+			// the content size only applies to a single frame
+			CheckFrameResult(_frameEncoder->SetContentSize(false, 0));
+			_contentSize = Nullable<long long>();
+		}
 	}
 
 	void LZ4Stream::WriteStartFrame() {
@@ -269,71 +522,12 @@ namespace lz4 {
 		_blockCount = 0;
 		//_ringbufferOffset = 0;
 
-		// write magic
-		array<byte>^ magic = gcnew array<byte>(4);
-		magic[0] = 0x04;
-		magic[1] = 0x22;
-		magic[2] = 0x4D;
-		magic[3] = 0x18;
-		WriteHeaderData(magic, 0, magic->Length);
-
-		// frame descriptor
-		array<byte>^ descriptor = gcnew array<byte>(2); // if _storeContentSize +8
-		descriptor[0] = 0;
-		if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-			descriptor[0] |= 0x4;
-		}
-
-		//if (_storeContentSize) {
-		//	descriptor[0] |= 0x8;
-		//}
-
-		if ((_checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block) {
-			descriptor[0] |= 0x10;
-		}
-
-		if (_blockMode == LZ4FrameBlockMode::Independent) {
-			descriptor[0] |= 0x20;
-		}
-
-		descriptor[0] |= 0x40; // version 01
-
-		descriptor[1] = 0;
-		if (_blockSize == LZ4FrameBlockSize::Max64KB) {
-			descriptor[1] |= (4 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max256KB) {
-			descriptor[1] |= (5 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max1MB) {
-			descriptor[1] |= (6 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max4MB) {
-			descriptor[1] |= (7 << 4);
-		}
-		else {
-			throw gcnew NotImplementedException();
-		}
+		if (_blockIndex != nullptr) { _blockIndex->BeginFrame(); }
 
-		//if (_storeContentSize) {
-		//	unsigned long long contentsize = 0; // we cant support this, as the contentsize is not known in advance
-		//	descriptor[2] = (byte)(contentsize & 0xFF);
-		//	descriptor[3] = (byte)((contentsize >> 8) & 0xFF);
-		//	descriptor[4] = (byte)((contentsize >> 16) & 0xFF);
-		//	descriptor[5] = (byte)((contentsize >> 24) & 0xFF);
-		//	descriptor[6] = (byte)((contentsize >> 32) & 0xFF);
-		//	descriptor[7] = (byte)((contentsize >> 40) & 0xFF);
-		//	descriptor[8] = (byte)((contentsize >> 48) & 0xFF);
-		//	descriptor[9] = (byte)((contentsize >> 56) & 0xFF);
-		//}
-
-		pin_ptr<byte> descriptorPtr = &descriptor[0];
-		U32 xxh = XXH32(descriptorPtr, descriptor->Length, 0);
-
-		WriteHeaderData(descriptor, 0, descriptor->Length);
-		array<Byte>^ checksumByte = gcnew array<Byte>(1);
-		checksumByte[0] = (xxh >> 8) & 0xFF;
-		WriteHeaderData(checksumByte, 0, 1);
+		// write magic, frame descriptor and header checksum
+		pin_ptr<byte> headerPtr = &_headerBuffer[0];
+		int size = CheckFrameResult(_frameEncoder->BeginFrame(headerPtr, _headerBuffer->Length));
+		WriteHeaderData(_headerBuffer, 0, size);
 	}
 
 	void LZ4Stream::WriteEmptyFrame() {
@@ -343,47 +537,9 @@ namespace lz4 {
 			throw gcnew InvalidOperationException("should not have happend, hasWrittenStartFrame: " + _hasWrittenStartFrame + ", hasWrittenInitialStartFrame: " + _hasWrittenInitialStartFrame);
 		}
 
-		// write magic
-		array<byte>^ magic = gcnew array<byte>(4);
-		magic[0] = 0x04;
-		magic[1] = 0x22;
-		magic[2] = 0x4D;
-		magic[3] = 0x18;
-		WriteHeaderData(magic, 0, magic->Length);
-
-		// frame descriptor
-		array<byte>^ descriptor = gcnew array<byte>(2);
-		descriptor[0] = 0;
-		if (_blockMode == LZ4FrameBlockMode::Independent) { descriptor[0] |= 0x20; }
-		descriptor[0] |= 0x40; // version 01
-
-		descriptor[1] = 0;
-		if (_blockSize == LZ4FrameBlockSize::Max64KB) {
-			descriptor[1] |= (4 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max256KB) {
-			descriptor[1] |= (5 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max1MB) {
-			descriptor[1] |= (6 << 4);
-		}
-		else if (_blockSize == LZ4FrameBlockSize::Max4MB) {
-			descriptor[1] |= (7 << 4);
-		}
-		else {
-			throw gcnew NotImplementedException();
-		}
-
-		pin_ptr<byte> descriptorPtr = &descriptor[0];
-		U32 xxh = XXH32(descriptorPtr, descriptor->Length, 0);
-
-		WriteHeaderData(descriptor, 0, descriptor->Length);
-		array<Byte>^ checksumByte = gcnew array<Byte>(1);
-		checksumByte[0] = (xxh >> 8) & 0xFF;
-		WriteHeaderData(checksumByte, 0, 1);
-
-		array<byte>^ endMarker = gcnew array<byte>(4);
-		WriteHeaderData(endMarker, 0, endMarker->Length);
+		pin_ptr<byte> headerPtr = &_headerBuffer[0];
+		int size = CheckFrameResult(native::LZ4Frame_writeEmptyFrame(&_frameEncoder->Info(), headerPtr, _headerBuffer->Length));
+		WriteHeaderData(_headerBuffer, 0, size);
 
 		_hasWrittenInitialStartFrame = true;
 		_frameCount++;
@@ -410,24 +566,14 @@ namespace lz4 {
 			WriteEndFrameInternal();
 		}
 
-		// write magic
-		array<byte>^ magic = gcnew array<byte>(4);
-		magic[0] = (0x50 + id);
-		magic[1] = 0x2A;
-		magic[2] = 0x4D;
-		magic[3] = 0x18;
-		_innerStream->Write(magic, 0, magic->Length);
-
-		// write size
-		array<byte>^ b = gcnew array<byte>(4);
-		b[0] = (byte)((unsigned int)count & 0xFF);
-		b[1] = (byte)(((unsigned int)count >> 8) & 0xFF);
-		b[2] = (byte)(((unsigned int)count >> 16) & 0xFF);
-		b[3] = (byte)(((unsigned int)count >> 24) & 0xFF);
-		_innerStream->Write(b, 0, b->Length);
+		// write magic and size
+		pin_ptr<byte> headerPtr = &_headerBuffer[0];
+		int size = CheckFrameResult(native::LZ4Frame_writeSkippableHeader(id, (unsigned int)count, headerPtr, _headerBuffer->Length));
+		_innerStream->Write(_headerBuffer, 0, size);
 
 		// write data
 		_innerStream->Write(buffer, offset, count);
+		if (_blockIndex != nullptr) { _blockIndex->Advance(size + count); }
 
 		_frameCount++;
 	}
@@ -435,100 +581,36 @@ namespace lz4 {
 	void LZ4Stream::FlushCurrentBlock(bool suppressEndFrame) {
 
 		char* inputBufferPtr = &_inputBufferPtr[_ringbufferOffset];
-		char* outputBufferPtr = &_outputBufferPtr[0];
 
 		if (!_hasWrittenStartFrame) {
 			WriteStartFrame();
 		}
 
-		if (_blockMode == LZ4FrameBlockMode::Independent || _blockCount == 0) {
-			// reset the stream { create independently compressed blocks }
-			if (!_highCompression) {
-				LZ4_loadDict(_lz4Stream, nullptr, 0);
-			}
-			else {
-				LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-			}
-		}
-
-		int targetSize;
-		bool isCompressed;
-
-		if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-			XXH_errorcode status = XXH32_update(_contentHashState, inputBufferPtr, _inputBufferOffset);
-			if (status != XXH_errorcode::XXH_OK) {
-				throw gcnew Exception("Failed to update content checksum");
-			}
-		}
-
-		int outputBytes;
-		if (!_highCompression) {
-			outputBytes = LZ4_compress_fast_continue(_lz4Stream, inputBufferPtr, outputBufferPtr, _inputBufferOffset, _outputBufferSize, 1);
-		}
-		else {
-			outputBytes = LZ4_compress_HC_continue(_lz4HCStream, inputBufferPtr, outputBufferPtr, _inputBufferOffset, _outputBufferSize);
+		if (_parallelCompressor == nullptr && _maxDegreeOfParallelism > 1) {
+			_parallelCompressor = gcnew LZ4ParallelBlockCompressor(_innerStream, &_frameEncoder->Info(), &_frameEncoder->Options(), _maxDegreeOfParallelism, _allocations);
+			// the encoder doesn't keep a prepared dictionary for another MemoryUsage, the block encoders load it
+			_parallelCompressor->SetDictionary(_dictionary != nullptr ? _dictionary->GetPrepared(_compressionLevel, _favorDecSpeed) : nullptr);
+			_parallelCompressor->BlockIndex = _blockIndex;
 		}
 
-		if (outputBytes == 0) {
-			// compression failed or output is too large
-
-			// reset the stream
-			//if (!_highCompression) {
-			//	LZ4_loadDict(_lz4Stream, nullptr, 0);
-			//}
-			//else {
-			//	LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-			//}
-
-			Buffer::BlockCopy(_inputBuffer, _ringbufferOffset, _outputBuffer, 0, _inputBufferOffset);
-			targetSize = _inputBufferOffset;
-			isCompressed = false;
-		}
-		else if (outputBytes >= _inputBufferOffset) {
-			// compressed size is bigger than input size
-
-			// reset the stream
-			//if (!_highCompression) {
-			//	LZ4_loadDict(_lz4Stream, nullptr, 0);
-			//}
-			//else {
-			//	LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-			//}
-
-			Buffer::BlockCopy(_inputBuffer, _ringbufferOffset, _outputBuffer, 0, _inputBufferOffset);
-			targetSize = _inputBufferOffset;
-			isCompressed = false;
-		}
-		else if (outputBytes < 0) {
-			throw gcnew Exception("Compress failed");
+		if (_parallelCompressor != nullptr) {
+			// compressed on the thread pool and written in order, linked blocks with the end of the previous block as history
+			CheckFrameResult(_frameEncoder->UpdateContentChecksum(inputBufferPtr, _inputBufferOffset));
+			_parallelCompressor->Acceleration = _currentAcceleration;
+			_parallelCompressor->Enqueue(_inputBuffer, _ringbufferOffset, _inputBufferOffset);
+			// the blocks written since the last block, the ones drained at the end of a frame included
+			// waiting for a block means the workers do not keep up with the inner stream
+			AdaptAcceleration(_parallelCompressor->WaitTicks, _parallelCompressor->WriteTicks);
+			_parallelCompressor->ResetTicks();
 		}
 		else {
-			targetSize = outputBytes;
-			isCompressed = true;
-		}
-
-		array<byte>^ b = gcnew array<byte>(4);
-		b[0] = (byte)((unsigned int)targetSize & 0xFF);
-		b[1] = (byte)(((unsigned int)targetSize >> 8) & 0xFF);
-		b[2] = (byte)(((unsigned int)targetSize >> 16) & 0xFF);
-		b[3] = (byte)(((unsigned int)targetSize >> 24) & 0xFF);
-
-		if (!isCompressed) {
-			b[3] |= 0x80;
-		}
-
-		_innerStream->Write(b, 0, b->Length);
-		_innerStream->Write(_outputBuffer, 0, targetSize);
-
-		if ((_checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block) {
-			void* targetPtr = &_outputBufferPtr[0];
-			U32 xxh = XXH32(targetPtr, targetSize, 0);
-
-			b[0] = (byte)(xxh & 0xFF);
-			b[1] = (byte)((xxh >> 8) & 0xFF);
-			b[2] = (byte)((xxh >> 16) & 0xFF);
-			b[3] = (byte)((xxh >> 24) & 0xFF);
-			_innerStream->Write(b, 0, b->Length);
+			CheckFrameResult(_frameEncoder->SetAcceleration(_currentAcceleration));
+			long long start = Stopwatch::GetTimestamp();
+			int size = CheckFrameResult(_frameEncoder->CompressBlock(inputBufferPtr, _inputBufferOffset, _outputBufferPtr, _outputBufferSize));
+			long long compressed = Stopwatch::GetTimestamp();
+			if (_blockIndex != nullptr) { _blockIndex->AddBlock(_inputBufferOffset, size); }
+			_innerStream->Write(_outputBuffer, 0, size);
+			AdaptAcceleration(compressed - start, Stopwatch::GetTimestamp() - compressed);
 		}
 
 		_inputBufferOffset = 0; // reset before calling WriteEndFrame() !!
@@ -544,306 +626,338 @@ namespace lz4 {
 		if (_ringbufferOffset > _inputBufferSize) _ringbufferOffset = 0;
 	}
 
-	bool LZ4Stream::GetFrameInfo() {
+	void LZ4Stream::AdaptAcceleration(long long compressTicks, long long writeTicks) {
+		if (!_maxAcceleration.HasValue || _compressionLevel != 0) { return; }
 
-		if (_hasFrameInfo) {
-			throw gcnew Exception("should not have happend, _hasFrameInfo: " + _hasFrameInfo);
+		// decide once per 8 blocks, a single slow write should not change the acceleration
+		_compressTicks += compressTicks;
+		_writeTicks += writeTicks;
+		if (++_adaptiveBlockCount < 8) { return; }
+
+		if (_compressTicks > 2 * _writeTicks) {
+			_currentAcceleration = Math::Min(_currentAcceleration * 2, _maxAcceleration.Value);
+		}
+		else if (_writeTicks > 2 * _compressTicks) {
+			_currentAcceleration = Math::Max(_currentAcceleration / 2, _acceleration);
 		}
 
-		array<byte>^ magic = gcnew array<byte>(4);
-		int bytesRead = _innerStream->Read(magic, 0, magic->Length);
-		if (bytesRead == 0) {
-			return false;
+		_compressTicks = 0;
+		_writeTicks = 0;
+		_adaptiveBlockCount = 0;
+	}
+
+	int LZ4Stream::ReadInnerStream(array<byte>^ buffer, int offset, int count) {
+		int total = 0;
+		if (_pendingInput != nullptr) {
+			total = Math::Min(count, _pendingInput->Length - _pendingInputOffset);
+			Buffer::BlockCopy(_pendingInput, _pendingInputOffset, buffer, offset, total);
+			_pendingInputOffset += total;
+			if (_pendingInputOffset == _pendingInput->Length) { _pendingInput = nullptr; }
+		}
+		while (total < count) {
+			int bytesRead = _innerStream->Read(buffer, offset + total, count - total);
+			if (bytesRead == 0) { break; }
+			total += bytesRead;
 		}
-		else if (bytesRead != magic->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+		return total;
+	}
+
+	void LZ4Stream::BeginDecodeFrame() {
+		const native::LZ4FrameInfo& info = _frameDecoder->Info();
 
+		_frameCount++;
 		_blockCount = 0;
-		if (magic[0] == 0x04 && magic[1] == 0x22 && magic[2] == 0x4D && magic[3] == 0x18) {
-			// lz4 frame
-			_frameCount++;
+		_blockSize = (LZ4FrameBlockSize)(info.blockSizeId - 4);
+		_blockMode = info.independentBlocks ? LZ4FrameBlockMode::Independent : LZ4FrameBlockMode::Linked;
+		_checksumMode = LZ4FrameChecksumMode::None;
+		if (info.contentChecksum) { _checksumMode = _checksumMode | LZ4FrameChecksumMode::Content; }
+		if (info.blockChecksum) { _checksumMode = _checksumMode | LZ4FrameChecksumMode::Block; }
+		_contentSize = info.hasContentSize ? Nullable<long long>((long long)info.contentSize) : Nullable<long long>();
+		_outputBufferOffset = 0;
 
-			// reset state
-			XXH32_reset(_contentHashState, 0);
-			_blockSize = LZ4FrameBlockSize::Max64KB;
-			_blockMode = LZ4FrameBlockMode::Linked;
-			_checksumMode = LZ4FrameChecksumMode::None;
-			_contentSize = 0;
-			_outputBufferOffset = 0;
-			_outputBufferBlockSize = 0;
-			//_ringbufferOffset = 0;
+		// kept until the next frame, the decoder references its data
+		_frameDictionary = LZ4Dictionary::Select(info, _dictionary, _dictionaries);
+		CheckFrameResult(_frameDecoder->SetDictionary(_frameDictionary != nullptr ? _frameDictionary->DataPtr : nullptr, _frameDictionary != nullptr ? _frameDictionary->Length : 0));
+		_outputBufferBlockSize = 0;
 
-			// read frame descriptor
-			array<byte>^ descriptor = gcnew array<byte>(2);
-			bytesRead = _innerStream->Read(descriptor, 0, descriptor->Length);
-			if (bytesRead != descriptor->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+		int blockSize = _frameDecoder->BlockSize();
+		int spanBlocks = 1;
+		if (_blockMode == LZ4FrameBlockMode::Linked) {
+			// the spans between the restart points of the block index are independent
+			LZ4BlockIndex^ index = _maxDegreeOfParallelism > 1 ? GetBlockIndex() : nullptr;
+			spanBlocks = index != nullptr ? index->RestartInterval : 0;
+		}
+		// the block decompressors read from the inner stream, not while a part of the frame is pending
+		_parallelFrame = _streamMode == LZ4StreamMode::Read && _maxDegreeOfParallelism > 1 && spanBlocks > 0 && _pendingInput == nullptr;
+		_pipelinedFrame = _streamMode == LZ4StreamMode::Read && _maxDegreeOfParallelism > 1 && !_parallelFrame && !_interactiveRead && _pendingInput == nullptr;
+		_frameDecoder->SetExternalBlockDecoding(_parallelFrame || _pipelinedFrame);
 
-			// verify version
-			if (!((descriptor[0] & 0x40) == 0x40 || (descriptor[0] & 0x60) == 0x60) || (descriptor[0] & 0x80) != 0x00) {
-				throw gcnew Exception("Unexpected frame version");
+		if (_parallelFrame) {
+			if (_parallelDecompressor != nullptr && (_parallelDecompressor->BlockSize != blockSize || _parallelDecompressor->SpanBlocks != spanBlocks)) {
+				delete _parallelDecompressor;
+				_parallelDecompressor = nullptr;
 			}
-			else if ((descriptor[0] & 0x01) != 0x00) {
-				throw gcnew Exception("Predefined dictionaries are not supported");
-			}
-			else if ((descriptor[0] & 0x02) != 0x00) {
-				// reserved value
-				throw gcnew Exception("Header contains unexpected value");
+			if (_parallelDecompressor == nullptr) {
+				_parallelDecompressor = gcnew LZ4ParallelBlockDecompressor(_innerStream, blockSize, spanBlocks, _maxDegreeOfParallelism, _allocations);
 			}
+			_parallelDecompressor->BeginFrame(_frameDecoder);
+			return;
+		}
 
-			if ((descriptor[0] & 0x04) == 0x04) {
-				_checksumMode = _checksumMode | LZ4FrameChecksumMode::Content;
+		if (_pipelinedFrame) {
+			if (_pipelinedDecompressor != nullptr && _pipelinedDecompressor->BlockSize != blockSize) {
+				delete _pipelinedDecompressor;
+				_pipelinedDecompressor = nullptr;
 			}
-			bool hasContentSize = false;
-			if ((descriptor[0] & 0x08) == 0x08) {
-				hasContentSize = true;
+			if (_pipelinedDecompressor == nullptr) {
+				_pipelinedDecompressor = gcnew LZ4PipelinedBlockDecompressor(_innerStream, blockSize, _maxDegreeOfParallelism + 1, _allocations);
 			}
-			if ((descriptor[0] & 0x10) == 0x10) {
-				_checksumMode = _checksumMode | LZ4FrameChecksumMode::Block;
-			}
-			if ((descriptor[0] & 0x20) == 0x20) {
-				_blockMode = LZ4FrameBlockMode::Independent;
+			_pipelinedDecompressor->BeginFrame(_frameDecoder);
+			return;
+		}
+
+		// resize buffers
+		if (_streamMode == LZ4StreamMode::Read && (_inputBuffer == nullptr || _inputBuffer->Length != LZ4FRAME_BLOCK_BOUND(blockSize))) {
+			// block data and block checksum are read in one go
+			if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); _inputBufferPtr = nullptr; }
+			_inputBuffer = _allocations->Buffer<byte>(LZ4FRAME_BLOCK_BOUND(blockSize));
+			_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
+			_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
+		}
+		if (_outputBuffer == nullptr || _outputBuffer->Length != _frameDecoder->OutputBufferSize()) {
+			if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
+			_outputBuffer = _allocations->Buffer<byte>(_frameDecoder->OutputBufferSize());
+			_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
+			_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
+		}
+		_outputBufferSize = _outputBuffer->Length;
+
+		// the blocks are decompressed directly into the output buffer
+		_frameDecoder->SetOutputBuffer(_outputBufferPtr, _outputBufferSize);
+	}
+
+	void LZ4Stream::OnFrameEvent(int frameEvent) {
+		switch (frameEvent) {
+		case native::LZ4FrameDecoder_FrameHeader:
+			BeginDecodeFrame();
+			break;
+		case native::LZ4FrameDecoder_EndMark:
+		case native::LZ4FrameDecoder_FrameEnd:
+			break;
+		case native::LZ4FrameDecoder_SkippableFrame:
+			// the user data is handed to the event handler, so it can't be reused
+			_frameCount++;
+			_userData = _allocations->Buffer<byte>((int)_frameDecoder->SkippableSize());
+			_userDataOffset = 0;
+			break;
+		case native::LZ4FrameDecoder_SkippableFrameEnd: {
+			if (LZ4BlockIndex::IsIndexFrame(_frameDecoder->SkippableId(), _userData)) {
+				// the block index is not user data
+				_userData = nullptr;
+				break;
 			}
+			LZ4UserDataFrameEventArgs^ e = gcnew LZ4UserDataFrameEventArgs(_frameDecoder->SkippableId(), _userData);
+			_userData = nullptr;
+			UserDataFrameRead(this, e);
+			break;
+		}
+		default:
+			CheckFrameResult(frameEvent);
+			throw gcnew Exception("should not have happend, frame event: " + frameEvent);
+		}
+	}
 
-			if ((descriptor[1] & 0x0F) != 0x00) {
-				// reserved value
-				throw gcnew Exception("Header contains unexpected value");
+	bool LZ4Stream::AcquireNextBlock() {
+		while (true) {
+			if (_parallelFrame && AcquireNextParallelBlock()) {
+				return true;
 			}
-			else if ((descriptor[1] & 0x80) != 0x00) {
-				// reserved value
-				throw gcnew Exception("Header contains unexpected value");
+			else if (_pipelinedFrame && AcquireNextPipelinedBlock()) {
+				return true;
 			}
 
-			int blockSizeId = (descriptor[1] & 0x70) >> 4;
-			if (blockSizeId == 4) {
-				_blockSize = LZ4FrameBlockSize::Max64KB;
-				_inputBufferSize = 64 KB;
-				_outputBufferSize = 64 KB;
+			if (!_concurrentFrames && !_concurrentFramesDisabled && _frameCount > 0 && _maxDegreeOfParallelism > 1 && !_interactiveRead && _pendingInput == nullptr && _frameDecoder->IsAtFrameBoundary()) {
+				// the stream continues after its first frame, the frames that follow are decompressed concurrently
+				_concurrentFrames = true;
 			}
-			else if (blockSizeId == 5) {
-				_blockSize = LZ4FrameBlockSize::Max256KB;
-				_inputBufferSize = 256 KB;
-				_outputBufferSize = 256 KB;
+			if (_concurrentFrames) {
+				if (AcquireNextConcurrentFrame()) {
+					return true;
+				}
+				else if (_concurrentFrames) {
+					return false; // end of stream
+				}
+				// the frame is too large, it is decoded from the part that has been read
+				continue;
 			}
-			else if (blockSizeId == 6) {
-				_blockSize = LZ4FrameBlockSize::Max1MB;
-				_inputBufferSize = 1 MB;
-				_outputBufferSize = 1 MB;
+
+			// read exactly the next part of the frame, skippable frame data is read directly into the user data
+			int required = _frameDecoder->NextInputSize();
+			array<byte>^ buffer;
+			int offset = 0;
+			if (_userData != nullptr) {
+				buffer = _userData;
+				offset = _userDataOffset;
 			}
-			else if (blockSizeId == 7) {
-				_blockSize = LZ4FrameBlockSize::Max4MB;
-				_inputBufferSize = 4 MB;
-				_outputBufferSize = 4 MB;
+			else if (required <= _headerBuffer->Length) {
+				buffer = _headerBuffer;
 			}
 			else {
-				throw gcnew Exception("Unsupported block size: " + blockSizeId);
+				buffer = _inputBuffer;
 			}
 
-			if (hasContentSize) {
-				byte tmp1 = descriptor[0], tmp2 = descriptor[1];
-				descriptor = gcnew array<byte>(2 + 8);
-				descriptor[0] = tmp1;
-				descriptor[1] = tmp2;
-				bytesRead = _innerStream->Read(descriptor, 2, 8);
-				if (bytesRead != 8) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-				_contentSize = 0;
-				for (int i = 2, ii = 0; i < descriptor->Length; i++, ii++) {
-					_contentSize |= ((unsigned long long)descriptor[i] << (ii * 8));
-				}
+			int bytesRead = ReadInnerStream(buffer, offset, required);
+			if (bytesRead == 0 && required > 0 && _frameDecoder->IsAtFrameBoundary()) {
+				return false; // end of stream
 			}
+			else if (bytesRead != required) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
 
-			// read checksum
-			array<byte>^ checksum = gcnew array<byte>(1);
-			bytesRead = _innerStream->Read(checksum, 0, checksum->Length);
-			if (bytesRead != checksum->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-			// verify checksum
-			pin_ptr<byte> descriptorPtr = &descriptor[0];
-			U32 xxh = XXH32(descriptorPtr, descriptor->Length, 0);
-			byte checksumByte = (xxh >> 8) & 0xFF;
-			if (checksum[0] != checksumByte) {
-				throw gcnew Exception("Frame checksum is invalid");
-			}
+			pin_ptr<byte> bufferPtr = nullptr;
+			if (required > 0) { bufferPtr = &buffer[offset]; }
+			const char* src = (const char*)bufferPtr;
+			int position = 0;
+			bool hasBlock = false;
+			while (true) {
+				int consumed;
+				int frameEvent = _frameDecoder->Decode(src + position, required - position, &consumed);
+				position += consumed;
 
-			// resize buffers
-			if (_inputBuffer == nullptr || _inputBuffer->Length != _inputBufferSize) {
-				if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); _inputBufferPtr = nullptr; }
-				_inputBuffer = gcnew array<byte>(_inputBufferSize);
-				_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-				_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-			}
-			if (_outputBuffer == nullptr || _outputBuffer->Length != 2 * _outputBufferSize) {
-				if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
-				_outputBuffer = gcnew array<byte>(2 * _outputBufferSize);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
+				if (frameEvent == native::LZ4FrameDecoder_NeedInput) {
+					break;
+				}
+				else if (frameEvent == native::LZ4FrameDecoder_Block) {
+					_blockCount++;
+					_readBuffer = _outputBuffer;
+					_readBufferOffset = _frameDecoder->OutputOffset();
+					_outputBufferBlockSize = _frameDecoder->OutputSize();
+					_outputBufferOffset = 0;
+					hasBlock = true;
+				}
+				else if (frameEvent == native::LZ4FrameDecoder_SkippableData) {
+					_userDataOffset += _frameDecoder->OutputSize();
+				}
+				else {
+					OnFrameEvent(frameEvent);
+				}
 			}
 
-			_hasFrameInfo = true;
-			return true;
-		}
-		else if (magic[0] >= 0x50 && magic[0] <= 0x5f && magic[1] == 0x2A && magic[2] == 0x4D && magic[3] == 0x18) {
-			// skippable frame
-			_frameCount++;
-
-			// read frame size
-			array<byte>^ b = gcnew array<byte>(4);
-			bytesRead = _innerStream->Read(b, 0, b->Length);
-			if (bytesRead != b->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-			unsigned int frameSize = 0;
-			for (int i = 0, ii = 0; i < b->Length; i++, ii++) {
-				frameSize |= ((unsigned int)b[i] << (ii * 8));
+			if (hasBlock) {
+				return true;
 			}
-
-			array<byte>^ userData = gcnew array<byte>(frameSize);
-			bytesRead = _innerStream->Read(userData, 0, userData->Length);
-			if (bytesRead != userData->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-			int id = (magic[0] & 0xF);
-
-			LZ4UserDataFrameEventArgs^ e = gcnew LZ4UserDataFrameEventArgs(id, userData);
-			UserDataFrameRead(this, e);
-
-			// read next frame header
-			return GetFrameInfo();
-		}
-		else {
-			throw gcnew Exception("lz4 stream is corrupt");
 		}
 	}
 
-	bool LZ4Stream::AcquireNextBlock() {
-		if (!_hasFrameInfo) {
-			if (!GetFrameInfo()) {
-				return false;
+	bool LZ4Stream::AcquireNextParallelBlock() {
+		if (!_parallelDecompressor->EndOfFrame) {
+			int maxBlocks = Int32::MaxValue;
+			if (_interactiveRead) {
+				// only read the blocks that are needed from the inner stream
+				maxBlocks = _parallelDecompressor->PendingBlocks > 0 ? 0 : 1;
 			}
+			_parallelDecompressor->ReadAhead(maxBlocks);
 		}
 
-		array<byte>^ b = gcnew array<byte>(4);
-
-		// read block size
-		int bytesRead = _innerStream->Read(b, 0, b->Length);
-		if (bytesRead != b->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-		bool isCompressed = true;
-		if ((b[3] & 0x80) == 0x80) {
-			isCompressed = false;
-			b[3] &= 0x7F;
+		if (_parallelDecompressor->PendingBlocks == 0) {
+			// end marker, the frame decoder continues with the content checksum
+			_parallelFrame = false;
+			_frameDecoder->SetExternalBlockDecoding(false);
+			return false;
 		}
 
-		unsigned int blockSize = 0;
-		for (int i = 0, ii = 0; i < b->Length; i++, ii++) {
-			blockSize |= ((unsigned int)b[i] << (ii * 8));
-		}
+		LZ4ParallelBlock^ block = _parallelDecompressor->NextBlock();
+		_blockCount += block->_spanBlocks;
 
-		if (blockSize > (unsigned int)_outputBufferSize) {
-			throw gcnew Exception("Block size exceeds maximum block size");
-		}
+		CheckFrameResult(_frameDecoder->UpdateContentChecksum(block->DataPtr, block->_targetSize));
 
-		if (blockSize == 0) {
-			// end marker
-
-			//_outputBufferSize = 0;
-			//_outputBufferOffset = 0;
-			//_outputBufferBlockSize = 0;
-			//_inputBufferSize = 0;
-			//_inputBufferOffset = 0;
-			_hasFrameInfo = false;
-
-			if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-				// calculate hash
-				U32 xxh = XXH32_digest(_contentHashState);
-
-				// read hash
-				b = gcnew array<byte>(4);
-				bytesRead = _innerStream->Read(b, 0, b->Length);
-				if (bytesRead != b->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-				if (b[0] != (byte)(xxh & 0xFF) ||
-					b[1] != (byte)((xxh >> 8) & 0xFF) ||
-					b[2] != (byte)((xxh >> 16) & 0xFF) ||
-					b[3] != (byte)((xxh >> 24) & 0xFF)) {
-					throw gcnew Exception("Content checksum did not match");
-				}
-			}
-
-			return AcquireNextBlock();
-		}
-
-		// read block data
-		bytesRead = _innerStream->Read(_inputBuffer, 0, blockSize);
-		if (bytesRead != blockSize) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
-
-		_blockCount++;
+		_readBuffer = block->Data;
+		_readBufferOffset = 0;
+		_outputBufferBlockSize = block->_targetSize;
+		_outputBufferOffset = 0;
 
-		if ((_checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block) {
-			// read block checksum
-			b = gcnew array<byte>(4);
-			bytesRead = _innerStream->Read(b, 0, b->Length);
-			if (bytesRead != b->Length) { throw gcnew EndOfStreamException("Unexpected end of stream"); }
+		return true;
+	}
 
-			unsigned int checksum = 0;
-			for (int i = b->Length - 1; i >= 0; i--) {
-				checksum |= ((unsigned int)b[i] << (i * 8));
-			}
-			// verify checksum
-			void* targetPtr = &_inputBufferPtr[0];
-			U32 xxh = XXH32(targetPtr, blockSize, 0);
-			if (checksum != xxh) {
-				throw gcnew Exception("Block checksum did not match");
-			}
+	bool LZ4Stream::AcquireNextPipelinedBlock() {
+		// the content checksum is updated by the pipeline
+		LZ4ParallelBlock^ block = _pipelinedDecompressor->NextBlock();
+		if (block == nullptr) {
+			// end marker, the frame decoder continues with the content checksum
+			_pipelinedFrame = false;
+			_frameDecoder->SetExternalBlockDecoding(false);
+			return false;
 		}
+		_blockCount++;
 
-		int currentRingbufferOffset = _ringbufferOffset;
+		_readBuffer = block->Data;
+		_readBufferOffset = 0;
+		_outputBufferBlockSize = block->_targetSize;
+		_outputBufferOffset = 0;
 
-		// preserve previously compressed block data (for LZ4_decompress_safe_continue dictionary [LZ4FrameBlockMode::Linked])
-		// update ringbuffer offset
-		_ringbufferOffset += _outputBufferSize;
-		// wraparound the ringbuffer offset
-		if (_ringbufferOffset > _outputBufferSize) _ringbufferOffset = 0;
+		return true;
+	}
 
-		if (!isCompressed) {
-			Buffer::BlockCopy(_inputBuffer, 0, _outputBuffer, _ringbufferOffset, blockSize);
-			_outputBufferBlockSize = blockSize;
+	bool LZ4Stream::AcquireNextConcurrentFrame() {
+		if (_frameDecompressor == nullptr) {
+			_frameDecompressor = gcnew LZ4ParallelFrameDecompressor(_innerStream, LZ4STREAM_PARALLEL_FRAME_SIZE_MAX, _maxDegreeOfParallelism, _allocations);
 		}
-		else {
-			char* inputPtr = &_inputBufferPtr[0];
-			char* outputPtr = &_outputBufferPtr[_ringbufferOffset];
-			char* dict = &_outputBufferPtr[currentRingbufferOffset];
-			int status;
-			if (_blockCount > 1) {
-				status = LZ4_setStreamDecode(_lz4DecodeStream, dict, _outputBufferSize);
-			}
-			else {
-				status = LZ4_setStreamDecode(_lz4DecodeStream, nullptr, 0);
+
+		while (true) {
+			if (!_frameDecompressor->EndOfStream) {
+				_frameDecompressor->ReadAhead(_frameDecoder, Int32::MaxValue, _dictionary, _dictionaries);
 			}
-			if (status != 1) {
-				throw gcnew Exception("LZ4_setStreamDecode failed");
+			if (_frameDecompressor->PendingFrames == 0) {
+				return false;
 			}
-			int decompressedSize = LZ4_decompress_safe_continue(_lz4DecodeStream, inputPtr, outputPtr, blockSize, _outputBufferSize);
-			if (decompressedSize <= 0) {
-				throw gcnew Exception("Decompress failed");
+
+			LZ4ParallelFrame^ frame = _frameDecompressor->NextFrame();
+			if (frame->_incomplete) {
+				// the frame decoder starts again with the frame header, the rest of the stream is decoded frame by frame
+				_pendingInput = _allocations->Buffer<byte>(frame->_inputSize);
+				Buffer::BlockCopy(frame->_inputBuffer, 0, _pendingInput, 0, frame->_inputSize);
+				_pendingInputOffset = 0;
+				_frameDecoder->Reset();
+				_frameDecoder->SetExternalBlockDecoding(false);
+				_concurrentFrames = false;
+				_concurrentFramesDisabled = true;
+				return false;
 			}
-			_outputBufferBlockSize = decompressedSize;
-		}
 
-		if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-			void* contentPtr = &_outputBufferPtr[_ringbufferOffset];
-			XXH_errorcode status = XXH32_update(_contentHashState, contentPtr, _outputBufferBlockSize);
-			if (status != XXH_errorcode::XXH_OK) {
-				throw gcnew Exception("Failed to update content checksum");
+			_frameCount++;
+			if (frame->_skippable) {
+				// the block index is not user data
+				if (!LZ4BlockIndex::IsIndexFrame(frame->_skippableId, frame->_userData)) {
+					UserDataFrameRead(this, gcnew LZ4UserDataFrameEventArgs(frame->_skippableId, frame->_userData));
+				}
+				continue;
 			}
-		}
 
-		_outputBufferOffset = 0;
+			_blockCount = frame->_blockCount;
+			_contentSize = frame->_contentSize;
+			if (frame->_targetSize == 0) {
+				continue;
+			}
 
-		return true;
+			_readBuffer = frame->_outputBuffer;
+			_readBufferOffset = 0;
+			_outputBufferBlockSize = frame->_targetSize;
+			_outputBufferOffset = 0;
+			return true;
+		}
 	}
 
-	void LZ4Stream::CompressNextBlock() {
+	bool LZ4Stream::CompressNextBlock() {
 
 		// write at least one start frame
 		//if (!_hasWrittenInitialStartFrame) { WriteStartFrame(); }
 
+		_outputBufferOffset = 0;
+		_outputBufferBlockSize = 0;
+
+		if (_isCompressed) {
+			// end of the inner stream, the last frame has been completed
+			return false;
+		}
+
 		int chunk = _inputBufferSize - _inputBufferOffset;
 		if (chunk == 0) { throw gcnew Exception("should not have happend, Read(): compress, chunk == 0"); }
 
@@ -864,196 +978,57 @@ namespace lz4 {
 			}
 		} while (chunk > 0);
 
-		if (_inputBufferOffset == 0) {
-			return;
-		}
-
-		_headerBufferSize = 0;
-		_outputBufferOffset = 0;
-
-		char* inputBufferPtr = &_inputBufferPtr[_ringbufferOffset];
-		char* outputBufferPtr = &_outputBufferPtr[0];
-
-		if (!_hasWrittenStartFrame) {
-			WriteStartFrame();
-		}
-
-		if (_blockMode == LZ4FrameBlockMode::Independent || _blockCount == 0) {
-			// reset the stream { create independently compressed blocks }
-			if (!_highCompression) {
-				LZ4_loadDict(_lz4Stream, nullptr, 0);
-			}
-			else {
-				LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
+		if (_inputBufferOffset > 0) {
+			// the frame header, the block and the frame end are collected in the output buffer
+			if (!_hasWrittenStartFrame) {
+				WriteStartFrame();
 			}
-		}
 
-		int targetSize;
-		bool isCompressed;
+			char* inputBufferPtr = &_inputBufferPtr[_ringbufferOffset];
+			CheckFrameResult(_frameEncoder->SetAcceleration(_currentAcceleration));
+			int size = CheckFrameResult(_frameEncoder->CompressBlock(inputBufferPtr, _inputBufferOffset, &_outputBufferPtr[_outputBufferBlockSize], _outputBufferSize - _outputBufferBlockSize));
+			_outputBufferBlockSize += size;
 
-		if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-			XXH_errorcode status = XXH32_update(_contentHashState, inputBufferPtr, _inputBufferOffset);
-			if (status != XXH_errorcode::XXH_OK) {
-				throw gcnew Exception("Failed to update content checksum");
+			_inputBufferOffset = 0; // reset before calling WriteEndFrame() !!
+			_blockCount++;
+
+			if (_maxFrameSize.HasValue && _blockCount >= _maxFrameSize.Value) {
+				WriteEndFrameInternal();
 			}
-		}
 
-		int outputBytes;
-		if (!_highCompression) {
-			outputBytes = LZ4_compress_fast_continue(_lz4Stream, inputBufferPtr, outputBufferPtr, _inputBufferOffset, _outputBufferSize, 1);
-		}
-		else {
-			outputBytes = LZ4_compress_HC_continue(_lz4HCStream, inputBufferPtr, outputBufferPtr, _inputBufferOffset, _outputBufferSize);
-		}
-		if (outputBytes == 0) {
-			// compression failed or output is too large
-
-			// reset the stream
-			//if (!_highCompression) {
-			//	LZ4_loadDict(_lz4Stream, nullptr, 0);
-			//}
-			//else {
-			//	LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-			//}
-
-			Buffer::BlockCopy(_inputBuffer, _ringbufferOffset, _outputBuffer, 0, _inputBufferOffset);
-			targetSize = _inputBufferOffset;
-			isCompressed = false;
-		}
-		else if (outputBytes >= _inputBufferOffset) {
-			// compressed size is bigger than input size
-
-			// reset the stream
-			//if (!_highCompression) {
-			//	LZ4_loadDict(_lz4Stream, nullptr, 0);
-			//}
-			//else {
-			//	LZ4_loadDictHC(_lz4HCStream, nullptr, 0);
-			//}
-
-			Buffer::BlockCopy(_inputBuffer, _ringbufferOffset, _outputBuffer, 0, _inputBufferOffset);
-			targetSize = _inputBufferOffset;
-			isCompressed = false;
-		}
-		else if (outputBytes < 0) {
-			throw gcnew Exception("Compress failed");
-		}
-		else {
-			targetSize = outputBytes;
-			isCompressed = true;
+			// update ringbuffer offset
+			_ringbufferOffset += _inputBufferSize;
+			// wraparound the ringbuffer offset
+			if (_ringbufferOffset > _inputBufferSize) _ringbufferOffset = 0;
 		}
 
-		array<byte>^ b = gcnew array<byte>(4);
-		_headerBuffer[_headerBufferSize++] = (byte)((unsigned int)targetSize & 0xFF);
-		_headerBuffer[_headerBufferSize++] = (byte)(((unsigned int)targetSize >> 8) & 0xFF);
-		_headerBuffer[_headerBufferSize++] = (byte)(((unsigned int)targetSize >> 16) & 0xFF);
-		_headerBuffer[_headerBufferSize++] = (byte)(((unsigned int)targetSize >> 24) & 0xFF);
-
-		if (!isCompressed) {
-			_headerBuffer[_headerBufferSize - 1] |= 0x80;
+		if (_isCompressed) {
+			WriteEndFrameInternal();
 		}
 
-		_outputBufferBlockSize = targetSize;
-		_currentMode = 1;
+		return _outputBufferBlockSize > 0;
 	}
 
 	int LZ4Stream::CompressData(array<Byte>^ buffer, int offset, int count)
 	{
-		// _currentMode == 0 -> frame start
-		// _currentMode == 1 -> copy header data
-		// _currentMode == 2 -> block data
-		// _currentMode == 3 -> copy header data after block
-
-		int consumed = 0, total = 0;
-		do {
-			offset += consumed;
-			count -= consumed;
-			consumed = 0;
-
-			if (_currentMode == 0)
-			{
-				if (!_isCompressed) {
-					CompressNextBlock();
-				}
-				else if (_hasWrittenStartFrame) {
-					WriteEndFrameInternal();
-					_currentMode = 4;
-				}
-				else {
-					return total;
-				}
-			}
-			else if (_currentMode == 1)
-			{
-				if (_headerBufferSize == 0) { throw gcnew Exception("should not have happend, Read(): compress, _headerBufferSize == 0"); }
-				int chunk = consumed = Math::Min(_headerBufferSize - _outputBufferOffset, count);
-				Buffer::BlockCopy(_headerBuffer, _outputBufferOffset, buffer, offset, chunk);
-				_outputBufferOffset += chunk;
-				if (_outputBufferOffset == _headerBufferSize) {
-					_outputBufferOffset = 0;
-					_currentMode = 2;
-				}
-			}
-			else if (_currentMode == 2)
-			{
-				if (_outputBufferBlockSize == 0) { throw gcnew Exception("should not have happend, Read(): compress, _outputBufferBlockSize == 0"); }
-				int chunk = consumed = Math::Min(_outputBufferBlockSize - _outputBufferOffset, count);
-				Buffer::BlockCopy(_outputBuffer, _outputBufferOffset, buffer, offset, chunk);
-				_outputBufferOffset += chunk;
-				if (_outputBufferOffset == _outputBufferBlockSize) {
-					_inputBufferOffset = 0; // reset before calling WriteEndFrame() !!
-					_blockCount++;
-					_currentMode = 3;
-				}
+		int total = 0;
+		while (count > 0)
+		{
+			if (_outputBufferOffset == _outputBufferBlockSize && !CompressNextBlock()) {
+				break;
 			}
-			else if (_currentMode == 3)
-			{
-				_currentMode = 0;
-
-				_headerBufferSize = 0;
-				_outputBufferOffset = 0;
 
-				if ((_checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block) {
+			int chunk = Math::Min(count, _outputBufferBlockSize - _outputBufferOffset);
+			Buffer::BlockCopy(_outputBuffer, _outputBufferOffset, buffer, offset, chunk);
 
-					void* targetPtr = &_outputBufferPtr[0];
-					U32 xxh = XXH32(targetPtr, _outputBufferBlockSize, 0);
-
-					_headerBuffer[_headerBufferSize++] = (byte)(xxh & 0xFF);
-					_headerBuffer[_headerBufferSize++] = (byte)((xxh >> 8) & 0xFF);
-					_headerBuffer[_headerBufferSize++] = (byte)((xxh >> 16) & 0xFF);
-					_headerBuffer[_headerBufferSize++] = (byte)((xxh >> 24) & 0xFF);
-					_currentMode = 4;
-				}
-
-				if (_maxFrameSize.HasValue && _blockCount >= _maxFrameSize.Value) {
-					WriteEndFrameInternal();
-					_currentMode = 4;
-				}
-
-				// update ringbuffer offset
-				_ringbufferOffset += _inputBufferSize;
-				// wraparound the ringbuffer offset
-				if (_ringbufferOffset > _inputBufferSize) _ringbufferOffset = 0;
-			}
-			else if (_currentMode == 4)
-			{
-				if (_headerBufferSize == 0) { throw gcnew Exception("should not have happend, Read(): compress, _headerBufferSize == 0"); }
-				int chunk = consumed = Math::Min(_headerBufferSize - _outputBufferOffset, count);
-				Buffer::BlockCopy(_headerBuffer, _outputBufferOffset, buffer, offset, chunk);
-				_outputBufferOffset += chunk;
-				if (_outputBufferOffset == _headerBufferSize) {
-					_outputBufferOffset = 0;
-					_headerBufferSize = 0;
-					_currentMode = 0;
-				}
-			}
-			else {
-				throw gcnew Exception("should not have happend, Read(): compress, _currentmode == " + _currentMode);
+			_outputBufferOffset += chunk;
+			offset += chunk;
+			count -= chunk;
+			total += chunk;
+			if (_interactiveRead) {
+				break;
 			}
-
-			total += consumed;
-		} while (!_interactiveRead && consumed < count);
-
+		}
 		return total;
 	}
 
@@ -1064,15 +1039,14 @@ namespace lz4 {
 			if (_outputBufferOffset >= _outputBufferBlockSize && !AcquireNextBlock()) {
 				return -1; // end of stream
 			}
-			return _outputBuffer[_ringbufferOffset + _outputBufferOffset++];
+			_position++;
+			return _readBuffer[_readBufferOffset + _outputBufferOffset++];
 		}
 		else {
-			array<Byte>^ data = gcnew array<Byte>(1);
-			int x = CompressData(data, 0, 1);
-			if (x == 0) {
+			if (_outputBufferOffset >= _outputBufferBlockSize && !CompressNextBlock()) {
 				return -1; // stream end
 			}
-			return data[0];
+			return _outputBuffer[_outputBufferOffset++];
 		}
 	}
 
@@ -1090,12 +1064,13 @@ namespace lz4 {
 				int chunk = Math::Min(count, _outputBufferBlockSize - _outputBufferOffset);
 				if (chunk > 0)
 				{
-					Buffer::BlockCopy(_outputBuffer, _ringbufferOffset + _outputBufferOffset, buffer, offset, chunk);
+					Buffer::BlockCopy(_readBuffer, _readBufferOffset + _outputBufferOffset, buffer, offset, chunk);
 
 					_outputBufferOffset += chunk;
 					offset += chunk;
 					count -= chunk;
 					total += chunk;
+					_position += chunk;
 					if (_interactiveRead) {
 						break;
 					}
@@ -1128,9 +1103,7 @@ namespace lz4 {
 		}
 		else
 		{
-			array<Byte>^ b = gcnew array<Byte>(1);
-			b[0] = value;
-			DecompressData(b, 0, 1);
+			DecompressData((const char*)&value, 1);
 		}
 	}
 
@@ -1166,420 +1139,34 @@ namespace lz4 {
 		}
 		else
 		{
-			DecompressData(buffer, offset, count);
+			pin_ptr<byte> bufferPtr = &buffer[offset];
+			DecompressData((const char*)bufferPtr, count);
 		}
 	}
 
-	void LZ4Stream::DecompressData(array<Byte>^ data, int offset, int count)
+	void LZ4Stream::DecompressData(const char* data, int count)
 	{
-		int consumed = 0;
-		do {
-			offset += consumed;
-			count -= consumed;
-			consumed = 0;
-
-			if (_currentMode >= 0 && _currentMode <= 4) {
-				consumed = DecompressHeader(data, offset, count);
-			}
-			else if (_currentMode == 5) {
-				// user data frame
-				int l = _outputBuffer->Length;
-				int remaining = l - _outputBufferOffset;
-				int chunk = consumed = Math::Min(remaining, count);
-				Buffer::BlockCopy(data, offset, _outputBuffer, _outputBufferOffset, chunk);
-				_outputBufferOffset += chunk;
-				remaining = l - _outputBufferOffset;
-				if (remaining == 0) {
-					int id = (_headerBuffer[0] & 0xF);
-
-					array<Byte>^ userData = gcnew array<Byte>(l);
-					Buffer::BlockCopy(_outputBuffer, 0, userData, 0, l);
-					LZ4UserDataFrameEventArgs^ e = gcnew LZ4UserDataFrameEventArgs(id, userData);
-					UserDataFrameRead(this, e);
-
-					_headerBufferSize = 0;
-					_currentMode = 0;
-				}
-			}
-			else if (_currentMode >= 6 && _currentMode <= 10) {
-				// lz4 frame
-				consumed = DecompressBlock(data, offset, count);
-			}
-			else {
-				throw gcnew Exception("should not have happend, Write(): decompress, _currentmode == " + _currentMode);
-			}
-		} while (consumed < count);
-	}
-
-	int LZ4Stream::DecompressBlock(array<Byte>^ data, int offset, int count)
-	{
-		int consumed = 0;
-		if (_currentMode == 6) {
-			for (int i = _headerBufferSize, ii = 0; i < 4 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 4) {
-
-				_isCompressed = true;
-				if ((_headerBuffer[3] & 0x80) == 0x80) {
-					_isCompressed = false;
-					_headerBuffer[3] &= 0x7F;
-				}
-
-				unsigned int blockSize = 0;
-				for (int i = 0, ii = 0; i < 4; i++, ii++) {
-					blockSize |= ((unsigned int)_headerBuffer[i] << (ii * 8));
-				}
-
-				if (blockSize > (unsigned int)_outputBufferSize) {
-					throw gcnew Exception("Block size exceeds maximum block size");
-				}
-
-				if (blockSize == 0) {
-					// end marker
+		int position = 0;
+		while (true) {
+			int consumed;
+			int frameEvent = _frameDecoder->Decode(data + position, count - position, &consumed);
+			position += consumed;
 
-					if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-						_headerBufferSize = 0;
-						_currentMode = 7;
-					}
-					else {
-						_headerBufferSize = 0;
-						_currentMode = 0;
-					}
-					return consumed;
-				}
-
-				_targetBufferSize = blockSize;
-				_inputBufferOffset = 0;
-				_currentMode = 8;
-			}
-		}
-		else if (_currentMode == 7) {
-			for (int i = _headerBufferSize, ii = 0; i < 4 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 4) {
-
-				// calculate hash
-				U32 xxh = XXH32_digest(_contentHashState);
-
-				if (_headerBuffer[0] != (byte)(xxh & 0xFF) ||
-					_headerBuffer[1] != (byte)((xxh >> 8) & 0xFF) ||
-					_headerBuffer[2] != (byte)((xxh >> 16) & 0xFF) ||
-					_headerBuffer[3] != (byte)((xxh >> 24) & 0xFF)) {
-					throw gcnew Exception("Content checksum did not match");
-				}
-
-				_headerBufferSize = 0;
-				_currentMode = 0;
+			if (frameEvent == native::LZ4FrameDecoder_NeedInput) {
+				break;
 			}
-		}
-		else if (_currentMode == 8) {
-
-			int remaining = _targetBufferSize - _inputBufferOffset;
-
-			int chunk = consumed = Math::Min(remaining, count);
-			Buffer::BlockCopy(data, offset, _inputBuffer, _inputBufferOffset, chunk);
-			_inputBufferOffset += chunk;
-			remaining = _targetBufferSize - _inputBufferOffset;
-			if (remaining == 0) {
-
+			else if (frameEvent == native::LZ4FrameDecoder_Block) {
 				_blockCount++;
-
-				if ((_checksumMode & LZ4FrameChecksumMode::Block) == LZ4FrameChecksumMode::Block) {
-					_headerBufferSize = 0;
-					_currentMode = 9;
-				}
-				else {
-					_currentMode = 10;
-				}
+				_innerStream->Write(_outputBuffer, _frameDecoder->OutputOffset(), _frameDecoder->OutputSize());
 			}
-		}
-		else if (_currentMode == 9) {
-			// block checksum
-			for (int i = _headerBufferSize, ii = 0; i < 4 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 4) {
-				unsigned int checksum = 0;
-				for (int i = 3; i >= 0; i--) {
-					checksum |= ((unsigned int)_headerBuffer[i] << (i * 8));
-				}
-				// verify checksum
-				void* targetPtr = &_inputBufferPtr[0];
-				U32 xxh = XXH32(targetPtr, _targetBufferSize, 0);
-				if (checksum != xxh) {
-					throw gcnew Exception("Block checksum did not match");
-				}
-
-				_currentMode = 10;
-			}
-		}
-		else if (_currentMode == 10) {
-			int currentRingbufferOffset = _ringbufferOffset;
-
-			// preserve previously compressed block data (for LZ4_decompress_safe_continue dictionary [LZ4FrameBlockMode::Linked])
-			// update ringbuffer offset
-			_ringbufferOffset += _outputBufferSize;
-			// wraparound the ringbuffer offset
-			if (_ringbufferOffset > _outputBufferSize) _ringbufferOffset = 0;
-
-			if (!_isCompressed) {
-				Buffer::BlockCopy(_inputBuffer, 0, _outputBuffer, _ringbufferOffset, _targetBufferSize);
-				_outputBufferBlockSize = _targetBufferSize;
+			else if (frameEvent == native::LZ4FrameDecoder_SkippableData) {
+				int chunk = _frameDecoder->OutputSize();
+				Marshal::Copy(IntPtr((void*)_frameDecoder->Output()), _userData, _userDataOffset, chunk);
+				_userDataOffset += chunk;
 			}
 			else {
-				char* inputPtr = &_inputBufferPtr[0];
-				char* outputPtr = &_outputBufferPtr[_ringbufferOffset];
-				char* dict = &_outputBufferPtr[currentRingbufferOffset];
-				int status;
-				if (_blockCount > 1) {
-					status = LZ4_setStreamDecode(_lz4DecodeStream, dict, _outputBufferSize);
-				}
-				else {
-					status = LZ4_setStreamDecode(_lz4DecodeStream, nullptr, 0);
-				}
-				if (status != 1) {
-					throw gcnew Exception("LZ4_setStreamDecode failed");
-				}
-				int decompressedSize = LZ4_decompress_safe_continue(_lz4DecodeStream, inputPtr, outputPtr, _targetBufferSize, _outputBufferSize);
-				if (decompressedSize <= 0) {
-					throw gcnew Exception("Decompress failed");
-				}
-				_outputBufferBlockSize = decompressedSize;
-			}
-
-			_innerStream->Write(_outputBuffer, _ringbufferOffset, _outputBufferBlockSize);
-
-			if ((_checksumMode & LZ4FrameChecksumMode::Content) == LZ4FrameChecksumMode::Content) {
-				void* contentPtr = &_outputBufferPtr[_ringbufferOffset];
-				XXH_errorcode status = XXH32_update(_contentHashState, contentPtr, _outputBufferBlockSize);
-				if (status != XXH_errorcode::XXH_OK) {
-					throw gcnew Exception("Failed to update content checksum");
-				}
-			}
-
-			_headerBufferSize = 0;
-			_outputBufferOffset = 0;
-			_currentMode = 6;
-		}
-		else {
-			throw gcnew Exception("should not have happend, Write(): decompress, _currentmode == " + _currentMode);
-		}
-
-		return consumed;
-	}
-
-	int LZ4Stream::DecompressHeader(array<Byte>^ data, int offset, int count)
-	{
-		// _currentMode == 0 -> no data
-		// _currentMode == 1 -> lz4 frame magic
-		// _currentMode == 2 -> user frame magic
-		// _currentMode == 3 -> checksum
-		// _currentMode == 4 -> lz4 content size
-		// _currentMode == 5 -> user frame size		
-		// _currentMode == 6 -> frame data
-		// _currentMode == 7 -> content checksum
-		// _currentMode == 8 -> block data
-		// _currentMode == 9 -> block checksum
-		// _currentMode == 10 -> decompress block
-
-		int consumed = 0;
-		if (_currentMode == 0) {
-			for (int i = _headerBufferSize, ii = 0; i < 4 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 4) {
-				_blockCount = 0;
-				if (_headerBuffer[0] == 0x04 && _headerBuffer[1] == 0x22 && _headerBuffer[2] == 0x4D && _headerBuffer[3] == 0x18) {
-					// expect 2 byte descriptor
-					_currentMode = 1;
-				}
-				else if (_headerBuffer[0] >= 0x50 && _headerBuffer[0] <= 0x5f && _headerBuffer[1] == 0x2A && _headerBuffer[2] == 0x4D && _headerBuffer[3] == 0x18) {
-					_currentMode = 2;
-				}
-				else {
-					throw gcnew Exception("Invalid magic: 0x" + _headerBuffer[0].ToString("x2") + _headerBuffer[1].ToString("x2") + _headerBuffer[2].ToString("x2") + _headerBuffer[3].ToString("x2"));
-				}
+				OnFrameEvent(frameEvent);
 			}
 		}
-		else if (_currentMode == 1)
-		{
-			for (int i = _headerBufferSize, ii = 0; i < 6 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 6) {
-				_frameCount++;
-
-				// reset state
-				XXH32_reset(_contentHashState, 0);
-				_blockSize = LZ4FrameBlockSize::Max64KB;
-				_blockMode = LZ4FrameBlockMode::Linked;
-				_checksumMode = LZ4FrameChecksumMode::None;
-				_contentSize = 0;
-				_outputBufferOffset = 0;
-				_outputBufferBlockSize = 0;
-				//_ringbufferOffset = 0;
-
-				// verify version
-				if (!((_headerBuffer[4] & 0x40) == 0x40 || (_headerBuffer[4] & 0x60) == 0x60) || (_headerBuffer[4] & 0x80) != 0x00) {
-					throw gcnew Exception("Unexpected frame version");
-				}
-				else if ((_headerBuffer[4] & 0x01) != 0x00) {
-					throw gcnew Exception("Predefined dictionaries are not supported");
-				}
-				else if ((_headerBuffer[4] & 0x02) != 0x00) {
-					// reserved value
-					throw gcnew Exception("Header contains unexpected value");
-				}
-
-				if ((_headerBuffer[4] & 0x04) == 0x04) {
-					_checksumMode = _checksumMode | LZ4FrameChecksumMode::Content;
-				}
-				bool hasContentSize = false;
-				if ((_headerBuffer[4] & 0x08) == 0x08) {
-					hasContentSize = true;
-				}
-				if ((_headerBuffer[4] & 0x10) == 0x10) {
-					_checksumMode = _checksumMode | LZ4FrameChecksumMode::Block;
-				}
-				if ((_headerBuffer[4] & 0x20) == 0x20) {
-					_blockMode = LZ4FrameBlockMode::Independent;
-				}
-
-				if ((_headerBuffer[5] & 0x0F) != 0x00) {
-					// reserved value
-					throw gcnew Exception("Header contains unexpected value");
-				}
-				else if ((_headerBuffer[5] & 0x80) != 0x00) {
-					// reserved value
-					throw gcnew Exception("Header contains unexpected value");
-				}
-
-				int blockSizeId = (_headerBuffer[5] & 0x70) >> 4;
-				if (blockSizeId == 4) {
-					_blockSize = LZ4FrameBlockSize::Max64KB;
-					_inputBufferSize = 64 KB;
-					_outputBufferSize = 64 KB;
-				}
-				else if (blockSizeId == 5) {
-					_blockSize = LZ4FrameBlockSize::Max256KB;
-					_inputBufferSize = 256 KB;
-					_outputBufferSize = 256 KB;
-				}
-				else if (blockSizeId == 6) {
-					_blockSize = LZ4FrameBlockSize::Max1MB;
-					_inputBufferSize = 1 MB;
-					_outputBufferSize = 1 MB;
-				}
-				else if (blockSizeId == 7) {
-					_blockSize = LZ4FrameBlockSize::Max4MB;
-					_inputBufferSize = 4 MB;
-					_outputBufferSize = 4 MB;
-				}
-				else {
-					throw gcnew Exception("Unsupported block size: " + blockSizeId);
-				}
-
-				// resize buffers
-				if (_inputBuffer == nullptr || _inputBuffer->Length != _inputBufferSize) {
-					if (_inputBufferHandle.IsAllocated) { _inputBufferHandle.Free(); _inputBufferPtr = nullptr; }
-					_inputBuffer = gcnew array<byte>(_inputBufferSize);
-					_inputBufferHandle = GCHandle::Alloc(_inputBuffer, GCHandleType::Pinned);
-					_inputBufferPtr = (char*)(void*)_inputBufferHandle.AddrOfPinnedObject();
-				}
-				if (_outputBuffer == nullptr || _outputBuffer->Length != 2 * _outputBufferSize) {
-					if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
-					_outputBuffer = gcnew array<byte>(2 * _outputBufferSize);
-					_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-					_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				}
-
-				if (hasContentSize) {
-					// expect 8 more bytes
-					_currentMode = 4;
-				}
-				else {
-					_currentMode = 3;
-				}
-			}
-		}
-		else if (_currentMode == 4)
-		{
-			for (int i = _headerBufferSize, ii = 0; i < 14 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 14) {
-
-				_contentSize = 0;
-				for (int i = 6, ii = 0; i < 14; i++, ii++) {
-					_contentSize |= ((unsigned long long)_headerBuffer[i] << (ii * 8));
-				}
-
-				_currentMode = 3;
-			}
-		}
-		else if (_currentMode == 3)
-		{
-			_headerBuffer[_headerBufferSize++] = data[offset];
-
-			// verify checksum
-			pin_ptr<byte> descriptorPtr = &_headerBuffer[4];
-			U32 xxh = XXH32(descriptorPtr, _headerBufferSize - 5, 0);
-			byte checksumByte = (xxh >> 8) & 0xFF;
-			if (_headerBuffer[_headerBufferSize - 1] != checksumByte) {
-				throw gcnew Exception("Frame checksum is invalid");
-			}
-
-			_headerBufferSize = 0;
-			_currentMode = 6;
-			consumed = 1;
-		}
-		else if (_currentMode == 2)
-		{
-			for (int i = _headerBufferSize, ii = 0; i < 8 && ii < count; i++, ii++) {
-				_headerBuffer[i] = data[offset + ii];
-				_headerBufferSize++;
-				consumed++;
-			}
-
-			if (_headerBufferSize == 8) {
-
-				_frameCount++;
-
-				unsigned int frameSize = 0;
-				for (int i = 4, ii = 0; i < 8; i++, ii++) {
-					frameSize |= ((unsigned int)_headerBuffer[i] << (ii * 8));
-				}
-
-				_outputBufferSize = frameSize;
-				_outputBufferOffset = 0;
-				if (_outputBufferHandle.IsAllocated) { _outputBufferHandle.Free(); _outputBufferPtr = nullptr; }
-				_outputBuffer = gcnew array<byte>(_outputBufferSize);
-				_outputBufferHandle = GCHandle::Alloc(_outputBuffer, GCHandleType::Pinned);
-				_outputBufferPtr = (char*)(void*)_outputBufferHandle.AddrOfPinnedObject();
-				_currentMode = 5;
-			}
-		}
-
-		return consumed;
 	}
 }
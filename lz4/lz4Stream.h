@@ -30,13 +30,21 @@
 
 #pragma once
 
-#include "lz4.h"
-#include "lz4hc.h"
-#include "xxhash.h"
+#include "lz4Frame.h"
+#include "lz4Dictionary.h"
+#include "lz4BlockIndex.h"
+#include "lz4ParallelBlockCompressor.h"
+#include "lz4ParallelBlockDecompressor.h"
+#include "lz4PipelinedBlockDecompressor.h"
+#include "lz4ParallelFrameDecompressor.h"
+
+// decompress: frames that decompress to at most this size are read ahead whole and decompressed in parallel
+#define LZ4STREAM_PARALLEL_FRAME_SIZE_MAX (16 * 1024 * 1024)
 
 using namespace System;
 using namespace System::IO;
 using namespace System::IO::Compression;
+using namespace System::Diagnostics;
 using namespace System::Runtime::InteropServices;
 
 namespace lz4 {
@@ -89,10 +97,6 @@ namespace lz4 {
 		Stream^ _innerStream;
 
 		array<Byte> ^_headerBuffer = gcnew array<Byte>(23);
-		int _headerBufferSize = 0;
-		int _currentMode = 0;
-
-		int _targetBufferSize = 0;
 		bool _isCompressed = false;
 
 		CompressionMode _compressionMode;
@@ -101,14 +105,31 @@ namespace lz4 {
 		LZ4FrameChecksumMode _checksumMode = LZ4FrameChecksumMode::None;
 		LZ4StreamMode _streamMode;
 		Nullable<long long> _maxFrameSize = Nullable<long long>();
-		bool _highCompression;
+		int _compressionLevel = 0;
+		bool _favorDecSpeed = false;
+		int _acceleration = 1;
+		Nullable<int> _maxAcceleration = Nullable<int>();
+		int _currentAcceleration = 1;
+		long long _compressTicks = 0;
+		long long _writeTicks = 0;
+		int _adaptiveBlockCount = 0;
 		bool _leaveInnerStreamOpen;
 		bool _hasWrittenStartFrame = false;
 		bool _hasWrittenInitialStartFrame = false;
-		bool _hasFrameInfo = false;
-		unsigned long long _contentSize = 0;
+		Nullable<long long> _contentSize = Nullable<long long>();
+		LZ4Dictionary^ _dictionary = nullptr;
+		LZ4Dictionary^ _frameDictionary = nullptr;
+		System::Collections::Generic::Dictionary<unsigned int, LZ4Dictionary^>^ _dictionaries = nullptr;
 		long long _frameCount = 0;
 		bool _interactiveRead = false;
+		int _maxDegreeOfParallelism = 1;
+		bool _writeBlockIndex = false;
+		int _restartInterval = 0;
+		int _memoryUsage = 0;
+		LZ4BlockIndex^ _blockIndex = nullptr;
+		bool _hasReadBlockIndex = false;
+		long long _position = 0;
+		LZ4Allocations^ _allocations;
 
 		array<byte>^ _inputBuffer = nullptr;
 		array<byte>^ _outputBuffer = nullptr;
@@ -123,30 +144,60 @@ namespace lz4 {
 		int _inputBufferOffset = 0;
 		int _ringbufferOffset = 0;
 		long long _blockCount = 0;
+		array<byte>^ _readBuffer = nullptr;
+		int _readBufferOffset = 0;
+		bool _parallelFrame = false;
+		bool _pipelinedFrame = false;
+		bool _concurrentFrames = false;
+		bool _concurrentFramesDisabled = false;
+		array<byte>^ _userData = nullptr;
+		int _userDataOffset = 0;
+		// the part of a frame that was read ahead and is decoded on the calling thread after all
+		array<byte>^ _pendingInput = nullptr;
+		int _pendingInputOffset = 0;
 
 		void Init();
+		void ResetState(Stream^ innerStream);
+		void WriteEndStream();
 		void WriteEmptyFrame();
 		void WriteStartFrame();
 		void FlushCurrentBlock(bool suppressEndFrame);
-		bool GetFrameInfo();
+		int ReadInnerStream(array<byte>^ buffer, int offset, int count);
+		void BeginDecodeFrame();
+		void OnFrameEvent(int frameEvent);
 		bool AcquireNextBlock();
-		
-		int DecompressBlock(array<Byte>^ data, int offset, int count);
-		void DecompressData(array<Byte>^ data, int offset, int count);
-		int DecompressHeader(array<Byte>^ data, int offset, int count);
-
-		LZ4_stream_t *_lz4Stream = nullptr;
-		LZ4_streamHC_t *_lz4HCStream = nullptr;
-		LZ4_streamDecode_t *_lz4DecodeStream = nullptr;
-		XXH32_state_t *_contentHashState = nullptr;
+		bool AcquireNextParallelBlock();
+		bool AcquireNextPipelinedBlock();
+		bool AcquireNextConcurrentFrame();
+		void AdaptAcceleration(long long compressTicks, long long writeTicks);
+		LZ4BlockIndex^ GetBlockIndex();
+		void SeekFrame(long long offset);
+		void SeekContent(long long position);
+
+		void DecompressData(const char* data, int count);
+
+		native::LZ4FrameEncoder *_frameEncoder = nullptr;
+		native::LZ4FrameDecoder *_frameDecoder = nullptr;
+		LZ4ParallelBlockCompressor^ _parallelCompressor = nullptr;
+		LZ4ParallelBlockDecompressor^ _parallelDecompressor = nullptr;
+		LZ4PipelinedBlockDecompressor^ _pipelinedDecompressor = nullptr;
+		LZ4ParallelFrameDecompressor^ _frameDecompressor = nullptr;
 
 		bool Get_CanRead();
 		bool Get_CanSeek();
 		bool Get_CanWrite();
 		long long Get_Length();
 		long long Get_Position();
-
-		void CompressNextBlock();
+		Nullable<long long> Get_ContentSize();
+		void Set_ContentSize(Nullable<long long> value);
+		void Set_Acceleration(int value);
+		void Set_MaxAcceleration(Nullable<int> value);
+		void Set_Dictionary(LZ4Dictionary^ value);
+		void Set_WriteBlockIndex(bool value);
+		void Set_RestartInterval(int value);
+		void Set_MemoryUsage(int value);
+
+		bool CompressNextBlock();
 		int CompressData(array<byte>^ buffer, int offset, int count);
 		void WriteHeaderData(array<byte>^ buffer, int offset, int count);
 
@@ -154,21 +205,38 @@ namespace lz4 {
 		void WriteUserDataFrameInternal(int id, array<byte>^ buffer, int offset, int count);
 
 	internal:
+		static void CreateFrameInfo(LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, native::LZ4FrameInfo* info);
+
 		property long long CurrentBlockCount {
 			long long get() {
 				return _blockCount;
 			};
 		}
 
+		property bool IsDisposed {
+			bool get() {
+				return _frameEncoder == nullptr && _frameDecoder == nullptr;
+			};
+		}
+
+		// LZ4StreamPool: binds a stream that has been reset to the inner stream of the next message
+		void Rebind(Stream^ innerStream);
+
 	public:
 		~LZ4Stream();
 		!LZ4Stream();
 
 		static LZ4Stream^ CreateCompressor(Stream^ innerStream, LZ4StreamMode streamMode, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, bool highCompression, bool leaveInnerStreamOpen);
+		// compressionLevel: 0 for fast compression, 3 - 12 for high compression (highCompression uses 9), favorDecSpeed: levels 10 - 12 prefer matches that decompress faster
+		static LZ4Stream^ CreateCompressor(Stream^ innerStream, LZ4StreamMode streamMode, LZ4FrameBlockMode blockMode, LZ4FrameBlockSize blockSize, LZ4FrameChecksumMode checksumMode, Nullable<long long> maxFrameSize, int compressionLevel, bool favorDecSpeed, bool leaveInnerStreamOpen);
 		static LZ4Stream^ CreateDecompressor(Stream^ innerStream, LZ4StreamMode streamMode, bool leaveInnerStreamOpen);
 
 		void WriteEndFrame();
+		// completes the stream as Dispose does, then continues on innerStream with the same buffers and settings
+		void Reset(Stream^ innerStream);
 		void WriteUserDataFrame(int id, array<byte>^ buffer, int offset, int count);
+		// dictionary for the frames with its id
+		void AddDictionary(LZ4Dictionary^ dictionary);
 
 		event EventHandler<LZ4UserDataFrameEventArgs^>^ UserDataFrameRead;
 
@@ -181,12 +249,108 @@ namespace lz4 {
 			}
 		}
 
+		// blocks processed concurrently, 1: on the calling thread (linked fast compression can compress less)
+		property int MaxDegreeOfParallelism {
+			int get() {
+				return _maxDegreeOfParallelism;
+			}
+			void set(int value) {
+				if (value < 1) { throw gcnew ArgumentOutOfRangeException("value"); }
+				else if (_parallelCompressor != nullptr || _parallelDecompressor != nullptr || _pipelinedDecompressor != nullptr || _frameDecompressor != nullptr) { throw gcnew InvalidOperationException("MaxDegreeOfParallelism cannot be changed after the first block has been processed"); }
+				_maxDegreeOfParallelism = value;
+			}
+		}
+
+		// writes a block index at the end of the stream, a stream with an index can seek
+		property bool WriteBlockIndex {
+			bool get() {
+				return _writeBlockIndex;
+			}
+			void set(bool value) {
+				Set_WriteBlockIndex(value);
+			}
+		}
+
+		// linked blocks: a block without history every RestartInterval blocks, 0: the first block of a frame
+		property int RestartInterval {
+			int get() {
+				return _restartInterval;
+			}
+			void set(int value) {
+				Set_RestartInterval(value);
+			}
+		}
+
+		// hash table size 2^MemoryUsage bytes, 0: default
+		property int MemoryUsage {
+			int get() {
+				return _memoryUsage;
+			}
+			void set(int value) {
+				Set_MemoryUsage(value);
+			}
+		}
+
+		// dictionary of the next frames, or of the frames without a dictionary id
+		property LZ4Dictionary^ Dictionary {
+			LZ4Dictionary^ get() {
+				return _dictionary;
+			}
+			void set(LZ4Dictionary^ value) {
+				Set_Dictionary(value);
+			}
+		}
+
+		// fast compression: 1 - LZ4FRAME_ACCELERATION_MAX, from the next block
+		property int Acceleration {
+			int get() {
+				return _acceleration;
+			}
+			void set(int value) {
+				Set_Acceleration(value);
+			}
+		}
+
+		// upper limit of the adaptive acceleration, null: off
+		property Nullable<int> MaxAcceleration {
+			Nullable<int> get() {
+				return _maxAcceleration;
+			}
+			void set(Nullable<int> value) {
+				Set_MaxAcceleration(value);
+			}
+		}
+
+		// acceleration of the next block
+		property int CurrentAcceleration {
+			int get() {
+				return _currentAcceleration;
+			};
+		}
+
 		property long long FrameCount {
 			long long get() {
 				return _frameCount;
 			};
 		}
 
+		// buffers and native states allocated by the stream (LZ4Allocations)
+		property long long AllocationCount {
+			long long get() {
+				return _allocations->Count;
+			};
+		}
+
+		// content size of the next frame, or of the current frame when reading
+		property Nullable<long long> ContentSize {
+			Nullable<long long> get() {
+				return Get_ContentSize();
+			}
+			void set(Nullable<long long> value) {
+				Set_ContentSize(value);
+			}
+		}
+
 		property virtual bool CanRead {
 			bool get() override {
 				return Get_CanRead();
@@ -212,7 +376,7 @@ namespace lz4 {
 				return Get_Position();
 			}
 			void set(long long value) override {
-				throw gcnew NotSupportedException("SetPosition");
+				Seek(value, SeekOrigin::Begin);
 			}
 		}
 		virtual void Flush() override;
@@ -0,0 +1,118 @@
+#include "stdafx.h"
+/*
+   Source File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#include "lz4StreamPool.h"
+
+namespace lz4 {
+
+	LZ4StreamPool::LZ4StreamPool(Func<Stream^, LZ4Stream^>^ factory, int maxStreams) {
+		if (factory == nullptr) { throw gcnew ArgumentNullException("factory"); }
+		else if (maxStreams < 0) { throw gcnew ArgumentOutOfRangeException("maxStreams"); }
+
+		_factory = factory;
+		_maxStreams = maxStreams;
+		_streams = gcnew System::Collections::Generic::Stack<LZ4Stream^>();
+	}
+
+	LZ4StreamPool::~LZ4StreamPool() {
+		Monitor::Enter(_streams);
+		try {
+			while (_streams->Count > 0) { delete _streams->Pop(); }
+		}
+		finally {
+			Monitor::Exit(_streams);
+		}
+	}
+
+	int LZ4StreamPool::Count::get() {
+		Monitor::Enter(_streams);
+		try {
+			return _streams->Count;
+		}
+		finally {
+			Monitor::Exit(_streams);
+		}
+	}
+
+	LZ4Stream^ LZ4StreamPool::Rent(Stream^ innerStream) {
+		if (innerStream == nullptr) { throw gcnew ArgumentNullException("innerStream"); }
+
+		LZ4Stream^ stream = nullptr;
+		Monitor::Enter(_streams);
+		try {
+			if (_streams->Count > 0) { stream = _streams->Pop(); }
+		}
+		finally {
+			Monitor::Exit(_streams);
+		}
+
+		if (stream != nullptr) {
+			// the stream was completed when it was returned
+			stream->Rebind(innerStream);
+			Interlocked::Increment(_reused);
+			return stream;
+		}
+
+		stream = _factory(innerStream);
+		if (stream == nullptr) { throw gcnew InvalidOperationException("The factory did not create a stream"); }
+		Interlocked::Increment(_created);
+		return stream;
+	}
+
+	void LZ4StreamPool::Return(LZ4Stream^ stream) {
+		if (stream == nullptr) { throw gcnew ArgumentNullException("stream"); }
+		else if (stream->IsDisposed) { return; }
+
+		// the stream no longer references the inner stream of the caller, a stream that fails to complete is not kept
+		try {
+			stream->Reset(Stream::Null);
+		}
+		catch (Exception^) {
+			// the native states are released, the error of the reset is the one that is reported
+			try { delete stream; }
+			catch (Exception^) {}
+			throw;
+		}
+
+		Monitor::Enter(_streams);
+		try {
+			if (_streams->Count < _maxStreams) {
+				_streams->Push(stream);
+				return;
+			}
+		}
+		finally {
+			Monitor::Exit(_streams);
+		}
+		delete stream;
+	}
+}
@@ -0,0 +1,84 @@
+/*
+   Header File
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+   * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   source repository: https://github.com/IonKiwi/lz4.net
+   */
+
+
+#pragma once
+
+#include "lz4Stream.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+
+namespace lz4 {
+
+	// keeps LZ4Stream compressors or decompressors of one configuration, a returned stream is reset (LZ4Stream::Reset) and rented again for the next inner stream
+	// the buffers (three blocks for a compressor, 12 MB with 4 MB blocks) and native states are allocated once per kept stream, settings made on a rented stream are kept
+	public ref class LZ4StreamPool sealed
+	{
+	private:
+		Func<Stream^, LZ4Stream^>^ _factory;
+		System::Collections::Generic::Stack<LZ4Stream^>^ _streams;
+		int _maxStreams;
+		long long _created = 0;
+		long long _reused = 0;
+
+	public:
+		// factory: creates a stream on an inner stream (LZ4Stream::CreateCompressor, LZ4Stream::CreateDecompressor), maxStreams: streams that are kept for reuse
+		LZ4StreamPool(Func<Stream^, LZ4Stream^>^ factory, int maxStreams);
+		// disposes the streams that are kept
+		~LZ4StreamPool();
+
+		// a kept stream continues on innerStream, otherwise the factory creates one
+		LZ4Stream^ Rent(Stream^ innerStream);
+		// completes the stream (the last frame and the block index are written, the inner stream is closed unless leaveInnerStreamOpen) and keeps it
+		// a disposed stream, or one beyond maxStreams, is not kept; a stream that fails to complete is disposed and the error is rethrown
+		void Return(LZ4Stream^ stream);
+
+		property int Count {
+			int get();
+		}
+		property int MaxStreams {
+			int get() {
+				return _maxStreams;
+			}
+		}
+		property long long Created {
+			long long get() {
+				return Interlocked::Read(_created);
+			}
+		}
+		property long long Reused {
+			long long get() {
+				return Interlocked::Read(_reused);
+			}
+		}
+	};
+}
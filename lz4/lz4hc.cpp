@@ -80,13 +80,28 @@ typedef enum { noDictCtx, usingDictCtxHc } dictCtx_directive;
 /*===   Macros   ===*/
 #define MIN(a,b)   ( (a) < (b) ? (a) : (b) )
 #define MAX(a,b)   ( (a) > (b) ? (a) : (b) )
-#define HASH_FUNCTION(i)         (((i) * 2654435761U) >> ((MINMATCH*8)-LZ4HC_HASH_LOG))
+#define HASH_FUNCTION(i, hashLog) (((i) * 2654435761U) >> ((MINMATCH*8)-(hashLog)))
 #define DELTANEXTMAXD(p)         chainTable[(p) & LZ4HC_MAXD_MASK]    /* flexible, LZ4HC_MAXD dependent */
 #define DELTANEXTU16(table, pos) table[(U16)(pos)]   /* faster */
 /* Make fields passed to, and updated by LZ4HC_encodeSequence explicit */
 #define UPDATABLE(ip, op, anchor) &ip, &op, &anchor
 
-static U32 LZ4HC_hashPtr(const void* ptr) { return HASH_FUNCTION(LZ4_read32(ptr)); }
+/* hashLog : log2 of the hash table entries (LZ4HC_HASH_LOG, or the size selected by LZ4_initStreamHCEx()).
+ * The compressors receive it as a constant, see LZ4HC_compress_generic_noDictCtx() */
+LZ4_FORCE_INLINE U32 LZ4HC_hashPtr(const void* ptr, U32 hashLog) { return HASH_FUNCTION(LZ4_read32(ptr), hashLog); }
+static U32 LZ4HC_getHashLog(const LZ4HC_CCtx_internal* hc4) { return hc4->hashLog ? (U32)hc4->hashLog : LZ4HC_HASH_LOG; }
+
+static int LZ4HC_isValidHashLog(int hashLog)
+{
+    return (hashLog == LZ4HC_HASH_LOG)
+        || (hashLog == 10) || (hashLog == 12) || (hashLog == 14) || (hashLog == 16);
+}
+
+/* size of the state fields and a table of (1 << hashLog) entries, the table is the last field */
+static size_t LZ4HC_sizeofInternal(U32 hashLog)
+{
+    return offsetof(LZ4HC_CCtx_internal, hashTable) + (sizeof(U32) << hashLog);
+}
 
 
 /**************************************
@@ -94,10 +109,18 @@ static U32 LZ4HC_hashPtr(const void* ptr) { return HASH_FUNCTION(LZ4_read32(ptr)
 **************************************/
 static void LZ4HC_clearTables (LZ4HC_CCtx_internal* hc4)
 {
-    MEM_INIT(hc4->hashTable, 0, sizeof(hc4->hashTable));
+    MEM_INIT(hc4->hashTable, 0, sizeof(U32) << LZ4HC_getHashLog(hc4));
     MEM_INIT(hc4->chainTable, 0xFF, sizeof(hc4->chainTable));
 }
 
+/* full reset, only the used part of the hash table is cleared, the hash log is set */
+static void LZ4HC_initStream_internal (LZ4HC_CCtx_internal* hc4, U32 hashLog)
+{
+    assert(LZ4HC_isValidHashLog((int)hashLog));
+    MEM_INIT(hc4, 0, LZ4HC_sizeofInternal(hashLog));
+    hc4->hashLog = (hashLog == LZ4HC_HASH_LOG) ? 0 : (LZ4_i8)hashLog;
+}
+
 static void LZ4HC_init_internal (LZ4HC_CCtx_internal* hc4, const BYTE* start)
 {
     uptrval startingOffset = (uptrval)(hc4->end - hc4->base);
@@ -116,7 +139,7 @@ static void LZ4HC_init_internal (LZ4HC_CCtx_internal* hc4, const BYTE* start)
 
 
 /* Update chains up to ip (excluded) */
-LZ4_FORCE_INLINE void LZ4HC_Insert (LZ4HC_CCtx_internal* hc4, const BYTE* ip)
+LZ4_FORCE_INLINE void LZ4HC_Insert (LZ4HC_CCtx_internal* hc4, const BYTE* ip, U32 const hashLog)
 {
     U16* const chainTable = hc4->chainTable;
     U32* const hashTable  = hc4->hashTable;
@@ -125,7 +148,7 @@ LZ4_FORCE_INLINE void LZ4HC_Insert (LZ4HC_CCtx_internal* hc4, const BYTE* ip)
     U32 idx = hc4->nextToUpdate;
 
     while (idx < target) {
-        U32 const h = LZ4HC_hashPtr(base+idx);
+        U32 const h = LZ4HC_hashPtr(base+idx, hashLog);
         size_t delta = idx - hashTable[h];
         if (delta>LZ4_DISTANCE_MAX) delta = LZ4_DISTANCE_MAX;
         DELTANEXTU16(chainTable, idx) = (U16)delta;
@@ -147,6 +170,13 @@ int LZ4HC_countBack(const BYTE* const ip, const BYTE* const match,
     assert(min <= 0);
     assert(ip >= iMin); assert((size_t)(ip-iMin) < (1U<<31));
     assert(match >= mMin); assert((size_t)(match - mMin) < (1U<<31));
+#if defined(LZ4_VECTOR_SIZE)
+    while (back - LZ4_VECTOR_SIZE >= min) {
+        U64 const diff = ~LZ4_vectorEqual(ip + back - LZ4_VECTOR_SIZE, match + back - LZ4_VECTOR_SIZE) & LZ4_VECTOR_MASK;
+        if (diff) return back - (int)LZ4_vectorHighEqual(diff);
+        back -= LZ4_VECTOR_SIZE;
+    }
+#endif
     while ( (back > min)
          && (ip[back-1] == match[back-1]) )
             back--;
@@ -176,6 +206,15 @@ LZ4HC_countPattern(const BYTE* ip, const BYTE* const iEnd, U32 const pattern32)
     reg_t const pattern = (sizeof(pattern)==8) ?
         (reg_t)pattern32 + (((reg_t)pattern32) << (sizeof(pattern)*4)) : pattern32;
 
+#if defined(LZ4_VECTOR_SIZE)
+    while (likely(ip < iEnd-(LZ4_VECTOR_SIZE-1))) {
+        U64 const diff = ~LZ4_vectorEqualPattern(ip, pattern32) & LZ4_VECTOR_MASK;
+        if (!diff) { ip+=LZ4_VECTOR_SIZE; continue; }
+        ip += LZ4_vectorLowEqual(diff);
+        return (unsigned)(ip - iStart);
+    }
+#endif
+
     while (likely(ip < iEnd-(sizeof(pattern)-1))) {
         reg_t const diff = LZ4_read_ARCH(ip) ^ pattern;
         if (!diff) { ip+=sizeof(pattern); continue; }
@@ -208,6 +247,14 @@ LZ4HC_reverseCountPattern(const BYTE* ip, const BYTE* const iLow, U32 pattern)
 {
     const BYTE* const iStart = ip;
 
+#if defined(LZ4_VECTOR_SIZE)
+    while (likely(ip >= iLow+LZ4_VECTOR_SIZE)) {
+        U64 const diff = ~LZ4_vectorEqualPattern(ip-LZ4_VECTOR_SIZE, pattern) & LZ4_VECTOR_MASK;
+        if (!diff) { ip-=LZ4_VECTOR_SIZE; continue; }
+        ip -= LZ4_vectorHighEqual(diff);
+        return (unsigned)(iStart - ip);
+    }
+#endif
     while (likely(ip >= iLow+4)) {
         if (LZ4_read32(ip-4) != pattern) break;
         ip -= 4;
@@ -246,7 +293,8 @@ LZ4HC_InsertAndGetWiderMatch (
     const int patternAnalysis,
     const int chainSwap,
     const dictCtx_directive dict,
-    const HCfavor_e favorDecSpeed)
+    const HCfavor_e favorDecSpeed,
+    U32 const hashLog)
 {
     U16* const chainTable = hc4->chainTable;
     U32* const HashTable = hc4->hashTable;
@@ -267,8 +315,8 @@ LZ4HC_InsertAndGetWiderMatch (
 
     DEBUGLOG(7, "LZ4HC_InsertAndGetWiderMatch");
     /* First Match */
-    LZ4HC_Insert(hc4, ip);
-    matchIndex = HashTable[LZ4HC_hashPtr(ip)];
+    LZ4HC_Insert(hc4, ip, hashLog);
+    matchIndex = HashTable[LZ4HC_hashPtr(ip, hashLog)];
     DEBUGLOG(7, "First match at index %u / %u (lowestMatchIndex)",
                 matchIndex, lowestMatchIndex);
 
@@ -415,7 +463,7 @@ LZ4HC_InsertAndGetWiderMatch (
       && nbAttempts > 0
       && ipIndex - lowestMatchIndex < LZ4_DISTANCE_MAX) {
         size_t const dictEndOffset = (size_t)(dictCtx->end - dictCtx->base);
-        U32 dictMatchIndex = dictCtx->hashTable[LZ4HC_hashPtr(ip)];
+        U32 dictMatchIndex = dictCtx->hashTable[LZ4HC_hashPtr(ip, hashLog)];   /* same hash log, see LZ4_attach_HC_dictionary() */
         assert(dictEndOffset <= 1 GB);
         matchIndex = dictMatchIndex + lowestMatchIndex - (U32)dictEndOffset;
         while (ipIndex - matchIndex <= LZ4_DISTANCE_MAX && nbAttempts--) {
@@ -449,13 +497,14 @@ int LZ4HC_InsertAndFindBestMatch(LZ4HC_CCtx_internal* const hc4,   /* Index tabl
                                  const BYTE** matchpos,
                                  const int maxNbAttempts,
                                  const int patternAnalysis,
-                                 const dictCtx_directive dict)
+                                 const dictCtx_directive dict,
+                                 U32 const hashLog)
 {
     const BYTE* uselessPtr = ip;
     /* note : LZ4HC_InsertAndGetWiderMatch() is able to modify the starting position of a match (*startpos),
      * but this won't be the case here, as we define iLowLimit==ip,
      * so LZ4HC_InsertAndGetWiderMatch() won't be allowed to search past ip */
-    return LZ4HC_InsertAndGetWiderMatch(hc4, ip, ip, iLimit, MINMATCH-1, matchpos, &uselessPtr, maxNbAttempts, patternAnalysis, 0 /*chainSwap*/, dict, favorCompressionRatio);
+    return LZ4HC_InsertAndGetWiderMatch(hc4, ip, ip, iLimit, MINMATCH-1, matchpos, &uselessPtr, maxNbAttempts, patternAnalysis, 0 /*chainSwap*/, dict, favorCompressionRatio, hashLog);
 }
 
 /* LZ4HC_encodeSequence() :
@@ -555,7 +604,8 @@ LZ4_FORCE_INLINE int LZ4HC_compress_hashChain (
     int const maxOutputSize,
     int maxNbAttempts,
     const limitedOutput_directive limit,
-    const dictCtx_directive dict
+    const dictCtx_directive dict,
+    U32 const hashLog
     )
 {
     const int inputSize = *srcSizePtr;
@@ -587,7 +637,7 @@ LZ4_FORCE_INLINE int LZ4HC_compress_hashChain (
 
     /* Main Loop */
     while (ip <= mflimit) {
-        ml = LZ4HC_InsertAndFindBestMatch(ctx, ip, matchlimit, &ref, maxNbAttempts, patternAnalysis, dict);
+        ml = LZ4HC_InsertAndFindBestMatch(ctx, ip, matchlimit, &ref, maxNbAttempts, patternAnalysis, dict, hashLog);
         if (ml<MINMATCH) { ip++; continue; }
 
         /* saved, in case we would skip too much */
@@ -597,7 +647,7 @@ _Search2:
         if (ip+ml <= mflimit) {
             ml2 = LZ4HC_InsertAndGetWiderMatch(ctx,
                             ip + ml - 2, ip + 0, matchlimit, ml, &ref2, &start2,
-                            maxNbAttempts, patternAnalysis, 0, dict, favorCompressionRatio);
+                            maxNbAttempts, patternAnalysis, 0, dict, favorCompressionRatio, hashLog);
         } else {
             ml2 = ml;
         }
@@ -642,7 +692,7 @@ _Search3:
         if (start2 + ml2 <= mflimit) {
             ml3 = LZ4HC_InsertAndGetWiderMatch(ctx,
                             start2 + ml2 - 3, start2, matchlimit, ml2, &ref3, &start3,
-                            maxNbAttempts, patternAnalysis, 0, dict, favorCompressionRatio);
+                            maxNbAttempts, patternAnalysis, 0, dict, favorCompressionRatio, hashLog);
         } else {
             ml3 = ml2;
         }
@@ -785,13 +835,14 @@ _dest_overflow:
 }
 
 
-static int LZ4HC_compress_optimal( LZ4HC_CCtx_internal* ctx,
+LZ4_FORCE_INLINE int LZ4HC_compress_optimal( LZ4HC_CCtx_internal* ctx,
     const char* const source, char* dst,
     int* srcSizePtr, int dstCapacity,
     int const nbSearches, size_t sufficient_len,
     const limitedOutput_directive limit, int const fullUpdate,
     const dictCtx_directive dict,
-    const HCfavor_e favorDecSpeed);
+    const HCfavor_e favorDecSpeed,
+    U32 const hashLog);
 
 
 LZ4_FORCE_INLINE int LZ4HC_compress_generic_internal (
@@ -802,7 +853,8 @@ LZ4_FORCE_INLINE int LZ4HC_compress_generic_internal (
     int const dstCapacity,
     int cLevel,
     const limitedOutput_directive limit,
-    const dictCtx_directive dict
+    const dictCtx_directive dict,
+    U32 const hashLog
     )
 {
     typedef enum { lz4hc, lz4opt } lz4hc_strat_e;
@@ -843,14 +895,14 @@ LZ4_FORCE_INLINE int LZ4HC_compress_generic_internal (
         if (cParam.strat == lz4hc) {
             result = LZ4HC_compress_hashChain(ctx,
                                 src, dst, srcSizePtr, dstCapacity,
-                                cParam.nbSearches, limit, dict);
+                                cParam.nbSearches, limit, dict, hashLog);
         } else {
             assert(cParam.strat == lz4opt);
             result = LZ4HC_compress_optimal(ctx,
                                 src, dst, srcSizePtr, dstCapacity,
                                 cParam.nbSearches, cParam.targetLength, limit,
                                 cLevel == LZ4HC_CLEVEL_MAX,   /* ultra mode */
-                                dict, favor);
+                                dict, favor, hashLog);
         }
         if (result <= 0) ctx->dirty = 1;
         return result;
@@ -870,8 +922,17 @@ LZ4HC_compress_generic_noDictCtx (
         limitedOutput_directive limit
         )
 {
+    U32 const hashLog = LZ4HC_getHashLog(ctx);
     assert(ctx->dictCtx == NULL);
-    return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx);
+    /* instantiated for every table size, so that the hash shifts are constants */
+    switch (hashLog) {
+    case 10: return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx, 10);
+    case 12: return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx, 12);
+    case 14: return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx, 14);
+    case 16: return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx, 16);
+    default: assert(hashLog == LZ4HC_HASH_LOG);
+             return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, noDictCtx, LZ4HC_HASH_LOG);
+    }
 }
 
 static int
@@ -891,12 +952,13 @@ LZ4HC_compress_generic_dictCtx (
         ctx->dictCtx = NULL;
         return LZ4HC_compress_generic_noDictCtx(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit);
     } else if (position == 0 && *srcSizePtr > 4 KB) {
-        memcpy(ctx, ctx->dictCtx, sizeof(LZ4HC_CCtx_internal));
+        memcpy(ctx, ctx->dictCtx, LZ4HC_sizeofInternal(LZ4HC_getHashLog(ctx)));
         LZ4HC_setExternalDict(ctx, (const BYTE *)src);
         ctx->compressionLevel = (short)cLevel;
         return LZ4HC_compress_generic_noDictCtx(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit);
     } else {
-        return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, usingDictCtxHc);
+        /* only the first 64 KB after LZ4_attach_HC_dictionary(), the hash log is not a constant */
+        return LZ4HC_compress_generic_internal(ctx, src, dst, srcSizePtr, dstCapacity, cLevel, limit, usingDictCtxHc, LZ4HC_getHashLog(ctx));
     }
 }
 
@@ -921,6 +983,13 @@ LZ4HC_compress_generic (
 
 int LZ4_sizeofStateHC(void) { return (int)sizeof(LZ4_streamHC_t); }
 
+int LZ4_sizeofStateHCEx(int hashLog)
+{
+    if (!LZ4HC_isValidHashLog(hashLog)) { return 0; }
+    if (hashLog <= LZ4HC_HASH_LOG) { return (int)sizeof(LZ4_streamHC_t); }
+    return (int)((LZ4HC_sizeofInternal((U32)hashLog) + sizeof(void*) - 1) & ~(sizeof(void*) - 1));
+}
+
 static size_t LZ4_streamHC_t_alignment(void)
 {
 #if LZ4_ALIGN_TEST
@@ -1018,6 +1087,32 @@ LZ4_streamHC_t* LZ4_initStreamHC (void* buffer, size_t size)
     return LZ4_streamHCPtr;
 }
 
+LZ4_streamHC_t* LZ4_initStreamHCEx (void* buffer, size_t size, int hashLog)
+{
+    LZ4_streamHC_t* const LZ4_streamHCPtr = (LZ4_streamHC_t*)buffer;
+    DEBUGLOG(4, "LZ4_initStreamHCEx(%p, %u, %d)", buffer, (unsigned)size, hashLog);
+    /* check conditions */
+    if (buffer == NULL) return NULL;
+    if (!LZ4HC_isValidHashLog(hashLog)) return NULL;
+    if (size < (size_t)LZ4_sizeofStateHCEx(hashLog)) return NULL;
+    if (!LZ4_isAligned(buffer, LZ4_streamHC_t_alignment())) return NULL;
+    /* init */
+    LZ4HC_initStream_internal(&LZ4_streamHCPtr->internal_donotuse, (U32)hashLog);
+    LZ4_setCompressionLevel(LZ4_streamHCPtr, LZ4HC_CLEVEL_DEFAULT);
+    return LZ4_streamHCPtr;
+}
+
+LZ4_streamHC_t* LZ4_createStreamHCEx(int hashLog)
+{
+    int const size = LZ4_sizeofStateHCEx(hashLog);
+    LZ4_streamHC_t* state;
+    if (size == 0) return NULL;
+    state = (LZ4_streamHC_t*)ALLOC((size_t)size);
+    if (state == NULL) return NULL;
+    LZ4_initStreamHCEx(state, (size_t)size, hashLog);
+    return state;
+}
+
 /* just a stub */
 void LZ4_resetStreamHC (LZ4_streamHC_t* LZ4_streamHCPtr, int compressionLevel)
 {
@@ -1029,7 +1124,8 @@ void LZ4_resetStreamHC_fast (LZ4_streamHC_t* LZ4_streamHCPtr, int compressionLev
 {
     DEBUGLOG(4, "LZ4_resetStreamHC_fast(%p, %d)", LZ4_streamHCPtr, compressionLevel);
     if (LZ4_streamHCPtr->internal_donotuse.dirty) {
-        LZ4_initStreamHC(LZ4_streamHCPtr, sizeof(*LZ4_streamHCPtr));
+        /* keeps the hash log, see LZ4_initStreamHCEx() */
+        LZ4HC_initStream_internal(&LZ4_streamHCPtr->internal_donotuse, LZ4HC_getHashLog(&LZ4_streamHCPtr->internal_donotuse));
     } else {
         /* preserve end - base : can trigger clearTable's threshold */
         LZ4_streamHCPtr->internal_donotuse.end -= (uptrval)LZ4_streamHCPtr->internal_donotuse.base;
@@ -1066,16 +1162,21 @@ int LZ4_loadDictHC (LZ4_streamHC_t* LZ4_streamHCPtr,
     }
     /* need a full initialization, there are bad side-effects when using resetFast() */
     {   int const cLevel = ctxPtr->compressionLevel;
-        LZ4_initStreamHC(LZ4_streamHCPtr, sizeof(*LZ4_streamHCPtr));
+        LZ4HC_initStream_internal(ctxPtr, LZ4HC_getHashLog(ctxPtr));
         LZ4_setCompressionLevel(LZ4_streamHCPtr, cLevel);
     }
     LZ4HC_init_internal (ctxPtr, (const BYTE*)dictionary);
     ctxPtr->end = (const BYTE*)dictionary + dictSize;
-    if (dictSize >= 4) LZ4HC_Insert (ctxPtr, ctxPtr->end-3);
+    if (dictSize >= 4) LZ4HC_Insert (ctxPtr, ctxPtr->end-3, LZ4HC_getHashLog(ctxPtr));
     return dictSize;
 }
 
 void LZ4_attach_HC_dictionary(LZ4_streamHC_t *working_stream, const LZ4_streamHC_t *dictionary_stream) {
+    /* the tables are searched with the same hash, a dictionary of another hash log is not attached */
+    if (dictionary_stream != NULL
+      && LZ4HC_getHashLog(&dictionary_stream->internal_donotuse) != LZ4HC_getHashLog(&working_stream->internal_donotuse)) {
+        dictionary_stream = NULL;
+    }
     working_stream->internal_donotuse.dictCtx = dictionary_stream != NULL ? &(dictionary_stream->internal_donotuse) : NULL;
 }
 
@@ -1085,7 +1186,7 @@ static void LZ4HC_setExternalDict(LZ4HC_CCtx_internal* ctxPtr, const BYTE* newBl
 {
     DEBUGLOG(4, "LZ4HC_setExternalDict(%p, %p)", ctxPtr, newBlock);
     if (ctxPtr->end >= ctxPtr->base + ctxPtr->dictLimit + 4)
-        LZ4HC_Insert (ctxPtr, ctxPtr->end-3);   /* Referencing remaining dictionary content */
+        LZ4HC_Insert (ctxPtr, ctxPtr->end-3, LZ4HC_getHashLog(ctxPtr));   /* Referencing remaining dictionary content */
 
     /* Only one memory segment for extDict, so any previous extDict is lost at this stage */
     ctxPtr->lowLimit  = ctxPtr->dictLimit;
@@ -1294,14 +1395,15 @@ LZ4HC_FindLongerMatch(LZ4HC_CCtx_internal* const ctx,
                       const BYTE* ip, const BYTE* const iHighLimit,
                       int minLen, int nbSearches,
                       const dictCtx_directive dict,
-                      const HCfavor_e favorDecSpeed)
+                      const HCfavor_e favorDecSpeed,
+                      U32 const hashLog)
 {
     LZ4HC_match_t match = { 0 , 0 };
     const BYTE* matchPtr = NULL;
     /* note : LZ4HC_InsertAndGetWiderMatch() is able to modify the starting position of a match (*startpos),
      * but this won't be the case here, as we define iLowLimit==ip,
      * so LZ4HC_InsertAndGetWiderMatch() won't be allowed to search past ip */
-    int matchLength = LZ4HC_InsertAndGetWiderMatch(ctx, ip, ip, iHighLimit, minLen, &matchPtr, &ip, nbSearches, 1 /*patternAnalysis*/, 1 /*chainSwap*/, dict, favorDecSpeed);
+    int matchLength = LZ4HC_InsertAndGetWiderMatch(ctx, ip, ip, iHighLimit, minLen, &matchPtr, &ip, nbSearches, 1 /*patternAnalysis*/, 1 /*chainSwap*/, dict, favorDecSpeed, hashLog);
     if (matchLength <= minLen) return match;
     if (favorDecSpeed) {
         if ((matchLength>18) & (matchLength<=36)) matchLength=18;   /* favor shortcut */
@@ -1312,7 +1414,7 @@ LZ4HC_FindLongerMatch(LZ4HC_CCtx_internal* const ctx,
 }
 
 
-static int LZ4HC_compress_optimal ( LZ4HC_CCtx_internal* ctx,
+LZ4_FORCE_INLINE int LZ4HC_compress_optimal ( LZ4HC_CCtx_internal* ctx,
                                     const char* const source,
                                     char* dst,
                                     int* srcSizePtr,
@@ -1322,7 +1424,8 @@ static int LZ4HC_compress_optimal ( LZ4HC_CCtx_internal* ctx,
                                     const limitedOutput_directive limit,
                                     int const fullUpdate,
                                     const dictCtx_directive dict,
-                                    const HCfavor_e favorDecSpeed)
+                                    const HCfavor_e favorDecSpeed,
+                                    U32 const hashLog)
 {
     int retval = 0;
 #define TRAILING_LITERALS 3
@@ -1358,7 +1461,7 @@ static int LZ4HC_compress_optimal ( LZ4HC_CCtx_internal* ctx,
          int best_mlen, best_off;
          int cur, last_match_pos = 0;
 
-         LZ4HC_match_t const firstMatch = LZ4HC_FindLongerMatch(ctx, ip, matchlimit, MINMATCH-1, nbSearches, dict, favorDecSpeed);
+         LZ4HC_match_t const firstMatch = LZ4HC_FindLongerMatch(ctx, ip, matchlimit, MINMATCH-1, nbSearches, dict, favorDecSpeed, hashLog);
          if (firstMatch.len==0) { ip++; continue; }
 
          if ((size_t)firstMatch.len > sufficient_len) {
@@ -1431,10 +1534,10 @@ static int LZ4HC_compress_optimal ( LZ4HC_CCtx_internal* ctx,
 
              DEBUGLOG(7, "search at rPos:%u", cur);
              if (fullUpdate)
-                 newMatch = LZ4HC_FindLongerMatch(ctx, curPtr, matchlimit, MINMATCH-1, nbSearches, dict, favorDecSpeed);
+                 newMatch = LZ4HC_FindLongerMatch(ctx, curPtr, matchlimit, MINMATCH-1, nbSearches, dict, favorDecSpeed, hashLog);
              else
                  /* only test matches of minimum length; slightly faster, but misses a few bytes */
-                 newMatch = LZ4HC_FindLongerMatch(ctx, curPtr, matchlimit, last_match_pos - cur, nbSearches, dict, favorDecSpeed);
+                 newMatch = LZ4HC_FindLongerMatch(ctx, curPtr, matchlimit, last_match_pos - cur, nbSearches, dict, favorDecSpeed, hashLog);
              if (!newMatch.len) continue;
 
              if ( ((size_t)newMatch.len > sufficient_len)
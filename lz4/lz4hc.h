@@ -194,6 +194,8 @@ LZ4LIB_API int LZ4_saveDictHC (LZ4_streamHC_t* streamHCPtr, char* safeBuffer, in
 #define LZ4HC_MAXD_MASK (LZ4HC_MAXD - 1)
 
 #define LZ4HC_HASH_LOG 15
+#define LZ4HC_HASH_LOG_MIN 10   /* LZ4_initStreamHCEx() */
+#define LZ4HC_HASH_LOG_MAX 16
 #define LZ4HC_HASHTABLESIZE (1 << LZ4HC_HASH_LOG)
 #define LZ4HC_HASH_MASK (LZ4HC_HASHTABLESIZE - 1)
 
@@ -201,7 +203,6 @@ LZ4LIB_API int LZ4_saveDictHC (LZ4_streamHC_t* streamHCPtr, char* safeBuffer, in
 typedef struct LZ4HC_CCtx_internal LZ4HC_CCtx_internal;
 struct LZ4HC_CCtx_internal
 {
-    LZ4_u32   hashTable[LZ4HC_HASHTABLESIZE];
     LZ4_u16   chainTable[LZ4HC_MAXD];
     const LZ4_byte* end;       /* next block here to continue on current prefix */
     const LZ4_byte* base;      /* All index relative to this position */
@@ -213,7 +214,9 @@ struct LZ4HC_CCtx_internal
     LZ4_i8    favorDecSpeed;   /* favor decompression speed if this flag set,
                                   otherwise, favor compression ratio */
     LZ4_i8    dirty;           /* stream has to be fully reset if this flag is set */
+    LZ4_i8    hashLog;         /* 0 : LZ4HC_HASH_LOG */
     const LZ4HC_CCtx_internal* dictCtx;
+    LZ4_u32   hashTable[LZ4HC_HASHTABLESIZE];   /* last, LZ4_initStreamHCEx() tables can be larger */
 };
 
 
@@ -405,6 +408,22 @@ LZ4LIB_STATIC_API void LZ4_attach_HC_dictionary(
           LZ4_streamHC_t *working_stream,
     const LZ4_streamHC_t *dictionary_stream);
 
+/*! LZ4_createStreamHCEx(), LZ4_initStreamHCEx(), LZ4_sizeofStateHCEx() :
+ *  Streams with a hash table of (1 << hashLog) entries, instead of the LZ4HC_HASH_LOG default.
+ *  hashLog is one of 10, 12, 14, 16, or LZ4HC_HASH_LOG.
+ *  A smaller table is cleared faster and its entries stay in cache, which helps small messages.
+ *  The compressors are instantiated for each of these sizes, like LZ4_createStreamEx() ones.
+ *
+ *  LZ4_sizeofStateHCEx() @return the buffer size for LZ4_initStreamHCEx(), or 0 when hashLog is not supported.
+ *  Sizes above the default are larger than LZ4_streamHC_t, such a stream can't be declared statically.
+ *  The hash log is kept by LZ4_resetStreamHC_fast() and LZ4_loadDictHC(),
+ *  LZ4_initStreamHC() and LZ4_resetStreamHC() reset the stream to LZ4HC_HASH_LOG.
+ *  LZ4_attach_HC_dictionary() ignores a dictionary stream with a different hash log.
+ */
+LZ4LIB_STATIC_API int LZ4_sizeofStateHCEx(int hashLog);
+LZ4LIB_STATIC_API LZ4_streamHC_t* LZ4_initStreamHCEx(void* buffer, size_t size, int hashLog);
+LZ4LIB_STATIC_API LZ4_streamHC_t* LZ4_createStreamHCEx(int hashLog);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -106,6 +106,10 @@ typedef enum { XXH_OK=0, XXH_ERROR } XXH_errorcode;
      /* this version may generate warnings for unused static functions */
 #    define XXH_PUBLIC_API static
 #  endif
+#elif defined(XXH_DLL_EXPORT) && (XXH_DLL_EXPORT==1)
+#  define XXH_PUBLIC_API __declspec(dllexport)
+#elif defined(XXH_DLL_IMPORT) && (XXH_DLL_IMPORT==1)
+#  define XXH_PUBLIC_API __declspec(dllimport)
 #else
 #  define XXH_PUBLIC_API   /* do nothing */
 #endif /* XXH_INLINE_ALL || XXH_PRIVATE_API */